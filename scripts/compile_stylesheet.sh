@@ -0,0 +1,113 @@
+#!/bin/bash
+#
+# Copyright 2014-present Pixate, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# This script compiles a CSS file into a .pxssc stylesheet that Pixate Freestyle can memory-map at launch instead of
+# parsing. Add the output to your app bundle next to (or instead of) default.css. Since the framework depends on UIKit,
+# the compiler runs in the iOS simulator, so a simulator device must be booted.
+#
+#   compile_stylesheet.sh [-c Debug|Release] input.css [output.pxssc]
+
+. ${PX_FREESTYLE_SCRIPT:-$(dirname $0)}/common.sh
+
+BUILDCONFIGURATION=Release
+while getopts ":c:" OPTNAME
+do
+  case "$OPTNAME" in
+    "c")
+      BUILDCONFIGURATION=$OPTARG
+      ;;
+    *)
+      echo "$0 [-c Debug|Release] input.css [output.pxssc]"
+      die
+      ;;
+  esac
+done
+shift $(($OPTIND - 1))
+
+test -n "$1" || die "Missing input CSS file"
+test -x "$XCODEBUILD" || die 'Could not find xcodebuild in $PATH'
+
+PX_FREESTYLE_COMPILER_LIB_DIR=$PX_FREESTYLE_BUILD/${BUILDCONFIGURATION}x86_64
+PX_FREESTYLE_COMPILER=$PX_FREESTYLE_BUILD/compile_stylesheet
+
+# -----------------------------------------------------------------------------
+# Build the simulator library, if needed
+#
+if [ ! -f $PX_FREESTYLE_COMPILER_LIB_DIR/libpixate-freestyle.a ]; then
+  progress_message "Building simulator library."
+
+  cd $PX_FREESTYLE_SRC
+  $XCODEBUILD \
+    RUN_CLANG_STATIC_ANALYZER=NO \
+    -target "pixate-freestyle" \
+    -sdk iphonesimulator \
+    -configuration "$BUILDCONFIGURATION" \
+    ARCHS=x86_64 \
+    VALID_ARCHS=x86_64 \
+    IPHONEOS_DEPLOYMENT_TARGET=7.0 \
+    TARGET_BUILD_DIR=$PX_FREESTYLE_COMPILER_LIB_DIR \
+    BUILT_PRODUCTS_DIR=$PX_FREESTYLE_COMPILER_LIB_DIR \
+    SYMROOT=$PX_FREESTYLE_BUILD \
+    build >>$PX_FREESTYLE_BUILD_LOG 2>&1 \
+    || die "XCode build failed for the simulator library"
+fi
+
+# -----------------------------------------------------------------------------
+# Build the compiler
+#
+progress_message "Building stylesheet compiler."
+
+PX_FREESTYLE_INCLUDES=$(find $PX_FREESTYLE_SRC/Core $PX_FREESTYLE_SRC/Kernel $PX_FREESTYLE_SRC/Modules -type d | sed 's/^/-I/')
+
+xcrun -sdk iphonesimulator clang \
+  -arch x86_64 \
+  -mios-simulator-version-min=7.0 \
+  -fobjc-arc \
+  -ObjC \
+  -include $PX_FREESTYLE_SRC/pixate-freestyle-Prefix.pch \
+  -I$PX_FREESTYLE_SRC \
+  $PX_FREESTYLE_INCLUDES \
+  $PX_FREESTYLE_SCRIPT/compile_stylesheet/main.m \
+  $PX_FREESTYLE_COMPILER_LIB_DIR/libpixate-freestyle.a \
+  -framework Foundation \
+  -framework UIKit \
+  -framework QuartzCore \
+  -framework CoreText \
+  -o $PX_FREESTYLE_COMPILER \
+  || die "Could not build the stylesheet compiler"
+
+# -----------------------------------------------------------------------------
+# Compile the stylesheet
+#
+PX_FREESTYLE_INPUT=$(cd $(dirname "$1") && pwd)/$(basename "$1")
+if [ -n "$2" ]; then
+  PX_FREESTYLE_OUTPUT=$(cd $(dirname "$2") && pwd)/$(basename "$2")
+else
+  PX_FREESTYLE_OUTPUT=${PX_FREESTYLE_INPUT%.*}.pxssc
+fi
+
+progress_message "Compiling $PX_FREESTYLE_INPUT."
+
+xcrun simctl spawn booted $PX_FREESTYLE_COMPILER "$PX_FREESTYLE_INPUT" "$PX_FREESTYLE_OUTPUT" \
+  || die "Could not compile $PX_FREESTYLE_INPUT"
+
+progress_message "Wrote $PX_FREESTYLE_OUTPUT."
+
+# -----------------------------------------------------------------------------
+# Done
+#
+common_success
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  main.m
+//  Pixate
+//
+//  Command-line front end for PXStylesheetCompiler. See compile_stylesheet.sh
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStylesheetCompiler.h"
+#import "PXCompiledStylesheet.h"
+
+int main(int argc, const char *argv[])
+{
+    @autoreleasepool
+    {
+        if (argc < 2 || argc > 3)
+        {
+            fprintf(stderr, "usage: %s input.css [output.%s]\n", argv[0], PXCompiledStylesheetPathExtension.UTF8String);
+            return 2;
+        }
+
+        NSString *input = [NSString stringWithUTF8String:argv[1]];
+        NSString *output = (argc == 3)
+            ? [NSString stringWithUTF8String:argv[2]]
+            : [input.stringByDeletingPathExtension stringByAppendingPathExtension:PXCompiledStylesheetPathExtension];
+        NSArray *errors = nil;
+        BOOL success = [PXStylesheetCompiler compileFileAtPath:input toPath:output errors:&errors];
+
+        // parse errors are kept in the compiled stylesheet, just as they would be when parsing at runtime
+        for (NSString *error in errors)
+        {
+            fprintf(stderr, "%s: warning: %s\n", input.UTF8String, error.UTF8String);
+        }
+
+        if (success == NO)
+        {
+            fprintf(stderr, "%s: error: unable to compile to %s\n", input.UTF8String, output.UTF8String);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -107,6 +107,12 @@
  */
 - (BOOL)isOpaque;
 
+/**
+ *  Return this color's RGBA components as a string that stays the same across launches, or nil if the color has no
+ *  RGB or grayscale components, like a pattern color
+ */
+- (NSString *)componentDescription;
+
 /**
  *  Adds percent to the lightness channel of this color
  */
@@ -437,6 +437,23 @@ void PXForceLoadUIColorPXColor() {}
     return success ? (alpha == 1.0f) : NO;
 }
 
+- (NSString *)componentDescription
+{
+    CGFloat red, green, blue, alpha;
+    NSString *result = nil;
+
+    if ([self getRed:&red green:&green blue:&blue alpha:&alpha])
+    {
+        result = [NSString stringWithFormat:@"rgba(%g,%g,%g,%g)", red, green, blue, alpha];
+    }
+    else if ([self getWhite:&red alpha:&alpha])
+    {
+        result = [NSString stringWithFormat:@"rgba(%g,%g,%g,%g)", red, red, red, alpha];
+    }
+
+    return result;
+}
+
 - (UIColor *)lightenByPercent:(CGFloat)percent
 {
     CGFloat hue, saturation, lightness, alpha;
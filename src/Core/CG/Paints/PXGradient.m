@@ -104,52 +104,56 @@
 
 - (CGGradientRef)gradient
 {
-    if (!_gradient)
+    // gradients are shared by declarations, and may be rendered from more than one thread at once
+    @synchronized(self)
     {
-        // if color count and offset count don't match, then evenly distribute all colors from 0 to 1
-        if (_colors.count != self.offsets.count)
+        if (!_gradient)
         {
-            [_offsets removeAllObjects];
-
-            for (int i = 0; i < _colors.count; i++)
+            // if color count and offset count don't match, then evenly distribute all colors from 0 to 1
+            if (_colors.count != self.offsets.count)
             {
-                [_offsets addObject:[NSNumber numberWithFloat:(CGFloat) i / (_colors.count - 1)]];
+                [_offsets removeAllObjects];
+
+                for (int i = 0; i < _colors.count; i++)
+                {
+                    [_offsets addObject:[NSNumber numberWithFloat:(CGFloat) i / (_colors.count - 1)]];
+                }
             }
-        }
 
-        // convert locations
-        NSUInteger locationCount = [_offsets count];
-        CGFloat locations[locationCount];
+            // convert locations
+            NSUInteger locationCount = [_offsets count];
+            CGFloat locations[locationCount];
 
-        for (int i = 0; i < locationCount; i++)
-        {
-            locations[i] = [[_offsets objectAtIndex:i] floatValue];
-        }
+            for (int i = 0; i < locationCount; i++)
+            {
+                locations[i] = [[_offsets objectAtIndex:i] floatValue];
+            }
 
-        // convert colors
-        NSMutableArray *cgColorArray = [NSMutableArray array];
+            // convert colors
+            NSMutableArray *cgColorArray = [NSMutableArray array];
 
-        for (int i = 0; i < [_colors count]; i++)
-        {
-            CGColorRef cref = ((UIColor *) [_colors objectAtIndex:i]).CGColor;
+            for (int i = 0; i < [_colors count]; i++)
+            {
+                CGColorRef cref = ((UIColor *) [_colors objectAtIndex:i]).CGColor;
 
-            [cgColorArray addObject:(__bridge id)cref];
-        }
+                [cgColorArray addObject:(__bridge id)cref];
+            }
 
-        NSArray *colorArray = [NSArray arrayWithArray:cgColorArray];
+            NSArray *colorArray = [NSArray arrayWithArray:cgColorArray];
 
-        // create color space
-        CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+            // create color space
+            CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
 
-        // create gradient
-        _gradient = CGGradientCreateWithColors(colorSpace, (__bridge CFArrayRef) colorArray, locations);
+            // create gradient
+            _gradient = CGGradientCreateWithColors(colorSpace, (__bridge CFArrayRef) colorArray, locations);
 
-        // release color space
-        CGColorSpaceRelease(colorSpace);
-    }
+            // release color space
+            CGColorSpaceRelease(colorSpace);
+        }
 
-    // return gradient
-    return _gradient;
+        // return gradient
+        return _gradient;
+    }
 }
 
 - (BOOL)isOpaque
@@ -199,11 +203,54 @@
         result = [self->_offsets isEqualToArray:that->_offsets]
             &&  [self->_colors isEqualToArray:that->_colors]
             &&  CGAffineTransformEqualToTransform(self->_transform, that->_transform)
-            &&  (self->_gradient == that->_gradient)
+            &&  (self->_gradientUnits == that->_gradientUnits)
             &&  (self->_blendMode == that->_blendMode);
     }
 
     return result;
 }
 
+- (NSUInteger)hash
+{
+    // NSArray only hashes its count, so fold in the stops themselves
+    NSUInteger result = _gradientUnits * 31 + _blendMode;
+
+    for (UIColor *color in _colors)
+    {
+        result = result * 31 + color.hash;
+    }
+
+    for (NSNumber *offset in _offsets)
+    {
+        result = result * 31 + offset.hash;
+    }
+
+    return result;
+}
+
+- (NSString *)persistentDescription
+{
+    NSMutableString *result = [NSMutableString stringWithFormat:@"%d %d %@",
+                               _gradientUnits, _blendMode, NSStringFromCGAffineTransform(_transform)];
+
+    for (UIColor *color in _colors)
+    {
+        NSString *part = [color componentDescription];
+
+        if (part == nil)
+        {
+            return nil;
+        }
+
+        [result appendFormat:@" %@", part];
+    }
+
+    for (NSNumber *offset in _offsets)
+    {
+        [result appendFormat:@" %g", offset.floatValue];
+    }
+
+    return result;
+}
+
 @end
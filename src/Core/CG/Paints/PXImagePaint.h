@@ -35,6 +35,7 @@ typedef enum {
 @interface PXImagePaint : NSObject <PXPaint>
 
 @property (nonatomic) NSURL *imageURL;
+@property (nonatomic, readonly) BOOL hasSVGImageURL;
 //@property (nonatomic) PXImageRepeatType repeatX;
 //@property (nonatomic) PXImageRepeatType repeatY;
 
@@ -23,7 +23,7 @@
 //
 
 #import "PXImagePaint.h"
-#import "PXShapeView.h"
+#import "PXSVGLoader.h"
 #import "MAFuture.h"
 
 @implementation PXImagePaint
@@ -69,10 +69,10 @@
         // create image
         if ([self hasSVGImageURL])
         {
-            PXShapeView *shapeView = [[PXShapeView alloc] initWithFrame:bounds];
+            // the file is parsed once and fit to each size requested
+            PXShapeDocument *document = [PXSVGLoader sharedDocumentForURL:_imageURL];
 
-            [shapeView loadSceneFromURL:_imageURL];
-            image = [shapeView renderToImage];
+            image = [document renderToImageWithSize:size withOpacity:NO];
         }
         else
         {
@@ -161,4 +161,31 @@
     return self;
 }
 
+#pragma mark - Overrides
+
+- (BOOL)isEqual:(id)object
+{
+    BOOL result = NO;
+
+    if ([object isKindOfClass:[PXImagePaint class]])
+    {
+        PXImagePaint *that = object;
+
+        result = (_imageURL == that->_imageURL || [_imageURL isEqual:that->_imageURL]) && _blendMode == that->_blendMode;
+    }
+
+    return result;
+}
+
+- (NSUInteger)hash
+{
+    return _imageURL.hash * 31 + _blendMode;
+}
+
+- (NSString *)persistentDescription
+{
+    // the image behind the URL may change without the URL changing, so rendered images are never persisted
+    return nil;
+}
+
 @end
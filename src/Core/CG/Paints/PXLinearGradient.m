@@ -403,4 +403,49 @@ typedef enum {
     return result;
 }
 
+- (NSUInteger)hash
+{
+    NSUInteger result = super.hash * 31 + angleType_;
+
+    switch (angleType_)
+    {
+        case PXAngleTypeAngle:
+            result = result * 31 + [NSNumber numberWithFloat:_angle].hash;
+            break;
+
+        case PXAngleTypeDirection:
+            result = result * 31 + _gradientDirection;
+            break;
+
+        case PXAngleTypePoints:
+            result = result * 31 + [NSNumber numberWithFloat:_p1.x + _p1.y + _p2.x + _p2.y].hash;
+            break;
+    }
+
+    return result;
+}
+
+- (NSString *)persistentDescription
+{
+    NSString *stops = super.persistentDescription;
+    NSString *geometry = nil;
+
+    switch (angleType_)
+    {
+        case PXAngleTypeAngle:
+            geometry = [NSString stringWithFormat:@"angle %g", _angle];
+            break;
+
+        case PXAngleTypeDirection:
+            geometry = [NSString stringWithFormat:@"direction %d", _gradientDirection];
+            break;
+
+        case PXAngleTypePoints:
+            geometry = [NSString stringWithFormat:@"points %@ %@", NSStringFromCGPoint(_p1), NSStringFromCGPoint(_p2)];
+            break;
+    }
+
+    return (stops) ? [NSString stringWithFormat:@"linear(%@ %@)", geometry, stops] : nil;
+}
+
 @end
@@ -39,6 +39,12 @@
  */
 @property (readonly, nonatomic, getter=isOpaque) BOOL opaque;
 
+/**
+ *  A description of everything that affects how this paint renders, which stays the same across launches, or nil if
+ *  the paint depends on something the description cannot capture, like the contents of an external image
+ */
+@property (readonly, nonatomic) NSString *persistentDescription;
+
 /**
  *  A method used to apply the implementations fill to the specified CGPath in the given CGContext
  *
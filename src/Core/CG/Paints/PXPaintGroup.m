@@ -138,4 +138,35 @@
     return result;
 }
 
+- (NSUInteger)hash
+{
+    NSUInteger result = 0;
+
+    for (id<PXPaint> paint in paints_)
+    {
+        result = result * 31 + paint.hash;
+    }
+
+    return result;
+}
+
+- (NSString *)persistentDescription
+{
+    NSMutableArray *parts = [NSMutableArray arrayWithCapacity:paints_.count];
+
+    for (id<PXPaint> paint in paints_)
+    {
+        NSString *part = paint.persistentDescription;
+
+        if (part == nil)
+        {
+            return nil;
+        }
+
+        [parts addObject:part];
+    }
+
+    return [NSString stringWithFormat:@"group(%@)", [parts componentsJoinedByString:@" "]];
+}
+
 @end
@@ -162,4 +162,19 @@
     return result;
 }
 
+- (NSUInteger)hash
+{
+    return super.hash * 31 + [NSNumber numberWithFloat:_radius].hash;
+}
+
+- (NSString *)persistentDescription
+{
+    NSString *stops = super.persistentDescription;
+
+    return (stops)
+        ?   [NSString stringWithFormat:@"radial(%@ %@ %g %@)",
+             NSStringFromCGPoint(_startCenter), NSStringFromCGPoint(_endCenter), _radius, stops]
+        :   nil;
+}
+
 @end
@@ -82,6 +82,18 @@
     return result;
 }
 
+- (NSUInteger)hash
+{
+    return _color.hash * 31 + _blendMode;
+}
+
+- (NSString *)persistentDescription
+{
+    NSString *color = [[self activeColor] componentDescription];
+
+    return (color) ? [NSString stringWithFormat:@"solid(%@ %d)", color, _blendMode] : nil;
+}
+
 #pragma mark - PXPaint implementation
 
 - (void)applyFillToPath:(CGPathRef)path withContext:(CGContextRef)context
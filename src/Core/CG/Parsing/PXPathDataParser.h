@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXPathDataParser.h
+//  Pixate
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ *  The segment types stored in a PXPathSegmentBuffer. Each is followed in the value array by its absolute coordinates:
+ *  two for a move or line, four for a quadratic curve, six for a cubic curve, none for a close, and six for an arc, which
+ *  is stored as a center, x and y radii, and start and end angles
+ */
+typedef enum
+{
+    PXPathSegmentMove,
+    PXPathSegmentLine,
+    PXPathSegmentQuadratic,
+    PXPathSegmentCubic,
+    PXPathSegmentArc,
+    PXPathSegmentClose
+} PXPathSegmentType;
+
+/**
+ *  A compact list of path segments, with one byte per segment type and the coordinates of all segments packed into a
+ *  single array
+ */
+typedef struct
+{
+    uint8_t *types;
+    NSUInteger count;
+    NSUInteger capacity;
+    CGFloat *values;
+    NSUInteger valueCount;
+    NSUInteger valueCapacity;
+} PXPathSegmentBuffer;
+
+/**
+ *  Initialize an empty buffer, sized for path data of the specified length
+ *
+ *  @param buffer The buffer to initialize
+ *  @param length The number of bytes of path data expected
+ */
+void PXPathSegmentBufferInit(PXPathSegmentBuffer *buffer, NSUInteger length);
+
+/**
+ *  Free the storage of a buffer
+ *
+ *  @param buffer The buffer to free
+ */
+void PXPathSegmentBufferFree(PXPathSegmentBuffer *buffer);
+
+/**
+ *  Parse SVG 1.1 path data in a single pass, appending its segments to the buffer. Relative and shorthand commands are
+ *  resolved to absolute segments. Parsing stops at the first error, keeping the segments before it
+ *
+ *  @param buffer The buffer to append to
+ *  @param bytes The path data, which is ASCII in any valid path
+ *  @param length The number of bytes of path data
+ *  @returns NSNotFound on success, or the offset of the first error
+ */
+NSUInteger PXPathSegmentBufferParse(PXPathSegmentBuffer *buffer, const char *bytes, NSUInteger length);
+
+/**
+ *  Create a new path holding every segment of the buffer. The caller is responsible for releasing it
+ *
+ *  @param buffer The buffer to convert
+ */
+CGMutablePathRef PXPathSegmentBufferCreatePath(const PXPathSegmentBuffer *buffer);
+
+/**
+ *  Convert an SVG elliptical arc from the endpoint parameterization to a center, radii, and start and end angles, as
+ *  used by CGPathAddEllipticalArc. Returns NO, leaving values unchanged, when both radii are zero
+ *
+ *  @param from The current point
+ *  @param rx The x radius
+ *  @param ry The y radius
+ *  @param xAxisRotation The rotation of the ellipse, in degrees
+ *  @param largeArcFlag Whether the larger of the two possible arcs is used
+ *  @param sweepFlag Whether the arc is drawn in the positive-angle direction
+ *  @param to The end point
+ *  @param values The center x and y, x and y radii, and start and end angles of the arc
+ */
+BOOL PXPathGetArcCenter(CGPoint from, CGFloat rx, CGFloat ry, CGFloat xAxisRotation, BOOL largeArcFlag, BOOL sweepFlag, CGPoint to, CGFloat values[6]);
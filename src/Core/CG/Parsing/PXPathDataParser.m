@@ -0,0 +1,473 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXPathDataParser.m
+//  Pixate
+//
+
+#import "PXPathDataParser.h"
+#import "PXSVGAttributes.h"
+#import "PXEllipticalArc.h"
+#import "PXMath.h"
+
+static inline BOOL PXPathIsSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',';
+}
+
+static inline BOOL PXPathIsNumberStart(char c)
+{
+    return ('0' <= c && c <= '9') || c == '.' || c == '-' || c == '+';
+}
+
+/**
+ *  Return the number of arguments of a command, or -1 if the character is not a command
+ */
+static int PXPathArgumentCount(char command)
+{
+    int result = -1;
+
+    switch (command)
+    {
+        case 'Z': case 'z': result = 0; break;
+        case 'H': case 'h': case 'V': case 'v': result = 1; break;
+        case 'M': case 'm': case 'L': case 'l': case 'T': case 't': result = 2; break;
+        case 'Q': case 'q': case 'S': case 's': result = 4; break;
+        case 'C': case 'c': result = 6; break;
+        case 'A': case 'a': result = 7; break;
+    }
+
+    return result;
+}
+
+static void PXPathSegmentBufferAppend(PXPathSegmentBuffer *buffer, PXPathSegmentType type, const CGFloat *values, NSUInteger count)
+{
+    if (buffer->count == buffer->capacity)
+    {
+        buffer->capacity = MAX(buffer->capacity * 2, 16);
+        buffer->types = realloc(buffer->types, buffer->capacity);
+    }
+
+    if (buffer->valueCount + count > buffer->valueCapacity)
+    {
+        buffer->valueCapacity = MAX(buffer->valueCapacity * 2, buffer->valueCount + count);
+        buffer->values = realloc(buffer->values, buffer->valueCapacity * sizeof(CGFloat));
+    }
+
+    buffer->types[buffer->count++] = (uint8_t) type;
+
+    if (count > 0)
+    {
+        memcpy(buffer->values + buffer->valueCount, values, count * sizeof(CGFloat));
+        buffer->valueCount += count;
+    }
+}
+
+void PXPathSegmentBufferInit(PXPathSegmentBuffer *buffer, NSUInteger length)
+{
+    // a coordinate takes at least two bytes with its separator, and most segments have at least two
+    buffer->count = 0;
+    buffer->capacity = length / 4 + 1;
+    buffer->types = malloc(buffer->capacity);
+    buffer->valueCount = 0;
+    buffer->valueCapacity = length / 2 + 2;
+    buffer->values = malloc(buffer->valueCapacity * sizeof(CGFloat));
+}
+
+void PXPathSegmentBufferFree(PXPathSegmentBuffer *buffer)
+{
+    free(buffer->types);
+    free(buffer->values);
+
+    buffer->types = NULL;
+    buffer->values = NULL;
+    buffer->count = buffer->capacity = 0;
+    buffer->valueCount = buffer->valueCapacity = 0;
+}
+
+NSUInteger PXPathSegmentBufferParse(PXPathSegmentBuffer *buffer, const char *bytes, NSUInteger length)
+{
+    const char *p = bytes;
+    const char *end = bytes + length;
+    NSUInteger errorOffset = NSNotFound;
+    char command = '\0';
+    CGFloat firstX = 0.0, firstY = 0.0;
+    CGFloat lastX = 0.0, lastY = 0.0;
+    CGFloat lastHandleX = 0.0, lastHandleY = 0.0;
+
+    // the end of the last segment added, which is not moved by an arc with no radii
+    CGPoint current = CGPointZero;
+
+    while (errorOffset == NSNotFound)
+    {
+        char previous = command;
+        CGFloat v[7];
+        int count;
+
+        while (p < end && PXPathIsSeparator(*p))
+        {
+            p++;
+        }
+
+        if (p == end)
+        {
+            break;
+        }
+
+        // a command letter, or more arguments for the last command
+        if (PXPathArgumentCount(*p) >= 0)
+        {
+            command = *p++;
+        }
+        else if (command == '\0' || !PXPathIsNumberStart(*p))
+        {
+            errorOffset = p - bytes;
+            break;
+        }
+
+        count = PXPathArgumentCount(command);
+
+        for (int i = 0; i < count && errorOffset == NSNotFound; i++)
+        {
+            BOOL scanned;
+
+            if ((command == 'A' || command == 'a') && (i == 3 || i == 4))
+            {
+                // flags are a single digit and may be written without separators, as in "a1 1 0 0110 10"
+                while (p < end && PXPathIsSeparator(*p))
+                {
+                    p++;
+                }
+
+                scanned = (p < end && (*p == '0' || *p == '1') && p + 1 < end && PXPathIsNumberStart(p[1]) && p[1] != '.');
+
+                if (scanned)
+                {
+                    v[i] = *p++ - '0';
+                }
+                else
+                {
+                    scanned = PXSVGScanNumber(&p, end, &v[i]);
+                }
+            }
+            else
+            {
+                scanned = PXSVGScanListNumber(&p, end, &v[i]);
+            }
+
+            if (!scanned)
+            {
+                errorOffset = p - bytes;
+            }
+        }
+
+        if (errorOffset != NSNotFound)
+        {
+            break;
+        }
+
+        switch (command)
+        {
+            case 'm':
+                v[0] += lastX;
+                v[1] += lastY;
+                // fall through
+            case 'M':
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentMove, v, 2);
+
+                // subsequent pairs are implicit line commands
+                command = (command == 'M') ? 'L' : 'l';
+                lastX = firstX = v[0];
+                lastY = firstY = v[1];
+                current = CGPointMake(v[0], v[1]);
+                break;
+
+            case 'l':
+                v[0] += lastX;
+                v[1] += lastY;
+                // fall through
+            case 'L':
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentLine, v, 2);
+
+                lastX = v[0];
+                lastY = v[1];
+                current = CGPointMake(v[0], v[1]);
+                break;
+
+            case 'h':
+                v[0] += lastX;
+                // fall through
+            case 'H':
+                v[1] = lastY;
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentLine, v, 2);
+
+                lastX = v[0];
+                current = CGPointMake(v[0], v[1]);
+                break;
+
+            case 'v':
+                v[0] += lastY;
+                // fall through
+            case 'V':
+                v[1] = v[0];
+                v[0] = lastX;
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentLine, v, 2);
+
+                lastY = v[1];
+                current = CGPointMake(v[0], v[1]);
+                break;
+
+            case 'c':
+                for (int i = 0; i < 6; i += 2)
+                {
+                    v[i] += lastX;
+                    v[i + 1] += lastY;
+                }
+                // fall through
+            case 'C':
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentCubic, v, 6);
+
+                lastHandleX = v[2];
+                lastHandleY = v[3];
+                lastX = v[4];
+                lastY = v[5];
+                current = CGPointMake(v[4], v[5]);
+                break;
+
+            case 'S':
+            case 's':
+            {
+                CGFloat values[6];
+                BOOL reflect = (previous == 'S' || previous == 's' || previous == 'C' || previous == 'c');
+
+                values[0] = (reflect) ? 2.0 * lastX - lastHandleX : lastX;
+                values[1] = (reflect) ? 2.0 * lastY - lastHandleY : lastY;
+
+                for (int i = 0; i < 4; i += 2)
+                {
+                    values[i + 2] = (command == 's') ? v[i] + lastX : v[i];
+                    values[i + 3] = (command == 's') ? v[i + 1] + lastY : v[i + 1];
+                }
+
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentCubic, values, 6);
+
+                lastHandleX = values[2];
+                lastHandleY = values[3];
+                lastX = values[4];
+                lastY = values[5];
+                current = CGPointMake(values[4], values[5]);
+                break;
+            }
+
+            case 'q':
+                for (int i = 0; i < 4; i += 2)
+                {
+                    v[i] += lastX;
+                    v[i + 1] += lastY;
+                }
+                // fall through
+            case 'Q':
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentQuadratic, v, 4);
+
+                lastHandleX = v[0];
+                lastHandleY = v[1];
+                lastX = v[2];
+                lastY = v[3];
+                current = CGPointMake(v[2], v[3]);
+                break;
+
+            case 'T':
+            case 't':
+            {
+                CGFloat values[4];
+                BOOL reflect = (previous == 'Q' || previous == 'q' || previous == 'T' || previous == 't');
+
+                values[0] = (reflect) ? 2.0 * lastX - lastHandleX : lastX;
+                values[1] = (reflect) ? 2.0 * lastY - lastHandleY : lastY;
+                values[2] = (command == 't') ? v[0] + lastX : v[0];
+                values[3] = (command == 't') ? v[1] + lastY : v[1];
+
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentQuadratic, values, 4);
+
+                lastHandleX = values[0];
+                lastHandleY = values[1];
+                lastX = values[2];
+                lastY = values[3];
+                current = CGPointMake(values[2], values[3]);
+                break;
+            }
+
+            case 'a':
+                v[5] += lastX;
+                v[6] += lastY;
+                // fall through
+            case 'A':
+            {
+                CGFloat values[6];
+                CGPoint to = CGPointMake(v[5], v[6]);
+
+                if (PXPathGetArcCenter(current, v[0], v[1], v[2], (v[3] > 0.0), (v[4] > 0.0), to, values))
+                {
+                    PXPathSegmentBufferAppend(buffer, PXPathSegmentArc, values, 6);
+                    current = to;
+                }
+
+                lastX = to.x;
+                lastY = to.y;
+                break;
+            }
+
+            case 'Z':
+            case 'z':
+                PXPathSegmentBufferAppend(buffer, PXPathSegmentClose, NULL, 0);
+
+                // arguments may not follow a close
+                command = '\0';
+                lastX = firstX;
+                lastY = firstY;
+                current = CGPointMake(firstX, firstY);
+                break;
+        }
+    }
+
+    return errorOffset;
+}
+
+CGMutablePathRef PXPathSegmentBufferCreatePath(const PXPathSegmentBuffer *buffer)
+{
+    CGMutablePathRef path = CGPathCreateMutable();
+    const CGFloat *v = buffer->values;
+
+    for (NSUInteger i = 0; i < buffer->count; i++)
+    {
+        switch ((PXPathSegmentType) buffer->types[i])
+        {
+            case PXPathSegmentMove:
+                CGPathMoveToPoint(path, NULL, v[0], v[1]);
+                v += 2;
+                break;
+
+            case PXPathSegmentLine:
+                CGPathAddLineToPoint(path, NULL, v[0], v[1]);
+                v += 2;
+                break;
+
+            case PXPathSegmentQuadratic:
+                CGPathAddQuadCurveToPoint(path, NULL, v[0], v[1], v[2], v[3]);
+                v += 4;
+                break;
+
+            case PXPathSegmentCubic:
+                CGPathAddCurveToPoint(path, NULL, v[0], v[1], v[2], v[3], v[4], v[5]);
+                v += 6;
+                break;
+
+            case PXPathSegmentArc:
+                CGPathAddEllipticalArc(path, NULL, v[0], v[1], v[2], v[3], v[4], v[5]);
+                v += 6;
+                break;
+
+            case PXPathSegmentClose:
+                CGPathCloseSubpath(path);
+                break;
+        }
+    }
+
+    return path;
+}
+
+BOOL PXPathGetArcCenter(CGPoint from, CGFloat rx, CGFloat ry, CGFloat xAxisRotation, BOOL largeArcFlag, BOOL sweepFlag, CGPoint to, CGFloat values[6])
+{
+    BOOL result = (rx != 0.0 || ry != 0.0);
+
+    if (result)
+    {
+        CGFloat halfDx  = (from.x - to.x) * 0.5;
+        CGFloat halfDy  = (from.y - to.y) * 0.5;
+        CGFloat radians = DEGREES_TO_RADIANS(xAxisRotation);
+        CGFloat cosine  = COS(radians);
+        CGFloat sine    = SIN(radians);
+        CGFloat x1p     = halfDx *  cosine + halfDy * sine;
+        CGFloat y1p     = halfDx * -sine   + halfDy * cosine;
+        CGFloat x1px1p  = x1p*x1p;
+        CGFloat y1py1p  = y1p*y1p;
+        CGFloat lambda  = (x1px1p/(rx*rx)) + (y1py1p/(ry*ry));
+
+        // it may be impossible for the specified radii to describe
+        // an ellipse passing through the previous point and end point.
+        // Adjust radii, if necessary, so ellipse can pass through those
+        // points.
+        if ( lambda > 1.0 )
+        {
+            CGFloat factor = SQRT(lambda);
+
+            rx *= factor;
+            ry *= factor;
+        }
+
+        CGFloat rxrx = rx*rx;
+        CGFloat ryry = ry*ry;
+        CGFloat rxrxryry = rxrx*ryry;
+        CGFloat rxrxy1py1p = rxrx*y1py1p;
+        CGFloat ryryx1px1p = ryry*x1px1p;
+        CGFloat numerator = rxrxryry - rxrxy1py1p - ryryx1px1p;
+        CGFloat s;
+
+        if ( numerator < 1e-6 )
+        {
+            s = 0.0;
+        }
+        else
+        {
+            s = SQRT(numerator / (rxrxy1py1p + ryryx1px1p));
+        }
+        if ( largeArcFlag == sweepFlag )
+        {
+            s = -s;
+        }
+        CGFloat cxp = s *  rx*y1p / ry;
+        CGFloat cyp = s * -ry*x1p / rx;
+
+        // NOTE: SVG spec divides x-component by rx and y-component by ry
+        CGFloat vx = x1p - cxp;
+        CGFloat vy = y1p - cyp;
+        CGFloat wx = -x1p - cxp;
+        CGFloat wy = -y1p - cyp;
+
+        // the angles from the x-axis to v, and from v to w
+        CGFloat startAngle = ATAN2(vy, vx);
+        CGFloat sweepAngle = ATAN2(wy, wx) - ATAN2(vy, vx);
+
+        if ( !sweepFlag && sweepAngle > 0.0 )
+        {
+            sweepAngle -= TWO_PI;
+        }
+        else if ( sweepFlag && sweepAngle < 0.0 )
+        {
+            sweepAngle += TWO_PI;
+        }
+
+        values[0] = cxp * cosine - cyp * sine   + (from.x + to.x) * 0.5;
+        values[1] = cxp * sine   + cyp * cosine + (from.y + to.y) * 0.5;
+        values[2] = rx;
+        values[3] = ry;
+        values[4] = startAngle;
+        values[5] = startAngle + sweepAngle;
+    }
+
+    return result;
+}
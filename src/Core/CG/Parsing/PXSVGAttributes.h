@@ -0,0 +1,203 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXSVGAttributes.h
+//  Pixate
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ *  An enumeration of the attribute names understood by PXSVGLoader. Names not listed here are still kept, but only
+ *  as strings
+ */
+typedef enum
+{
+    PXSVGAttributeUnknown = -1,
+
+    PXSVGAttributeId,
+    PXSVGAttributeStyle,
+    PXSVGAttributeX,
+    PXSVGAttributeY,
+    PXSVGAttributeWidth,
+    PXSVGAttributeHeight,
+    PXSVGAttributeRx,
+    PXSVGAttributeRy,
+    PXSVGAttributeCx,
+    PXSVGAttributeCy,
+    PXSVGAttributeR,
+    PXSVGAttributeFx,
+    PXSVGAttributeFy,
+    PXSVGAttributeX1,
+    PXSVGAttributeY1,
+    PXSVGAttributeX2,
+    PXSVGAttributeY2,
+    PXSVGAttributeD,
+    PXSVGAttributePoints,
+    PXSVGAttributeViewBox,
+    PXSVGAttributePreserveAspectRatio,
+    PXSVGAttributeTransform,
+    PXSVGAttributeOpacity,
+    PXSVGAttributeVisibility,
+    PXSVGAttributeFill,
+    PXSVGAttributeFillOpacity,
+    PXSVGAttributeStroke,
+    PXSVGAttributeStrokeOpacity,
+    PXSVGAttributeStrokeWidth,
+    PXSVGAttributeStrokeType,
+    PXSVGAttributeStrokeDashArray,
+    PXSVGAttributeStrokeDashOffset,
+    PXSVGAttributeStrokeLineCap,
+    PXSVGAttributeStrokeLineJoin,
+    PXSVGAttributeStrokeMiterLimit,
+    PXSVGAttributeGradientUnits,
+    PXSVGAttributeGradientTransform,
+    PXSVGAttributeOffset,
+    PXSVGAttributeStopColor,
+    PXSVGAttributeStopOpacity,
+    PXSVGAttributeStartAngle,
+    PXSVGAttributeEndAngle,
+
+    PXSVGAttributeCount
+} PXSVGAttribute;
+
+/**
+ *  Return the attribute with the specified UTF-8 name, or PXSVGAttributeUnknown if it is not one PXSVGLoader
+ *  understands
+ *
+ *  @param name The bytes of the name, which need not be NUL-terminated
+ *  @param length The number of bytes in the name
+ */
+PXSVGAttribute PXSVGAttributeForName(const char *name, NSUInteger length);
+
+/**
+ *  Scan a number, with an optional sign, fraction, and exponent, starting at *cursor. On success, the cursor is
+ *  advanced past the number. Otherwise, NO is returned and the cursor is left unchanged
+ *
+ *  @param cursor The position to scan from
+ *  @param end The end of the bytes to scan
+ *  @param number The scanned number
+ */
+BOOL PXSVGScanNumber(const char **cursor, const char *end, CGFloat *number);
+
+/**
+ *  Scan the next number of a list separated by whitespace and commas, as used by the points, viewBox, and
+ *  stroke-dasharray attributes
+ *
+ *  @param cursor The position to scan from
+ *  @param end The end of the bytes to scan
+ *  @param number The scanned number
+ */
+BOOL PXSVGScanListNumber(const char **cursor, const char *end, CGFloat *number);
+
+/**
+ *  Convert an attribute value to a number, ignoring leading whitespace and any trailing unit. Percentages are divided
+ *  by 100, and values without a leading number are zero
+ *
+ *  @param bytes The UTF-8 bytes of the value
+ *  @param length The number of bytes in the value
+ */
+CGFloat PXSVGNumberFromBytes(const char *bytes, NSUInteger length);
+
+/**
+ *  PXSVGAttributes holds the attributes of a single SVG element, with the declarations of its style attribute merged
+ *  over them. Values are kept as UTF-8 bytes in one buffer indexed by PXSVGAttribute, so numbers can be parsed without
+ *  creating strings, and strings are only created when asked for.
+ *
+ *  This is a dictionary keyed by attribute name, so it can be passed anywhere PXSVGLoader used to pass the attribute
+ *  dictionary built by NSXMLParser.
+ */
+@interface PXSVGAttributes : NSDictionary
+
+/**
+ *  Return the specified dictionary if it is already an instance of PXSVGAttributes, or a new instance holding its
+ *  string values otherwise
+ *
+ *  @param dictionary A dictionary of attribute values
+ */
++ (PXSVGAttributes *)attributesWithDictionary:(NSDictionary *)dictionary;
+
+/**
+ *  Initialize a new instance with room for the specified number of value bytes before its buffer needs to grow
+ *
+ *  @param capacity The number of value bytes to reserve
+ */
+- (id)initWithValueCapacity:(NSUInteger)capacity;
+
+/**
+ *  Determine if the specified attribute has a value
+ *
+ *  @param attribute The attribute to test
+ */
+- (BOOL)hasAttribute:(PXSVGAttribute)attribute;
+
+/**
+ *  Return the value of the specified attribute, or nil if it has none
+ *
+ *  @param attribute The attribute to look up
+ */
+- (NSString *)stringForAttribute:(PXSVGAttribute)attribute;
+
+/**
+ *  Return the UTF-8 bytes of the value of the specified attribute, or NULL if it has none. The bytes are not
+ *  NUL-terminated and remain valid until this instance is changed or deallocated
+ *
+ *  @param attribute The attribute to look up
+ *  @param length The number of bytes in the value
+ */
+- (const char *)bytesForAttribute:(PXSVGAttribute)attribute length:(NSUInteger *)length;
+
+/**
+ *  Return the value of the specified attribute as a number, or zero if it has none. See PXSVGNumberFromBytes
+ *
+ *  @param attribute The attribute to look up
+ */
+- (CGFloat)numberForAttribute:(PXSVGAttribute)attribute;
+
+/**
+ *  Return the value of the specified attribute as an array of NSNumbers, or nil if it has none
+ *
+ *  @param attribute The attribute to look up
+ */
+- (NSArray *)numbersForAttribute:(PXSVGAttribute)attribute;
+
+/**
+ *  Scan up to count numbers from the value of the specified attribute, returning the number scanned
+ *
+ *  @param numbers The buffer to fill
+ *  @param count The capacity of the buffer
+ *  @param attribute The attribute to scan
+ */
+- (NSUInteger)getNumbers:(CGFloat *)numbers count:(NSUInteger)count forAttribute:(PXSVGAttribute)attribute;
+
+/**
+ *  Set the value of the named attribute, replacing any earlier value. This is used while an element is being scanned
+ *
+ *  @param bytes The UTF-8 bytes of the value
+ *  @param length The number of bytes in the value
+ *  @param name The UTF-8 bytes of the attribute name
+ *  @param nameLength The number of bytes in the name
+ */
+- (void)setValueBytes:(const char *)bytes length:(NSUInteger)length forName:(const char *)name length:(NSUInteger)nameLength;
+
+/**
+ *  Split the style attribute into its declarations and set each one, overriding attributes of the same name. This is
+ *  called once all of an element's attributes have been set
+ */
+- (void)mergeStyleAttribute;
+
+@end
@@ -0,0 +1,594 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXSVGAttributes.m
+//  Pixate
+//
+
+#import "PXSVGAttributes.h"
+
+// the number of slots in the name table. This must be a power of two and at least twice PXSVGAttributeCount
+#define NAME_TABLE_SIZE 128
+
+#define ATTRIBUTE_BIT(attribute) (1ULL << (attribute))
+
+static const char * const ATTRIBUTE_NAMES[PXSVGAttributeCount] = {
+    "id",
+    "style",
+    "x",
+    "y",
+    "width",
+    "height",
+    "rx",
+    "ry",
+    "cx",
+    "cy",
+    "r",
+    "fx",
+    "fy",
+    "x1",
+    "y1",
+    "x2",
+    "y2",
+    "d",
+    "points",
+    "viewBox",
+    "preserveAspectRatio",
+    "transform",
+    "opacity",
+    "visibility",
+    "fill",
+    "fill-opacity",
+    "stroke",
+    "stroke-opacity",
+    "stroke-width",
+    "stroke-type",
+    "stroke-dasharray",
+    "stroke-dashoffset",
+    "stroke-linecap",
+    "stroke-linejoin",
+    "stroke-miterlimit",
+    "gradientUnits",
+    "gradientTransform",
+    "offset",
+    "stop-color",
+    "stop-opacity",
+    "start-angle",
+    "end-angle"
+};
+
+static const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// open-addressed table from name hash to attribute + 1, with zero marking an empty slot
+static uint8_t NAME_TABLE[NAME_TABLE_SIZE];
+static size_t NAME_LENGTHS[PXSVGAttributeCount];
+
+static inline BOOL PXSVGIsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline BOOL PXSVGIsDigit(char c)
+{
+    return '0' <= c && c <= '9';
+}
+
+static inline uint32_t PXSVGHashName(const char *name, NSUInteger length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+
+    for (NSUInteger i = 0; i < length; i++)
+    {
+        hash = (hash ^ (uint8_t) name[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+static void PXSVGInitializeNameTable(void)
+{
+    for (int attribute = 0; attribute < PXSVGAttributeCount; attribute++)
+    {
+        size_t length = strlen(ATTRIBUTE_NAMES[attribute]);
+        uint32_t index = PXSVGHashName(ATTRIBUTE_NAMES[attribute], length) & (NAME_TABLE_SIZE - 1);
+
+        while (NAME_TABLE[index] != 0)
+        {
+            index = (index + 1) & (NAME_TABLE_SIZE - 1);
+        }
+
+        NAME_TABLE[index] = (uint8_t) (attribute + 1);
+        NAME_LENGTHS[attribute] = length;
+    }
+}
+
+PXSVGAttribute PXSVGAttributeForName(const char *name, NSUInteger length)
+{
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        PXSVGInitializeNameTable();
+    });
+
+    PXSVGAttribute result = PXSVGAttributeUnknown;
+    uint32_t index = PXSVGHashName(name, length) & (NAME_TABLE_SIZE - 1);
+
+    while (NAME_TABLE[index] != 0)
+    {
+        int attribute = NAME_TABLE[index] - 1;
+
+        if (NAME_LENGTHS[attribute] == length && memcmp(ATTRIBUTE_NAMES[attribute], name, length) == 0)
+        {
+            result = (PXSVGAttribute) attribute;
+            break;
+        }
+
+        index = (index + 1) & (NAME_TABLE_SIZE - 1);
+    }
+
+    return result;
+}
+
+BOOL PXSVGScanNumber(const char **cursor, const char *end, CGFloat *number)
+{
+    const char *p = *cursor;
+    BOOL negative = NO;
+    BOOL hasDigits = NO;
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // integer part. Digits past what a 64-bit mantissa can hold only scale the result
+    for (; p < end && PXSVGIsDigit(*p); p++)
+    {
+        hasDigits = YES;
+
+        if (significantDigits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+
+            if (mantissa != 0)
+            {
+                significantDigits++;
+            }
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+
+    // fraction
+    if (p < end && *p == '.')
+    {
+        const char *q = p + 1;
+
+        for (; q < end && PXSVGIsDigit(*q); q++)
+        {
+            hasDigits = YES;
+
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + (*q - '0');
+                exponent--;
+
+                if (mantissa != 0)
+                {
+                    significantDigits++;
+                }
+            }
+        }
+
+        if (hasDigits)
+        {
+            p = q;
+        }
+    }
+
+    // exponent, which is only consumed when followed by digits so units like "em" are left alone
+    if (hasDigits && p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *q = p + 1;
+        BOOL negativeExponent = NO;
+        int value = 0;
+
+        if (q < end && (*q == '-' || *q == '+'))
+        {
+            negativeExponent = (*q == '-');
+            q++;
+        }
+
+        if (q < end && PXSVGIsDigit(*q))
+        {
+            for (; q < end && PXSVGIsDigit(*q); q++)
+            {
+                if (value < 10000)
+                {
+                    value = value * 10 + (*q - '0');
+                }
+            }
+
+            exponent += (negativeExponent) ? -value : value;
+            p = q;
+        }
+    }
+
+    if (hasDigits)
+    {
+        double value = (double) mantissa;
+
+        if (exponent < 0)
+        {
+            value = (exponent >= -22) ? value / POWERS_OF_TEN[-exponent] : value * pow(10.0, exponent);
+        }
+        else if (exponent > 0)
+        {
+            value = (exponent <= 22) ? value * POWERS_OF_TEN[exponent] : value * pow(10.0, exponent);
+        }
+
+        *number = (CGFloat) ((negative) ? -value : value);
+        *cursor = p;
+    }
+
+    return hasDigits;
+}
+
+BOOL PXSVGScanListNumber(const char **cursor, const char *end, CGFloat *number)
+{
+    const char *p = *cursor;
+
+    while (p < end && (PXSVGIsSpace(*p) || *p == ','))
+    {
+        p++;
+    }
+
+    BOOL result = PXSVGScanNumber(&p, end, number);
+
+    if (result)
+    {
+        *cursor = p;
+    }
+
+    return result;
+}
+
+CGFloat PXSVGNumberFromBytes(const char *bytes, NSUInteger length)
+{
+    const char *p = bytes;
+    const char *end = bytes + length;
+    CGFloat number = 0.0;
+
+    while (p < end && PXSVGIsSpace(*p))
+    {
+        p++;
+    }
+
+    if (PXSVGScanNumber(&p, end, &number) && p < end && *p == '%')
+    {
+        number /= 100.0;
+    }
+
+    return number;
+}
+
+@implementation PXSVGAttributes
+{
+    char *buffer_;
+    NSUInteger length_;
+    NSUInteger capacity_;
+    uint64_t present_;
+    NSRange ranges_[PXSVGAttributeCount];
+    __strong NSString *strings_[PXSVGAttributeCount];
+    NSMutableDictionary *extras_;
+}
+
+#pragma mark - Static Methods
+
++ (PXSVGAttributes *)attributesWithDictionary:(NSDictionary *)dictionary
+{
+    PXSVGAttributes *result = nil;
+
+    if ([dictionary isKindOfClass:[PXSVGAttributes class]])
+    {
+        result = (PXSVGAttributes *) dictionary;
+    }
+    else
+    {
+        result = [[PXSVGAttributes alloc] init];
+
+        [dictionary enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            if ([key isKindOfClass:[NSString class]] && [value isKindOfClass:[NSString class]])
+            {
+                const char *name = [key UTF8String];
+                const char *bytes = [value UTF8String];
+
+                [result setValueBytes:bytes length:strlen(bytes) forName:name length:strlen(name)];
+            }
+        }];
+    }
+
+    return result;
+}
+
+#pragma mark - Initializers
+
+- (id)init
+{
+    return [self initWithValueCapacity:0];
+}
+
+- (id)initWithValueCapacity:(NSUInteger)capacity
+{
+    if (self = [super init])
+    {
+        if (capacity > 0)
+        {
+            buffer_ = malloc(capacity);
+            capacity_ = capacity;
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    free(buffer_);
+}
+
+#pragma mark - Getters
+
+- (BOOL)hasAttribute:(PXSVGAttribute)attribute
+{
+    return (present_ & ATTRIBUTE_BIT(attribute)) != 0;
+}
+
+- (NSString *)stringForAttribute:(PXSVGAttribute)attribute
+{
+    NSString *result = nil;
+
+    if (present_ & ATTRIBUTE_BIT(attribute))
+    {
+        result = strings_[attribute];
+
+        if (result == nil)
+        {
+            NSRange range = ranges_[attribute];
+
+            result = [[NSString alloc] initWithBytes:buffer_ + range.location length:range.length encoding:NSUTF8StringEncoding];
+            strings_[attribute] = result;
+        }
+    }
+
+    return result;
+}
+
+- (const char *)bytesForAttribute:(PXSVGAttribute)attribute length:(NSUInteger *)length
+{
+    const char *result = NULL;
+
+    if (present_ & ATTRIBUTE_BIT(attribute))
+    {
+        result = buffer_ + ranges_[attribute].location;
+        *length = ranges_[attribute].length;
+    }
+    else
+    {
+        *length = 0;
+    }
+
+    return result;
+}
+
+- (CGFloat)numberForAttribute:(PXSVGAttribute)attribute
+{
+    CGFloat result = 0.0;
+
+    if (present_ & ATTRIBUTE_BIT(attribute))
+    {
+        result = PXSVGNumberFromBytes(buffer_ + ranges_[attribute].location, ranges_[attribute].length);
+    }
+
+    return result;
+}
+
+- (NSArray *)numbersForAttribute:(PXSVGAttribute)attribute
+{
+    NSMutableArray *result = nil;
+
+    if (present_ & ATTRIBUTE_BIT(attribute))
+    {
+        const char *p = buffer_ + ranges_[attribute].location;
+        const char *end = p + ranges_[attribute].length;
+        CGFloat number;
+
+        result = [NSMutableArray array];
+
+        while (PXSVGScanListNumber(&p, end, &number))
+        {
+            [result addObject:@(number)];
+        }
+    }
+
+    return result;
+}
+
+- (NSUInteger)getNumbers:(CGFloat *)numbers count:(NSUInteger)count forAttribute:(PXSVGAttribute)attribute
+{
+    NSUInteger result = 0;
+
+    if (present_ & ATTRIBUTE_BIT(attribute))
+    {
+        const char *p = buffer_ + ranges_[attribute].location;
+        const char *end = p + ranges_[attribute].length;
+
+        while (result < count && PXSVGScanListNumber(&p, end, &numbers[result]))
+        {
+            result++;
+        }
+    }
+
+    return result;
+}
+
+#pragma mark - Setters
+
+- (void)setValueBytes:(const char *)bytes length:(NSUInteger)length forName:(const char *)name length:(NSUInteger)nameLength
+{
+    if (length_ + length > capacity_)
+    {
+        capacity_ = MAX(capacity_ * 2, length_ + length);
+        buffer_ = realloc(buffer_, capacity_);
+    }
+
+    memcpy(buffer_ + length_, bytes, length);
+
+    [self setValueRange:NSMakeRange(length_, length) forName:name length:nameLength];
+
+    length_ += length;
+}
+
+- (void)setValueRange:(NSRange)range forName:(const char *)name length:(NSUInteger)nameLength
+{
+    PXSVGAttribute attribute = PXSVGAttributeForName(name, nameLength);
+
+    if (attribute != PXSVGAttributeUnknown)
+    {
+        ranges_[attribute] = range;
+        strings_[attribute] = nil;
+        present_ |= ATTRIBUTE_BIT(attribute);
+    }
+    else
+    {
+        NSString *key = [[NSString alloc] initWithBytes:name length:nameLength encoding:NSUTF8StringEncoding];
+        NSString *value = [[NSString alloc] initWithBytes:buffer_ + range.location length:range.length encoding:NSUTF8StringEncoding];
+
+        if (key && value)
+        {
+            if (extras_ == nil)
+            {
+                extras_ = [[NSMutableDictionary alloc] init];
+            }
+
+            [extras_ setObject:value forKey:key];
+        }
+    }
+}
+
+- (void)mergeStyleAttribute
+{
+    if (present_ & ATTRIBUTE_BIT(PXSVGAttributeStyle))
+    {
+        // declarations are sub-ranges of the style value, so they share its bytes rather than being copied
+        NSUInteger position = ranges_[PXSVGAttributeStyle].location;
+        NSUInteger end = NSMaxRange(ranges_[PXSVGAttributeStyle]);
+
+        while (position < end)
+        {
+            NSUInteger declarationEnd = position;
+            NSUInteger colon = NSNotFound;
+
+            for (; declarationEnd < end && buffer_[declarationEnd] != ';'; declarationEnd++)
+            {
+                if (colon == NSNotFound && buffer_[declarationEnd] == ':')
+                {
+                    colon = declarationEnd;
+                }
+            }
+
+            if (colon != NSNotFound)
+            {
+                NSUInteger nameStart = position;
+                NSUInteger nameEnd = colon;
+                NSUInteger valueStart = colon + 1;
+                NSUInteger valueEnd = declarationEnd;
+
+                while (nameStart < nameEnd && PXSVGIsSpace(buffer_[nameStart])) nameStart++;
+                while (nameEnd > nameStart && PXSVGIsSpace(buffer_[nameEnd - 1])) nameEnd--;
+                while (valueStart < valueEnd && PXSVGIsSpace(buffer_[valueStart])) valueStart++;
+                while (valueEnd > valueStart && PXSVGIsSpace(buffer_[valueEnd - 1])) valueEnd--;
+
+                if (nameEnd > nameStart)
+                {
+                    [self setValueRange:NSMakeRange(valueStart, valueEnd - valueStart)
+                                forName:buffer_ + nameStart
+                                 length:nameEnd - nameStart];
+                }
+            }
+
+            position = declarationEnd + 1;
+        }
+    }
+}
+
+#pragma mark - NSDictionary Methods
+
+- (NSUInteger)count
+{
+    return __builtin_popcountll(present_) + extras_.count;
+}
+
+- (id)objectForKey:(id)key
+{
+    id result = nil;
+
+    if ([key isKindOfClass:[NSString class]])
+    {
+        char name[64];
+        PXSVGAttribute attribute = PXSVGAttributeUnknown;
+
+        if ([key getCString:name maxLength:sizeof(name) encoding:NSUTF8StringEncoding])
+        {
+            attribute = PXSVGAttributeForName(name, strlen(name));
+        }
+
+        result = (attribute != PXSVGAttributeUnknown) ? [self stringForAttribute:attribute] : [extras_ objectForKey:key];
+    }
+
+    return result;
+}
+
+- (NSEnumerator *)keyEnumerator
+{
+    NSMutableArray *keys = [NSMutableArray arrayWithCapacity:self.count];
+
+    for (int attribute = 0; attribute < PXSVGAttributeCount; attribute++)
+    {
+        if (present_ & ATTRIBUTE_BIT(attribute))
+        {
+            [keys addObject:@(ATTRIBUTE_NAMES[attribute])];
+        }
+    }
+
+    if (extras_)
+    {
+        [keys addObjectsFromArray:extras_.allKeys];
+    }
+
+    return [keys objectEnumerator];
+}
+
+@end
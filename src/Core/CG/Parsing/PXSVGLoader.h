@@ -31,8 +31,11 @@
  *  PXSVGLoader is used to load SVG files that have been exported by Adobe Illustrator. This does not support any of the
  *  SVG levels or specfications. As such, this loader is likely to fail when loading SVG files generated by hand or by
  *  other tools.
+ *
+ *  Files are read in chunks by a streaming tokenizer, and built-in elements are dispatched by type. Subclasses may still
+ *  override any of the element handlers, which receive a PXSVGAttributes dictionary.
  */
-@interface PXSVGLoader : NSObject <NSXMLParserDelegate>
+@interface PXSVGLoader : NSObject
 
 @property (nonatomic) NSURL *URL;
 
@@ -50,6 +53,26 @@
  */
 + (PXShapeDocument *) loadFromData:(NSData *)data;
 
+/**
+ *  Create a PXScene by loading an SVG file from the given stream, a chunk at a time. The stream is opened and closed
+ *  if it is not already open
+ *
+ *  @param stream The stream to load
+ */
++ (PXShapeDocument *)loadFromStream:(NSInputStream *)stream;
+
+/**
+ *  Return a PXScene for the SVG file specified by the given URL, shared with every other caller asking for the same
+ *  file. A file is parsed again only once its modification date or size changes, or once its scene has been evicted from
+ *  the cache. Files and data URLs are shared, while other URLs are loaded on each call.
+ *
+ *  The returned scene must not be changed, or given to a PXShapeView. Render it with render:withSize: or
+ *  renderToImageWithSize:withOpacity:, which fit its viewport to a size without changing the scene
+ *
+ *  @param URL The URL to load
+ */
++ (PXShapeDocument *)sharedDocumentForURL:(NSURL *)URL;
+
 /**
  *  The class that will be used to load the SVG file.
  */
@@ -23,11 +23,18 @@
 //
 
 #import "PXSVGLoader.h"
+#import "PXSVGTokenizer.h"
 #import "PXTransformParser.h"
 #import "PXValueParser.h"
 #import "PXGraphics.h"
-#import "NSScanner+PXFloat.h"
 #import "PixateFreestyle.h"
+#import "PXCacheManager.h"
+
+// the number of bytes read from a stream at a time
+#define CHUNK_SIZE 16384
+
+@interface PXSVGLoader () <PXSVGTokenizerDelegate>
+@end
 
 @implementation PXSVGLoader
 {
@@ -73,63 +80,95 @@ static PXValueParser *VALUE_PARSER;
 
 #pragma mark - Static Methods
 
++ (PXSVGLoader *)newLoader
+{
+    Class loader = (loaderClass) ? loaderClass : [PXSVGLoader class];
+
+    return [[loader alloc] init];
+}
+
 + (PXShapeDocument *) loadFromURL:(NSURL *)URL
 {
-    NSData *data = [NSData dataWithContentsOfURL:URL];
+    PXSVGLoader *parser = [self newLoader];
 
-    // create and init NSXMLParser object
-    NSXMLParser *nsXmlParser = [[NSXMLParser alloc] initWithData:data];
-    
-    // create and init our delegate
-    Class loader = (loaderClass) ? loaderClass : [PXSVGLoader class];
-    PXSVGLoader *parser = [[loader alloc] init];
-    
     // save reference to URL for errors
     parser.URL = URL;
-    
-    // set delegate
-    [nsXmlParser setDelegate:parser];
-    
-    // parsing...
-    BOOL success = [nsXmlParser parse];
-    
-    // test the result
-    if (!success)
-    {
-        //        [parser logErrorMessageWithFormat:@"Error parsing document: %@", URL];
-    }
-    
-    PXShapeDocument *document = parser->document;
-    document.shape = parser->result;
-    
-    return document;
+
+    if (URL.isFileURL)
+    {
+        // stream files so they never need to be read into memory all at once
+        [parser loadStream:[NSInputStream inputStreamWithURL:URL]];
+    }
+    else
+    {
+        [parser loadData:[NSData dataWithContentsOfURL:URL]];
+    }
+
+    return [parser loadedDocument];
 }
 
-+ (PXShapeDocument *) loadFromData:(NSData *)data
++ (PXShapeDocument *)sharedDocumentForURL:(NSURL *)URL
 {
-    // create and init NSXMLParser object
-    NSXMLParser *nsXmlParser = [[NSXMLParser alloc] initWithData:data];
+    NSString *key = [self sharedDocumentKeyForURL:URL];
+    PXShapeDocument *sharedDocument = (key) ? [PXCacheManager shapeDocumentForKey:key] : nil;
 
-    // create and init our delegate
-    Class loader = (loaderClass) ? loaderClass : [PXSVGLoader class];
-    PXSVGLoader *parser = [[loader alloc] init];
+    if (sharedDocument == nil && URL)
+    {
+        sharedDocument = [self loadFromURL:URL];
 
-    // set delegate
-    [nsXmlParser setDelegate:parser];
+        // build every path now, so the shared scene is never changed while it is being rendered
+        NSUInteger cost = [sharedDocument buildPaths];
 
-    // parsing...
-    BOOL success = [nsXmlParser parse];
+        if (key)
+        {
+            [PXCacheManager setShapeDocument:sharedDocument forKey:key cost:cost];
+        }
+    }
 
-    // test the result
-    if (!success)
+    return sharedDocument;
+}
+
++ (NSString *)sharedDocumentKeyForURL:(NSURL *)URL
+{
+    NSString *key = nil;
+    NSString *loaderName = NSStringFromClass((loaderClass) ? loaderClass : [PXSVGLoader class]);
+
+    if (URL.isFileURL)
+    {
+        // NSURL caches resource values, so ask the file manager for the current stamp
+        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:URL.path error:NULL];
+
+        if (attributes)
+        {
+            key = [NSString stringWithFormat:@"%@|%@|%f|%llu",
+                   loaderName, URL.path, attributes.fileModificationDate.timeIntervalSinceReferenceDate, attributes.fileSize];
+        }
+    }
+    else if ([@"data" isEqualToString:URL.scheme])
     {
-//        [parser logErrorMessageWithFormat:@"Error parsing document: %@", URL];
+        // the content is part of the URL
+        key = [NSString stringWithFormat:@"%@|%@", loaderName, URL.absoluteString];
     }
 
-    PXShapeDocument *document = parser->document;
-    document.shape = parser->result;
+    return key;
+}
 
-    return document;
++ (PXShapeDocument *) loadFromData:(NSData *)data
+{
+    PXSVGLoader *parser = [self newLoader];
+
+    [parser loadData:data];
+
+    return [parser loadedDocument];
+}
+
++ (PXShapeDocument *)loadFromStream:(NSInputStream *)stream
+{
+    PXSVGLoader *parser = [self newLoader];
+
+    [parser loadStream:stream];
+
+    return [parser loadedDocument];
 }
 
 #pragma mark - Initializers
@@ -145,33 +184,9 @@ static PXValueParser *VALUE_PARSER;
         currentGradient = nil;
         gradients = [NSMutableDictionary dictionary];
 
+        // built-in elements are dispatched by type. These only hold handlers added by subclasses
         startHandlers = [[NSMutableDictionary alloc] init];
-        [self addStartSelector:@selector(startSVGElement:) forElement:@"svg"];
-        [self addStartSelector:@selector(startGElement:) forElement:@"g"];
-        [self addStartSelector:@selector(startPathElement:) forElement:@"path"];
-        [self addStartSelector:@selector(startRectElement:) forElement:@"rect"];
-        [self addStartSelector:@selector(startLineElement:) forElement:@"line"];
-        [self addStartSelector:@selector(startCircleElement:) forElement:@"circle"];
-        [self addStartSelector:@selector(startEllipseElement:) forElement:@"ellipse"];
-        [self addStartSelector:@selector(startLinearGradientElement:) forElement:@"linearGradient"];
-        [self addStartSelector:@selector(startRadialGradientElement:) forElement:@"radialGradient"];
-        [self addStartSelector:@selector(startStopElement:) forElement:@"stop"];
-        [self addStartSelector:@selector(startPolygonElement:) forElement:@"polygon"];
-        [self addStartSelector:@selector(startPolylineElement:) forElement:@"polyline"];
-        [self addStartSelector:@selector(startTextElement:) forElement:@"text"];
-        [self addStartSelector:@selector(startArcElement:) forElement:@"arc"];
-        [self addStartSelector:@selector(startPieElement:) forElement:@"pie"];
-
-        // these aren't actually implemented but they are so common, we add handlers to prevent warnings
-        [self addStartSelector:@selector(ignoreElement:) forElement:@"desc"];
-        [self addStartSelector:@selector(ignoreElement:) forElement:@"defs"];
-
         endHandlers = [[NSMutableDictionary alloc] init];
-        [self addEndSelector:@selector(endSVGElement) forElement:@"svg"];
-        [self addEndSelector:@selector(endGElement) forElement:@"g"];
-        [self addEndSelector:@selector(endGradientElement) forElement:@"linearGradient"];
-        [self addEndSelector:@selector(endGradientElement) forElement:@"radialGradient"];
-        [self addEndSelector:@selector(endTextElement) forElement:@"text"];
 
         // view port alignment type map
         alignTypes = @{
@@ -201,63 +216,102 @@ static PXValueParser *VALUE_PARSER;
     [startHandlers setValue:[NSValue valueWithPointer:selector] forKey:elementName];
 }
 
-#pragma mark - Parsing Methods
+#pragma mark - Loading Methods
 
-- (void) parser:(NSXMLParser *)parser
-didStartElement:(NSString *)elementName
-   namespaceURI:(NSString *)namespaceURI
-  qualifiedName:(NSString *)qName
-     attributes:(NSDictionary *)attributeDict
+- (BOOL)loadData:(NSData *)data
 {
-    NSValue *selectorPointer = [startHandlers valueForKey:elementName];
+    PXSVGTokenizer *tokenizer = [[PXSVGTokenizer alloc] initWithDelegate:self];
 
-    if (selectorPointer)
-    {
-        SEL selector = [selectorPointer pointerValue];
+    [tokenizer appendBytes:data.bytes length:data.length];
+
+    return [tokenizer finish];
+}
 
-        // merge style properties with attribute values. Style declarations override attributes
-        NSString *style = [attributeDict objectForKey:@"style"];
+- (BOOL)loadStream:(NSInputStream *)stream
+{
+    PXSVGTokenizer *tokenizer = [[PXSVGTokenizer alloc] initWithDelegate:self];
+    BOOL opened = (stream.streamStatus == NSStreamStatusNotOpen);
+    uint8_t buffer[CHUNK_SIZE];
+    NSInteger count;
+
+    if (opened)
+    {
+        [stream open];
+    }
 
-        if (style)
+    while ((count = [stream read:buffer maxLength:CHUNK_SIZE]) > 0)
+    {
+        if (![tokenizer appendBytes:buffer length:count])
         {
-            NSMutableDictionary *newAttributeDict = [NSMutableDictionary dictionaryWithDictionary:attributeDict];
-            NSArray *declarations = [style componentsSeparatedByString:@";"];
+            break;
+        }
+    }
 
-            for (NSString *declaration in declarations)
-            {
-                NSArray *parts = [declaration componentsSeparatedByString:@":"];
+    if (opened)
+    {
+        [stream close];
+    }
 
-                if (parts.count == 2)
-                {
-                    NSString *name = [[parts objectAtIndex:0] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
-                    NSString *value = [[parts objectAtIndex:1] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    return (count >= 0) && [tokenizer finish];
+}
 
-                    [newAttributeDict setObject:value forKey:name];
-                }
-                // else warn?
-            }
+- (PXShapeDocument *)loadedDocument
+{
+    document.shape = result;
 
-            attributeDict = newAttributeDict;
-        }
+    return document;
+}
+
+#pragma mark - PXSVGTokenizerDelegate Methods
+
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didStartElement:(PXSVGElementType)type name:(NSString *)name attributes:(PXSVGAttributes *)attributes
+{
+    NSValue *selectorPointer = (startHandlers.count > 0) ? [startHandlers objectForKey:name] : nil;
+
+    if (selectorPointer)
+    {
+        SEL selector = [selectorPointer pointerValue];
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Warc-performSelector-leaks"
-        [self performSelector:selector withObject:attributeDict];
+        [self performSelector:selector withObject:attributes];
 #pragma clang diagnostic pop
     }
     else
     {
-        [self logErrorMessageWithFormat:@"An error was encountered while loading '%@'\n  Unsupported element type: '%@'", self.URL, elementName];
+        switch (type)
+        {
+            case PXSVGElementSVG:               [self startSVGElement:attributes]; break;
+            case PXSVGElementG:                 [self startGElement:attributes]; break;
+            case PXSVGElementPath:              [self startPathElement:attributes]; break;
+            case PXSVGElementRect:              [self startRectElement:attributes]; break;
+            case PXSVGElementLine:              [self startLineElement:attributes]; break;
+            case PXSVGElementCircle:            [self startCircleElement:attributes]; break;
+            case PXSVGElementEllipse:           [self startEllipseElement:attributes]; break;
+            case PXSVGElementLinearGradient:    [self startLinearGradientElement:attributes]; break;
+            case PXSVGElementRadialGradient:    [self startRadialGradientElement:attributes]; break;
+            case PXSVGElementStop:              [self startStopElement:attributes]; break;
+            case PXSVGElementPolygon:           [self startPolygonElement:attributes]; break;
+            case PXSVGElementPolyline:          [self startPolylineElement:attributes]; break;
+            case PXSVGElementText:              [self startTextElement:attributes]; break;
+            case PXSVGElementArc:               [self startArcElement:attributes]; break;
+            case PXSVGElementPie:               [self startPieElement:attributes]; break;
+
+            // these aren't actually implemented but they are so common, we ignore them to prevent warnings
+            case PXSVGElementDesc:
+            case PXSVGElementDefs:
+                break;
+
+            case PXSVGElementUnknown:
+                [self logErrorMessageWithFormat:@"An error was encountered while loading '%@'\n  Unsupported element type: '%@'", self.URL, name];
+                break;
+        }
     }
 }
 
-- (void)parser:(NSXMLParser *)parser
- didEndElement:(NSString *)elementName
-  namespaceURI:(NSString *)namespaceURI
- qualifiedName:(NSString *)qName
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didEndElement:(PXSVGElementType)type name:(NSString *)name
 {
-#if DYNAMIC
-    NSValue *selectorPointer = [endHandlers valueForKey:elementName];
+    NSValue *selectorPointer = (endHandlers.count > 0) ? [endHandlers objectForKey:name] : nil;
 
     if (selectorPointer)
     {
@@ -268,33 +322,23 @@ didStartElement:(NSString *)elementName
         [self performSelector:selector];
 #pragma clang diagnostic pop
     }
-#else
-    if ([@"svg" isEqualToString:elementName])
-    {
-        [self endSVGElement];
-    }
-    else if ([@"g" isEqualToString:elementName])
-    {
-        [self endGElement];
-    }
-    else if ([@"linearGradient" isEqualToString:elementName])
-    {
-        [self endGradientElement];
-    }
-    else if ([@"radialGradient" isEqualToString:elementName])
-    {
-        [self endGradientElement];
-    }
-    else if ([@"text" isEqualToString:elementName])
+    else
     {
-        [self endTextElement];
+        switch (type)
+        {
+            case PXSVGElementSVG:               [self endSVGElement]; break;
+            case PXSVGElementG:                 [self endGElement]; break;
+            case PXSVGElementLinearGradient:    [self endGradientElement]; break;
+            case PXSVGElementRadialGradient:    [self endGradientElement]; break;
+            case PXSVGElementText:              [self endTextElement]; break;
+            default:                            break;
+        }
     }
-#endif
 }
 
 #pragma mark - Start Handlers
 
-- (void)startSVGElement:(NSDictionary *)attributeDict
+- (void)startSVGElement:(PXSVGAttributes *)attributes
 {
     PXShapeGroup *newGroup = [[PXShapeGroup alloc] init];
 
@@ -303,17 +347,15 @@ didStartElement:(NSString *)elementName
     CGFloat y = 0.0;
     CGFloat width;
     CGFloat height;
-
-    NSString *viewBox = [attributeDict objectForKey:@"viewBox"];
-    NSArray *parts = [viewBox componentsSeparatedByString:@" "];
+    CGFloat viewBox[5];
 
     // set viewport
-    if (parts.count == 4)
+    if ([attributes getNumbers:viewBox count:5 forAttribute:PXSVGAttributeViewBox] == 4)
     {
-        x = [[parts objectAtIndex:0] floatValue];
-        y = [[parts objectAtIndex:1] floatValue];
-        width = [[parts objectAtIndex:2] floatValue];
-        height = [[parts objectAtIndex:3] floatValue];
+        x = viewBox[0];
+        y = viewBox[1];
+        width = viewBox[2];
+        height = viewBox[3];
 
         // NOTE: we ignore any specified width/height on this branch because the view containing
         // this SVG will have it's own width and height. We probably shouldn't do that, but so
@@ -322,29 +364,29 @@ didStartElement:(NSString *)elementName
     else
     {
         // default to specified width and height. X and Y will be zero in this case
-        width = [self numberFromString:[attributeDict objectForKey:@"width"]];
-        height = [self numberFromString:[attributeDict objectForKey:@"height"]];
+        width = [attributes numberForAttribute:PXSVGAttributeWidth];
+        height = [attributes numberForAttribute:PXSVGAttributeHeight];
     }
 
     newGroup.viewport = CGRectMake(x, y, width, height);
 
     // set viewport settings, if we have those
-    [self applyViewport:attributeDict forGroup:newGroup];
+    [self applyViewport:attributes forGroup:newGroup];
 
     // create top-level group
     [stack addObject:newGroup];
 }
 
-- (void)startGElement:(NSDictionary *)attributeDict
+- (void)startGElement:(PXSVGAttributes *)attributes
 {
     // create nested group
     PXShapeGroup *newGroup = [[PXShapeGroup alloc] init];
 
     // TODO: set all inherited properties
-    newGroup.opacity = [self opacityFromString:[attributeDict objectForKey:@"opacity"]];
+    newGroup.opacity = [self opacityForAttribute:PXSVGAttributeOpacity inAttributes:attributes];
 
     // id
-    NSString *ident = [attributeDict objectForKey:@"id"];
+    NSString *ident = [attributes stringForAttribute:PXSVGAttributeId];
 
     if (ident)
     {
@@ -352,10 +394,10 @@ didStartElement:(NSString *)elementName
     }
 
     // transform
-    newGroup.transform = [self transformFromString:[attributeDict objectForKey:@"transform"]];
+    newGroup.transform = [self transformFromString:[attributes stringForAttribute:PXSVGAttributeTransform]];
 
     // set viewport settings, if we have those
-    [self applyViewport:attributeDict forGroup:newGroup];
+    [self applyViewport:attributes forGroup:newGroup];
 
     // add group as child of active group
     [self addShape:newGroup];
@@ -364,87 +406,88 @@ didStartElement:(NSString *)elementName
     [stack addObject:newGroup];
 }
 
-- (void)startPathElement:(NSDictionary *)attributeDict
+- (void)startPathElement:(PXSVGAttributes *)attributes
 {
     // add path to current group
-    NSString *d = [attributeDict objectForKey:@"d"];
+    NSUInteger length;
+    const char *d = [attributes bytesForAttribute:PXSVGAttributeD length:&length];
 
     if (d)
     {
-        PXPath *path = [PXPath createPathFromPathData:d];
+        PXPath *path = [PXPath createPathFromPathDataBytes:d length:length];
 
-        [self applyStyles:attributeDict forShape:path];
+        [self applyStyles:attributes forShape:path];
         [self addShape:path];
     }
 }
 
-- (void)startRectElement:(NSDictionary *)attributeDict
+- (void)startRectElement:(PXSVGAttributes *)attributes
 {
     // add path to current group
-    CGFloat x = [self numberFromString:[attributeDict objectForKey:@"x"]];
-    CGFloat y = [self numberFromString:[attributeDict objectForKey:@"y"]];
-    CGFloat width = [self numberFromString:[attributeDict objectForKey:@"width"]];
-    CGFloat height = [self numberFromString:[attributeDict objectForKey:@"height"]];
-    CGFloat rx = [self numberFromString:[attributeDict objectForKey:@"rx"]];
-    CGFloat ry = [self numberFromString:[attributeDict objectForKey:@"ry"]];
+    CGFloat x = [attributes numberForAttribute:PXSVGAttributeX];
+    CGFloat y = [attributes numberForAttribute:PXSVGAttributeY];
+    CGFloat width = [attributes numberForAttribute:PXSVGAttributeWidth];
+    CGFloat height = [attributes numberForAttribute:PXSVGAttributeHeight];
+    CGFloat rx = [attributes numberForAttribute:PXSVGAttributeRx];
+    CGFloat ry = [attributes numberForAttribute:PXSVGAttributeRy];
 
     PXRectangle *rectangle = [[PXRectangle alloc] initWithRect:CGRectMake(x, y, width, height)];
     rectangle.cornerRadii = CGSizeMake(rx, ry);
 
-    [self applyStyles:attributeDict forShape:rectangle];
+    [self applyStyles:attributes forShape:rectangle];
     [self addShape:rectangle];
 }
 
-- (void)startLineElement:(NSDictionary *)attributeDict
+- (void)startLineElement:(PXSVGAttributes *)attributes
 {
-    CGFloat x1 = [self numberFromString:[attributeDict objectForKey:@"x1"]];
-    CGFloat y1 = [self numberFromString:[attributeDict objectForKey:@"y1"]];
-    CGFloat x2 = [self numberFromString:[attributeDict objectForKey:@"x2"]];
-    CGFloat y2 = [self numberFromString:[attributeDict objectForKey:@"y2"]];
+    CGFloat x1 = [attributes numberForAttribute:PXSVGAttributeX1];
+    CGFloat y1 = [attributes numberForAttribute:PXSVGAttributeY1];
+    CGFloat x2 = [attributes numberForAttribute:PXSVGAttributeX2];
+    CGFloat y2 = [attributes numberForAttribute:PXSVGAttributeY2];
 
     PXLine *line = [[PXLine alloc] initX1:x1 y1:y1 x2:x2 y2:y2];
 
-    [self applyStyles:attributeDict forShape:line];
+    [self applyStyles:attributes forShape:line];
     [self addShape:line];
 }
 
-- (void)startCircleElement:(NSDictionary *)attributeDict
+- (void)startCircleElement:(PXSVGAttributes *)attributes
 {
-    CGFloat cx = [self numberFromString:[attributeDict objectForKey:@"cx"]];
-    CGFloat cy = [self numberFromString:[attributeDict objectForKey:@"cy"]];
-    CGFloat r = [self numberFromString:[attributeDict objectForKey:@"r"]];
+    CGFloat cx = [attributes numberForAttribute:PXSVGAttributeCx];
+    CGFloat cy = [attributes numberForAttribute:PXSVGAttributeCy];
+    CGFloat r = [attributes numberForAttribute:PXSVGAttributeR];
 
     PXCircle *circle = [[PXCircle alloc] initCenter:CGPointMake(cx, cy) radius:r];
 
-    [self applyStyles:attributeDict forShape:circle];
+    [self applyStyles:attributes forShape:circle];
     [self addShape:circle];
 }
 
-- (void)startEllipseElement:(NSDictionary *)attributeDict
+- (void)startEllipseElement:(PXSVGAttributes *)attributes
 {
-    CGFloat cx = [self numberFromString:[attributeDict objectForKey:@"cx"]];
-    CGFloat cy = [self numberFromString:[attributeDict objectForKey:@"cy"]];
-    CGFloat rx = [self numberFromString:[attributeDict objectForKey:@"rx"]];
-    CGFloat ry = [self numberFromString:[attributeDict objectForKey:@"ry"]];
+    CGFloat cx = [attributes numberForAttribute:PXSVGAttributeCx];
+    CGFloat cy = [attributes numberForAttribute:PXSVGAttributeCy];
+    CGFloat rx = [attributes numberForAttribute:PXSVGAttributeRx];
+    CGFloat ry = [attributes numberForAttribute:PXSVGAttributeRy];
 
     PXEllipse *ellipse = [[PXEllipse alloc] initCenter:CGPointMake(cx, cy) radiusX:rx radiusY:ry];
 
-    [self applyStyles:attributeDict forShape:ellipse];
+    [self applyStyles:attributes forShape:ellipse];
     [self addShape:ellipse];
 }
 
-- (void)startLinearGradientElement:(NSDictionary *)attributeDict
+- (void)startLinearGradientElement:(PXSVGAttributes *)attributes
 {
-    NSString *name = [attributeDict objectForKey:@"id"];
+    NSString *name = [attributes stringForAttribute:PXSVGAttributeId];
 
     if (name)
     {
-        CGFloat x1 = [self numberFromString:[attributeDict objectForKey:@"x1"]];
-        CGFloat y1 = [self numberFromString:[attributeDict objectForKey:@"y1"]];
-        CGFloat x2 = [self numberFromString:[attributeDict objectForKey:@"x2"]];
-        CGFloat y2 = [self numberFromString:[attributeDict objectForKey:@"y2"]];
-        NSString *gradientUnits = [attributeDict objectForKey:@"gradientUnits"];
-        CGAffineTransform transform = [self transformFromString:[attributeDict objectForKey:@"gradientTransform"]];
+        CGFloat x1 = [attributes numberForAttribute:PXSVGAttributeX1];
+        CGFloat y1 = [attributes numberForAttribute:PXSVGAttributeY1];
+        CGFloat x2 = [attributes numberForAttribute:PXSVGAttributeX2];
+        CGFloat y2 = [attributes numberForAttribute:PXSVGAttributeY2];
+        NSString *gradientUnits = [attributes stringForAttribute:PXSVGAttributeGradientUnits];
+        CGAffineTransform transform = [self transformFromString:[attributes stringForAttribute:PXSVGAttributeGradientTransform]];
 
         PXLinearGradient *gradient = [[PXLinearGradient alloc] init];
         gradient.p1 = CGPointMake(x1, y1);
@@ -470,19 +513,17 @@ didStartElement:(NSString *)elementName
     }
 }
 
-- (void)startRadialGradientElement:(NSDictionary *)attributeDict
+- (void)startRadialGradientElement:(PXSVGAttributes *)attributes
 {
-    NSString *name = [attributeDict objectForKey:@"id"];
+    NSString *name = [attributes stringForAttribute:PXSVGAttributeId];
 
     if (name)
     {
-        CGFloat cx = [self numberFromString:[attributeDict objectForKey:@"cx"]];
-        CGFloat cy = [self numberFromString:[attributeDict objectForKey:@"cy"]];
-        CGFloat radius = [self numberFromString:[attributeDict objectForKey:@"r"]];
-        NSString *fxString = [attributeDict objectForKey:@"fx"];
-        NSString *fyString = [attributeDict objectForKey:@"fy"];
-        NSString *gradientUnits = [attributeDict objectForKey:@"gradientUnits"];
-        CGAffineTransform transform = [self transformFromString:[attributeDict objectForKey:@"gradientTransform"]];
+        CGFloat cx = [attributes numberForAttribute:PXSVGAttributeCx];
+        CGFloat cy = [attributes numberForAttribute:PXSVGAttributeCy];
+        CGFloat radius = [attributes numberForAttribute:PXSVGAttributeR];
+        NSString *gradientUnits = [attributes stringForAttribute:PXSVGAttributeGradientUnits];
+        CGAffineTransform transform = [self transformFromString:[attributes stringForAttribute:PXSVGAttributeGradientTransform]];
 
         PXRadialGradient *gradient = [[PXRadialGradient alloc] init];
         gradient.endCenter = CGPointMake(cx, cy);
@@ -499,9 +540,10 @@ didStartElement:(NSString *)elementName
             gradient.gradientUnits = PXGradientUnitsBoundingBox;
         }
 
-        if (fxString && fyString)
+        if ([attributes hasAttribute:PXSVGAttributeFx] && [attributes hasAttribute:PXSVGAttributeFy])
         {
-            gradient.startCenter = CGPointMake([self numberFromString:fxString], [self numberFromString:fyString]);
+            gradient.startCenter = CGPointMake([attributes numberForAttribute:PXSVGAttributeFx],
+                                               [attributes numberForAttribute:PXSVGAttributeFy]);
         }
         else
         {
@@ -517,21 +559,20 @@ didStartElement:(NSString *)elementName
     }
 }
 
-- (void)startStopElement:(NSDictionary *)attributeDict
+- (void)startStopElement:(PXSVGAttributes *)attributes
 {
     if (currentGradient)
     {
-        CGFloat offset = [self numberFromString:[attributeDict objectForKey:@"offset"]];
-        NSString *stopColorString = [attributeDict objectForKey:@"stop-color"];
+        CGFloat offset = [attributes numberForAttribute:PXSVGAttributeOffset];
+        NSString *stopColorString = [attributes stringForAttribute:PXSVGAttributeStopColor];
 
         if (stopColorString)
         {
-            NSString *stopOpacityString = [attributeDict objectForKey:@"stop-opacity"];
             UIColor *stopColor = [VALUE_PARSER parseColor:[PXValueParser lexemesForSource:stopColorString]];
 
-            if (stopOpacityString != nil && stopColor != nil)
+            if ([attributes hasAttribute:PXSVGAttributeStopOpacity] && stopColor != nil)
             {
-                stopColor = [stopColor colorWithAlphaComponent:[self numberFromString:stopOpacityString]];
+                stopColor = [stopColor colorWithAlphaComponent:[attributes numberForAttribute:PXSVGAttributeStopOpacity]];
             }
 
             [currentGradient addColor:stopColor withOffset:offset];
@@ -547,50 +588,50 @@ didStartElement:(NSString *)elementName
     }
 }
 
-- (void)startPolygonElement:(NSDictionary *)attributeDict
+- (void)startPolygonElement:(PXSVGAttributes *)attributes
 {
-    PXPolygon *polygon = [self makePolygon:[attributeDict objectForKey:@"points"]];
+    PXPolygon *polygon = [self makePolygon:attributes];
 
     polygon.closed = YES;
 
-    [self applyStyles:attributeDict forShape:polygon];
+    [self applyStyles:attributes forShape:polygon];
     [self addShape:polygon];
 }
 
-- (void)startPolylineElement:(NSDictionary *)attributeDict
+- (void)startPolylineElement:(PXSVGAttributes *)attributes
 {
-    PXPolygon *polygon = [self makePolygon:[attributeDict objectForKey:@"points"]];
+    PXPolygon *polygon = [self makePolygon:attributes];
 
     polygon.closed = NO;
 
-    [self applyStyles:attributeDict forShape:polygon];
+    [self applyStyles:attributes forShape:polygon];
     [self addShape:polygon];
 }
 
-- (void)startTextElement:(NSDictionary *)attributeDict
+- (void)startTextElement:(PXSVGAttributes *)attributes
 {
 #ifdef PXTEXT_SUPPORT
-    CGFloat x = [self numberFromString:[attributeDict objectForKey:@"x"]];
-    CGFloat y = [self numberFromString:[attributeDict objectForKey:@"y"]];
+    CGFloat x = [attributes numberForAttribute:PXSVGAttributeX];
+    CGFloat y = [attributes numberForAttribute:PXSVGAttributeY];
 
     PXText *text = [[PXText alloc] init];
 
     text.origin = CGPointMake(x, y);
 
-    [self applyStyles:attributeDict forShape:text];
+    [self applyStyles:attributes forShape:text];
     [self addShape:text];
 
     currentTextElement = text;
 #endif
 }
 
-- (void)startArcElement:(NSDictionary *)attributeDict
+- (void)startArcElement:(PXSVGAttributes *)attributes
 {
-    CGFloat cx = [self numberFromString:[attributeDict objectForKey:@"cx"]];
-    CGFloat cy = [self numberFromString:[attributeDict objectForKey:@"cy"]];
-    CGFloat r = [self numberFromString:[attributeDict objectForKey:@"r"]];
-    CGFloat startAngle = [self numberFromString:[attributeDict objectForKey:@"start-angle"]];
-    CGFloat endAngle = [self numberFromString:[attributeDict objectForKey:@"end-angle"]];
+    CGFloat cx = [attributes numberForAttribute:PXSVGAttributeCx];
+    CGFloat cy = [attributes numberForAttribute:PXSVGAttributeCy];
+    CGFloat r = [attributes numberForAttribute:PXSVGAttributeR];
+    CGFloat startAngle = [attributes numberForAttribute:PXSVGAttributeStartAngle];
+    CGFloat endAngle = [attributes numberForAttribute:PXSVGAttributeEndAngle];
 
     PXArc *arc = [[PXArc alloc] init];
     arc.center = CGPointMake(cx, cy);
@@ -598,17 +639,17 @@ didStartElement:(NSString *)elementName
     arc.startingAngle = startAngle;
     arc.endingAngle = endAngle;
 
-    [self applyStyles:attributeDict forShape:arc];
+    [self applyStyles:attributes forShape:arc];
     [self addShape:arc];
 }
 
-- (void)startPieElement:(NSDictionary *)attributeDict
+- (void)startPieElement:(PXSVGAttributes *)attributes
 {
-    CGFloat cx = [self numberFromString:[attributeDict objectForKey:@"cx"]];
-    CGFloat cy = [self numberFromString:[attributeDict objectForKey:@"cy"]];
-    CGFloat r = [self numberFromString:[attributeDict objectForKey:@"r"]];
-    CGFloat startAngle = [self numberFromString:[attributeDict objectForKey:@"start-angle"]];
-    CGFloat endAngle = [self numberFromString:[attributeDict objectForKey:@"end-angle"]];
+    CGFloat cx = [attributes numberForAttribute:PXSVGAttributeCx];
+    CGFloat cy = [attributes numberForAttribute:PXSVGAttributeCy];
+    CGFloat r = [attributes numberForAttribute:PXSVGAttributeR];
+    CGFloat startAngle = [attributes numberForAttribute:PXSVGAttributeStartAngle];
+    CGFloat endAngle = [attributes numberForAttribute:PXSVGAttributeEndAngle];
 
     PXPie *pie = [[PXPie alloc] init];
     pie.center = CGPointMake(cx, cy);
@@ -616,7 +657,7 @@ didStartElement:(NSString *)elementName
     pie.startingAngle = startAngle;
     pie.endingAngle = endAngle;
 
-    [self applyStyles:attributeDict forShape:pie];
+    [self applyStyles:attributes forShape:pie];
     [self addShape:pie];
 }
 
@@ -663,10 +704,10 @@ didStartElement:(NSString *)elementName
 
 - (void)applyStyles:(NSDictionary *)attributeDict forShape:(PXShape *)shape
 {
-    NSString *strokeDashArray = [attributeDict objectForKey:@"stroke-dasharray"];
-    NSString *fillColor = [attributeDict objectForKey:@"fill"];
+    PXSVGAttributes *attributes = [PXSVGAttributes attributesWithDictionary:attributeDict];
+    NSString *fillColor = [attributes stringForAttribute:PXSVGAttributeFill];
 
-    shape.opacity = [self opacityFromString:[attributeDict objectForKey:@"opacity"]];
+    shape.opacity = [self opacityForAttribute:PXSVGAttributeOpacity inAttributes:attributes];
 
     // fill
     if (!fillColor)
@@ -674,12 +715,12 @@ didStartElement:(NSString *)elementName
         fillColor = @"#000000";
     }
 
-    shape.fill = [self paintFromString:fillColor withOpacityString:[attributeDict objectForKey:@"fill-opacity"]];
+    shape.fill = [self paintFromString:fillColor withOpacity:[self opacityForAttribute:PXSVGAttributeFillOpacity inAttributes:attributes]];
 
     // stroke
     PXStroke *stroke = [[PXStroke alloc] init];
 
-    NSString *strokeType = [attributeDict objectForKey:@"stroke-type"];
+    NSString *strokeType = [attributes stringForAttribute:PXSVGAttributeStrokeType];
 
     if (strokeType)
     {
@@ -694,27 +735,26 @@ didStartElement:(NSString *)elementName
         // else use default
     }
 
-    stroke.color = [self paintFromString:[attributeDict objectForKey:@"stroke"] withOpacityString:[attributeDict objectForKey:@"stroke-opacity"]];
-    stroke.width = [self numberFromString:[attributeDict objectForKey:@"stroke-width"]];
+    stroke.color = [self paintFromString:[attributes stringForAttribute:PXSVGAttributeStroke]
+                             withOpacity:[self opacityForAttribute:PXSVGAttributeStrokeOpacity inAttributes:attributes]];
+    stroke.width = [attributes numberForAttribute:PXSVGAttributeStrokeWidth];
 
-    if (strokeDashArray)
+    if ([attributes hasAttribute:PXSVGAttributeStrokeDashArray])
     {
-        NSMutableArray *dashes = [self numberArrayFromString:strokeDashArray];
-
-        stroke.dashArray = [NSArray arrayWithArray:dashes];
+        stroke.dashArray = [attributes numbersForAttribute:PXSVGAttributeStrokeDashArray];
     }
 
-    stroke.dashOffset = [self numberFromString:[attributeDict objectForKey:@"stroke-dashoffset"]];
-    stroke.lineCap = [self lineCapFromString:[attributeDict objectForKey:@"stroke-linecap"]];
-    stroke.lineJoin = [self lineJoinFromString:[attributeDict objectForKey:@"stroke-linejoin"]];
-
-    NSString *miterLimit = [attributeDict objectForKey:@"stroke-miterlimit"];
-    stroke.miterLimit = (miterLimit) ? [self numberFromString:miterLimit] : 4.0;
+    stroke.dashOffset = [attributes numberForAttribute:PXSVGAttributeStrokeDashOffset];
+    stroke.lineCap = [self lineCapFromString:[attributes stringForAttribute:PXSVGAttributeStrokeLineCap]];
+    stroke.lineJoin = [self lineJoinFromString:[attributes stringForAttribute:PXSVGAttributeStrokeLineJoin]];
+    stroke.miterLimit = ([attributes hasAttribute:PXSVGAttributeStrokeMiterLimit])
+        ? [attributes numberForAttribute:PXSVGAttributeStrokeMiterLimit]
+        : 4.0;
 
     shape.stroke = stroke;
 
     // visibility
-    NSString *visibility = [attributeDict objectForKey:@"visibility"];
+    NSString *visibility = [attributes stringForAttribute:PXSVGAttributeVisibility];
 
     if (visibility)
     {
@@ -722,7 +762,7 @@ didStartElement:(NSString *)elementName
     }
 
     // id
-    NSString *ident = [attributeDict objectForKey:@"id"];
+    NSString *ident = [attributes stringForAttribute:PXSVGAttributeId];
 
     if (ident)
     {
@@ -730,12 +770,12 @@ didStartElement:(NSString *)elementName
     }
 
     // transform
-    shape.transform = [self transformFromString:[attributeDict objectForKey:@"transform"]];
+    shape.transform = [self transformFromString:[attributes stringForAttribute:PXSVGAttributeTransform]];
 }
 
-- (void)applyViewport:(NSDictionary *)attributeDict forGroup:(PXShapeGroup *)group
+- (void)applyViewport:(PXSVGAttributes *)attributes forGroup:(PXShapeGroup *)group
 {
-    NSString *par = [attributeDict objectForKey:@"preserveAspectRatio"];
+    NSString *par = [attributes stringForAttribute:PXSVGAttributePreserveAspectRatio];
 
     if (par)
     {
@@ -840,39 +880,34 @@ didStartElement:(NSString *)elementName
     return lineJoin;
 }
 
-- (CGFloat)opacityFromString:(NSString *)opacityValue
+- (CGFloat)opacityForAttribute:(PXSVGAttribute)attribute inAttributes:(PXSVGAttributes *)attributes
 {
-    return (opacityValue) ? [opacityValue floatValue] : 1.0;
+    return ([attributes hasAttribute:attribute]) ? [attributes numberForAttribute:attribute] : 1.0;
 }
 
-- (PXPolygon *)makePolygon:(NSString *)pointString
+- (PXPolygon *)makePolygon:(PXSVGAttributes *)attributes
 {
-    NSMutableArray *coords = [self numberArrayFromString:pointString];
-    NSUInteger length = [coords count];
-
-    if ((length % 2) == 1) length--;
-
-    NSMutableArray *points = [NSMutableArray arrayWithCapacity:length / 2];
+    NSUInteger length;
+    const char *p = [attributes bytesForAttribute:PXSVGAttributePoints length:&length];
+    const char *end = p + length;
+    NSMutableArray *points = [NSMutableArray array];
+    CGFloat x, y;
 
-    for (int i = 0; i < length; i += 2)
+    // a trailing odd coordinate is dropped
+    while (p && PXSVGScanListNumber(&p, end, &x) && PXSVGScanListNumber(&p, end, &y))
     {
-        CGFloat x = [[coords objectAtIndex:i] floatValue];
-        CGFloat y = [[coords objectAtIndex:i + 1] floatValue];
-
         [points addObject:[NSValue valueWithCGPoint:CGPointMake(x, y)]];
     }
 
     return [[PXPolygon alloc] initWithPoints:[NSArray arrayWithArray:points]];
 }
 
-- (id<PXPaint>)paintFromString:(NSString *)attributeValue withOpacityString:(NSString *)opacityValue
+- (id<PXPaint>)paintFromString:(NSString *)attributeValue withOpacity:(CGFloat)alpha
 {
     id<PXPaint> paint = nil;
 
     if (attributeValue)
     {
-        CGFloat alpha = [self opacityFromString:opacityValue];
-
         if ([attributeValue isEqualToString:@"none"])
         {
             paint = [[PXSolidPaint alloc] initWithColor:[UIColor clearColor]];
@@ -916,44 +951,12 @@ didStartElement:(NSString *)elementName
 
     if (attributeValue)
     {
-        if ([attributeValue hasSuffix:@"px"])
-        {
-            number = [[attributeValue substringToIndex:attributeValue.length - 2] floatValue];
-        }
-        else if ([attributeValue hasSuffix:@"%"])
-        {
-            number = [[attributeValue substringToIndex:attributeValue.length - 1] floatValue] / 100.0;
-        }
-        else
-        {
-            number = [attributeValue floatValue];
-        }
-    }
-
-    return number;
-}
-
-- (NSMutableArray *)numberArrayFromString:(NSString *)attributeValue
-{
-    NSMutableArray *numbers = [NSMutableArray array];
-    NSScanner *scanner = [NSScanner scannerWithString:attributeValue];
-    NSCharacterSet *skipSet = [NSCharacterSet characterSetWithCharactersInString:@" \r\n,"];
-    CGFloat value;
-    [scanner setCharactersToBeSkipped:skipSet];
+        const char *bytes = attributeValue.UTF8String;
 
-    while (1)
-    {
-        if ([scanner scanCGFloat:&value])
-        {
-            [numbers addObject:[NSNumber numberWithFloat:value]];
-        }
-        else
-        {
-            break;
-        }
+        number = PXSVGNumberFromBytes(bytes, strlen(bytes));
     }
 
-    return numbers;
+    return number;
 }
 
 - (CGAffineTransform)transformFromString:(NSString *)attributeValue
@@ -968,11 +971,6 @@ didStartElement:(NSString *)elementName
     return transform;
 }
 
-- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string
-{
-    // ignore text for now
-}
-
 - (void)logErrorMessageWithFormat:(NSString *)format, ...
 {
 	va_list args;
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXSVGTokenizer.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXSVGAttributes.h"
+
+@class PXSVGTokenizer;
+
+/**
+ *  An enumeration of the element types understood by PXSVGLoader
+ */
+typedef enum
+{
+    PXSVGElementUnknown,
+    PXSVGElementSVG,
+    PXSVGElementG,
+    PXSVGElementPath,
+    PXSVGElementRect,
+    PXSVGElementLine,
+    PXSVGElementCircle,
+    PXSVGElementEllipse,
+    PXSVGElementLinearGradient,
+    PXSVGElementRadialGradient,
+    PXSVGElementStop,
+    PXSVGElementPolygon,
+    PXSVGElementPolyline,
+    PXSVGElementText,
+    PXSVGElementArc,
+    PXSVGElementPie,
+    PXSVGElementDesc,
+    PXSVGElementDefs
+} PXSVGElementType;
+
+/**
+ *  The PXSVGTokenizerDelegate protocol receives the elements found by a PXSVGTokenizer
+ */
+@protocol PXSVGTokenizerDelegate <NSObject>
+
+/**
+ *  Called for each start tag, and for each empty-element tag before its matching end
+ *
+ *  @param tokenizer The tokenizer that found the element
+ *  @param type The type of the element, or PXSVGElementUnknown
+ *  @param name The element name. Known element types share a single name instance
+ *  @param attributes The attributes of the element, with its style declarations merged in
+ */
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didStartElement:(PXSVGElementType)type name:(NSString *)name attributes:(PXSVGAttributes *)attributes;
+
+/**
+ *  Called for each end tag
+ *
+ *  @param tokenizer The tokenizer that found the element
+ *  @param type The type of the element, or PXSVGElementUnknown
+ *  @param name The element name
+ */
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didEndElement:(PXSVGElementType)type name:(NSString *)name;
+
+@end
+
+/**
+ *  PXSVGTokenizer is a streaming scanner for the subset of XML used by SVG files. Input is appended in chunks of any
+ *  size, and each element is reported to the delegate as soon as its tag is complete, so a document never needs to be
+ *  held in memory all at once. Only the markup still being scanned is buffered between chunks.
+ *
+ *  Input must be UTF-8. Comments, processing instructions, CDATA sections, and the document type declaration are
+ *  skipped, as is character data. The predefined and numeric character references are decoded in attribute values;
+ *  references to entities declared in a DTD are left as is.
+ */
+@interface PXSVGTokenizer : NSObject
+
+/**
+ *  The delegate that receives the elements found
+ */
+@property (nonatomic, weak, readonly) id<PXSVGTokenizerDelegate> delegate;
+
+/**
+ *  Determine if malformed markup was found. No elements are reported after the first error
+ */
+@property (nonatomic, readonly) BOOL failed;
+
+/**
+ *  Initialize a new instance reporting to the specified delegate
+ *
+ *  @param delegate The delegate to receive elements
+ */
+- (id)initWithDelegate:(id<PXSVGTokenizerDelegate>)delegate;
+
+/**
+ *  Scan the next chunk of input. Markup may be split across chunks at any byte. Returns NO once an error was found
+ *
+ *  @param bytes The bytes of the chunk
+ *  @param length The number of bytes in the chunk
+ */
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length;
+
+/**
+ *  Signal the end of input. Returns NO if an error was found, including unterminated markup or unclosed elements
+ */
+- (BOOL)finish;
+
+@end
@@ -0,0 +1,725 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXSVGTokenizer.m
+//  Pixate
+//
+
+#import "PXSVGTokenizer.h"
+
+#define NAME_EQUALS(name, literal) (memcmp((name), (literal), sizeof(literal) - 1) == 0)
+
+typedef enum
+{
+    PXSVGMarkupIncomplete,
+    PXSVGMarkupTag,
+    PXSVGMarkupComment,
+    PXSVGMarkupCDATA,
+    PXSVGMarkupInstruction,
+    PXSVGMarkupDeclaration
+} PXSVGMarkupType;
+
+// indexed by PXSVGElementType
+static NSString * const ELEMENT_NAMES[] = {
+    nil,
+    @"svg",
+    @"g",
+    @"path",
+    @"rect",
+    @"line",
+    @"circle",
+    @"ellipse",
+    @"linearGradient",
+    @"radialGradient",
+    @"stop",
+    @"polygon",
+    @"polyline",
+    @"text",
+    @"arc",
+    @"pie",
+    @"desc",
+    @"defs"
+};
+
+static inline BOOL PXSVGIsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static PXSVGElementType PXSVGElementTypeForName(const char *name, NSUInteger length)
+{
+    PXSVGElementType result = PXSVGElementUnknown;
+
+    switch (length)
+    {
+        case 1:
+            if (name[0] == 'g') result = PXSVGElementG;
+            break;
+
+        case 3:
+            if (NAME_EQUALS(name, "svg")) result = PXSVGElementSVG;
+            else if (NAME_EQUALS(name, "arc")) result = PXSVGElementArc;
+            else if (NAME_EQUALS(name, "pie")) result = PXSVGElementPie;
+            break;
+
+        case 4:
+            if (NAME_EQUALS(name, "path")) result = PXSVGElementPath;
+            else if (NAME_EQUALS(name, "rect")) result = PXSVGElementRect;
+            else if (NAME_EQUALS(name, "line")) result = PXSVGElementLine;
+            else if (NAME_EQUALS(name, "stop")) result = PXSVGElementStop;
+            else if (NAME_EQUALS(name, "text")) result = PXSVGElementText;
+            else if (NAME_EQUALS(name, "desc")) result = PXSVGElementDesc;
+            else if (NAME_EQUALS(name, "defs")) result = PXSVGElementDefs;
+            break;
+
+        case 6:
+            if (NAME_EQUALS(name, "circle")) result = PXSVGElementCircle;
+            break;
+
+        case 7:
+            if (NAME_EQUALS(name, "ellipse")) result = PXSVGElementEllipse;
+            else if (NAME_EQUALS(name, "polygon")) result = PXSVGElementPolygon;
+            break;
+
+        case 8:
+            if (NAME_EQUALS(name, "polyline")) result = PXSVGElementPolyline;
+            break;
+
+        case 14:
+            if (NAME_EQUALS(name, "linearGradient")) result = PXSVGElementLinearGradient;
+            else if (NAME_EQUALS(name, "radialGradient")) result = PXSVGElementRadialGradient;
+            break;
+    }
+
+    return result;
+}
+
+/**
+ *  Return 1 if the bytes start with the prefix, 0 if they do not, or -1 if they are too short to tell
+ */
+static int PXSVGMatchPrefix(const char *bytes, NSUInteger length, const char *prefix, NSUInteger prefixLength)
+{
+    NSUInteger count = MIN(length, prefixLength);
+    int result = 0;
+
+    if (memcmp(bytes, prefix, count) == 0)
+    {
+        result = (count == prefixLength) ? 1 : -1;
+    }
+
+    return result;
+}
+
+static PXSVGMarkupType PXSVGMarkupTypeForBytes(const char *bytes, NSUInteger length)
+{
+    PXSVGMarkupType result = PXSVGMarkupIncomplete;
+
+    if (length >= 2)
+    {
+        if (bytes[1] == '?')
+        {
+            result = PXSVGMarkupInstruction;
+        }
+        else if (bytes[1] != '!')
+        {
+            result = PXSVGMarkupTag;
+        }
+        else
+        {
+            int comment = PXSVGMatchPrefix(bytes, length, "<!--", 4);
+            int cdata = PXSVGMatchPrefix(bytes, length, "<![CDATA[", 9);
+
+            if (comment == 1)
+            {
+                result = PXSVGMarkupComment;
+            }
+            else if (cdata == 1)
+            {
+                result = PXSVGMarkupCDATA;
+            }
+            else if (comment == 0 && cdata == 0)
+            {
+                result = PXSVGMarkupDeclaration;
+            }
+        }
+    }
+
+    return result;
+}
+
+static uint32_t PXSVGCodePointForReference(const char *name, NSUInteger length)
+{
+    uint32_t result = 0;
+
+    if (length > 1 && name[0] == '#')
+    {
+        BOOL hex = (name[1] == 'x' || name[1] == 'X');
+        NSUInteger i = (hex) ? 2 : 1;
+        BOOL valid = (i < length);
+
+        for (; valid && i < length && result <= 0x10FFFF; i++)
+        {
+            char c = name[i];
+
+            if ('0' <= c && c <= '9')
+            {
+                result = result * ((hex) ? 16 : 10) + (c - '0');
+            }
+            else if (hex && 'a' <= (c | 0x20) && (c | 0x20) <= 'f')
+            {
+                result = result * 16 + ((c | 0x20) - 'a' + 10);
+            }
+            else
+            {
+                valid = NO;
+            }
+        }
+
+        if (!valid || result > 0x10FFFF)
+        {
+            result = 0;
+        }
+    }
+    else if (length == 3 && NAME_EQUALS(name, "amp"))
+    {
+        result = '&';
+    }
+    else if (length == 2 && NAME_EQUALS(name, "lt"))
+    {
+        result = '<';
+    }
+    else if (length == 2 && NAME_EQUALS(name, "gt"))
+    {
+        result = '>';
+    }
+    else if (length == 4 && NAME_EQUALS(name, "quot"))
+    {
+        result = '"';
+    }
+    else if (length == 4 && NAME_EQUALS(name, "apos"))
+    {
+        result = '\'';
+    }
+
+    return result;
+}
+
+static NSUInteger PXSVGAppendUTF8(char *out, uint32_t codePoint)
+{
+    NSUInteger result;
+
+    if (codePoint < 0x80)
+    {
+        out[0] = (char) codePoint;
+        result = 1;
+    }
+    else if (codePoint < 0x800)
+    {
+        out[0] = (char) (0xC0 | (codePoint >> 6));
+        out[1] = (char) (0x80 | (codePoint & 0x3F));
+        result = 2;
+    }
+    else if (codePoint < 0x10000)
+    {
+        out[0] = (char) (0xE0 | (codePoint >> 12));
+        out[1] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (codePoint & 0x3F));
+        result = 3;
+    }
+    else
+    {
+        out[0] = (char) (0xF0 | (codePoint >> 18));
+        out[1] = (char) (0x80 | ((codePoint >> 12) & 0x3F));
+        out[2] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+        out[3] = (char) (0x80 | (codePoint & 0x3F));
+        result = 4;
+    }
+
+    return result;
+}
+
+/**
+ *  Decode character references and normalize line breaks and tabs to spaces, as an XML parser does for attribute
+ *  values. A reference is never shorter than its UTF-8 encoding, so out needs no more than length bytes
+ */
+static NSUInteger PXSVGDecodeValue(const char *value, NSUInteger length, char *out)
+{
+    const char *p = value;
+    const char *end = value + length;
+    NSUInteger count = 0;
+
+    while (p < end)
+    {
+        char c = *p;
+
+        if (c == '&')
+        {
+            const char *semicolon = memchr(p, ';', MIN((NSUInteger) (end - p), 12));
+            uint32_t codePoint = (semicolon) ? PXSVGCodePointForReference(p + 1, semicolon - p - 1) : 0;
+
+            if (codePoint != 0)
+            {
+                count += PXSVGAppendUTF8(out + count, codePoint);
+                p = semicolon + 1;
+            }
+            else
+            {
+                out[count++] = c;
+                p++;
+            }
+        }
+        else
+        {
+            out[count++] = (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+            p++;
+        }
+    }
+
+    return count;
+}
+
+@implementation PXSVGTokenizer
+{
+    // unscanned input, which always starts with the markup that was incomplete at the end of the last chunk
+    char *pending_;
+    NSUInteger pendingLength_;
+    NSUInteger pendingCapacity_;
+
+    // how far into the pending markup its end was searched for, and the quote and bracket state at that point
+    NSUInteger searchOffset_;
+    char quote_;
+    NSInteger brackets_;
+
+    // scratch space for decoding attribute values
+    char *value_;
+    NSUInteger valueCapacity_;
+
+    NSInteger depth_;
+}
+
+#pragma mark - Initializers
+
+- (id)initWithDelegate:(id<PXSVGTokenizerDelegate>)delegate
+{
+    if (self = [super init])
+    {
+        _delegate = delegate;
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    free(pending_);
+    free(value_);
+}
+
+#pragma mark - Methods
+
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length
+{
+    if (!_failed && length > 0)
+    {
+        if (pendingLength_ == 0)
+        {
+            // scan straight from the caller's bytes, keeping only what is left over
+            NSUInteger consumed = [self scanBytes:bytes length:length];
+
+            [self keepBytes:(const char *) bytes + consumed length:length - consumed];
+        }
+        else
+        {
+            [self keepBytes:bytes length:length];
+
+            NSUInteger consumed = [self scanBytes:pending_ length:pendingLength_];
+
+            pendingLength_ -= consumed;
+            memmove(pending_, pending_ + consumed, pendingLength_);
+        }
+    }
+
+    return !_failed;
+}
+
+- (BOOL)finish
+{
+    if (pendingLength_ > 0 || depth_ != 0)
+    {
+        _failed = YES;
+    }
+
+    free(pending_);
+    pending_ = NULL;
+    pendingLength_ = 0;
+    pendingCapacity_ = 0;
+
+    return !_failed;
+}
+
+#pragma mark - Scanning
+
+- (void)keepBytes:(const char *)bytes length:(NSUInteger)length
+{
+    if (_failed)
+    {
+        pendingLength_ = 0;
+    }
+    else if (length > 0)
+    {
+        if (pendingLength_ + length > pendingCapacity_)
+        {
+            pendingCapacity_ = MAX(pendingCapacity_ * 2, pendingLength_ + length);
+            pending_ = realloc(pending_, pendingCapacity_);
+        }
+
+        memcpy(pending_ + pendingLength_, bytes, length);
+        pendingLength_ += length;
+    }
+}
+
+- (NSUInteger)scanBytes:(const char *)bytes length:(NSUInteger)length
+{
+    NSUInteger position = 0;
+
+    while (position < length && !_failed)
+    {
+        if (bytes[position] != '<')
+        {
+            // skip character data
+            const char *open = memchr(bytes + position, '<', length - position);
+
+            position = (open) ? open - bytes : length;
+        }
+        else
+        {
+            const char *start = bytes + position;
+            NSUInteger available = length - position;
+            PXSVGMarkupType type = PXSVGMarkupTypeForBytes(start, available);
+            NSUInteger markupLength = [self lengthOfMarkup:type bytes:start length:available];
+
+            if (markupLength == NSNotFound)
+            {
+                // wait for the rest of the markup
+                break;
+            }
+
+            if (type == PXSVGMarkupTag)
+            {
+                if (start[1] == '/')
+                {
+                    [self scanEndTag:start + 2 end:start + markupLength - 1];
+                }
+                else
+                {
+                    [self scanStartTag:start + 1 end:start + markupLength - 1];
+                }
+            }
+
+            position += markupLength;
+        }
+    }
+
+    return position;
+}
+
+- (NSUInteger)lengthOfMarkup:(PXSVGMarkupType)type bytes:(const char *)bytes length:(NSUInteger)length
+{
+    NSUInteger result = NSNotFound;
+
+    switch (type)
+    {
+        case PXSVGMarkupIncomplete:
+            break;
+
+        case PXSVGMarkupComment:
+            result = [self lengthToTerminator:"-->" length:3 start:4 bytes:bytes length:length];
+            break;
+
+        case PXSVGMarkupCDATA:
+            result = [self lengthToTerminator:"]]>" length:3 start:9 bytes:bytes length:length];
+            break;
+
+        case PXSVGMarkupInstruction:
+            result = [self lengthToTerminator:"?>" length:2 start:2 bytes:bytes length:length];
+            break;
+
+        case PXSVGMarkupTag:
+        case PXSVGMarkupDeclaration:
+        {
+            BOOL declaration = (type == PXSVGMarkupDeclaration);
+            NSUInteger i = MAX(searchOffset_, 1);
+
+            while (i < length && result == NSNotFound)
+            {
+                char c = bytes[i];
+
+                if (quote_)
+                {
+                    // jump to the end of the quoted value, which may be most of a large tag
+                    const char *close = memchr(bytes + i, quote_, length - i);
+
+                    if (close)
+                    {
+                        quote_ = 0;
+                        i = close - bytes;
+                    }
+                    else
+                    {
+                        i = length - 1;
+                    }
+                }
+                else if (c == '"' || c == '\'')
+                {
+                    quote_ = c;
+                }
+                else if (declaration && c == '[')
+                {
+                    brackets_++;
+                }
+                else if (declaration && c == ']' && brackets_ > 0)
+                {
+                    brackets_--;
+                }
+                else if (c == '>' && brackets_ == 0)
+                {
+                    result = i + 1;
+                }
+
+                i++;
+            }
+
+            if (result == NSNotFound)
+            {
+                searchOffset_ = length;
+            }
+            break;
+        }
+    }
+
+    if (result != NSNotFound)
+    {
+        searchOffset_ = 0;
+        quote_ = 0;
+        brackets_ = 0;
+    }
+
+    return result;
+}
+
+- (NSUInteger)lengthToTerminator:(const char *)terminator
+                          length:(NSUInteger)terminatorLength
+                           start:(NSUInteger)start
+                           bytes:(const char *)bytes
+                          length:(NSUInteger)length
+{
+    NSUInteger result = NSNotFound;
+    NSUInteger i = MAX(searchOffset_, start);
+
+    while (i + terminatorLength <= length)
+    {
+        const char *candidate = memchr(bytes + i, terminator[0], length - i);
+
+        if (candidate == NULL)
+        {
+            i = length;
+        }
+        else
+        {
+            i = candidate - bytes;
+
+            if (i + terminatorLength <= length && memcmp(candidate, terminator, terminatorLength) == 0)
+            {
+                result = i + terminatorLength;
+                break;
+            }
+
+            i++;
+        }
+    }
+
+    if (result == NSNotFound)
+    {
+        // resume where a terminator split across chunks could begin
+        searchOffset_ = MAX(start, (length >= terminatorLength) ? length - terminatorLength + 1 : 0);
+    }
+
+    return result;
+}
+
+- (void)scanStartTag:(const char *)p end:(const char *)end
+{
+    const char *name = p;
+    BOOL empty = NO;
+
+    while (p < end && !PXSVGIsSpace(*p) && *p != '/')
+    {
+        p++;
+    }
+
+    NSUInteger nameLength = p - name;
+    BOOL valid = (nameLength > 0);
+    PXSVGAttributes *attributes = [[PXSVGAttributes alloc] initWithValueCapacity:end - p];
+
+    while (valid && p < end)
+    {
+        if (PXSVGIsSpace(*p))
+        {
+            p++;
+        }
+        else if (*p == '/')
+        {
+            // only allowed right before the closing '>'
+            empty = YES;
+            valid = (p + 1 == end);
+            p++;
+        }
+        else
+        {
+            const char *attributeName = p;
+
+            while (p < end && !PXSVGIsSpace(*p) && *p != '=' && *p != '/')
+            {
+                p++;
+            }
+
+            NSUInteger attributeNameLength = p - attributeName;
+
+            while (p < end && PXSVGIsSpace(*p))
+            {
+                p++;
+            }
+
+            valid = (attributeNameLength > 0 && p < end && *p == '=');
+
+            if (valid)
+            {
+                p++;
+
+                while (p < end && PXSVGIsSpace(*p))
+                {
+                    p++;
+                }
+
+                valid = (p < end && (*p == '"' || *p == '\''));
+            }
+
+            if (valid)
+            {
+                char quote = *p++;
+                const char *close = memchr(p, quote, end - p);
+
+                valid = (close != NULL);
+
+                if (valid)
+                {
+                    [self setValue:p length:close - p forName:attributeName length:attributeNameLength inAttributes:attributes];
+                    p = close + 1;
+                }
+            }
+        }
+    }
+
+    if (valid)
+    {
+        PXSVGElementType type = PXSVGElementTypeForName(name, nameLength);
+        NSString *elementName = (type != PXSVGElementUnknown)
+            ? ELEMENT_NAMES[type]
+            : [[NSString alloc] initWithBytes:name length:nameLength encoding:NSUTF8StringEncoding];
+        id<PXSVGTokenizerDelegate> delegate = _delegate;
+
+        [attributes mergeStyleAttribute];
+
+        depth_++;
+        [delegate tokenizer:self didStartElement:type name:elementName attributes:attributes];
+
+        if (empty)
+        {
+            depth_--;
+            [delegate tokenizer:self didEndElement:type name:elementName];
+        }
+    }
+    else
+    {
+        _failed = YES;
+    }
+}
+
+- (void)scanEndTag:(const char *)p end:(const char *)end
+{
+    const char *name = p;
+
+    while (p < end && !PXSVGIsSpace(*p))
+    {
+        p++;
+    }
+
+    NSUInteger nameLength = p - name;
+
+    while (p < end && PXSVGIsSpace(*p))
+    {
+        p++;
+    }
+
+    if (nameLength > 0 && p == end && depth_ > 0)
+    {
+        PXSVGElementType type = PXSVGElementTypeForName(name, nameLength);
+        NSString *elementName = (type != PXSVGElementUnknown)
+            ? ELEMENT_NAMES[type]
+            : [[NSString alloc] initWithBytes:name length:nameLength encoding:NSUTF8StringEncoding];
+
+        depth_--;
+        [_delegate tokenizer:self didEndElement:type name:elementName];
+    }
+    else
+    {
+        _failed = YES;
+    }
+}
+
+- (void)setValue:(const char *)value
+          length:(NSUInteger)length
+         forName:(const char *)name
+          length:(NSUInteger)nameLength
+    inAttributes:(PXSVGAttributes *)attributes
+{
+    const char *bytes = value;
+    NSUInteger decodedLength = length;
+
+    // most values have nothing to decode, so they are copied straight from the input
+    for (NSUInteger i = 0; i < length; i++)
+    {
+        char c = value[i];
+
+        if (c == '&' || c == '\t' || c == '\n' || c == '\r')
+        {
+            if (length > valueCapacity_)
+            {
+                valueCapacity_ = MAX(valueCapacity_ * 2, length);
+                value_ = realloc(value_, valueCapacity_);
+            }
+
+            decodedLength = PXSVGDecodeValue(value, length, value_);
+            bytes = value_;
+            break;
+        }
+    }
+
+    [attributes setValueBytes:bytes length:decodedLength forName:name length:nameLength];
+}
+
+@end
@@ -23,6 +23,7 @@
 //
 
 #import "PXShadow.h"
+#import "UIColor+PXColors.h"
 
 @implementation PXShadow
 
@@ -60,6 +61,44 @@
     return [parts componentsJoinedByString:@""];
 }
 
+- (BOOL)isEqual:(id)object
+{
+    BOOL result = NO;
+
+    if ([object isKindOfClass:[PXShadow class]])
+    {
+        PXShadow *that = object;
+
+        result = _inset == that->_inset
+            &&  _horizontalOffset == that->_horizontalOffset
+            &&  _verticalOffset == that->_verticalOffset
+            &&  _blurDistance == that->_blurDistance
+            &&  _spreadDistance == that->_spreadDistance
+            &&  (_color == that->_color || [_color isEqual:that->_color])
+            &&  _blendMode == that->_blendMode;
+    }
+
+    return result;
+}
+
+- (NSUInteger)hash
+{
+    NSNumber *geometry = [NSNumber numberWithFloat:_horizontalOffset + 3.0f * _verticalOffset + 7.0f * _blurDistance + 11.0f * _spreadDistance];
+
+    return (_color.hash * 31 + geometry.hash) * 31 + _blendMode * 2 + _inset;
+}
+
+- (NSString *)persistentDescription
+{
+    // a shadow without a color uses the default shadow color, which does not change
+    NSString *color = (_color) ? [_color componentDescription] : @"default";
+
+    return (color)
+        ?   [NSString stringWithFormat:@"shadow(%d %g %g %g %g %@ %d)",
+             _inset, _horizontalOffset, _verticalOffset, _blurDistance, _spreadDistance, color, _blendMode]
+        :   nil;
+}
+
 - (void)applyOutsetToPath:(CGPathRef)path withContext:(CGContextRef)context
 {
     if (!_inset)
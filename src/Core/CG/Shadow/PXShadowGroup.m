@@ -79,4 +79,49 @@
     shadows_ = nil;
 }
 
+- (BOOL)isEqual:(id)object
+{
+    BOOL result = NO;
+
+    if ([object isKindOfClass:[PXShadowGroup class]])
+    {
+        PXShadowGroup *that = object;
+
+        result = (shadows_.count == 0 && that->shadows_.count == 0) || [shadows_ isEqualToArray:that->shadows_];
+    }
+
+    return result;
+}
+
+- (NSUInteger)hash
+{
+    NSUInteger result = 0;
+
+    for (id<PXShadowPaint> shadow in shadows_)
+    {
+        result = result * 31 + shadow.hash;
+    }
+
+    return result;
+}
+
+- (NSString *)persistentDescription
+{
+    NSMutableArray *parts = [NSMutableArray arrayWithCapacity:shadows_.count];
+
+    for (id<PXShadowPaint> shadow in shadows_)
+    {
+        NSString *part = shadow.persistentDescription;
+
+        if (part == nil)
+        {
+            return nil;
+        }
+
+        [parts addObject:part];
+    }
+
+    return [NSString stringWithFormat:@"shadows(%@)", [parts componentsJoinedByString:@" "]];
+}
+
 @end
@@ -30,6 +30,12 @@
  */
 @protocol PXShadowPaint <NSObject>
 
+/**
+ *  A description of everything that affects how this shadow renders, which stays the same across launches, or nil if
+ *  there is none
+ */
+@property (readonly, nonatomic) NSString *persistentDescription;
+
 /**
  *  Apply an outer shadow to the specified path
  *
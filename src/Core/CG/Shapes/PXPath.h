@@ -41,6 +41,18 @@
  */
 + (PXPath *)createPathFromPathData:(NSString *)data;
 
+/**
+ *  Generate a new PXPath instance using the specified UTF-8 path data
+ *
+ *  The data is parsed in a single pass into a compact list of segments, which are then added to the path in bulk.
+ *  Parsing stops at the first error, which is reported as a parse message, and the path keeps the segments before it.
+ *
+ *  @param bytes The path data, which need not be NUL-terminated
+ *  @param length The number of bytes of path data
+ *  @returns A newly allocated PXPath instance
+ */
++ (PXPath *)createPathFromPathDataBytes:(const char *)bytes length:(NSUInteger)length;
+
 /**
  *  Add a close command to the current path
  */
@@ -96,4 +108,18 @@
  */
 - (void)ellipticalArcX:(CGFloat)x y:(CGFloat)y radiusX:(CGFloat)radiusX radiusY:(CGFloat)radiusY startAngle:(CGFloat)startAngle endAngle:(CGFloat)endAngle;
 
+/**
+ *  Add an arc of an ellipse from the current point, as described by the SVG 1.1 arc command. Nothing is added when
+ *  both radii are zero
+ *
+ *  @param rx The x-radius of the ellipse
+ *  @param ry The y-radius of the ellipse
+ *  @param xAxisRotation The rotation of the ellipse, in degrees
+ *  @param largeArcFlag Whether the larger of the two possible arcs is used
+ *  @param sweepFlag Whether the arc is drawn in the positive-angle direction
+ *  @param x The x-coordinate of the end of the arc
+ *  @param y The y-coordinate of the end of the arc
+ */
+- (void)ellipticalArcRadiusX:(CGFloat)rx radiusY:(CGFloat)ry xAxisRotation:(CGFloat)xAxisRotation largeArcFlag:(BOOL)largeArcFlag sweepFlag:(BOOL)sweepFlag x:(CGFloat)x y:(CGFloat)y;
+
 @end
@@ -24,10 +24,12 @@
 
 #import "PXPath.h"
 #import "PXEllipticalArc.h"
-#import "NSScanner+PXFloat.h"
+#import "PXPathDataParser.h"
 #import "PixateFreestyle.h"
-#import "PXMath.h"
-#import "PXVector.h"
+
+@interface PXPath ()
+- (id)initWithMutablePath:(CGMutablePathRef)path;
+@end
 
 @implementation PXPath
 {
@@ -38,434 +40,76 @@
 
 + (PXPath *)createPathFromPathData:(NSString *)data
 {
-    PXPath *path = [[PXPath alloc] init];
+    CFStringRef string = (__bridge CFStringRef) data;
+    NSUInteger length = data.length;
+    const char *bytes = (length > 0) ? CFStringGetCStringPtr(string, kCFStringEncodingUTF8) : "";
+    PXPath *result;
+
+    if (bytes)
+    {
+        result = [self createPathFromPathDataBytes:bytes length:strlen(bytes)];
+    }
+    else
+    {
+        // Valid path data is ASCII, so a lossy ASCII copy of UTF-16 storage parses the same and reports errors at the
+        // same offsets
+        UInt8 *buffer = malloc(length);
+        CFIndex used = 0;
+
+        CFStringGetBytes(string, CFRangeMake(0, length), kCFStringEncodingASCII, '?', false, buffer, length, &used);
+        result = [self createPathFromPathDataBytes:(const char *) buffer length:used];
+
+        free(buffer);
+    }
+
+    return result;
+}
+
++ (PXPath *)createPathFromPathDataBytes:(const char *)bytes length:(NSUInteger)length
+{
+    PXPathSegmentBuffer buffer;
 
-    NSScanner *scanner = [NSScanner scannerWithString:data];
-    NSCharacterSet *skipSet = [NSCharacterSet characterSetWithCharactersInString:@" \r\n,"];
-    [scanner setCharactersToBeSkipped:skipSet];
+    PXPathSegmentBufferInit(&buffer, length);
 
-    NSCharacterSet *commandSet = [NSCharacterSet characterSetWithCharactersInString:@"MmLlCcHhVvQqAaSsTtZz"];
-    NSString *command;
-    unichar lastCommand = '\0';
-    CGFloat firstX = 0.0, firstY = 0.0;
-    CGFloat lastX = 0.0, lastY = 0.0;
-    CGFloat lastHandleX = 0.0, lastHandleY = 0.0;
-    CGFloat x1, y1, x2, y2, x3, y3;
+    NSUInteger errorOffset = PXPathSegmentBufferParse(&buffer, bytes, length);
 
-    while ([scanner isAtEnd] == NO)
+    if (errorOffset != NSNotFound)
     {
-        unichar ch;
-
-        if ([scanner scanCharactersFromSet:commandSet intoString:&command] == YES)
-        {
-            ch = [command characterAtIndex:0];
-
-            if (command.length > 1)
-            {
-                scanner.scanLocation = scanner.scanLocation - (command.length - 1);
-            }
-        }
-        else
-        {
-            ch = lastCommand;
-        }
-
-        switch (ch)
-        {
-            case 'A':
-            {
-                CGFloat rx, ry, xAxisRotation, largeArcFlag, sweepFlag;
-
-                [scanner scanCGFloat:&rx];
-                [scanner scanCGFloat:&ry];
-                [scanner scanCGFloat:&xAxisRotation];
-                [scanner scanCGFloat:&largeArcFlag];
-                [scanner scanCGFloat:&sweepFlag];
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-
-                [path ellipticalArcRadiusX:rx radiusY:ry xAxisRotation:xAxisRotation largeArcFlag:(largeArcFlag > 0.0) sweepFlag:(sweepFlag > 0.0) x:x1 y:y1];
-
-                lastCommand = ch;
-                lastX = x1;
-                lastY = y1;
-                break;
-            }
-
-            case 'a':
-            {
-                CGFloat rx, ry, xAxisRotation, largeArcFlag, sweepFlag;
-
-                [scanner scanCGFloat:&rx];
-                [scanner scanCGFloat:&ry];
-                [scanner scanCGFloat:&xAxisRotation];
-                [scanner scanCGFloat:&largeArcFlag];
-                [scanner scanCGFloat:&sweepFlag];
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-
-                x1 += lastX;
-                y1 += lastY;
-
-                [path ellipticalArcRadiusX:rx radiusY:ry xAxisRotation:xAxisRotation largeArcFlag:(largeArcFlag > 0.0) sweepFlag:(sweepFlag > 0.0) x:x1 y:y1];
-
-                lastCommand = ch;
-                lastX = x1;
-                lastY = y1;
-                break;
-            }
-
-            case 'C':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                [scanner scanCGFloat:&x3];
-                [scanner scanCGFloat:&y3];
-                //NSLog(@"cubicto %f,%f,%f,%f,%f,%f", x1, y1, x2, y2, x3, y3);
-
-                [path cubicBezierToX1:x1 y1:y1 x2:x2 y2:y2 x3:x3 y3:y3];
-
-                lastCommand = ch;
-                lastHandleX = x2;
-                lastHandleY = y2;
-                lastX = x3;
-                lastY = y3;
-                break;
-
-            case 'c':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                [scanner scanCGFloat:&x3];
-                [scanner scanCGFloat:&y3];
-                //NSLog(@"rcubicto %f,%f,%f,%f,%f,%f", x1, y1, x2, y2, x3, y3);
-
-                x1 += lastX;
-                y1 += lastY;
-                x2 += lastX;
-                y2 += lastY;
-                x3 += lastX;
-                y3 += lastY;
-
-                [path cubicBezierToX1:x1 y1:y1 x2:x2 y2:y2 x3:x3 y3:y3];
-
-                lastCommand = ch;
-                lastHandleX = x2;
-                lastHandleY = y2;
-                lastX = x3;
-                lastY = y3;
-                break;
-
-            case 'H':
-                [scanner scanCGFloat:&x1];
-                //NSLog(@"horiz %f", x1);
-
-                [path lineToX:x1 y:lastY];
-
-                lastCommand = ch;
-                lastX = x1;
-                break;
-
-            case 'h':
-                [scanner scanCGFloat:&x1];
-                //NSLog(@"rhoriz %f", x1);
-
-                x1 += lastX;
-
-                [path lineToX:x1 y:lastY];
-
-                lastCommand = ch;
-                lastX = x1;
-                break;
-
-            case 'L':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                //NSLog(@"lineto %f,%f", x1, y1);
-
-                [path lineToX:x1 y:y1];
-
-                lastCommand = ch;
-                lastX = x1;
-                lastY = y1;
-                break;
-
-            case 'l':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                //NSLog(@"rlineto %f,%f", x1, y1);
-
-                x1 += lastX;
-                y1 += lastY;
-
-                [path lineToX:x1 y:y1];
-
-                lastCommand = ch;
-                lastX = x1;
-                lastY = y1;
-                break;
-
-            case 'M':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                //NSLog(@"moveto %f,%f", x1, y1);
-
-                [path moveToX:x1 y:y1];
-
-                lastCommand = 'L';
-                lastX = x1;
-                lastY = y1;
-                firstX = x1;
-                firstY = y1;
-                break;
-
-            case 'm':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                //NSLog(@"rmoveto %f,%f", x1, y1);
-
-                x1 += lastX;
-                y1 += lastY;
-
-                [path moveToX:x1 y:y1];
-
-                lastCommand = 'l';
-                lastX = x1;
-                lastY = y1;
-                firstX = x1;
-                firstY = y1;
-                break;
-
-            case 'Q':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                //NSLog(@"quadto %f,%f,%f,%f", x1, y1, x2, y2);
-
-                [path quadraticBezierToX1:x1 y1:y1 x2:x2 y2:y2];
-
-                lastCommand = ch;
-                lastHandleX = x1;
-                lastHandleY = y1;
-                lastX = x2;
-                lastY = y2;
-                break;
-
-            case 'q':
-                [scanner scanCGFloat:&x1];
-                [scanner scanCGFloat:&y1];
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                //NSLog(@"rquadto %f,%f,%f,%f", x1, y1, x2, y2);
-
-                x1 += lastX;
-                y1 += lastY;
-                x2 += lastX;
-                y2 += lastY;
-
-                [path quadraticBezierToX1:x1 y1:y1 x2:x2 y2:y2];
-
-                lastCommand = ch;
-                lastHandleX = x1;
-                lastHandleY = y1;
-                lastX = x2;
-                lastY = y2;
-                break;
-
-            case 'S':
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                [scanner scanCGFloat:&x3];
-                [scanner scanCGFloat:&y3];
-                //NSLog(@"scubicto %f,%f,%f,%f", x2, y2, x3, y3);
-
-                switch (lastCommand) {
-                    case 'S':
-                    case 's':
-                    case 'C':
-                    case 'c':
-                        x1 = 2.0 * lastX - lastHandleX;
-                        y1 = 2.0 * lastY - lastHandleY;
-                        break;
-
-                    default:
-                        x1 = lastX;
-                        y1 = lastY;
-                        break;
-                }
-
-                [path cubicBezierToX1:x1 y1:y1 x2:x2 y2:y2 x3:x3 y3:y3];
-
-                lastCommand = ch;
-                lastHandleX = x2;
-                lastHandleY = y2;
-                lastX = x3;
-                lastY = y3;
-                break;
-
-            case 's':
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                [scanner scanCGFloat:&x3];
-                [scanner scanCGFloat:&y3];
-                //NSLog(@"rscubicto %f,%f,%f,%f", x2, y2, x3, y3);
-
-                switch (lastCommand) {
-                    case 'S':
-                    case 's':
-                    case 'C':
-                    case 'c':
-                        x1 = 2.0 * lastX - lastHandleX;
-                        y1 = 2.0 * lastY - lastHandleY;
-                        break;
-
-                    default:
-                        x1 = lastX;
-                        y1 = lastY;
-                }
-                x2 += lastX;
-                y2 += lastY;
-                x3 += lastX;
-                y3 += lastY;
-
-                [path cubicBezierToX1:x1 y1:y1 x2:x2 y2:y2 x3:x3 y3:y3];
-
-                lastCommand = ch;
-                lastHandleX = x2;
-                lastHandleY = y2;
-                lastX = x3;
-                lastY = y3;
-                break;
-
-            case 'T':
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                //NSLog(@"squadto %f,%f", x2, y2);
-
-                switch (lastCommand) {
-                    case 'Q':
-                    case 'q':
-                    case 'T':
-                    case 't':
-                        x1 = 2.0 * lastX - lastHandleX;
-                        y1 = 2.0 * lastY - lastHandleY;
-                        break;
-
-                    default:
-                        x1 = lastX;
-                        y1 = lastY;
-                        break;
-                }
-
-                [path quadraticBezierToX1:x1 y1:y1 x2:x2 y2:y2];
-
-                lastCommand = ch;
-                lastHandleX = x1;
-                lastHandleY = y1;
-                lastX = x2;
-                lastY = y2;
-                break;
-
-            case 't':
-                [scanner scanCGFloat:&x2];
-                [scanner scanCGFloat:&y2];
-                //NSLog(@"rsquadto %f,%f", x2, y2);
-
-                switch (lastCommand) {
-                    case 'Q':
-                    case 'q':
-                    case 'T':
-                    case 't':
-                        x1 = 2.0 * lastX - lastHandleX;
-                        y1 = 2.0 * lastY - lastHandleY;
-                        break;
-
-                    default:
-                        x1 = lastX;
-                        y1 = lastY;
-                        break;
-                }
-                x2 += lastX;
-                y2 += lastY;
-
-                [path quadraticBezierToX1:x1 y1:y1 x2:x2 y2:y2];
-
-                lastCommand = ch;
-                lastHandleX = x1;
-                lastHandleY = y1;
-                lastX = x2;
-                lastY = y2;
-                break;
-
-            case 'V':
-                [scanner scanCGFloat:&y1];
-                //NSLog(@"vert %f", x1);
-
-                [path lineToX:lastX y:y1];
-
-                lastCommand = ch;
-                lastY = y1;
-                break;
-
-            case 'v':
-                [scanner scanCGFloat:&y1];
-                //NSLog(@"rvert %f", x1);
-
-                y1 += lastY;
-
-                [path lineToX:lastX y:y1];
-
-                lastCommand = ch;
-                lastY = y1;
-                break;
-
-            case 'Z':
-                //NSLog(@"close");
-                [path close];
-
-                lastCommand = '\0';
-                lastX = firstX;
-                lastY = firstY;
-                break;
-
-            case 'z':
-                //NSLog(@"close");
-                [path close];
-
-                lastCommand = '\0';
-                lastX = firstX;
-                lastY = firstY;
-                break;
-
-            default:
-            {
-                NSString *message = [NSString stringWithFormat:@"Unrecognized or missing path command at offset: %lu", (unsigned long)scanner.scanLocation];
-
-                // report error
-                [PixateFreestyle.configuration sendParseMessage:message];
-
-                // stop scanning
-                scanner.scanLocation = data.length;
-                break;
-            }
-        }
+        NSString *message = [NSString stringWithFormat:@"Unrecognized or missing path command at offset: %lu", (unsigned long)errorOffset];
+
+        // report error, keeping the segments before it
+        [PixateFreestyle.configuration sendParseMessage:message];
     }
 
-    return path;
+    CGMutablePathRef pathPath = PXPathSegmentBufferCreatePath(&buffer);
+    PXPath *result = [[PXPath alloc] initWithMutablePath:pathPath];
+
+    CGPathRelease(pathPath);
+    PXPathSegmentBufferFree(&buffer);
+
+    return result;
 }
 
 #pragma mark - Initializers
 
 - (id)init
+{
+    CGMutablePathRef path = CGPathCreateMutable();
+
+    self = [self initWithMutablePath:path];
+
+    CGPathRelease(path);
+
+    return self;
+}
+
+- (id)initWithMutablePath:(CGMutablePathRef)path
 {
     self = [super init];
 
     if (self)
     {
-        pathPath = CGPathCreateMutable();
+        pathPath = (CGMutablePathRef) CGPathRetain(path);
     }
 
     return self;
@@ -488,81 +132,11 @@
 
 - (void)ellipticalArcRadiusX:(CGFloat)rx radiusY:(CGFloat)ry xAxisRotation:(CGFloat)xAxisRotation largeArcFlag:(BOOL)largeArcFlag sweepFlag:(BOOL)sweepFlag x:(CGFloat)x y:(CGFloat)y
 {
-    CGPoint lastPoint = CGPathGetCurrentPoint(pathPath);
-
-    CGFloat cx, cy;
-    CGFloat startAngle, sweepAngle, endAngle;
+    CGFloat values[6];
 
-    if ( rx != 0.0 || ry != 0.0 )
+    if (PXPathGetArcCenter(CGPathGetCurrentPoint(pathPath), rx, ry, xAxisRotation, largeArcFlag, sweepFlag, CGPointMake(x, y), values))
     {
-        CGFloat halfDx  = (lastPoint.x - x) * 0.5;
-        CGFloat halfDy  = (lastPoint.y - y) * 0.5;
-        CGFloat radians = DEGREES_TO_RADIANS(xAxisRotation);
-        CGFloat cosine  = COS(radians);
-        CGFloat sine    = SIN(radians);
-        CGFloat x1p     = halfDx *  cosine + halfDy * sine;
-        CGFloat y1p     = halfDx * -sine   + halfDy * cosine;
-        CGFloat x1px1p  = x1p*x1p;
-        CGFloat y1py1p  = y1p*y1p;
-        CGFloat lambda  = (x1px1p/(rx*rx)) + (y1py1p/(ry*ry));
-
-        // it may be impossible for the specified radii to describe
-        // an ellipse passing through the previous point and end point.
-        // Adjust radii, if necessary, so ellipse can pass through those
-        // points.
-        if ( lambda > 1.0 )
-        {
-            CGFloat factor = SQRT(lambda);
-
-            rx *= factor;
-            ry *= factor;
-        }
-
-        CGFloat rxrx = rx*rx;
-        CGFloat ryry = ry*ry;
-        CGFloat rxrxryry = rxrx*ryry;
-        CGFloat rxrxy1py1p = rxrx*y1py1p;
-        CGFloat ryryx1px1p = ryry*x1px1p;
-        CGFloat numerator = rxrxryry - rxrxy1py1p - ryryx1px1p;
-        CGFloat s;
-
-        if ( numerator < 1e-6 )
-        {
-            s = 0.0;
-        }
-        else
-        {
-            s = SQRT(numerator / (rxrxy1py1p + ryryx1px1p));
-        }
-        if ( largeArcFlag == sweepFlag )
-        {
-            s = -s;
-        }
-        CGFloat cxp = s *  rx*y1p / ry;
-        CGFloat cyp = s * -ry*x1p / rx;
-        cx  = cxp * cosine - cyp * sine   + (lastPoint.x + x) * 0.5;
-        cy  = cxp * sine   + cyp * cosine + (lastPoint.y + y) * 0.5;
-
-        PXVector *u = [PXVector vectorWithX:1.0 Y:0.0];
-        // NOTE: SVG spec divides x-component by rx and y-component by ry
-        PXVector *v = [PXVector vectorWithX:(x1p - cxp) Y:(y1p - cyp)];
-        PXVector *w = [PXVector vectorWithX:(-x1p - cxp) Y:(-y1p - cyp)];
-
-        startAngle = [u angleBetweenVector:v];
-        sweepAngle = [v angleBetweenVector:w];
-
-        if ( !sweepFlag && sweepAngle > 0.0 )
-        {
-            sweepAngle -= TWO_PI;
-        }
-        else if ( sweepFlag && sweepAngle < 0.0 )
-        {
-            sweepAngle += TWO_PI;
-        }
-
-        endAngle = startAngle + sweepAngle;
-
-        [self ellipticalArcX:cx y:cy radiusX:rx radiusY:ry startAngle:startAngle endAngle:endAngle];
+        [self ellipticalArcX:values[0] y:values[1] radiusX:values[2] radiusY:values[3] startAngle:values[4] endAngle:values[5]];
     }
 }
 
@@ -43,6 +43,17 @@
  */
 @property (readonly, nonatomic) CGPathRef path;
 
+/**
+ *  A read-only property of the bounding box of everything this shape draws, in its parent's coordinate space. This is
+ *  the local bounding box with this shape's transform applied. It is CGRectNull when nothing is drawn and
+ *  CGRectInfinite when the extent is unknown.
+ *
+ *  The bounding box is cached like the path. It is cleared when the path, transform, stroke, clipping path, or
+ *  visibility of this shape or of one of its descendants changes. A stroke whose width is changed in place is noticed
+ *  the next time this shape's bounding box is read.
+ */
+@property (readonly, nonatomic) CGRect boundingBox;
+
 /**
  *  A read-only property pointing to the PXScene that owns this instance.
  *
@@ -66,6 +77,20 @@
  */
 - (void)clearPath;
 
+/**
+ *  Return the bounding box of everything this shape draws, in its own coordinate space.
+ *
+ *  Typically, this method would not be called in isolation. It is more of a helper method for the boundingBox property.
+ *  The default covers the path, expanded by the stroke, and the clipping path. Sub-classes that draw more than that
+ *  should override this method, returning CGRectInfinite if the extent is not known.
+ */
+- (CGRect)localBoundingBox;
+
+/**
+ *  Clear the bounding box cache of this shape and its ancestors.
+ */
+- (void)clearBoundingBox;
+
 /**
  *  Render any children associated with this shape.
  *
@@ -86,4 +111,16 @@
  */
 - (void)setNeedsDisplay;
 
+/**
+ *  Return the number of shapes rendered, and the number of shapes skipped because their bounding box fell outside of
+ *  the context's clip, since the counts were last reset. These counts include shapes rendered on any thread.
+ */
++ (NSUInteger)renderedShapeCount;
++ (NSUInteger)culledShapeCount;
+
+/**
+ *  Reset the rendered and culled shape counts
+ */
++ (void)resetRenderCounts;
+
 @end
@@ -25,13 +25,48 @@
 #import "PXShape.h"
 #import "PXShapeView.h"
 #import "PXShadow.h"
+#import "PXStroke.h"
+#import "PXTiledRasterizer.h"
+
+static uint64_t RENDERED_SHAPE_COUNT;
+static uint64_t CULLED_SHAPE_COUNT;
+
+/**
+ *  Return how far the specified stroke reaches beyond the path it strokes, or CGFLOAT_MAX if that is not known
+ */
+static CGFloat PXShapeStrokeOutset(id<PXStrokeRenderer> stroke)
+{
+    CGFloat result = 0.0;
+
+    if ([stroke isKindOfClass:[PXStroke class]])
+    {
+        PXStroke *pxStroke = (PXStroke *) stroke;
+
+        if (pxStroke.color && pxStroke.width > 0.0)
+        {
+            // miter joins reach furthest, and square caps reach half a width times the square root of two
+            result = pxStroke.width * 0.5 * MAX(pxStroke.miterLimit, 1.5);
+        }
+    }
+    else if (stroke)
+    {
+        result = CGFLOAT_MAX;
+    }
+
+    return result;
+}
 
 @implementation PXShape
+{
+    BOOL hasBoundingBox_;
+    CGFloat boundingBoxStrokeOutset_;
+}
 
 @synthesize parent = _parent;
 @synthesize owningDocument = _owningDocument;
 
 @synthesize path = _path;
+@synthesize boundingBox = _boundingBox;
 @synthesize stroke = _stroke;
 @synthesize fill = _fill;
 @synthesize opacity = _opacity;
@@ -41,6 +76,24 @@
 @synthesize shadow = _shadow;
 @synthesize padding = _padding;
 
+#pragma mark - Static Methods
+
++ (NSUInteger)renderedShapeCount
+{
+    return (NSUInteger) __atomic_load_n(&RENDERED_SHAPE_COUNT, __ATOMIC_RELAXED);
+}
+
++ (NSUInteger)culledShapeCount
+{
+    return (NSUInteger) __atomic_load_n(&CULLED_SHAPE_COUNT, __ATOMIC_RELAXED);
+}
+
++ (void)resetRenderCounts
+{
+    __atomic_store_n(&RENDERED_SHAPE_COUNT, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&CULLED_SHAPE_COUNT, 0, __ATOMIC_RELAXED);
+}
+
 #pragma mark - Initializers
 
 - (id)init
@@ -53,6 +106,7 @@
         self->_owningDocument = nil;
 
         self->_path = nil;
+        self->_boundingBox = CGRectNull;
         self.stroke = nil;
         self.fill = nil;
         self.opacity = 1.0;
@@ -77,6 +131,41 @@
     return self->_path;
 }
 
+- (CGRect)boundingBox
+{
+    CGFloat strokeOutset = PXShapeStrokeOutset(self.stroke);
+
+    if (self->hasBoundingBox_ && self->boundingBoxStrokeOutset_ != strokeOutset)
+    {
+        // the stroke was changed in place, so our ancestors' boxes are stale too
+        [self clearBoundingBox];
+    }
+
+    if (!self->hasBoundingBox_)
+    {
+        CGRect result = (self.visible) ? [self localBoundingBox] : CGRectNull;
+
+        if (self.clippingPath && !CGRectIsNull(result))
+        {
+            CGPathRef clip = self.clippingPath.path;
+            CGRect clipBounds = (clip) ? CGPathGetBoundingBox(clip) : CGRectNull;
+
+            result = (CGRectIsInfinite(result)) ? clipBounds : CGRectIntersection(result, clipBounds);
+        }
+
+        if (!CGRectIsNull(result) && !CGRectIsInfinite(result))
+        {
+            result = CGRectApplyAffineTransform(result, self.transform);
+        }
+
+        self->_boundingBox = result;
+        self->boundingBoxStrokeOutset_ = strokeOutset;
+        self->hasBoundingBox_ = YES;
+    }
+
+    return self->_boundingBox;
+}
+
 - (PXShapeDocument *)owningDocument
 {
     id<PXRenderable> result = self;
@@ -113,6 +202,7 @@
     if (self->_stroke != stroke)
     {
         self->_stroke = stroke;
+        [self clearBoundingBox];
         [self setNeedsDisplay];
     }
 }
@@ -143,6 +233,7 @@
     if (self->_visible != visible)
     {
         self->_visible = visible;
+        [self clearBoundingBox];
         [self setNeedsDisplay];
     }
 }
@@ -152,6 +243,7 @@
     if (!CGAffineTransformEqualToTransform(self->_transform, transform))
     {
         self->_transform = transform;
+        [self clearBoundingBox];
         [self setNeedsDisplay];
     }
 }
@@ -161,6 +253,7 @@
     if (self->_clippingPath != clippingPath)
     {
         self->_clippingPath = clippingPath;
+        [self clearBoundingBox];
         [self setNeedsDisplay];
     }
 }
@@ -170,6 +263,7 @@
     if (self->_shadow != shadow)
     {
         self->_shadow = shadow;
+        [self clearBoundingBox];
         [self setNeedsDisplay];
     }
 }
@@ -180,13 +274,62 @@
 {
     self.path = nil;
 
+    [self clearBoundingBox];
     [self setNeedsDisplay];
 }
 
+- (void)clearBoundingBox
+{
+    PXShape *shape = self;
+
+    // a cleared box implies cleared boxes all the way up, so we can stop at the first one
+    while (shape && shape->hasBoundingBox_)
+    {
+        shape->hasBoundingBox_ = NO;
+        shape = ([shape.parent isKindOfClass:[PXShape class]]) ? (PXShape *) shape.parent : nil;
+    }
+}
+
+- (CGRect)localBoundingBox
+{
+    CGRect result = CGRectNull;
+    CGFloat strokeOutset = PXShapeStrokeOutset(self.stroke);
+
+    if (self.shadow || strokeOutset == CGFLOAT_MAX)
+    {
+        result = CGRectInfinite;
+    }
+    else if (self.path)
+    {
+        result = CGRectInset(CGPathGetBoundingBox(self.path), -strokeOutset, -strokeOutset);
+    }
+
+    return result;
+}
+
+- (BOOL)isCulledInContext:(CGContextRef)context
+{
+    CGRect bounds = self.boundingBox;
+    BOOL result = CGRectIsNull(bounds);
+
+    if (!result && !CGRectIsInfinite(bounds))
+    {
+        CGRect clip = CGContextGetClipBoundingBox(context);
+        CGSize pixel = CGContextConvertSizeToUserSpace(context, CGSizeMake(1.0, 1.0));
+
+        // pixels only partly covered by the shape's edges still need it
+        result = !CGRectIntersectsRect(clip, CGRectInset(bounds, -fabs(pixel.width), -fabs(pixel.height)));
+    }
+
+    __atomic_fetch_add((result) ? &CULLED_SHAPE_COUNT : &RENDERED_SHAPE_COUNT, 1, __ATOMIC_RELAXED);
+
+    return result;
+}
+
 - (void)render:(CGContextRef)context
 {
-    // Don't draw if we're not visible
-    if (context != nil && self.visible == YES)
+    // Don't draw if we're not visible, or if everything we draw falls outside of the clip
+    if (context != nil && self.visible == YES && ![self isCulledInContext:context])
     {
         // push context
         CGContextSaveGState(context);
@@ -241,9 +384,11 @@
 
 - (UIImage *)renderToImageWithBounds:(CGRect)bounds withOpacity:(BOOL)opaque
 {
-    UIImage *result = nil;
+    UIImage *result = [[PXTiledRasterizer sharedInstance] imageOfRenderable:self withBounds:bounds withOpacity:opaque usingBlock:^(CGContextRef context) {
+        [self render:context];
+    }];
 
-    if (bounds.size.width > 0 && bounds.size.height > 0)
+    if (result == nil && bounds.size.width > 0 && bounds.size.height > 0)
     {
         // start new image context
         UIGraphicsBeginImageContextWithOptions(bounds.size, opaque, 0.0);
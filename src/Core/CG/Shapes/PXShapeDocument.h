@@ -66,4 +66,31 @@
  */
 - (void)addShape:(id<PXRenderable>)shape forName:(NSString *)name;
 
+/**
+ *  Build and cache the path and bounding box of every shape in this scene, returning an estimate of the bytes the scene
+ *  holds.
+ *
+ *  Paths are otherwise built lazily while rendering. Once they are built, a scene that is not changed can be rendered
+ *  by several callers at once, which is how PXSVGLoader shares parsed documents.
+ */
+- (NSUInteger)buildPaths;
+
+/**
+ *  Render this scene with its viewport scaled to fit the specified size, without changing its bounds. This is how a
+ *  shared scene is rendered, so its bounds must be left empty
+ *
+ *  @param context The context in which to render
+ *  @param size The size to fit the scene's viewport within
+ */
+- (void)render:(CGContextRef)context withSize:(CGSize)size;
+
+/**
+ *  Render this scene at the specified size, as render:withSize: does, and return that as a UIImage
+ *
+ *  @param size The size of the resulting image
+ *  @param opaque Determine if the resulting image should have an alpha channel or not
+ *  @returns A UIImage of the rendered scene, or nil if the size is empty
+ */
+- (UIImage *)renderToImageWithSize:(CGSize)size withOpacity:(BOOL)opaque;
+
 @end
@@ -24,6 +24,37 @@
 
 #import "PXShapeDocument.h"
 #import "PXShapeGroup.h"
+#import "PXTiledRasterizer.h"
+
+// an estimate of the bytes held by a shape object and its paints, apart from its path
+static const NSUInteger SHAPE_COST = 256;
+
+static void PXShapeDocumentAddPathCost(void *info, const CGPathElement *element)
+{
+    NSUInteger *cost = info;
+    NSUInteger pointCount = 0;
+
+    switch (element->type)
+    {
+        case kCGPathElementMoveToPoint:
+        case kCGPathElementAddLineToPoint:
+            pointCount = 1;
+            break;
+
+        case kCGPathElementAddQuadCurveToPoint:
+            pointCount = 2;
+            break;
+
+        case kCGPathElementAddCurveToPoint:
+            pointCount = 3;
+            break;
+
+        case kCGPathElementCloseSubpath:
+            break;
+    }
+
+    *cost += 1 + pointCount * sizeof(CGPoint);
+}
 
 @implementation PXShapeDocument
 {
@@ -127,6 +158,89 @@
     }
 }
 
+- (NSUInteger)buildPaths
+{
+    return [self buildPathsOfShape:_shape];
+}
+
+- (NSUInteger)buildPathsOfShape:(id<PXRenderable>)renderable
+{
+    NSUInteger result = 0;
+
+    if ([renderable isKindOfClass:[PXShape class]])
+    {
+        PXShape *shape = (PXShape *) renderable;
+        CGPathRef path = shape.path;
+
+        result += SHAPE_COST;
+
+        if (path)
+        {
+            CGPathApply(path, &result, PXShapeDocumentAddPathCost);
+        }
+
+        if (shape.clippingPath)
+        {
+            result += [self buildPathsOfShape:shape.clippingPath];
+        }
+
+        // renders cull with the bounding box, so it is cached here too
+        [shape boundingBox];
+    }
+
+    if ([renderable isKindOfClass:[PXShapeGroup class]])
+    {
+        PXShapeGroup *group = (PXShapeGroup *) renderable;
+
+        for (NSUInteger i = 0; i < group.shapeCount; i++)
+        {
+            result += [self buildPathsOfShape:[group shapeAtIndex:i]];
+        }
+    }
+
+    return result;
+}
+
+- (void)render:(CGContextRef)context withSize:(CGSize)size
+{
+    if (self->_shape)
+    {
+        CGContextSaveGState(context);
+
+        // this is the transform setBounds: would have the top-level group apply to its children. The top-level group
+        // of a loaded document has no transform of its own, so applying it outside of the group is equivalent
+        if ([self->_shape isKindOfClass:[PXShapeGroup class]])
+        {
+            CGContextConcatCTM(context, [(PXShapeGroup *) self->_shape viewPortTransformForSize:size]);
+        }
+
+        [self render:context];
+
+        CGContextRestoreGState(context);
+    }
+}
+
+- (UIImage *)renderToImageWithSize:(CGSize)size withOpacity:(BOOL)opaque
+{
+    CGRect bounds = CGRectMake(0.0, 0.0, size.width, size.height);
+    UIImage *result = [[PXTiledRasterizer sharedInstance] imageOfRenderable:self withBounds:bounds withOpacity:opaque usingBlock:^(CGContextRef context) {
+        [self render:context withSize:size];
+    }];
+
+    if (result == nil && size.width > 0 && size.height > 0)
+    {
+        UIGraphicsBeginImageContextWithOptions(size, opaque, 0.0);
+
+        [self render:UIGraphicsGetCurrentContext() withSize:size];
+
+        result = UIGraphicsGetImageFromCurrentImageContext();
+
+        UIGraphicsEndImageContext();
+    }
+
+    return result;
+}
+
 #pragma mark - PXRenderable Methods
 
 - (void)render:(CGContextRef)context
@@ -140,9 +254,11 @@
 
 - (UIImage *)renderToImageWithBounds:(CGRect)aBounds withOpacity:(BOOL)opaque
 {
-    UIImage *result = nil;
+    UIImage *result = [[PXTiledRasterizer sharedInstance] imageOfRenderable:self withBounds:aBounds withOpacity:opaque usingBlock:^(CGContextRef context) {
+        [self render:context];
+    }];
 
-    if (aBounds.size.width > 0 && aBounds.size.height > 0)
+    if (result == nil && aBounds.size.width > 0 && aBounds.size.height > 0)
     {
         // start new image context
         UIGraphicsBeginImageContextWithOptions(aBounds.size, opaque, 0.0);
@@ -89,6 +89,14 @@ typedef enum {
  */
 @property (readonly, nonatomic) CGAffineTransform viewPortTransform;
 
+/**
+ *  Return the transform that would need to be applied to this shape group in order for its viewport to fit within the
+ *  specified size. The viewPortTransform property uses this group's width and height
+ *
+ *  @param size The size to fit the viewport within
+ */
+- (CGAffineTransform)viewPortTransformForSize:(CGSize)size;
+
 /**
  *  Adds a shape to this shape group.
  *
@@ -55,6 +55,53 @@
     return (shapes_) ? shapes_.count : 0;
 }
 
+#pragma mark - Setters
+
+- (void)setWidth:(CGFloat)width
+{
+    if (_width != width)
+    {
+        _width = width;
+        [self clearBoundingBox];
+    }
+}
+
+- (void)setHeight:(CGFloat)height
+{
+    if (_height != height)
+    {
+        _height = height;
+        [self clearBoundingBox];
+    }
+}
+
+- (void)setViewport:(CGRect)viewport
+{
+    if (!CGRectEqualToRect(_viewport, viewport))
+    {
+        _viewport = viewport;
+        [self clearBoundingBox];
+    }
+}
+
+- (void)setViewportAlignment:(AlignViewPortType)viewportAlignment
+{
+    if (_viewportAlignment != viewportAlignment)
+    {
+        _viewportAlignment = viewportAlignment;
+        [self clearBoundingBox];
+    }
+}
+
+- (void)setViewportCrop:(CropType)viewportCrop
+{
+    if (_viewportCrop != viewportCrop)
+    {
+        _viewportCrop = viewportCrop;
+        [self clearBoundingBox];
+    }
+}
+
 #pragma mark - Methods
 
 - (void)addShape:(id<PXRenderable>)shape
@@ -66,6 +113,8 @@
 
         // set child's parent
         shape.parent = self;
+
+        [self clearBoundingBox];
     }
 }
 
@@ -77,6 +126,8 @@
 
         // TODO: verify this is in this group
         shape.parent = nil;
+
+        [self clearBoundingBox];
     }
 }
 
@@ -86,6 +137,11 @@
 }
 
 - (CGAffineTransform) viewPortTransform
+{
+    return [self viewPortTransformForSize:CGSizeMake(self.width, self.height)];
+}
+
+- (CGAffineTransform)viewPortTransformForSize:(CGSize)size
 {
     CGPoint viewPortOrigin = self.viewport.origin;
     CGSize viewPortSize = self.viewport.size;
@@ -93,10 +149,10 @@
     CGAffineTransform matrix = CGAffineTransformIdentity;
 
     // TODO: take viewPort x and y into account
-    if (viewPortSize.width && viewPortSize.height && self.width > 0 && self.height > 0)
+    if (viewPortSize.width && viewPortSize.height && size.width > 0 && size.height > 0)
     {
-        CGFloat ratioX = self.width / viewPortSize.width;
-        CGFloat ratioY = self.height / viewPortSize.height;
+        CGFloat ratioX = size.width / viewPortSize.width;
+        CGFloat ratioY = size.height / viewPortSize.height;
 
         matrix = CGAffineTransformTranslate(matrix, viewPortOrigin.x, viewPortOrigin.y);
 
@@ -110,7 +166,7 @@
                 (ratioX < ratioY && self.viewportCrop == kCropTypeSlice))
             {
                 CGFloat tx = 0;
-                CGFloat diffX = self.width - viewPortSize.width * ratioY ;
+                CGFloat diffX = size.width - viewPortSize.width * ratioY ;
 
                 switch (self.viewportAlignment)
                 {
@@ -137,7 +193,7 @@
                      (ratioX > ratioY && self.viewportCrop == kCropTypeSlice))
             {
                 CGFloat ty = 0;
-                CGFloat diffY = self.height - viewPortSize.height * ratioX;
+                CGFloat diffY = size.height - viewPortSize.height * ratioX;
 
                 switch (self.viewportAlignment)
                 {
@@ -171,6 +227,33 @@
     return matrix;
 }
 
+- (CGRect)localBoundingBox
+{
+    CGRect result = [super localBoundingBox];
+    CGRect children = CGRectNull;
+
+    // every child's box is read, even once the result is known, so the whole tree's boxes are cached together
+    for (id<PXRenderable> shape in shapes_)
+    {
+        CGRect childBounds = ([shape isKindOfClass:[PXShape class]]) ? ((PXShape *) shape).boundingBox : CGRectInfinite;
+
+        children = (CGRectIsInfinite(children) || CGRectIsInfinite(childBounds))
+            ? CGRectInfinite
+            : CGRectUnion(children, childBounds);
+    }
+
+    if (CGRectIsInfinite(result) || CGRectIsInfinite(children))
+    {
+        result = CGRectInfinite;
+    }
+    else if (!CGRectIsNull(children))
+    {
+        result = CGRectUnion(result, CGRectApplyAffineTransform(children, self.viewPortTransform));
+    }
+
+    return result;
+}
+
 - (void) renderChildren:(CGContextRef)context
 {
 
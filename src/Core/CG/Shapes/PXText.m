@@ -108,6 +108,12 @@
     return resultPath;
 }
 
+- (CGRect)localBoundingBox
+{
+    // our path is drawn offset by our origin and font size, so leave text to the clip
+    return CGRectInfinite;
+}
+
 - (void)render:(CGContextRef)context
 {
     CGContextSaveGState(context);
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXTiledRasterizer.h
+//  Pixate
+//
+
+#import <UIKit/UIKit.h>
+#import "PXRenderable.h"
+
+/**
+ *  PXTiledRasterizer renders large images by splitting the bitmap into tiles and rendering the tiles concurrently, each
+ *  into its own context over the tile's part of one shared buffer. Each tile's context is clipped to the tile, so shapes
+ *  whose bounding box does not reach it are culled. Tiles are aligned to device pixels, so the result is
+ *  pixel-identical to rendering the whole image at once.
+ *
+ *  Only shape trees that can be rendered from several threads at once are tiled: plain shapes and groups filled with
+ *  solid colors or gradients, stroked by a PXStroke, and without shadows. Every path and bounding box is built before
+ *  the tiles are rendered. Other trees, small images, and all images while disabled are left to the caller to render
+ *  serially.
+ */
+@interface PXTiledRasterizer : NSObject
+
+/**
+ *  The singleton instance of PXTiledRasterizer
+ */
++ (PXTiledRasterizer *)sharedInstance;
+
+/**
+ *  Determine if images are tiled. This defaults to NO
+ */
+@property (atomic) BOOL enabled;
+
+/**
+ *  The width and height of a tile, in pixels. The default is 256
+ */
+@property (atomic) NSUInteger tileSize;
+
+/**
+ *  The number of pixels an image needs before it is tiled. The default is 512 by 512
+ */
+@property (atomic) NSUInteger minimumPixelCount;
+
+/**
+ *  The number of images that have been tiled, and the number of tiles rendered, since the counters were last reset
+ */
+@property (nonatomic, readonly) NSUInteger imageCount;
+@property (nonatomic, readonly) NSUInteger tileCount;
+
+/**
+ *  Render an image of the specified renderable in tiles, or return nil if it should be rendered serially instead. The
+ *  block is called once per tile, possibly on several threads at once, with a context whose transform already maps
+ *  the bounds to the image
+ *
+ *  @param renderable The shape tree the block renders, used to decide if it can be tiled and to cull its shapes
+ *  @param bounds The bounds which establishes the view bounds and the resulting image size
+ *  @param opaque Determine if the resulting image should have an alpha channel or not
+ *  @param block The block that renders the renderable into a context
+ */
+- (UIImage *)imageOfRenderable:(id<PXRenderable>)renderable
+                    withBounds:(CGRect)bounds
+                   withOpacity:(BOOL)opaque
+                    usingBlock:(void (^)(CGContextRef context))block;
+
+/**
+ *  Reset the image and tile counters
+ */
+- (void)resetCounters;
+
+@end
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXTiledRasterizer.m
+//  Pixate
+//
+
+#import "PXTiledRasterizer.h"
+#import "PXShapeDocument.h"
+#import "PXShapeGroup.h"
+#import "PXStroke.h"
+#import "PXSolidPaint.h"
+#import "PXLinearGradient.h"
+#import "PXRadialGradient.h"
+#import "PXPaintGroup.h"
+
+@implementation PXTiledRasterizer
+{
+    IMP shapeRender_;
+    IMP shapeRenderChildren_;
+    IMP groupRenderChildren_;
+}
+
+#pragma mark - Static Methods
+
++ (PXTiledRasterizer *)sharedInstance
+{
+	static __strong PXTiledRasterizer *sharedInstance = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		sharedInstance = [[PXTiledRasterizer alloc] init];
+	});
+	return sharedInstance;
+}
+
+#pragma mark - Initializers
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        shapeRender_ = [PXShape instanceMethodForSelector:@selector(render:)];
+        shapeRenderChildren_ = [PXShape instanceMethodForSelector:@selector(renderChildren:)];
+        groupRenderChildren_ = [PXShapeGroup instanceMethodForSelector:@selector(renderChildren:)];
+
+        _tileSize = 256;
+        _minimumPixelCount = 512 * 512;
+    }
+
+    return self;
+}
+
+#pragma mark - Methods
+
+- (UIImage *)imageOfRenderable:(id<PXRenderable>)renderable
+                    withBounds:(CGRect)bounds
+                   withOpacity:(BOOL)opaque
+                    usingBlock:(void (^)(CGContextRef context))block
+{
+    CGSize size = bounds.size;
+    CGFloat scale = [UIScreen mainScreen].scale;
+    NSUInteger tileSize = MAX(self.tileSize, (NSUInteger) 1);
+
+    if (!self.enabled || block == nil || size.width <= 0 || size.height <= 0 ||
+        size.width * scale * size.height * scale < self.minimumPixelCount)
+    {
+        return nil;
+    }
+
+    // this also builds every path and bounding box, so the tiles only read the shape tree
+    if (![self prepareRenderable:renderable])
+    {
+        return nil;
+    }
+
+    UIImage *result = nil;
+
+    UIGraphicsBeginImageContextWithOptions(size, opaque, 0.0);
+
+    CGContextRef context = UIGraphicsGetCurrentContext();
+    uint8_t *data = CGBitmapContextGetData(context);
+
+    if (data)
+    {
+        size_t width = CGBitmapContextGetWidth(context);
+        size_t height = CGBitmapContextGetHeight(context);
+        size_t bytesPerRow = CGBitmapContextGetBytesPerRow(context);
+        size_t bytesPerPixel = CGBitmapContextGetBitsPerPixel(context) / 8;
+        size_t bitsPerComponent = CGBitmapContextGetBitsPerComponent(context);
+        CGBitmapInfo bitmapInfo = CGBitmapContextGetBitmapInfo(context);
+        CGColorSpaceRef colorSpace = CGBitmapContextGetColorSpace(context);
+        size_t columns = (width + tileSize - 1) / tileSize;
+        size_t rows = (height + tileSize - 1) / tileSize;
+
+        // the transform serial rendering would use, from bounds to the pixels of the whole image
+        CGAffineTransform matrix = CGAffineTransformTranslate(CGContextGetCTM(context), -bounds.origin.x, -bounds.origin.y);
+
+        dispatch_apply(columns * rows, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index) {
+            size_t x = (index % columns) * tileSize;
+            size_t y = (index / columns) * tileSize;
+            size_t tileWidth = MIN(tileSize, width - x);
+            size_t tileHeight = MIN(tileSize, height - y);
+
+            // rows are stored top first, while device space starts at the bottom
+            CGContextRef tileContext = CGBitmapContextCreate(data + y * bytesPerRow + x * bytesPerPixel,
+                                                             tileWidth, tileHeight, bitsPerComponent, bytesPerRow,
+                                                             colorSpace, bitmapInfo);
+
+            if (tileContext)
+            {
+                CGFloat tileBottom = (CGFloat) (height - y - tileHeight);
+
+                CGContextConcatCTM(tileContext, CGAffineTransformConcat(matrix, CGAffineTransformMakeTranslation(-(CGFloat) x, -tileBottom)));
+
+                // shapes outside of the tile are culled against its clip
+                @autoreleasepool
+                {
+                    block(tileContext);
+                }
+
+                CGContextRelease(tileContext);
+            }
+        });
+
+        @synchronized(self)
+        {
+            _imageCount++;
+            _tileCount += columns * rows;
+        }
+
+        result = UIGraphicsGetImageFromCurrentImageContext();
+    }
+
+    UIGraphicsEndImageContext();
+
+    return result;
+}
+
+- (void)resetCounters
+{
+    @synchronized(self)
+    {
+        _imageCount = 0;
+        _tileCount = 0;
+    }
+}
+
+#pragma mark - Private Methods
+
+/**
+ *  Determine if the specified renderable's tree can be tiled, building the path and bounding box of each of its shapes
+ */
+- (BOOL)prepareRenderable:(id<PXRenderable>)renderable
+{
+    id<PXRenderable> root = renderable;
+
+    if ([renderable isKindOfClass:[PXShapeDocument class]])
+    {
+        root = ((PXShapeDocument *) renderable).shape;
+    }
+
+    return [self prepareShape:root];
+}
+
+- (BOOL)prepareShape:(id<PXRenderable>)renderable
+{
+    BOOL result = [renderable isKindOfClass:[PXShape class]] && [self canTileShape:(PXShape *) renderable];
+
+    if (result)
+    {
+        PXShape *shape = (PXShape *) renderable;
+
+        if ([shape isKindOfClass:[PXShapeGroup class]])
+        {
+            PXShapeGroup *group = (PXShapeGroup *) shape;
+
+            for (NSUInteger i = 0; i < group.shapeCount && result; i++)
+            {
+                result = [self prepareShape:[group shapeAtIndex:i]];
+            }
+        }
+
+        // this reads the boxes of any children, and builds our path
+        [shape boundingBox];
+    }
+
+    return result;
+}
+
+- (BOOL)canTileShape:(PXShape *)shape
+{
+    BOOL result =
+        [shape methodForSelector:@selector(render:)] == shapeRender_
+    &&  ([shape methodForSelector:@selector(renderChildren:)] == shapeRenderChildren_ ||
+         [shape methodForSelector:@selector(renderChildren:)] == groupRenderChildren_)
+    &&  shape.shadow == nil
+    &&  [self canTilePaint:shape.fill];
+
+    if (result && shape.stroke)
+    {
+        result = [shape.stroke class] == [PXStroke class] && [self canTilePaint:((PXStroke *) shape.stroke).color];
+    }
+
+    return result;
+}
+
+- (BOOL)canTilePaint:(id<PXPaint>)paint
+{
+    BOOL result = (paint == nil)
+    ||  [paint class] == [PXSolidPaint class]
+    ||  [paint class] == [PXLinearGradient class]
+    ||  [paint class] == [PXRadialGradient class];
+
+    if (!result && [paint class] == [PXPaintGroup class])
+    {
+        result = YES;
+
+        for (id<PXPaint> child in ((PXPaintGroup *) paint).paints)
+        {
+            result = result && [self canTilePaint:child];
+        }
+    }
+
+    return result;
+}
+
+@end
@@ -130,6 +130,9 @@
     {
         CGContextRef context = UIGraphicsGetCurrentContext();
 
+        // shapes outside of the invalidated rect are culled against the clip
+        CGContextClipToRect(context, rect);
+
         [_document render:context];
     }
 }
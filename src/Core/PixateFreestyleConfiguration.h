@@ -97,6 +97,46 @@ typedef enum {
  */
 @property (nonatomic) NSUInteger styleCacheCount;
 
+/**
+ *  Set the number of bytes the image and style caches may hold together, or zero for no limit. This defaults to a
+ *  thirty-second of the device's physical memory
+ */
+@property (nonatomic) NSUInteger cacheMemoryBudget;
+
+/**
+ *  Set the estimated number of bytes of parsed SVG documents kept for reuse, so an image rendered at many sizes is only
+ *  parsed once, or zero for no limit
+ */
+@property (nonatomic) NSUInteger shapeDocumentCacheSize;
+
+/**
+ *  Determine if rendered background images are also kept on disk, so later launches can load them instead of
+ *  rendering them again. This defaults to NO
+ */
+@property (nonatomic) BOOL diskImageCache;
+
+/**
+ *  Set the number of bytes of background images kept on disk when diskImageCache is enabled, or zero for no limit
+ */
+@property (nonatomic) NSUInteger diskImageCacheSize;
+
+/**
+ *  Determine if large SVG images are rendered in tiles on several threads at once. Tiled images are pixel-identical to
+ *  images rendered serially. This defaults to NO
+ */
+@property (nonatomic) BOOL tiledRendering;
+
+/**
+ *  Determine if background images are rendered off the main thread. When enabled, a styleable whose background image
+ *  is not cached is styled with a placeholder and restyled once its image has been rendered
+ */
+@property (nonatomic) BOOL asyncImageRendering;
+
+/**
+ *  Set the number of background images that may be rendered at once when asyncImageRendering is enabled
+ */
+@property (nonatomic) NSUInteger imageRenderConcurrency;
+
 /*
  *  Return the property value for the specifified property name
  *
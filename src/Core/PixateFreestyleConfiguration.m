@@ -28,6 +28,9 @@
 #import "PXGenericStyler.h"
 #import "PXDeclaration.h"
 #import "PXStyleUtils.h"
+#import "PXImageRasterizer.h"
+#import "PXDiskImageCache.h"
+#import "PXTiledRasterizer.h"
 
 @implementation PixateFreestyleConfiguration
 {
@@ -64,6 +67,7 @@ static int ddLogLevel = LOG_LEVEL_WARN;
         _imageCacheCount = 10;
         _imageCacheSize = 0;
         _styleCacheCount = 10;
+        _cacheMemoryBudget = (NSUInteger) ([NSProcessInfo processInfo].physicalMemory / 32);
     }
 
     return self;
@@ -138,6 +142,63 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     [PXCacheManager setStyleCacheCount:styleCacheCount];
 }
 
+- (void)setCacheMemoryBudget:(NSUInteger)cacheMemoryBudget
+{
+    _cacheMemoryBudget = cacheMemoryBudget;
+
+    [PXCacheManager setMemoryBudget:cacheMemoryBudget];
+}
+
+- (NSUInteger)shapeDocumentCacheSize
+{
+    return [PXCacheManager shapeDocumentCacheSize];
+}
+
+- (void)setShapeDocumentCacheSize:(NSUInteger)shapeDocumentCacheSize
+{
+    [PXCacheManager setShapeDocumentCacheSize:shapeDocumentCacheSize];
+}
+
+- (BOOL)diskImageCache
+{
+    return [PXDiskImageCache sharedInstance].enabled;
+}
+
+- (void)setDiskImageCache:(BOOL)diskImageCache
+{
+    [PXDiskImageCache sharedInstance].enabled = diskImageCache;
+}
+
+- (NSUInteger)diskImageCacheSize
+{
+    return [PXDiskImageCache sharedInstance].sizeLimit;
+}
+
+- (void)setDiskImageCacheSize:(NSUInteger)diskImageCacheSize
+{
+    [PXDiskImageCache sharedInstance].sizeLimit = diskImageCacheSize;
+}
+
+- (BOOL)tiledRendering
+{
+    return [PXTiledRasterizer sharedInstance].enabled;
+}
+
+- (void)setTiledRendering:(BOOL)tiledRendering
+{
+    [PXTiledRasterizer sharedInstance].enabled = tiledRendering;
+}
+
+- (NSUInteger)imageRenderConcurrency
+{
+    return [PXImageRasterizer sharedInstance].maximumConcurrentRenders;
+}
+
+- (void)setImageRenderConcurrency:(NSUInteger)imageRenderConcurrency
+{
+    [PXImageRasterizer sharedInstance].maximumConcurrentRenders = imageRenderConcurrency;
+}
+
 #pragma mark - PXStyleable
 
 - (void)setStyleId:(NSString *)anId
@@ -238,6 +299,35 @@ static int ddLogLevel = LOG_LEVEL_WARN;
                     NSString *value = declaration.stringValue;
 
                     PixateFreestyle.configuration.styleCacheCount = [value integerValue];
+                },
+                @"cache-memory-budget" : ^(PXDeclaration *declaration, PXStylerContext *context) {
+                    NSString *value = declaration.stringValue;
+
+                    PixateFreestyle.configuration.cacheMemoryBudget = [value integerValue];
+                },
+                @"shape-document-cache-size" : ^(PXDeclaration *declaration, PXStylerContext *context) {
+                    NSString *value = declaration.stringValue;
+
+                    PixateFreestyle.configuration.shapeDocumentCacheSize = [value integerValue];
+                },
+                @"disk-image-cache" : ^(PXDeclaration *declaration, PXStylerContext *context) {
+                    PixateFreestyle.configuration.diskImageCache = declaration.booleanValue;
+                },
+                @"disk-image-cache-size" : ^(PXDeclaration *declaration, PXStylerContext *context) {
+                    NSString *value = declaration.stringValue;
+
+                    PixateFreestyle.configuration.diskImageCacheSize = [value integerValue];
+                },
+                @"tiled-rendering" : ^(PXDeclaration *declaration, PXStylerContext *context) {
+                    PixateFreestyle.configuration.tiledRendering = declaration.booleanValue;
+                },
+                @"async-image-rendering" : ^(PXDeclaration *declaration, PXStylerContext *context) {
+                    PixateFreestyle.configuration.asyncImageRendering = declaration.booleanValue;
+                },
+                @"image-render-concurrency" : ^(PXDeclaration *declaration, PXStylerContext *context) {
+                    NSString *value = declaration.stringValue;
+
+                    PixateFreestyle.configuration.imageRenderConcurrency = [value integerValue];
                 }
             }]
         ];
@@ -24,23 +24,131 @@
 
 #import <Foundation/Foundation.h>
 #import "PXStyleTreeInfo.h"
+#import "PXLRUCache.h"
 
+@class PXShapeDocument;
+@class PXRuleSet;
+
+/**
+ *  PXCacheManager owns the caches used while styling. The image and style caches share one memory budget: when their
+ *  combined cost exceeds it, the least recently used speculative entries of either cache are evicted first, then the
+ *  least recently used normal entries. Pinned entries are never evicted. A memory warning evicts every speculative
+ *  entry and trims the rest to half of their cost
+ */
 @interface PXCacheManager : NSObject
 
-+ (UIImage *)imageForKey:(NSNumber *)key;
-+ (void)setImage:(UIImage *)image forKey:(NSNumber *)key cost:(NSUInteger)cost;
++ (UIImage *)imageForKey:(id<NSCopying>)key;
++ (void)setImage:(UIImage *)image forKey:(id<NSCopying>)key cost:(NSUInteger)cost;
++ (void)setImage:(UIImage *)image forKey:(id<NSCopying>)key cost:(NSUInteger)cost priority:(PXCachePriority)priority;
 + (void)clearImageCache;
 + (NSUInteger)imageCacheCount;
 + (NSUInteger)imageCacheSize;
 + (void)setImageCacheCount:(NSUInteger)count;
 + (void)setImageCacheSize:(NSUInteger)size;
 
+/**
+ *  Return the number of bytes held by the decoded bitmap of the specified image, including its scale
+ *
+ *  @param image The image to measure
+ */
++ (NSUInteger)costForImage:(UIImage *)image;
+
+/**
+ *  The number of image lookups that found a cached image, and the number that did not, since the statistics were last
+ *  reset
+ */
++ (NSUInteger)imageCacheHitCount;
++ (NSUInteger)imageCacheMissCount;
+
+/**
+ *  The number of images evicted to stay within a limit or the memory budget, since the statistics were last reset
+ */
++ (NSUInteger)imageCacheEvictionCount;
+
+/**
+ *  The fraction of image lookups that found a cached image, or zero if there have been no lookups
+ */
++ (CGFloat)imageCacheHitRatio;
+
+/**
+ *  The total size, in bytes, of the bitmaps that image cache hits returned instead of rendering them again
+ */
++ (unsigned long long)imageCacheBytesSaved;
++ (void)resetImageCacheStatistics;
+
 + (PXStyleTreeInfo *)styleTreeInfoForKey:(NSString *)key;
 + (void)setStyleTreeInfo:(PXStyleTreeInfo *)styleTreeInfo forKey:(NSString *)key;
 + (void)clearStyleCache;
++ (void)removeStyleTreeInfosPassingTest:(BOOL (^)(PXStyleTreeInfo *styleTreeInfo))predicate;
 + (NSUInteger)styleCacheCount;
 + (void)setStyleCacheCount:(NSUInteger)count;
 
+/**
+ *  Style cache lookup and eviction counters, since the statistics were last reset
+ */
++ (NSUInteger)styleCacheHitCount;
++ (NSUInteger)styleCacheMissCount;
++ (NSUInteger)styleCacheEvictionCount;
++ (void)resetStyleCacheStatistics;
+
+/**
+ *  The number of bytes the image and style caches may hold together, or zero for no limit. Lowering the budget evicts
+ *  entries immediately
+ */
++ (NSUInteger)memoryBudget;
++ (void)setMemoryBudget:(NSUInteger)budget;
+
+/**
+ *  The number of bytes the image and style caches currently hold together
+ */
++ (NSUInteger)memoryUsage;
+
+/**
+ *  Evict every speculative entry, then trim the image and style caches to half of their combined cost. This is called
+ *  on memory warnings
+ */
++ (void)handleMemoryPressure;
+
+/**
+ *  Parsed SVG documents shared by every rendering of the same file, keyed by PXSVGLoader. Cached documents must not be
+ *  changed. The cache is limited by the estimated bytes of its documents rather than the memory budget, since they are
+ *  much smaller than the images rendered from them, and it is emptied on memory warnings
+ */
++ (PXShapeDocument *)shapeDocumentForKey:(id<NSCopying>)key;
++ (void)setShapeDocument:(PXShapeDocument *)document forKey:(id<NSCopying>)key cost:(NSUInteger)cost;
++ (void)clearShapeDocumentCache;
++ (NSUInteger)shapeDocumentCacheSize;
++ (void)setShapeDocumentCacheSize:(NSUInteger)size;
+
+/**
+ *  The number of documents and estimated bytes the shape document cache currently holds
+ */
++ (NSUInteger)shapeDocumentCacheCount;
++ (NSUInteger)shapeDocumentCacheUsage;
+
+/**
+ *  Shape document cache lookup and eviction counters, since the statistics were last reset
+ */
++ (NSUInteger)shapeDocumentCacheHitCount;
++ (NSUInteger)shapeDocumentCacheMissCount;
++ (NSUInteger)shapeDocumentCacheEvictionCount;
++ (void)resetShapeDocumentCacheStatistics;
+
++ (NSArray *)ruleSetMatchesForKey:(id<NSCopying>)key;
++ (void)setRuleSetMatches:(NSArray *)ruleSets forKey:(id<NSCopying>)key;
++ (void)clearRuleSetMatchCache;
++ (NSUInteger)ruleSetMatchCacheCount;
++ (void)setRuleSetMatchCacheCount:(NSUInteger)count;
+
++ (PXRuleSet *)mergedRuleSetForKey:(id<NSCopying>)key;
++ (void)setMergedRuleSet:(PXRuleSet *)ruleSet forKey:(id<NSCopying>)key;
+
++ (NSArray *)inlineRuleSetsForSource:(NSString *)source;
++ (void)setInlineRuleSets:(NSArray *)ruleSets forSource:(NSString *)source;
++ (void)clearInlineStyleCache;
++ (NSUInteger)inlineStyleCacheCount;
++ (void)setInlineStyleCacheCount:(NSUInteger)count;
+
 + (void)clearAllCaches;
 
 @end
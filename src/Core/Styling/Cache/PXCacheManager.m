@@ -25,8 +25,27 @@
 #import "PXCacheManager.h"
 #import "PixateFreestyle.h"
 
-static NSCache *IMAGE_CACHE;
-static NSCache *STYLE_CACHE;
+static PXLRUCache *IMAGE_CACHE;
+static PXLRUCache *STYLE_CACHE;
+static NSCache *RULE_SET_MATCH_CACHE;
+static NSCache *MERGED_RULE_SET_CACHE;
+static PXLRUCache *INLINE_STYLE_CACHE;
+static PXLRUCache *SHAPE_DOCUMENT_CACHE;
+
+// the combined byte limit of the image and style caches, guarded by IMAGE_CACHE
+static NSUInteger MEMORY_BUDGET;
+
+// bytes returned by image cache hits, guarded by IMAGE_CACHE
+static unsigned long long IMAGE_CACHE_BYTES_SAVED;
+
+// enough for the distinct element and ancestor combinations of a typical screen
+static const NSUInteger RULE_SET_MATCH_CACHE_COUNT = 512;
+
+// inline styles are usually repeated across many views, so only a few distinct sources are live at once
+static const NSUInteger INLINE_STYLE_CACHE_COUNT = 128;
+
+// a few hundred icons, at the estimated cost of their shapes and paths
+static const NSUInteger SHAPE_DOCUMENT_CACHE_SIZE = 4 * 1024 * 1024;
 
 @implementation PXCacheManager
 
@@ -34,19 +53,52 @@ static NSCache *STYLE_CACHE;
 
 +(void)initialize
 {
-    IMAGE_CACHE = [[NSCache alloc] init];
-    IMAGE_CACHE.name = @"Pixate Image Cache";
-    IMAGE_CACHE.countLimit = PixateFreestyle.configuration.imageCacheCount;
+    IMAGE_CACHE = [[PXLRUCache alloc] initWithCountLimit:PixateFreestyle.configuration.imageCacheCount];
     IMAGE_CACHE.totalCostLimit = PixateFreestyle.configuration.imageCacheSize;
 
-    STYLE_CACHE = [[NSCache alloc] init];
-    STYLE_CACHE.name = @"Pixate Style Cache";
-    STYLE_CACHE.countLimit = PixateFreestyle.configuration.styleCacheCount;
+    STYLE_CACHE = [[PXLRUCache alloc] initWithCountLimit:PixateFreestyle.configuration.styleCacheCount];
+
+    MEMORY_BUDGET = PixateFreestyle.configuration.cacheMemoryBudget;
+
+    RULE_SET_MATCH_CACHE = [[NSCache alloc] init];
+    RULE_SET_MATCH_CACHE.name = @"Pixate Rule Set Match Cache";
+    RULE_SET_MATCH_CACHE.countLimit = RULE_SET_MATCH_CACHE_COUNT;
+
+    // each match result is usually merged once per state, so this holds a few merges per cached match
+    MERGED_RULE_SET_CACHE = [[NSCache alloc] init];
+    MERGED_RULE_SET_CACHE.name = @"Pixate Merged Rule Set Cache";
+    MERGED_RULE_SET_CACHE.countLimit = RULE_SET_MATCH_CACHE_COUNT * 2;
+
+    INLINE_STYLE_CACHE = [[PXLRUCache alloc] initWithCountLimit:INLINE_STYLE_CACHE_COUNT];
+
+    SHAPE_DOCUMENT_CACHE = [[PXLRUCache alloc] initWithCountLimit:0];
+    SHAPE_DOCUMENT_CACHE.totalCostLimit = SHAPE_DOCUMENT_CACHE_SIZE;
+
+    // NSCache used to purge itself on memory warnings. Speculative entries go first now
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(handleMemoryPressure)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
 }
 
-+ (UIImage *)imageForKey:(NSNumber *)key
++ (UIImage *)imageForKey:(id<NSCopying>)key
 {
-    return (key != nil) ? [IMAGE_CACHE objectForKey:key] : nil;
+    UIImage *result = nil;
+
+    if (key != nil)
+    {
+        result = [IMAGE_CACHE objectForKey:key];
+
+        if (result != nil)
+        {
+            @synchronized(IMAGE_CACHE)
+            {
+                IMAGE_CACHE_BYTES_SAVED += [self costForImage:result];
+            }
+        }
+    }
+
+    return result;
 }
 
 + (PXStyleTreeInfo *)styleTreeInfoForKey:(NSString *)key
@@ -54,11 +106,37 @@ static NSCache *STYLE_CACHE;
     return (key != nil) ? [STYLE_CACHE objectForKey:key] : nil;
 }
 
-+ (void)setImage:(UIImage *)image forKey:(NSNumber *)key cost:(NSUInteger)cost
++ (NSArray *)ruleSetMatchesForKey:(id<NSCopying>)key
+{
+    return (key != nil) ? [RULE_SET_MATCH_CACHE objectForKey:key] : nil;
+}
+
++ (PXRuleSet *)mergedRuleSetForKey:(id<NSCopying>)key
+{
+    return (key != nil) ? [MERGED_RULE_SET_CACHE objectForKey:key] : nil;
+}
+
++ (NSArray *)inlineRuleSetsForSource:(NSString *)source
+{
+    return (source != nil) ? [INLINE_STYLE_CACHE objectForKey:source] : nil;
+}
+
++ (PXShapeDocument *)shapeDocumentForKey:(id<NSCopying>)key
+{
+    return (key != nil) ? [SHAPE_DOCUMENT_CACHE objectForKey:key] : nil;
+}
+
++ (void)setImage:(UIImage *)image forKey:(id<NSCopying>)key cost:(NSUInteger)cost
+{
+    [self setImage:image forKey:key cost:cost priority:PXCachePriorityNormal];
+}
+
++ (void)setImage:(UIImage *)image forKey:(id<NSCopying>)key cost:(NSUInteger)cost priority:(PXCachePriority)priority
 {
     if (image != nil && key != nil)
     {
-        [IMAGE_CACHE setObject:image forKey:key cost:cost];
+        [IMAGE_CACHE setObject:image forKey:key cost:cost priority:priority];
+        [self enforceMemoryBudget];
     }
 }
 
@@ -66,10 +144,61 @@ static NSCache *STYLE_CACHE;
 {
     if (styleTreeInfo != nil && key.length > 0)
     {
-        [STYLE_CACHE setObject:styleTreeInfo forKey:key];
+        [STYLE_CACHE setObject:styleTreeInfo forKey:key cost:styleTreeInfo.cost priority:PXCachePriorityNormal];
+        [self enforceMemoryBudget];
+    }
+}
+
++ (void)setRuleSetMatches:(NSArray *)ruleSets forKey:(id<NSCopying>)key
+{
+    if (ruleSets != nil && key != nil)
+    {
+        [RULE_SET_MATCH_CACHE setObject:ruleSets forKey:key];
     }
 }
 
++ (void)setMergedRuleSet:(PXRuleSet *)ruleSet forKey:(id<NSCopying>)key
+{
+    if (ruleSet != nil && key != nil)
+    {
+        [MERGED_RULE_SET_CACHE setObject:ruleSet forKey:key];
+    }
+}
+
++ (void)setInlineRuleSets:(NSArray *)ruleSets forSource:(NSString *)source
+{
+    if (ruleSets != nil && source != nil)
+    {
+        [INLINE_STYLE_CACHE setObject:ruleSets forKey:source];
+    }
+}
+
++ (void)setShapeDocument:(PXShapeDocument *)document forKey:(id<NSCopying>)key cost:(NSUInteger)cost
+{
+    if (document != nil && key != nil)
+    {
+        [SHAPE_DOCUMENT_CACHE setObject:document forKey:key cost:cost priority:PXCachePriorityNormal];
+    }
+}
+
++ (NSUInteger)costForImage:(UIImage *)image
+{
+    CGImageRef cgImage = image.CGImage;
+    NSUInteger result;
+
+    if (cgImage != NULL)
+    {
+        result = CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage);
+    }
+    else
+    {
+        // images without a bitmap, like CIImage-backed ones, are decoded at their pixel size
+        result = (NSUInteger) (image.size.width * image.scale * image.size.height * image.scale * 4);
+    }
+
+    return result;
+}
+
 + (NSUInteger)imageCacheCount
 {
     return IMAGE_CACHE.countLimit;
@@ -90,6 +219,47 @@ static NSCache *STYLE_CACHE;
     IMAGE_CACHE.totalCostLimit = size;
 }
 
++ (NSUInteger)imageCacheHitCount
+{
+    return IMAGE_CACHE.hitCount;
+}
+
++ (NSUInteger)imageCacheMissCount
+{
+    return IMAGE_CACHE.missCount;
+}
+
++ (NSUInteger)imageCacheEvictionCount
+{
+    return IMAGE_CACHE.evictionCount;
+}
+
++ (CGFloat)imageCacheHitRatio
+{
+    NSUInteger hits = IMAGE_CACHE.hitCount;
+    NSUInteger lookups = hits + IMAGE_CACHE.missCount;
+
+    return (lookups > 0) ? (CGFloat) hits / lookups : 0.0f;
+}
+
++ (unsigned long long)imageCacheBytesSaved
+{
+    @synchronized(IMAGE_CACHE)
+    {
+        return IMAGE_CACHE_BYTES_SAVED;
+    }
+}
+
++ (void)resetImageCacheStatistics
+{
+    [IMAGE_CACHE resetCounters];
+
+    @synchronized(IMAGE_CACHE)
+    {
+        IMAGE_CACHE_BYTES_SAVED = 0;
+    }
+}
+
 + (NSUInteger)styleCacheCount
 {
     return STYLE_CACHE.countLimit;
@@ -100,19 +270,159 @@ static NSCache *STYLE_CACHE;
     STYLE_CACHE.countLimit = count;
 }
 
-+ (void)clearImageCache
++ (NSUInteger)styleCacheHitCount
+{
+    return STYLE_CACHE.hitCount;
+}
+
++ (NSUInteger)styleCacheMissCount
 {
-    if (IMAGE_CACHE != nil)
+    return STYLE_CACHE.missCount;
+}
+
++ (NSUInteger)styleCacheEvictionCount
+{
+    return STYLE_CACHE.evictionCount;
+}
+
++ (void)resetStyleCacheStatistics
+{
+    [STYLE_CACHE resetCounters];
+}
+
++ (NSUInteger)memoryBudget
+{
+    @synchronized(IMAGE_CACHE)
+    {
+        return MEMORY_BUDGET;
+    }
+}
+
++ (void)setMemoryBudget:(NSUInteger)budget
+{
+    @synchronized(IMAGE_CACHE)
     {
-        [IMAGE_CACHE removeAllObjects];
+        MEMORY_BUDGET = budget;
     }
+
+    [self enforceMemoryBudget];
+}
+
++ (NSUInteger)memoryUsage
+{
+    return IMAGE_CACHE.totalCost + STYLE_CACHE.totalCost;
+}
+
++ (void)handleMemoryPressure
+{
+    [IMAGE_CACHE removeObjectsWithPriority:PXCachePrioritySpeculative];
+    [STYLE_CACHE removeObjectsWithPriority:PXCachePrioritySpeculative];
+
+    [self trimToCost:[self memoryUsage] / 2];
+
+    // documents are parsed again on their next use
+    [SHAPE_DOCUMENT_CACHE removeAllObjects];
+}
+
++ (NSUInteger)shapeDocumentCacheSize
+{
+    return SHAPE_DOCUMENT_CACHE.totalCostLimit;
+}
+
++ (void)setShapeDocumentCacheSize:(NSUInteger)size
+{
+    SHAPE_DOCUMENT_CACHE.totalCostLimit = size;
+}
+
++ (NSUInteger)shapeDocumentCacheCount
+{
+    return SHAPE_DOCUMENT_CACHE.count;
+}
+
++ (NSUInteger)shapeDocumentCacheUsage
+{
+    return SHAPE_DOCUMENT_CACHE.totalCost;
+}
+
++ (NSUInteger)shapeDocumentCacheHitCount
+{
+    return SHAPE_DOCUMENT_CACHE.hitCount;
+}
+
++ (NSUInteger)shapeDocumentCacheMissCount
+{
+    return SHAPE_DOCUMENT_CACHE.missCount;
+}
+
++ (NSUInteger)shapeDocumentCacheEvictionCount
+{
+    return SHAPE_DOCUMENT_CACHE.evictionCount;
+}
+
++ (void)resetShapeDocumentCacheStatistics
+{
+    [SHAPE_DOCUMENT_CACHE resetCounters];
+}
+
++ (NSUInteger)ruleSetMatchCacheCount
+{
+    return RULE_SET_MATCH_CACHE.countLimit;
+}
+
++ (void)setRuleSetMatchCacheCount:(NSUInteger)count
+{
+    RULE_SET_MATCH_CACHE.countLimit = count;
+}
+
++ (NSUInteger)inlineStyleCacheCount
+{
+    return INLINE_STYLE_CACHE.countLimit;
+}
+
++ (void)setInlineStyleCacheCount:(NSUInteger)count
+{
+    INLINE_STYLE_CACHE.countLimit = count;
+}
+
++ (void)clearImageCache
+{
+    [IMAGE_CACHE removeAllObjects];
 }
 
 + (void)clearStyleCache
 {
-    if (STYLE_CACHE != nil)
+    [STYLE_CACHE removeAllObjects];
+}
+
++ (void)removeStyleTreeInfosPassingTest:(BOOL (^)(PXStyleTreeInfo *styleTreeInfo))predicate
+{
+    if (predicate != nil)
+    {
+        [STYLE_CACHE removeObjectsPassingTest:^BOOL(id key, id object) {
+            return predicate(object);
+        }];
+    }
+}
+
++ (void)clearShapeDocumentCache
+{
+    [SHAPE_DOCUMENT_CACHE removeAllObjects];
+}
+
++ (void)clearRuleSetMatchCache
+{
+    if (RULE_SET_MATCH_CACHE != nil)
     {
-        [STYLE_CACHE removeAllObjects];
+        [RULE_SET_MATCH_CACHE removeAllObjects];
+        [MERGED_RULE_SET_CACHE removeAllObjects];
+    }
+}
+
++ (void)clearInlineStyleCache
+{
+    if (INLINE_STYLE_CACHE != nil)
+    {
+        [INLINE_STYLE_CACHE removeAllObjects];
     }
 }
 
@@ -120,6 +430,61 @@ static NSCache *STYLE_CACHE;
 {
     [self clearImageCache];
     [self clearStyleCache];
+    [self clearRuleSetMatchCache];
+    [self clearInlineStyleCache];
+    [self clearShapeDocumentCache];
+}
+
+#pragma mark - Private Methods
+
++ (void)enforceMemoryBudget
+{
+    NSUInteger budget = [self memoryBudget];
+
+    if (budget > 0)
+    {
+        [self trimToCost:budget];
+    }
+}
+
++ (void)trimToCost:(NSUInteger)cost
+{
+    NSArray *caches = @[ IMAGE_CACHE, STYLE_CACHE ];
+
+    // each cache only locks itself, so this never runs while a cache lock is held
+    @synchronized(self)
+    {
+        while ([self memoryUsage] > cost)
+        {
+            BOOL evicted = NO;
+
+            // evict the least recently used entry of either cache, from the lowest priority class that has one
+            for (PXCachePriority priority = PXCachePrioritySpeculative; priority < PXCachePriorityPinned && !evicted; priority++)
+            {
+                PXLRUCache *oldestCache = nil;
+                uint64_t oldestUse = UINT64_MAX;
+
+                for (PXLRUCache *cache in caches)
+                {
+                    uint64_t use = [cache leastRecentUseOfPriority:priority];
+
+                    if (use < oldestUse)
+                    {
+                        oldestUse = use;
+                        oldestCache = cache;
+                    }
+                }
+
+                evicted = [oldestCache evictLeastRecentlyUsedObjectOfPriority:priority];
+            }
+
+            if (!evicted)
+            {
+                // only pinned entries are left
+                break;
+            }
+        }
+    }
 }
 
 @end
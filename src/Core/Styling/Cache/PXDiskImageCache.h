@@ -0,0 +1,119 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXDiskImageCache.h
+//  Pixate
+//
+
+#import <UIKit/UIKit.h>
+
+@class PXImageCacheKey;
+
+/**
+ *  PXDiskImageCache is an optional second tier behind the in-memory image cache that keeps rendered background images
+ *  across launches. Each image is stored as a raw bitmap file named by its key's persistent identifier and by a
+ *  namespace derived from the library version, the app's version and build, and the content hashes of the current
+ *  stylesheets and the files they import, so loading changed stylesheets or a new library or app version never finds
+ *  stale bitmaps. Files are memory-mapped when read, so their pixels are only paged in when the image is first drawn.
+ *
+ *  The cache is capped at sizeLimit bytes. When over the limit, bitmaps from other namespaces are evicted first, then
+ *  the least recently used ones. Writes and evictions run on a private serial queue; reads are safe from any thread.
+ */
+@interface PXDiskImageCache : NSObject
+
+/**
+ *  The singleton instance of PXDiskImageCache, stored under the app's caches directory
+ */
++ (PXDiskImageCache *)sharedInstance;
+
+/**
+ *  Determine if images are read from and written to disk. The default is NO
+ */
+@property (atomic, getter=isEnabled) BOOL enabled;
+
+/**
+ *  The maximum number of bytes of bitmap files kept on disk, or zero for no limit. The default is 20 MB
+ */
+@property (atomic) NSUInteger sizeLimit;
+
+/**
+ *  The directory bitmap files are stored in
+ */
+@property (nonatomic, readonly) NSString *directory;
+
+/**
+ *  The number of bytes of bitmap files currently on disk. This waits for pending writes
+ */
+@property (nonatomic, readonly) NSUInteger totalSize;
+
+/**
+ *  The number of reads that found a bitmap, the number that did not, the number of bitmaps written, and the number
+ *  evicted to stay within sizeLimit, since the counters were last reset
+ */
+@property (nonatomic, readonly) NSUInteger hitCount;
+@property (nonatomic, readonly) NSUInteger missCount;
+@property (nonatomic, readonly) NSUInteger writeCount;
+@property (nonatomic, readonly) NSUInteger evictionCount;
+
+/**
+ *  Initialize a new instance storing its files in the specified directory, which is created when first written to
+ *
+ *  @param directory The directory to store bitmap files in
+ */
+- (id)initWithDirectory:(NSString *)directory;
+
+/**
+ *  Return the file name for the image of the specified key, or nil if the cache is disabled, the key cannot be
+ *  persisted, or a current stylesheet was changed in code and so has no content hash
+ *
+ *  @param key The key of the image
+ */
+- (NSString *)fileNameForKey:(PXImageCacheKey *)key;
+
+/**
+ *  Return the image stored under the specified file name, or nil if there is none. The file is memory-mapped, and the
+ *  image is marked as the most recently used
+ *
+ *  @param fileName The file name returned by fileNameForKey:, which may be nil
+ */
+- (UIImage *)imageWithFileName:(NSString *)fileName;
+
+/**
+ *  Store the specified image under the specified file name. The bitmap is written asynchronously, and images that are
+ *  not 8-bit RGB bitmaps are skipped
+ *
+ *  @param image The image to store
+ *  @param fileName The file name returned by fileNameForKey:, which may be nil
+ */
+- (void)setImage:(UIImage *)image withFileName:(NSString *)fileName;
+
+/**
+ *  Remove every bitmap file
+ */
+- (void)removeAllImages;
+
+/**
+ *  Block the calling thread until every pending write and eviction has finished
+ */
+- (void)waitUntilIdle;
+
+/**
+ *  Reset the hit, miss, write, and eviction counters
+ */
+- (void)resetCounters;
+
+@end
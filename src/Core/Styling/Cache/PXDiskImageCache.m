@@ -0,0 +1,538 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXDiskImageCache.m
+//  Pixate
+//
+
+#import "PXDiskImageCache.h"
+#import "PXImageCacheKey.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PixateFreestyle.h"
+#import "PXFileUtils.h"
+
+static NSString *const PXDiskImagePathExtension = @"pxbitmap";
+static const NSUInteger DEFAULT_SIZE_LIMIT = 20 * 1024 * 1024;
+
+// 'PXBM', followed by the format version, so files written by an incompatible build are ignored
+static const uint32_t PX_DISK_IMAGE_MAGIC = 0x5058424D;
+static const uint32_t PX_DISK_IMAGE_FORMAT = 1;
+
+/**
+ *  The header of a bitmap file. Its size keeps the pixel rows that follow it 16-byte aligned
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytesPerRow;
+    uint32_t bitmapInfo;
+    float scale;
+    uint32_t reserved;
+} PXDiskImageHeader;
+
+static void PXDiskImageReleaseData(void *info, const void *data, size_t size)
+{
+    // balances the retain of the mapped data taken when its provider was created
+    CFRelease(info);
+}
+
+/**
+ *  The size and last use of a bitmap file. Only accessed on the cache's queue
+ */
+@interface PXDiskImageEntry : NSObject
+{
+@public
+    NSUInteger size_;
+    NSTimeInterval lastUse_;
+}
+@end
+
+@implementation PXDiskImageEntry
+@end
+
+@implementation PXDiskImageCache
+{
+    dispatch_queue_t queue_;
+    NSMutableDictionary *entries_;      // file name -> PXDiskImageEntry, loaded on the queue when first needed
+    NSUInteger totalSize_;
+    NSString *namespace_;
+    NSArray *namespaceSources_;         // the stylesheet content hashes namespace_ was derived from
+    NSUInteger hitCount_;
+    NSUInteger missCount_;
+    NSUInteger writeCount_;
+    NSUInteger evictionCount_;
+}
+
+#pragma mark - Static Methods
+
++ (PXDiskImageCache *)sharedInstance
+{
+	static __strong PXDiskImageCache *sharedInstance = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+        NSString *caches = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+
+		sharedInstance = [[PXDiskImageCache alloc] initWithDirectory:[caches stringByAppendingPathComponent:@"PixateFreestyle/Images"]];
+	});
+	return sharedInstance;
+}
+
+#pragma mark - Initializers
+
+- (id)init
+{
+    return [self initWithDirectory:[NSTemporaryDirectory() stringByAppendingPathComponent:@"PixateFreestyle/Images"]];
+}
+
+- (id)initWithDirectory:(NSString *)directory
+{
+    if (self = [super init])
+    {
+        _directory = [directory copy];
+        _sizeLimit = DEFAULT_SIZE_LIMIT;
+        queue_ = dispatch_queue_create("com.pixate.freestyle.disk-image-cache", DISPATCH_QUEUE_SERIAL);
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSUInteger)totalSize
+{
+    __block NSUInteger result;
+
+    dispatch_sync(queue_, ^{
+        [self loadEntries];
+        result = totalSize_;
+    });
+
+    return result;
+}
+
+- (NSUInteger)hitCount
+{
+    @synchronized(self)
+    {
+        return hitCount_;
+    }
+}
+
+- (NSUInteger)missCount
+{
+    @synchronized(self)
+    {
+        return missCount_;
+    }
+}
+
+- (NSUInteger)writeCount
+{
+    @synchronized(self)
+    {
+        return writeCount_;
+    }
+}
+
+- (NSUInteger)evictionCount
+{
+    @synchronized(self)
+    {
+        return evictionCount_;
+    }
+}
+
+#pragma mark - Methods
+
+- (NSString *)fileNameForKey:(PXImageCacheKey *)key
+{
+    NSString *result = nil;
+
+    if (self.enabled)
+    {
+        NSString *namespace = [self currentNamespace];
+        NSString *identifier = (namespace) ? key.persistentIdentifier : nil;
+
+        if (identifier)
+        {
+            result = [NSString stringWithFormat:@"%@-%@.%@", namespace, identifier, PXDiskImagePathExtension];
+        }
+    }
+
+    return result;
+}
+
+- (UIImage *)imageWithFileName:(NSString *)fileName
+{
+    if (fileName == nil)
+    {
+        return nil;
+    }
+
+    NSData *data = [NSData dataWithContentsOfFile:[_directory stringByAppendingPathComponent:fileName]
+                                          options:NSDataReadingMappedIfSafe
+                                            error:NULL];
+    UIImage *result = [self imageFromData:data];
+
+    @synchronized(self)
+    {
+        if (result)
+        {
+            hitCount_++;
+        }
+        else
+        {
+            missCount_++;
+        }
+    }
+
+    if (result)
+    {
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+
+        dispatch_async(queue_, ^{
+            [self touchFileName:fileName at:now];
+        });
+    }
+
+    return result;
+}
+
+- (void)setImage:(UIImage *)image withFileName:(NSString *)fileName
+{
+    if (image == nil || fileName == nil)
+    {
+        return;
+    }
+
+    // the bitmap is copied on the queue, so the rendering thread only pays for the dispatch
+    dispatch_async(queue_, ^{
+        NSData *data = [self dataFromImage:image];
+
+        if (data)
+        {
+            [self writeData:data toFileName:fileName];
+        }
+    });
+}
+
+- (void)removeAllImages
+{
+    dispatch_sync(queue_, ^{
+        [[NSFileManager defaultManager] removeItemAtPath:_directory error:NULL];
+
+        entries_ = [[NSMutableDictionary alloc] init];
+        totalSize_ = 0;
+    });
+}
+
+- (void)waitUntilIdle
+{
+    dispatch_sync(queue_, ^{});
+}
+
+- (void)resetCounters
+{
+    @synchronized(self)
+    {
+        hitCount_ = 0;
+        missCount_ = 0;
+        writeCount_ = 0;
+        evictionCount_ = 0;
+    }
+}
+
+#pragma mark - Namespaces
+
+- (NSString *)currentNamespace
+{
+    NSMutableArray *sources = [NSMutableArray arrayWithCapacity:3];
+    NSString *result = nil;
+
+    for (PXStylesheet *stylesheet in @[ [self stylesheetOrNull:[PXStylesheet currentApplicationStylesheet]],
+                                        [self stylesheetOrNull:[PXStylesheet currentUserStylesheet]],
+                                        [self stylesheetOrNull:[PXStylesheet currentViewStylesheet]] ])
+    {
+        if ((id) stylesheet == [NSNull null])
+        {
+            [sources addObject:@"-"];
+        }
+        else if (stylesheet.contentHash)
+        {
+            [sources addObject:stylesheet.contentHash];
+        }
+        else
+        {
+            // a stylesheet changed in code has no content that a later launch could match
+            return nil;
+        }
+    }
+
+    @synchronized(self)
+    {
+        if (![sources isEqualToArray:namespaceSources_])
+        {
+            NSString *version = [PixateFreestyle version];
+            NSDictionary *info = [NSBundle mainBundle].infoDictionary;
+            NSString *appVersion = [info objectForKey:@"CFBundleShortVersionString"];
+            NSString *appBuild = [info objectForKey:(NSString *) kCFBundleVersionKey];
+
+            // a new build of the app may ship different fonts and images under the same stylesheets
+            NSString *description = [NSString stringWithFormat:@"%@|%@|%@|%@",
+                                     (version) ? version : @"",
+                                     (appVersion) ? appVersion : @"",
+                                     (appBuild) ? appBuild : @"",
+                                     [sources componentsJoinedByString:@"|"]];
+
+            namespace_ = [PXFileUtils digestOfData:[description dataUsingEncoding:NSUTF8StringEncoding]];
+            namespaceSources_ = sources;
+        }
+
+        result = namespace_;
+    }
+
+    return result;
+}
+
+- (id)stylesheetOrNull:(PXStylesheet *)stylesheet
+{
+    return (stylesheet) ? stylesheet : [NSNull null];
+}
+
+#pragma mark - Bitmaps
+
+- (UIImage *)imageFromData:(NSData *)data
+{
+    UIImage *result = nil;
+
+    if (data.length >= sizeof(PXDiskImageHeader))
+    {
+        const PXDiskImageHeader *header = data.bytes;
+        size_t length = (size_t) header->bytesPerRow * header->height;
+
+        if (header->magic == PX_DISK_IMAGE_MAGIC
+            && header->format == PX_DISK_IMAGE_FORMAT
+            && header->width > 0
+            && header->bytesPerRow >= header->width * 4
+            && data.length >= sizeof(PXDiskImageHeader) + length)
+        {
+            // the provider reads straight from the mapped file, so nothing is decoded until the image is drawn
+            CGDataProviderRef provider = CGDataProviderCreateWithData((void *) CFBridgingRetain(data),
+                                                                      (const uint8_t *) data.bytes + sizeof(PXDiskImageHeader),
+                                                                      length,
+                                                                      PXDiskImageReleaseData);
+            CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+            CGImageRef image = CGImageCreate(header->width, header->height, 8, 32, header->bytesPerRow, colorSpace,
+                                             (CGBitmapInfo) header->bitmapInfo, provider, NULL, false,
+                                             kCGRenderingIntentDefault);
+
+            if (image)
+            {
+                result = [UIImage imageWithCGImage:image scale:header->scale orientation:UIImageOrientationUp];
+                CGImageRelease(image);
+            }
+
+            CGColorSpaceRelease(colorSpace);
+            CGDataProviderRelease(provider);
+        }
+    }
+
+    return result;
+}
+
+- (NSData *)dataFromImage:(UIImage *)image
+{
+    CGImageRef cgImage = image.CGImage;
+    NSMutableData *result = nil;
+
+    if (cgImage
+        && CGImageGetBitsPerComponent(cgImage) == 8
+        && CGImageGetBitsPerPixel(cgImage) == 32
+        && CGColorSpaceGetModel(CGImageGetColorSpace(cgImage)) == kCGColorSpaceModelRGB)
+    {
+        CFDataRef pixels = CGDataProviderCopyData(CGImageGetDataProvider(cgImage));
+
+        if (pixels)
+        {
+            PXDiskImageHeader header = {
+                PX_DISK_IMAGE_MAGIC,
+                PX_DISK_IMAGE_FORMAT,
+                (uint32_t) CGImageGetWidth(cgImage),
+                (uint32_t) CGImageGetHeight(cgImage),
+                (uint32_t) CGImageGetBytesPerRow(cgImage),
+                (uint32_t) CGImageGetBitmapInfo(cgImage),
+                (float) image.scale,
+                0
+            };
+            size_t length = (size_t) header.bytesPerRow * header.height;
+
+            if ((size_t) CFDataGetLength(pixels) >= length)
+            {
+                result = [NSMutableData dataWithCapacity:sizeof(header) + length];
+                [result appendBytes:&header length:sizeof(header)];
+                [result appendBytes:CFDataGetBytePtr(pixels) length:length];
+            }
+
+            CFRelease(pixels);
+        }
+    }
+
+    return result;
+}
+
+#pragma mark - Queue Methods
+
+- (void)loadEntries
+{
+    if (entries_ != nil)
+    {
+        return;
+    }
+
+    NSArray *keys = @[ NSURLFileSizeKey, NSURLContentModificationDateKey ];
+    NSArray *urls = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:[NSURL fileURLWithPath:_directory]
+                                                  includingPropertiesForKeys:keys
+                                                                     options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                                       error:NULL];
+
+    entries_ = [[NSMutableDictionary alloc] initWithCapacity:urls.count];
+    totalSize_ = 0;
+
+    for (NSURL *url in urls)
+    {
+        if ([url.pathExtension isEqualToString:PXDiskImagePathExtension])
+        {
+            NSDictionary *values = [url resourceValuesForKeys:keys error:NULL];
+            PXDiskImageEntry *entry = [[PXDiskImageEntry alloc] init];
+
+            // the modification date is bumped on every use, so it orders uses made by earlier launches
+            entry->size_ = [[values objectForKey:NSURLFileSizeKey] unsignedIntegerValue];
+            entry->lastUse_ = [[values objectForKey:NSURLContentModificationDateKey] timeIntervalSinceReferenceDate];
+
+            [entries_ setObject:entry forKey:url.lastPathComponent];
+            totalSize_ += entry->size_;
+        }
+    }
+}
+
+- (void)touchFileName:(NSString *)fileName at:(NSTimeInterval)time
+{
+    [self loadEntries];
+
+    PXDiskImageEntry *entry = [entries_ objectForKey:fileName];
+
+    if (entry)
+    {
+        entry->lastUse_ = time;
+
+        [[NSFileManager defaultManager] setAttributes:@{ NSFileModificationDate : [NSDate dateWithTimeIntervalSinceReferenceDate:time] }
+                                         ofItemAtPath:[_directory stringByAppendingPathComponent:fileName]
+                                                error:NULL];
+    }
+}
+
+- (void)writeData:(NSData *)data toFileName:(NSString *)fileName
+{
+    [self loadEntries];
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+
+    if (![fileManager fileExistsAtPath:_directory])
+    {
+        [fileManager createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:NULL];
+    }
+
+    if ([data writeToFile:[_directory stringByAppendingPathComponent:fileName] atomically:YES])
+    {
+        PXDiskImageEntry *entry = [entries_ objectForKey:fileName];
+
+        if (entry)
+        {
+            totalSize_ -= entry->size_;
+        }
+        else
+        {
+            entry = [[PXDiskImageEntry alloc] init];
+            [entries_ setObject:entry forKey:fileName];
+        }
+
+        entry->size_ = data.length;
+        entry->lastUse_ = [NSDate timeIntervalSinceReferenceDate];
+        totalSize_ += entry->size_;
+
+        @synchronized(self)
+        {
+            writeCount_++;
+        }
+
+        [self evictToSizeLimit];
+    }
+}
+
+- (void)evictToSizeLimit
+{
+    NSUInteger sizeLimit = self.sizeLimit;
+
+    if (sizeLimit == 0 || totalSize_ <= sizeLimit)
+    {
+        return;
+    }
+
+    NSString *namespace;
+
+    @synchronized(self)
+    {
+        namespace = namespace_;
+    }
+
+    // bitmaps from other namespaces were rendered for stylesheets or library versions no longer in use, so they go
+    // first, then the least recently used ones
+    NSArray *fileNames = [entries_ keysSortedByValueUsingComparator:^NSComparisonResult(PXDiskImageEntry *a, PXDiskImageEntry *b) {
+        return (a->lastUse_ < b->lastUse_) ? NSOrderedAscending : (a->lastUse_ > b->lastUse_) ? NSOrderedDescending : NSOrderedSame;
+    }];
+    NSPredicate *isStale = [NSPredicate predicateWithBlock:^BOOL(NSString *fileName, NSDictionary *bindings) {
+        return namespace == nil || ![fileName hasPrefix:namespace];
+    }];
+    NSMutableArray *candidates = [NSMutableArray arrayWithArray:[fileNames filteredArrayUsingPredicate:isStale]];
+
+    [candidates addObjectsFromArray:[fileNames filteredArrayUsingPredicate:[NSCompoundPredicate notPredicateWithSubpredicate:isStale]]];
+
+    for (NSString *fileName in candidates)
+    {
+        if (totalSize_ <= sizeLimit)
+        {
+            break;
+        }
+
+        PXDiskImageEntry *entry = [entries_ objectForKey:fileName];
+
+        [[NSFileManager defaultManager] removeItemAtPath:[_directory stringByAppendingPathComponent:fileName] error:NULL];
+        [entries_ removeObjectForKey:fileName];
+        totalSize_ -= entry->size_;
+
+        @synchronized(self)
+        {
+            evictionCount_++;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXImageCacheKey.h
+//  Pixate
+//
+
+#import <UIKit/UIKit.h>
+
+@class PXStylerContext;
+
+/**
+ *  A PXImageCacheKey describes everything a styler context's background rendering depends on: the shape kind, bounds,
+ *  fill paints, border, corner radii, inner shadows, padding, insets, screen scale, and opacity. Two contexts with equal
+ *  keys render identical bitmaps, regardless of the styleables, states, or declaration orders that produced them, so
+ *  the key is used to share one cached image between them.
+ *
+ *  Backgrounds with cap insets whose edges are uniform along the stretchable middle are keyed by a minimal 9-slice
+ *  source instead of by their bounds, so every size with the same insets shares that one source.
+ */
+@interface PXImageCacheKey : NSObject <NSCopying>
+
+/**
+ *  Indicates if this key identifies a 9-slice source rather than a full-size background
+ */
+@property (nonatomic, readonly, getter=isStretchable) BOOL stretchable;
+
+/**
+ *  The bounds to render the background into. This is the context's bounds, or the source bounds when stretchable
+ */
+@property (nonatomic, readonly) CGRect renderBounds;
+
+/**
+ *  A digest of this key that stays the same across launches, so it can name a persisted image, or nil if a part of the
+ *  key cannot be described independently of this process, like a shape without known geometry or an image paint. This
+ *  is computed on each call
+ */
+@property (nonatomic, readonly) NSString *persistentIdentifier;
+
+/**
+ *  Initialize a new instance for the background of the specified styler context. The context's bounds must already
+ *  be resolved
+ *
+ *  @param context The styler context whose background is being rendered
+ */
+- (id)initWithStylerContext:(PXStylerContext *)context;
+
+/**
+ *  Return a key for this key's 9-slice source once stretched to the specified size. Stretched images are not
+ *  stretchable themselves, and are never equal to a background rendered directly at that size
+ *
+ *  @param size The size the source is stretched to
+ */
+- (PXImageCacheKey *)keyForStretchedSize:(CGSize)size;
+
+@end
@@ -0,0 +1,316 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXImageCacheKey.m
+//  Pixate
+//
+
+#import "PXImageCacheKey.h"
+#import "PXStylerContext.h"
+#import "PXRectangle.h"
+#import "PXArrowRectangle.h"
+#import "PXEllipse.h"
+#import "PXSolidPaint.h"
+#import "PXPaintGroup.h"
+#import "PXShadowPaint.h"
+#import "PXFileUtils.h"
+
+static BOOL PXPaintIsUniform(id<PXPaint> paint)
+{
+    if (paint == nil || [paint isKindOfClass:[PXSolidPaint class]])
+    {
+        return YES;
+    }
+    else if ([paint isKindOfClass:[PXPaintGroup class]])
+    {
+        for (id<PXPaint> child in ((PXPaintGroup *) paint).paints)
+        {
+            if (!PXPaintIsUniform(child))
+            {
+                return NO;
+            }
+        }
+
+        return YES;
+    }
+
+    return NO;
+}
+
+@implementation PXImageCacheKey
+{
+    // shape kind, render bounds, paints, border, radii, shadows, padding, insets, scale, and opacity, in that order
+    NSArray *parts_;
+    NSUInteger hash_;
+}
+
+#pragma mark - Initializers
+
+- (id)initWithStylerContext:(PXStylerContext *)context
+{
+    if (self = [super init])
+    {
+        NSMutableArray *parts = [NSMutableArray arrayWithCapacity:16];
+        NSNull *none = [NSNull null];
+        PXShape *shape = context.shape;
+        PXBoxModel *boxModel = context.boxModel;
+        PXOffsets *padding = (context.padding.hasOffset) ? context.padding : nil;
+        UIEdgeInsets insets = context.insets;
+        BOOL isRectangle = ([shape class] == [PXRectangle class]);
+
+        _renderBounds = context.bounds;
+        _stretchable = [self isStretchableContext:context padding:padding];
+
+        if (_stretchable)
+        {
+            // the middle point is the only part of the source that is stretched, so it must be uniform
+            _renderBounds = CGRectMake(0.0f, 0.0f, insets.left + insets.right + 1.0f, insets.top + insets.bottom + 1.0f);
+        }
+
+        // shape kind. Shapes with no known geometry beyond their bounds are only equal to themselves
+        if (isRectangle || [shape class] == [PXEllipse class])
+        {
+            [parts addObject:NSStringFromClass([shape class])];
+        }
+        else if ([shape class] == [PXArrowRectangle class])
+        {
+            [parts addObject:[NSString stringWithFormat:@"PXArrowRectangle:%d", ((PXArrowRectangle *) shape).direction]];
+        }
+        else
+        {
+            [parts addObject:(shape) ? shape : none];
+        }
+
+        [parts addObject:NSStringFromCGRect(_renderBounds)];
+
+        // fill paints, in the order they are combined
+        [parts addObject:(context.fill) ? context.fill : none];
+        [parts addObject:(context.imageFill) ? context.imageFill : none];
+
+        // border, which is rendered from the top border only
+        if (boxModel.hasBorder)
+        {
+            [parts addObject:[NSNumber numberWithFloat:boxModel.borderTopWidth]];
+            [parts addObject:(boxModel.borderTopPaint) ? boxModel.borderTopPaint : none];
+        }
+        else
+        {
+            [parts addObject:none];
+            [parts addObject:none];
+        }
+
+        // corner radii only apply to rectangles
+        if ([shape isKindOfClass:[PXRectangle class]] && boxModel.hasCornerRadius)
+        {
+            [parts addObject:[NSString stringWithFormat:@"%@ %@ %@ %@",
+                              NSStringFromCGSize(boxModel.radiusTopLeft),
+                              NSStringFromCGSize(boxModel.radiusTopRight),
+                              NSStringFromCGSize(boxModel.radiusBottomRight),
+                              NSStringFromCGSize(boxModel.radiusBottomLeft)]];
+        }
+        else
+        {
+            [parts addObject:none];
+        }
+
+        // only inner shadows are rendered into the background
+        [parts addObject:(context.innerShadow.count > 0) ? context.innerShadow : none];
+
+        if (padding)
+        {
+            [parts addObject:[NSString stringWithFormat:@"%g %g %g %g", padding.top, padding.right, padding.bottom, padding.left]];
+        }
+        else
+        {
+            [parts addObject:none];
+        }
+
+        [parts addObject:NSStringFromUIEdgeInsets(insets)];
+        [parts addObject:[NSNumber numberWithFloat:[UIScreen mainScreen].scale]];
+        [parts addObject:[NSNumber numberWithBool:context.isOpaque]];
+
+        parts_ = parts;
+
+        for (id part in parts_)
+        {
+            hash_ = hash_ * 31 + [part hash];
+        }
+    }
+
+    return self;
+}
+
+- (id)initWithParts:(NSArray *)parts renderBounds:(CGRect)renderBounds
+{
+    if (self = [super init])
+    {
+        parts_ = parts;
+        _renderBounds = renderBounds;
+
+        for (id part in parts_)
+        {
+            hash_ = hash_ * 31 + [part hash];
+        }
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSString *)persistentIdentifier
+{
+    NSMutableArray *descriptions = [NSMutableArray arrayWithCapacity:parts_.count];
+    NSString *result = nil;
+
+    for (id part in parts_)
+    {
+        NSString *description = nil;
+
+        if ([part isKindOfClass:[NSString class]])
+        {
+            description = part;
+        }
+        else if ([part isKindOfClass:[NSNumber class]])
+        {
+            description = [part stringValue];
+        }
+        else if (part == [NSNull null])
+        {
+            description = @"-";
+        }
+        else if ([part conformsToProtocol:@protocol(PXPaint)] || [part conformsToProtocol:@protocol(PXShadowPaint)])
+        {
+            description = [part persistentDescription];
+        }
+
+        // shapes compared by identity, and paints that depend on external content, have no persistent form
+        if (description == nil)
+        {
+            descriptions = nil;
+            break;
+        }
+
+        [descriptions addObject:description];
+    }
+
+    if (descriptions != nil)
+    {
+        result = [PXFileUtils digestOfData:[[descriptions componentsJoinedByString:@"|"] dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+
+    return result;
+}
+
+#pragma mark - Methods
+
+- (PXImageCacheKey *)keyForStretchedSize:(CGSize)size
+{
+    CGRect bounds = CGRectMake(0.0f, 0.0f, size.width, size.height);
+    NSMutableArray *parts = [parts_ mutableCopy];
+
+    // the render bounds follow the shape kind
+    [parts replaceObjectAtIndex:1 withObject:NSStringFromCGRect(bounds)];
+    [parts addObject:@"stretched"];
+
+    return [[PXImageCacheKey alloc] initWithParts:parts renderBounds:bounds];
+}
+
+#pragma mark - Helpers
+
+- (BOOL)isStretchableContext:(PXStylerContext *)context padding:(PXOffsets *)padding
+{
+    UIEdgeInsets insets = context.insets;
+    CGSize size = context.bounds.size;
+    PXBoxModel *boxModel = context.boxModel;
+
+    if (UIEdgeInsetsEqualToEdgeInsets(insets, UIEdgeInsetsZero)
+        || [context.shape class] != [PXRectangle class]
+        || padding != nil
+        || context.imageFill != nil
+        || context.innerShadow.count > 0
+        || !PXPaintIsUniform(context.fill))
+    {
+        return NO;
+    }
+
+    // there is nothing to share unless the background is larger than its source
+    CGFloat sourceWidth = insets.left + insets.right + 1.0f;
+    CGFloat sourceHeight = insets.top + insets.bottom + 1.0f;
+
+    if (size.width < sourceWidth || size.height < sourceHeight || (size.width == sourceWidth && size.height == sourceHeight))
+    {
+        return NO;
+    }
+
+    // borders and corners have to fit within the caps, so they are never stretched
+    if (boxModel.hasBorder)
+    {
+        CGFloat width = boxModel.borderTopWidth;
+
+        if (!PXPaintIsUniform(boxModel.borderTopPaint)
+            || width > insets.top || width > insets.left || width > insets.bottom || width > insets.right)
+        {
+            return NO;
+        }
+    }
+
+    return
+        boxModel.radiusTopLeft.width <= insets.left && boxModel.radiusTopLeft.height <= insets.top
+    &&  boxModel.radiusTopRight.width <= insets.right && boxModel.radiusTopRight.height <= insets.top
+    &&  boxModel.radiusBottomRight.width <= insets.right && boxModel.radiusBottomRight.height <= insets.bottom
+    &&  boxModel.radiusBottomLeft.width <= insets.left && boxModel.radiusBottomLeft.height <= insets.bottom;
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // immutable
+    return self;
+}
+
+#pragma mark - Overrides
+
+- (NSUInteger)hash
+{
+    return hash_;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (object == self)
+    {
+        return YES;
+    }
+
+    if (![object isKindOfClass:[PXImageCacheKey class]])
+    {
+        return NO;
+    }
+
+    PXImageCacheKey *other = object;
+
+    return hash_ == other->hash_ && [parts_ isEqualToArray:other->parts_];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<PXImageCacheKey %@>", [parts_ componentsJoinedByString:@" "]];
+}
+
+@end
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXLRUCache.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  The priority class of a cache entry, in the order entries are evicted. Speculative entries have not been used yet
+ *  and become normal on their first hit. Pinned entries are only removed explicitly
+ */
+typedef enum
+{
+    PXCachePrioritySpeculative,
+    PXCachePriorityNormal,
+    PXCachePriorityPinned
+} PXCachePriority;
+
+/**
+ *  A PXLRUCache holds at most countLimit objects and totalCostLimit bytes and, when over either limit, evicts the least
+ *  recently used speculative object, then the least recently used normal one. Unlike NSCache, eviction is
+ *  deterministic, so a small set of hot entries is never dropped in favor of entries used only once. All methods are
+ *  thread-safe
+ */
+@interface PXLRUCache : NSObject
+
+/**
+ *  The maximum number of objects held, or zero for no limit. Lowering the limit evicts objects immediately
+ */
+@property (nonatomic) NSUInteger countLimit;
+
+/**
+ *  The maximum total cost of the objects held, or zero for no limit. Lowering the limit evicts objects immediately
+ */
+@property (nonatomic) NSUInteger totalCostLimit;
+
+/**
+ *  The number of objects currently held
+ */
+@property (readonly, nonatomic) NSUInteger count;
+
+/**
+ *  The total cost of the objects currently held
+ */
+@property (readonly, nonatomic) NSUInteger totalCost;
+
+/**
+ *  The number of lookups that found an object, the number that did not, and the number of objects evicted to stay
+ *  within a limit, since the counters were last reset
+ */
+@property (readonly, nonatomic) NSUInteger hitCount;
+@property (readonly, nonatomic) NSUInteger missCount;
+@property (readonly, nonatomic) NSUInteger evictionCount;
+
+/**
+ *  Initialize a new instance holding at most the specified number of objects
+ *
+ *  @param countLimit The maximum number of objects, or zero for no limit
+ */
+- (id)initWithCountLimit:(NSUInteger)countLimit;
+
+/**
+ *  Return the object for the specified key, marking it as the most recently used, or nil if there is none
+ *
+ *  @param key The key to look up
+ */
+- (id)objectForKey:(id<NSCopying>)key;
+
+/**
+ *  Add or replace the object for the specified key as a normal entry with no cost
+ *
+ *  @param object The object to store
+ *  @param key The key to store it under
+ */
+- (void)setObject:(id)object forKey:(id<NSCopying>)key;
+
+/**
+ *  Add or replace the object for the specified key, evicting objects if the cache is then over a limit
+ *
+ *  @param object The object to store
+ *  @param key The key to store it under
+ *  @param cost The cost of the object, typically its size in bytes
+ *  @param priority The priority class of the object
+ */
+- (void)setObject:(id)object forKey:(id<NSCopying>)key cost:(NSUInteger)cost priority:(PXCachePriority)priority;
+
+/**
+ *  Remove the object for the specified key
+ *
+ *  @param key The key to remove
+ */
+- (void)removeObjectForKey:(id<NSCopying>)key;
+
+/**
+ *  Remove all objects of the specified priority class
+ *
+ *  @param priority The priority class to remove
+ */
+- (void)removeObjectsWithPriority:(PXCachePriority)priority;
+
+/**
+ *  Remove all objects for which the specified block returns YES
+ *
+ *  @param predicate The block deciding which objects to remove
+ */
+- (void)removeObjectsPassingTest:(BOOL (^)(id key, id object))predicate;
+
+/**
+ *  Remove all objects
+ */
+- (void)removeAllObjects;
+
+/**
+ *  Reset the hit, miss, and eviction counters
+ */
+- (void)resetCounters;
+
+/**
+ *  Return a stamp for the last use of the least recently used object of the specified priority class, or UINT64_MAX
+ *  if there is none. Stamps increase across all caches, so they order uses in different caches
+ *
+ *  @param priority The priority class to inspect
+ */
+- (uint64_t)leastRecentUseOfPriority:(PXCachePriority)priority;
+
+/**
+ *  Evict the least recently used object of the specified priority class, returning NO if there is none
+ *
+ *  @param priority The priority class to evict from
+ */
+- (BOOL)evictLeastRecentlyUsedObjectOfPriority:(PXCachePriority)priority;
+
+@end
@@ -0,0 +1,434 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXLRUCache.m
+//  Pixate
+//
+
+#import "PXLRUCache.h"
+
+// the number of priority classes, each of which has its own recency list
+#define PX_CACHE_PRIORITY_COUNT 3
+
+// shared by all caches, so stamps from different caches can be compared
+static uint64_t USE_STAMP = 0;
+
+/**
+ *  A node in a recency list. Nodes are owned by the key map and by their predecessor
+ */
+@interface PXLRUCacheEntry : NSObject
+{
+@public
+    id<NSCopying> key_;
+    id object_;
+    NSUInteger cost_;
+    PXCachePriority priority_;
+    uint64_t stamp_;
+    PXLRUCacheEntry *next_;
+    __unsafe_unretained PXLRUCacheEntry *previous_;
+}
+@end
+
+@implementation PXLRUCacheEntry
+@end
+
+@implementation PXLRUCache
+{
+    NSMutableDictionary *entries_;
+    PXLRUCacheEntry *heads_[PX_CACHE_PRIORITY_COUNT];                       // most recently used, per priority
+    __unsafe_unretained PXLRUCacheEntry *tails_[PX_CACHE_PRIORITY_COUNT];   // least recently used, per priority
+    NSUInteger countLimit_;
+    NSUInteger totalCostLimit_;
+    NSUInteger totalCost_;
+    NSUInteger hitCount_;
+    NSUInteger missCount_;
+    NSUInteger evictionCount_;
+}
+
+#pragma mark - Initializers
+
+- (id)init
+{
+    return [self initWithCountLimit:0];
+}
+
+- (id)initWithCountLimit:(NSUInteger)countLimit
+{
+    if (self = [super init])
+    {
+        entries_ = [[NSMutableDictionary alloc] init];
+        countLimit_ = countLimit;
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSUInteger)countLimit
+{
+    @synchronized(self)
+    {
+        return countLimit_;
+    }
+}
+
+- (NSUInteger)totalCostLimit
+{
+    @synchronized(self)
+    {
+        return totalCostLimit_;
+    }
+}
+
+- (NSUInteger)count
+{
+    @synchronized(self)
+    {
+        return entries_.count;
+    }
+}
+
+- (NSUInteger)totalCost
+{
+    @synchronized(self)
+    {
+        return totalCost_;
+    }
+}
+
+- (NSUInteger)hitCount
+{
+    @synchronized(self)
+    {
+        return hitCount_;
+    }
+}
+
+- (NSUInteger)missCount
+{
+    @synchronized(self)
+    {
+        return missCount_;
+    }
+}
+
+- (NSUInteger)evictionCount
+{
+    @synchronized(self)
+    {
+        return evictionCount_;
+    }
+}
+
+#pragma mark - Setters
+
+- (void)setCountLimit:(NSUInteger)countLimit
+{
+    @synchronized(self)
+    {
+        countLimit_ = countLimit;
+
+        [self evictToLimits];
+    }
+}
+
+- (void)setTotalCostLimit:(NSUInteger)totalCostLimit
+{
+    @synchronized(self)
+    {
+        totalCostLimit_ = totalCostLimit;
+
+        [self evictToLimits];
+    }
+}
+
+#pragma mark - Methods
+
+- (id)objectForKey:(id<NSCopying>)key
+{
+    if (key == nil)
+    {
+        return nil;
+    }
+
+    @synchronized(self)
+    {
+        PXLRUCacheEntry *entry = [entries_ objectForKey:key];
+
+        if (entry == nil)
+        {
+            missCount_++;
+            return nil;
+        }
+
+        hitCount_++;
+
+        [self unlinkEntry:entry];
+
+        // a speculative entry has proven to be useful
+        if (entry->priority_ == PXCachePrioritySpeculative)
+        {
+            entry->priority_ = PXCachePriorityNormal;
+        }
+
+        [self linkEntryAtHead:entry];
+
+        return entry->object_;
+    }
+}
+
+- (void)setObject:(id)object forKey:(id<NSCopying>)key
+{
+    [self setObject:object forKey:key cost:0 priority:PXCachePriorityNormal];
+}
+
+- (void)setObject:(id)object forKey:(id<NSCopying>)key cost:(NSUInteger)cost priority:(PXCachePriority)priority
+{
+    if (key == nil)
+    {
+        return;
+    }
+
+    if (object == nil)
+    {
+        [self removeObjectForKey:key];
+        return;
+    }
+
+    @synchronized(self)
+    {
+        PXLRUCacheEntry *entry = [entries_ objectForKey:key];
+
+        if (entry != nil)
+        {
+            [self unlinkEntry:entry];
+            totalCost_ -= entry->cost_;
+        }
+        else
+        {
+            entry = [[PXLRUCacheEntry alloc] init];
+            entry->key_ = [(id) key copyWithZone:NULL];
+
+            [entries_ setObject:entry forKey:entry->key_];
+        }
+
+        entry->object_ = object;
+        entry->cost_ = cost;
+        entry->priority_ = priority;
+        totalCost_ += cost;
+
+        [self linkEntryAtHead:entry];
+        [self evictToLimits];
+    }
+}
+
+- (void)removeObjectForKey:(id<NSCopying>)key
+{
+    if (key == nil)
+    {
+        return;
+    }
+
+    @synchronized(self)
+    {
+        PXLRUCacheEntry *entry = [entries_ objectForKey:key];
+
+        if (entry != nil)
+        {
+            [self removeEntry:entry];
+        }
+    }
+}
+
+- (void)removeObjectsWithPriority:(PXCachePriority)priority
+{
+    @synchronized(self)
+    {
+        while (tails_[priority] != nil)
+        {
+            [self removeEntry:tails_[priority]];
+        }
+    }
+}
+
+- (void)removeObjectsPassingTest:(BOOL (^)(id key, id object))predicate
+{
+    if (predicate == nil)
+    {
+        return;
+    }
+
+    @synchronized(self)
+    {
+        for (PXLRUCacheEntry *entry in [entries_ allValues])
+        {
+            if (predicate(entry->key_, entry->object_))
+            {
+                [self removeEntry:entry];
+            }
+        }
+    }
+}
+
+- (void)removeAllObjects
+{
+    @synchronized(self)
+    {
+        // break the lists iteratively so a long chain of strong next pointers is not released recursively
+        for (NSUInteger i = 0; i < PX_CACHE_PRIORITY_COUNT; i++)
+        {
+            while (heads_[i] != nil)
+            {
+                PXLRUCacheEntry *next = heads_[i]->next_;
+
+                heads_[i]->next_ = nil;
+                heads_[i] = next;
+            }
+
+            tails_[i] = nil;
+        }
+
+        totalCost_ = 0;
+        [entries_ removeAllObjects];
+    }
+}
+
+- (void)resetCounters
+{
+    @synchronized(self)
+    {
+        hitCount_ = 0;
+        missCount_ = 0;
+        evictionCount_ = 0;
+    }
+}
+
+- (uint64_t)leastRecentUseOfPriority:(PXCachePriority)priority
+{
+    @synchronized(self)
+    {
+        return (tails_[priority] != nil) ? tails_[priority]->stamp_ : UINT64_MAX;
+    }
+}
+
+- (BOOL)evictLeastRecentlyUsedObjectOfPriority:(PXCachePriority)priority
+{
+    @synchronized(self)
+    {
+        PXLRUCacheEntry *entry = tails_[priority];
+
+        if (entry == nil)
+        {
+            return NO;
+        }
+
+        [self removeEntry:entry];
+        evictionCount_++;
+
+        return YES;
+    }
+}
+
+#pragma mark - Private Methods
+
+- (BOOL)isOverLimits
+{
+    return (countLimit_ > 0 && entries_.count > countLimit_) || (totalCostLimit_ > 0 && totalCost_ > totalCostLimit_);
+}
+
+- (void)evictToLimits
+{
+    while ([self isOverLimits])
+    {
+        // pinned entries are never evicted, so the cache may stay over its limits
+        PXLRUCacheEntry *entry = (tails_[PXCachePrioritySpeculative] != nil)
+            ?   tails_[PXCachePrioritySpeculative]
+            :   tails_[PXCachePriorityNormal];
+
+        if (entry == nil)
+        {
+            break;
+        }
+
+        [self removeEntry:entry];
+        evictionCount_++;
+    }
+}
+
+- (void)removeEntry:(PXLRUCacheEntry *)entry
+{
+    // keep the entry alive until it is out of the map and the list
+    PXLRUCacheEntry *retained = entry;
+
+    [self unlinkEntry:retained];
+    [entries_ removeObjectForKey:retained->key_];
+    totalCost_ -= retained->cost_;
+}
+
+- (void)linkEntryAtHead:(PXLRUCacheEntry *)entry
+{
+    PXCachePriority priority = entry->priority_;
+
+    entry->stamp_ = __atomic_add_fetch(&USE_STAMP, 1, __ATOMIC_RELAXED);
+    entry->previous_ = nil;
+    entry->next_ = heads_[priority];
+
+    if (heads_[priority] != nil)
+    {
+        heads_[priority]->previous_ = entry;
+    }
+
+    heads_[priority] = entry;
+
+    if (tails_[priority] == nil)
+    {
+        tails_[priority] = entry;
+    }
+}
+
+- (void)unlinkEntry:(PXLRUCacheEntry *)entry
+{
+    // keep the entry alive while the links that own it are rewritten
+    PXLRUCacheEntry *retained = entry;
+    PXCachePriority priority = retained->priority_;
+    PXLRUCacheEntry *previous = retained->previous_;
+    PXLRUCacheEntry *next = retained->next_;
+
+    if (previous != nil)
+    {
+        previous->next_ = next;
+    }
+    else
+    {
+        heads_[priority] = next;
+    }
+
+    if (next != nil)
+    {
+        next->previous_ = previous;
+    }
+    else
+    {
+        tails_[priority] = previous;
+    }
+
+    retained->next_ = nil;
+    retained->previous_ = nil;
+}
+
+@end
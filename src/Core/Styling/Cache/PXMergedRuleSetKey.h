@@ -0,0 +1,37 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXMergedRuleSetKey.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  A PXMergedRuleSetKey identifies an ordered list of rule sets by the identity of its members. Merging depends only
+ *  on the rule sets and their order, so equal keys share one merged rule set. The rule sets are retained, so a key
+ *  never matches a later list whose rule sets happen to reuse the same addresses.
+ */
+@interface PXMergedRuleSetKey : NSObject <NSCopying>
+
+/**
+ *  Initialize a new instance for the specified rule sets
+ *
+ *  @param ruleSets The rule sets, in the order they are merged
+ */
+- (id)initWithRuleSets:(NSArray *)ruleSets;
+
+@end
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXMergedRuleSetKey.m
+//  Pixate
+//
+
+#import "PXMergedRuleSetKey.h"
+
+@implementation PXMergedRuleSetKey
+{
+    NSArray *ruleSets_;
+    NSUInteger hash_;
+}
+
+#pragma mark - Initializers
+
+- (id)initWithRuleSets:(NSArray *)ruleSets
+{
+    if (self = [super init])
+    {
+        ruleSets_ = [ruleSets copy];
+
+        // NSArray only hashes its count, so the members' addresses are combined instead
+        for (id ruleSet in ruleSets_)
+        {
+            hash_ = hash_ * 31 + (uintptr_t) ruleSet;
+        }
+    }
+
+    return self;
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // immutable
+    return self;
+}
+
+#pragma mark - Overrides
+
+- (NSUInteger)hash
+{
+    return hash_;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (object == self)
+    {
+        return YES;
+    }
+
+    if (![object isKindOfClass:[PXMergedRuleSetKey class]])
+    {
+        return NO;
+    }
+
+    PXMergedRuleSetKey *other = object;
+    NSUInteger count = ruleSets_.count;
+
+    if (hash_ != other->hash_ || count != other->ruleSets_.count)
+    {
+        return NO;
+    }
+
+    // rule sets are compared by identity
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        if ([ruleSets_ objectAtIndex:i] != [other->ruleSets_ objectAtIndex:i])
+        {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<PXMergedRuleSetKey %lu rule sets>", (unsigned long) ruleSets_.count];
+}
+
+@end
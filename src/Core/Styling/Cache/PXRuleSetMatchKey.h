@@ -0,0 +1,40 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXRuleSetMatchKey.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStyleable.h"
+
+/**
+ *  A PXRuleSetMatchKey identifies everything cacheable selector programs can observe about a styleable: the class,
+ *  style key, and namespace of the styleable and of each of its ancestors. Two styleables with equal keys match the
+ *  same cacheable rule sets of the same stylesheets, so the key is used to share match results between them.
+ */
+@interface PXRuleSetMatchKey : NSObject <NSCopying>
+
+/**
+ *  Initialize a new instance for the specified styleable and stylesheets. The stylesheets are compared by identity so
+ *  that results computed against replaced stylesheets are never returned
+ *
+ *  @param styleable The styleable being matched
+ *  @param stylesheets The stylesheets being matched against, with NSNull in place of missing stylesheets
+ */
+- (id)initWithStyleable:(id<PXStyleable>)styleable stylesheets:(NSArray *)stylesheets;
+
+@end
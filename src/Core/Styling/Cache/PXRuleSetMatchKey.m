@@ -0,0 +1,145 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXRuleSetMatchKey.m
+//  Pixate
+//
+
+#import "PXRuleSetMatchKey.h"
+#import "PXStyleableAtoms.h"
+
+// enough words for the stylesheets and a dozen ancestors without growing
+#define PX_MATCH_KEY_INITIAL_WORDS 32
+
+@implementation PXRuleSetMatchKey
+{
+    // stylesheet pointers followed by the class of the styleable and of each ancestor
+    uintptr_t *words_;
+    NSUInteger wordCount_;
+
+    // the style key and namespace of the styleable and of each ancestor
+    NSArray *strings_;
+    NSUInteger hash_;
+}
+
+#pragma mark - Initializers
+
+- (id)initWithStyleable:(id<PXStyleable>)styleable stylesheets:(NSArray *)stylesheets
+{
+    if (self = [super init])
+    {
+        NSUInteger capacity = MAX(stylesheets.count + 8, (NSUInteger) PX_MATCH_KEY_INITIAL_WORDS);
+        NSMutableArray *strings = [NSMutableArray arrayWithCapacity:16];
+        NSNull *none = [NSNull null];
+
+        words_ = malloc(capacity * sizeof(uintptr_t));
+
+        for (id stylesheet in stylesheets)
+        {
+            words_[wordCount_++] = (uintptr_t) stylesheet;
+            hash_ = hash_ * 31 + (uintptr_t) stylesheet;
+        }
+
+        for (id current = styleable; [current conformsToProtocol:@protocol(PXStyleable)]; current = ((id<PXStyleable>) current).pxStyleParent)
+        {
+            id<PXStyleable> node = current;
+            NSString *namespaceURI = ([node respondsToSelector:@selector(pxStyleNamespace)]) ? node.pxStyleNamespace : nil;
+            NSString *styleKey = nil;
+            NSUInteger styleKeyHash = 0;
+
+            // styleables that cache their atoms also cache the style key and its hash, so no string is built or hashed
+            if ([node respondsToSelector:@selector(pxStyleAtoms)])
+            {
+                PXStyleableAtoms *atoms = node.pxStyleAtoms;
+
+                styleKey = atoms.styleKey;
+                styleKeyHash = atoms.styleKeyHash;
+            }
+            else
+            {
+                styleKey = node.styleKey;
+                styleKeyHash = styleKey.hash;
+            }
+
+            if (wordCount_ == capacity)
+            {
+                capacity *= 2;
+                words_ = realloc(words_, capacity * sizeof(uintptr_t));
+            }
+
+            words_[wordCount_++] = (uintptr_t) [node class];
+
+            [strings addObject:(styleKey) ? styleKey : none];
+            [strings addObject:(namespaceURI) ? namespaceURI : none];
+
+            hash_ = hash_ * 31 + (uintptr_t) [node class];
+            hash_ = hash_ * 31 + styleKeyHash;
+            hash_ = hash_ * 31 + namespaceURI.hash;
+        }
+
+        strings_ = strings;
+    }
+
+    return self;
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // immutable
+    return self;
+}
+
+#pragma mark - Overrides
+
+- (NSUInteger)hash
+{
+    return hash_;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (object == self)
+    {
+        return YES;
+    }
+
+    if (![object isKindOfClass:[PXRuleSetMatchKey class]])
+    {
+        return NO;
+    }
+
+    PXRuleSetMatchKey *other = object;
+
+    // cached style keys are usually the same instances, so the strings compare by pointer first
+    return hash_ == other->hash_
+        && wordCount_ == other->wordCount_
+        && memcmp(words_, other->words_, wordCount_ * sizeof(uintptr_t)) == 0
+        && [strings_ isEqualToArray:other->strings_];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<PXRuleSetMatchKey %@>", [strings_ componentsJoinedByString:@" "]];
+}
+
+- (void)dealloc
+{
+    free(words_);
+}
+
+@end
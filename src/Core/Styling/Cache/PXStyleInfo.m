@@ -31,11 +31,92 @@
 #import "PXStyler.h"
 #import "NSObject+PXStyling.h"
 #import "PXPseudoClassFunction.h"
+#import "PXAtomDictionary.h"
+
+/**
+ *  A PXStyleDispatchPlan lists, in styler order, each active styler of a state along with the declarations it
+ *  processes. Plans depend on the stylers of the styleable they were built for, so they record that styleable's class
+ *  and stylers array to detect when they need to be rebuilt.
+ */
+@interface PXStyleDispatchPlan : NSObject
+@property (nonatomic, readonly) Class styleableClass;
+@property (nonatomic, readonly, strong) NSArray *viewStylers;
+@property (nonatomic, readonly, strong) NSArray *stylers;
+@property (nonatomic, readonly, strong) NSArray *declarationLists;
+@property (nonatomic, readonly, strong) PXRuleSet *ruleSet;
+@property (nonatomic, readonly) PXAtom stateAtom;
+@property (nonatomic, readonly) NSUInteger declarationsHash;
+- (id)initWithStyleable:(id<PXStyleable>)styleable
+                  state:(NSString *)stateName
+            viewStylers:(NSArray *)viewStylers
+      stylersByProperty:(PXAtomDictionary *)stylersByProperty
+           declarations:(NSArray *)declarations
+          activeStylers:(NSSet *)activeStylers;
+@end
+
+@implementation PXStyleDispatchPlan
+
+- (id)initWithStyleable:(id<PXStyleable>)styleable
+                  state:(NSString *)stateName
+            viewStylers:(NSArray *)viewStylers
+      stylersByProperty:(PXAtomDictionary *)stylersByProperty
+           declarations:(NSArray *)declarations
+          activeStylers:(NSSet *)activeStylers
+{
+    if (self = [super init])
+    {
+        NSMutableArray *stylers = [NSMutableArray array];
+        NSMutableArray *declarationLists = [NSMutableArray array];
+
+        _styleableClass = [styleable class];
+        _viewStylers = viewStylers;
+        _stateAtom = [PXAtomTable atomForString:stateName];
+        _declarationsHash = [PXStyleUtils hashValueForDeclarations:declarations];
+
+        for (id<PXStyler> currentStyler in viewStylers)
+        {
+            if ([activeStylers containsObject:NSStringFromClass(currentStyler.class)])
+            {
+                NSMutableArray *declarationList = [NSMutableArray array];
+
+                for (PXDeclaration *declaration in declarations)
+                {
+                    if ([stylersByProperty objectForAtom:declaration.nameAtom] == currentStyler)
+                    {
+                        [declarationList addObject:declaration];
+                    }
+                }
+
+                [stylers addObject:currentStyler];
+                [declarationLists addObject:declarationList];
+            }
+        }
+
+        _stylers = stylers;
+        _declarationLists = declarationLists;
+
+        // see if there's a catch-all 'updateStyleWithRuleSet:context:' method to call
+        if ([styleable respondsToSelector:@selector(updateStyleWithRuleSet:context:)])
+        {
+            _ruleSet = [[PXRuleSet alloc] init];
+
+            for (PXDeclaration *declaration in declarations)
+            {
+                [_ruleSet addDeclaration:declaration];
+            }
+        }
+    }
+
+    return self;
+}
+
+@end
 
 @implementation PXStyleInfo
 {
     NSMutableDictionary *declarationsByState_;
     NSMutableDictionary *stylersByState_;
+    NSMutableDictionary *dispatchPlansByState_;
 }
 
 #pragma mark - Static Methods
@@ -143,13 +224,13 @@
 + (void)setStyleInfo:(PXStyleInfo *)styleInfo withRuleSets:(NSArray *)ruleSets styleable:(id<PXStyleable>)styleable stateName:(NSString *)stateName
 {
     // merge all rule sets into a single rule set based on origin and weight/specificity
-    PXRuleSet *mergedRuleSet = [PXRuleSet ruleSetWithMergedRuleSets:ruleSets];
+    PXRuleSet *mergedRuleSet = [PXStyleUtils mergedRuleSetForRuleSets:ruleSets];
 
     NSArray *stylers = ([styleable respondsToSelector:@selector(viewStylers)])
         ? ((NSObject *)styleable).viewStylers
         : nil;
-    NSDictionary *stylersByProperty = ([styleable respondsToSelector:@selector(viewStylersByProperty)])
-        ? ((NSObject *)styleable).viewStylersByProperty
+    PXAtomDictionary *stylersByProperty = ([styleable respondsToSelector:@selector(viewStylersByProperty)])
+        ? [PXAtomDictionary atomDictionaryForDictionary:((NSObject *)styleable).viewStylersByProperty]
         : nil;
 
     // build a set of stylers that are active based on the property names we have in the merged rule set
@@ -161,7 +242,7 @@
 
     for (PXDeclaration *declaration in mergedRuleSet.declarations)
     {
-        id<PXStyler> styler = [stylersByProperty objectForKey:declaration.name];
+        id<PXStyler> styler = [stylersByProperty objectForAtom:declaration.nameAtom];
 
         if (styler)
         {
@@ -215,6 +296,7 @@
         // TODO: check for pre-existing?
 
         [declarationsByState_ setObject:declarations forKey:stateName];
+        [dispatchPlansByState_ removeObjectForKey:stateName];
     }
 }
 
@@ -228,6 +310,7 @@
         }
 
         [stylersByState_ setObject:stylers forKey:stateName];
+        [dispatchPlansByState_ removeObjectForKey:stateName];
     }
 }
 
@@ -241,6 +324,36 @@
     return (stylersByState_ != nil) ? [stylersByState_ objectForKey:stateName] : nil;
 }
 
+- (PXStyleDispatchPlan *)dispatchPlanForState:(NSString *)stateName
+                                    styleable:(id<PXStyleable>)styleable
+                                  viewStylers:(NSArray *)viewStylers
+{
+    PXStyleDispatchPlan *plan = [dispatchPlansByState_ objectForKey:stateName];
+
+    if (plan == nil || plan.styleableClass != [styleable class] || plan.viewStylers != viewStylers)
+    {
+        PXAtomDictionary *stylersByProperty = ([styleable respondsToSelector:@selector(viewStylersByProperty)])
+            ? [PXAtomDictionary atomDictionaryForDictionary:((NSObject *)styleable).viewStylersByProperty]
+            : nil;
+
+        plan = [[PXStyleDispatchPlan alloc] initWithStyleable:styleable
+                                                        state:stateName
+                                                  viewStylers:viewStylers
+                                            stylersByProperty:stylersByProperty
+                                                 declarations:[self declarationsForState:stateName]
+                                                activeStylers:[self stylersForState:stateName]];
+
+        if (dispatchPlansByState_ == nil)
+        {
+            dispatchPlansByState_ = [NSMutableDictionary dictionary];
+        }
+
+        [dispatchPlansByState_ setObject:plan forKey:stateName];
+    }
+
+    return plan;
+}
+
 - (void)applyToStyleable:(id<PXStyleable>)styleable
 {
     // abort application of style info if the styleable's style key does not match the info's style key
@@ -253,9 +366,6 @@
     NSArray *stylers = ([styleable respondsToSelector:@selector(viewStylers)])
         ? ((NSObject *)styleable).viewStylers
         : nil;
-    NSDictionary *stylersByProperty = ([styleable respondsToSelector:@selector(viewStylersByProperty)])
-        ? ((NSObject *)styleable).viewStylersByProperty
-        : nil;
 
     for (NSString *stateName in self.states)
     {
@@ -268,62 +378,52 @@
             continue;
         }
 
-        NSArray *activeDeclarations = [self declarationsForState:stateName];
+        PXStyleDispatchPlan *plan = [self dispatchPlanForState:stateName
+                                                     styleable:styleable
+                                                   viewStylers:stylers];
 
         if (self.forceInvalidation)
         {
             [PXStyleUtils invalidateStyleable:styleable];
         }
 
-        if (![PXStyleUtils stylesOfStyleable:styleable matchDeclarations:activeDeclarations state:stateName])
+        if (![PXStyleUtils stylesOfStyleable:styleable matchDeclarationsHash:plan.declarationsHash stateAtom:plan.stateAtom])
         {
-            NSSet *activeStylers = [self stylersForState:stateName];
+            NSArray *planStylers = plan.stylers;
+            NSArray *declarationLists = plan.declarationLists;
 
             // create context and store styleable and state name there
             PXStylerContext *context = [[PXStylerContext alloc] init];
 
             context.styleable = styleable;
             context.activeStateName = stateName;
-            context.styleHash = [PXStyleUtils hashValueForStyleable:styleable state:stateName];
+            context.styleHash = [PXStyleUtils hashValueForStyleable:styleable stateAtom:plan.stateAtom];
 
             // process declarations in styler order
-            for (id<PXStyler> currentStyler in stylers)
+            for (NSUInteger i = 0; i < planStylers.count; i++)
             {
-                if ([activeStylers containsObject:NSStringFromClass(currentStyler.class)])
-                {
-                    // process the declarations, in order
-                    for (PXDeclaration *declaration in activeDeclarations)
-                    {
-                        id<PXStyler> styler = [stylersByProperty objectForKey:declaration.name];
-
-                        if (styler == currentStyler)
-                        {
-                            [styler processDeclaration:declaration withContext:context];
-                        }
-                    }
+                id<PXStyler> currentStyler = [planStylers objectAtIndex:i];
 
-                    // apply styler completion block
-                    [currentStyler applyStylesWithContext:context];
+                // process the declarations, in order
+                for (PXDeclaration *declaration in [declarationLists objectAtIndex:i])
+                {
+                    [currentStyler processDeclaration:declaration withContext:context];
                 }
+
+                // apply styler completion block
+                [currentStyler applyStylesWithContext:context];
             }
 
-            // see if there's a catch-all 'updateStyleWithRuleSet:context:' method to call
-            if ([styleable respondsToSelector:@selector(updateStyleWithRuleSet:context:)])
+            // call the catch-all 'updateStyleWithRuleSet:context:' method, if the styleable has one
+            if (plan.ruleSet != nil)
             {
-                PXRuleSet *ruleSet = [[PXRuleSet alloc] init];
-
-                for (PXDeclaration *declaration in activeDeclarations)
-                {
-                    [ruleSet addDeclaration:declaration];
-                }
-
-                [(NSObject *)styleable updateStyleWithRuleSet:ruleSet context:context];
+                [(NSObject *)styleable updateStyleWithRuleSet:plan.ruleSet context:context];
             }
             
             // If the frame of the view has potentially changed, let's recompute the style hash
             if([context propertyValueForName:@"frame"])
             {
-                [PXStyleUtils stylesOfStyleable:styleable matchDeclarations:activeDeclarations state:stateName];
+                [PXStyleUtils stylesOfStyleable:styleable matchDeclarationsHash:plan.declarationsHash stateAtom:plan.stateAtom];
             }
         }
     }
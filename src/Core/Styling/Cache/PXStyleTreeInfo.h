@@ -30,6 +30,18 @@
 @property (nonatomic, readonly) NSString *styleKey;
 @property (nonatomic, readonly) BOOL cached;
 
+/**
+ *  The PXStyleableAtoms of the styleable and of each of its descendants, used to decide if a stylesheet change could
+ *  affect this info
+ */
+@property (nonatomic, readonly) NSArray *styleableAtoms;
+
+/**
+ *  An estimate of the memory held by this info, in bytes. Declarations are shared with their stylesheets, so they are
+ *  only counted as references
+ */
+@property (nonatomic, readonly) NSUInteger cost;
+
 - (id)initWithStyleable:(id<PXStyleable>)styleable;
 
 - (void)applyStylesToStyleable:(id<PXStyleable>)styleable;
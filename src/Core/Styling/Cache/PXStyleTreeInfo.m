@@ -25,6 +25,13 @@
 #import "PXStyleTreeInfo.h"
 #import "PXStyleInfo.h"
 #import "PXStyleUtils.h"
+#import "PXStyleableAtoms.h"
+
+// rough sizes of a style info with its state tables, of a styleable's atoms, and of a reference to a shared
+// declaration or styler
+static const NSUInteger STYLE_INFO_COST = 256;
+static const NSUInteger ATOMS_COST = 64;
+static const NSUInteger REFERENCE_COST = 16;
 
 @implementation PXStyleTreeInfo
 {
@@ -33,6 +40,7 @@
     NSMutableDictionary *childStyleInfo_;           // keyed by NSIndexPath
 //    NSMutableDictionary *pseudoElementStyleInfo_;   // keyed by NSIndexPath
     NSUInteger descendantCount_;
+    NSMutableArray *styleableAtoms_;
 }
 
 #pragma mark - Initializers
@@ -47,8 +55,19 @@
         _cached = !checkPseudoClassFunction.boolValue;
         styleableStyleInfo_.forceInvalidation = YES;
         childStyleInfo_ = [NSMutableDictionary dictionary];
+        styleableAtoms_ = [NSMutableArray array];
 
+        [self addStyleableAtomsForStyleable:styleable];
         [self collectChildStyleInfoForStyleable:styleable];
+
+        _cost = [self costOfStyleInfo:styleableStyleInfo_];
+
+        for (PXStyleInfo *styleInfo in childStyleInfo_.objectEnumerator)
+        {
+            _cost += [self costOfStyleInfo:styleInfo];
+        }
+
+        _cost += styleableAtoms_.count * ATOMS_COST;
     }
 
     return self;
@@ -61,6 +80,11 @@
     return styleKey_;
 }
 
+- (NSArray *)styleableAtoms
+{
+    return styleableAtoms_;
+}
+
 #pragma mark - Methods
 
 - (void)applyStylesToStyleable:(id<PXStyleable>)styleable
@@ -110,6 +134,23 @@
     return result;
 }
 
+- (NSUInteger)costOfStyleInfo:(PXStyleInfo *)styleInfo
+{
+    NSUInteger result = 0;
+
+    if (styleInfo != nil)
+    {
+        result = STYLE_INFO_COST;
+
+        for (NSString *state in styleInfo.states)
+        {
+            result += ([styleInfo declarationsForState:state].count + [styleInfo stylersForState:state].count) * REFERENCE_COST;
+        }
+    }
+
+    return result;
+}
+
 - (void)collectChildStyleInfoForStyleable:(id<PXStyleable>)styleable
 {
     NSUInteger index = 0;
@@ -125,8 +166,23 @@
     }
 }
 
+- (void)addStyleableAtomsForStyleable:(id<PXStyleable>)styleable
+{
+    // intern the strings: a stylesheet loaded later may mention classes that no stylesheet mentions now
+    PXStyleableAtoms *atoms = ([styleable respondsToSelector:@selector(pxStyleAtoms)])
+        ? styleable.pxStyleAtoms
+        : [[PXStyleableAtoms alloc] initWithElementName:styleable.pxStyleElementName
+                                                styleId:styleable.styleId
+                                           styleClasses:styleable.styleClasses
+                                                 intern:YES];
+
+    [styleableAtoms_ addObject:atoms];
+}
+
 - (void)setChildStyleInfoForStyleable:(id<PXStyleable>)styleable withIndexPath:(NSIndexPath *)indexPath
 {
+    [self addStyleableAtomsForStyleable:styleable];
+
     // get style info for this child
     PXStyleInfo *styleInfo = [PXStyleInfo styleInfoForStyleable:styleable];
 
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+
+//
+//  PXStylesheetDiff.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStyleable.h"
+
+@class PXStylesheet;
+@class PXStyleableAtoms;
+
+/**
+ *  A PXStylesheetDiff describes the rule sets that changed when one stylesheet replaced another. Rule sets are compared
+ *  by their source, including their media query, after trimming the run of identical rule sets at the start and end of
+ *  both stylesheets. Everything between those runs is treated as changed, so reordered rule sets are included. The
+ *  diff answers whether a styleable could be matched by any changed rule set, which lets callers discard and restyle
+ *  only what a small edit touches.
+ */
+@interface PXStylesheetDiff : NSObject
+
+/**
+ *  The rule sets that were removed from the old stylesheet or added to the new one
+ */
+@property (nonatomic, readonly, strong) NSArray *changedRuleSets;
+
+/**
+ *  A flag indicating that the change cannot be narrowed to specific styleables. This is set when either stylesheet is
+ *  missing, when namespaces, keyframes, or font faces differ, or when a changed rule set does not end in a type
+ *  selector
+ */
+@property (nonatomic, readonly) BOOL affectsAll;
+
+/**
+ *  A flag indicating that at least one styleable may be affected
+ */
+@property (nonatomic, readonly) BOOL hasChanges;
+
+/**
+ *  Compare the two stylesheets
+ *
+ *  @param oldStylesheet The stylesheet being replaced. This may be nil
+ *  @param newStylesheet The replacement stylesheet. This may be nil
+ */
++ (PXStylesheetDiff *)diffFromStylesheet:(PXStylesheet *)oldStylesheet toStylesheet:(PXStylesheet *)newStylesheet;
+
+/**
+ *  Determine if a styleable with the specified atoms could be matched by a changed rule set. Only the element name,
+ *  id, and classes required by each changed rule set's target type selector are checked, so this may return YES for
+ *  styleables the rule sets do not actually match
+ *
+ *  @param atoms The styleable's atoms. Classes must have been interned for the result to be reliable
+ */
+- (BOOL)affectsStyleableAtoms:(PXStyleableAtoms *)atoms;
+
+/**
+ *  Determine if any of the specified atoms could be matched by a changed rule set
+ *
+ *  @param atomsArray An array of PXStyleableAtoms
+ */
+- (BOOL)affectsAnyStyleableAtoms:(NSArray *)atomsArray;
+
+/**
+ *  Determine if the specified styleable could be matched by a changed rule set
+ *
+ *  @param styleable The styleable to test
+ */
+- (BOOL)affectsStyleable:(id<PXStyleable>)styleable;
+
+@end
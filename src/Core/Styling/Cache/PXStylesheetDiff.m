@@ -0,0 +1,234 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+
+//
+//  PXStylesheetDiff.m
+//  Pixate
+//
+
+#import "PXStylesheetDiff.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXMediaGroup.h"
+#import "PXRuleSet.h"
+#import "PXTypeSelector.h"
+#import "PXCombinator.h"
+#import "PXStyleableAtoms.h"
+
+@implementation PXStylesheetDiff
+{
+    // one PXStyleableAtoms per target type selector, holding the name, id, and classes a styleable must have
+    NSMutableArray *targets_;
+}
+
+#pragma mark - Static Methods
+
++ (PXStylesheetDiff *)diffFromStylesheet:(PXStylesheet *)oldStylesheet toStylesheet:(PXStylesheet *)newStylesheet
+{
+    PXStylesheetDiff *result = [[PXStylesheetDiff alloc] init];
+
+    if (oldStylesheet == newStylesheet)
+    {
+        // nothing to do
+    }
+    else if (oldStylesheet == nil || newStylesheet == nil || ![self stylesheet:oldStylesheet hasSameAtRulesAs:newStylesheet])
+    {
+        result->_affectsAll = YES;
+    }
+    else
+    {
+        NSMutableArray *oldRuleSets = [NSMutableArray array];
+        NSMutableArray *newRuleSets = [NSMutableArray array];
+        NSMutableArray *oldSources = [NSMutableArray array];
+        NSMutableArray *newSources = [NSMutableArray array];
+
+        [self collectRuleSetsOfStylesheet:oldStylesheet into:oldRuleSets sources:oldSources];
+        [self collectRuleSetsOfStylesheet:newStylesheet into:newRuleSets sources:newSources];
+
+        NSUInteger oldCount = oldSources.count;
+        NSUInteger newCount = newSources.count;
+        NSUInteger prefix = 0;
+        NSUInteger suffix = 0;
+
+        while (prefix < oldCount && prefix < newCount && [oldSources[prefix] isEqualToString:newSources[prefix]])
+        {
+            prefix++;
+        }
+
+        while (suffix < oldCount - prefix && suffix < newCount - prefix
+               && [oldSources[oldCount - suffix - 1] isEqualToString:newSources[newCount - suffix - 1]])
+        {
+            suffix++;
+        }
+
+        NSMutableArray *changedRuleSets = [NSMutableArray array];
+
+        [changedRuleSets addObjectsFromArray:[oldRuleSets subarrayWithRange:NSMakeRange(prefix, oldCount - prefix - suffix)]];
+        [changedRuleSets addObjectsFromArray:[newRuleSets subarrayWithRange:NSMakeRange(prefix, newCount - prefix - suffix)]];
+
+        result->_changedRuleSets = changedRuleSets;
+
+        for (PXRuleSet *ruleSet in changedRuleSets)
+        {
+            if (![result addTargetsOfRuleSet:ruleSet])
+            {
+                result->_affectsAll = YES;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
++ (BOOL)stylesheet:(PXStylesheet *)a hasSameAtRulesAs:(PXStylesheet *)b
+{
+    // keyframes are unordered, so compare them as sets of their source
+    NSSet *aKeyframes = (a.keyframes.count > 0) ? [NSSet setWithArray:[a.keyframes valueForKey:@"description"]] : [NSSet set];
+    NSSet *bKeyframes = (b.keyframes.count > 0) ? [NSSet setWithArray:[b.keyframes valueForKey:@"description"]] : [NSSet set];
+    NSArray *aFontFaces = [a.fontFaceDeclarations valueForKey:@"description"];
+    NSArray *bFontFaces = [b.fontFaceDeclarations valueForKey:@"description"];
+
+    return a.origin == b.origin
+        && (a.namespacePrefixes == b.namespacePrefixes || [a.namespacePrefixes isEqualToDictionary:b.namespacePrefixes])
+        && [aKeyframes isEqualToSet:bKeyframes]
+        && (aFontFaces == bFontFaces || [aFontFaces isEqualToArray:bFontFaces]);
+}
+
++ (void)collectRuleSetsOfStylesheet:(PXStylesheet *)stylesheet into:(NSMutableArray *)ruleSets sources:(NSMutableArray *)sources
+{
+    // include groups whose media query does not currently match, since they may match later without a reload
+    for (PXMediaGroup *group in stylesheet.mediaGroups)
+    {
+        NSString *query = (group.query) ? group.query.description : @"";
+
+        for (PXRuleSet *ruleSet in group.ruleSets)
+        {
+            [ruleSets addObject:ruleSet];
+            [sources addObject:[NSString stringWithFormat:@"%@\n%@", query, ruleSet.description]];
+        }
+    }
+}
+
+#pragma mark - Getters
+
+- (BOOL)hasChanges
+{
+    return _affectsAll || targets_.count > 0;
+}
+
+#pragma mark - Methods
+
+- (BOOL)addTargetsOfRuleSet:(PXRuleSet *)ruleSet
+{
+    for (id selector in ruleSet.selectors)
+    {
+        // the parser grows combinators down and to the left, so the top-most combinator's RHS is the target
+        id target = ([selector conformsToProtocol:@protocol(PXCombinator)]) ? ((id<PXCombinator>) selector).rhs : selector;
+
+        if (![target isKindOfClass:[PXTypeSelector class]])
+        {
+            return NO;
+        }
+
+        PXTypeSelector *typeSelector = target;
+        NSString *elementName = (typeSelector.hasUniversalType) ? nil : typeSelector.typeName;
+
+        if (elementName.length == 0 && typeSelector.styleId.length == 0 && typeSelector.styleClasses.count == 0)
+        {
+            // a universal target can match any styleable
+            return NO;
+        }
+
+        if (targets_ == nil)
+        {
+            targets_ = [NSMutableArray array];
+        }
+
+        // intern the strings so styleables whose atoms were looked up without interning can still be compared
+        [targets_ addObject:[[PXStyleableAtoms alloc] initWithElementName:elementName
+                                                                  styleId:typeSelector.styleId
+                                                             styleClasses:typeSelector.styleClasses
+                                                                   intern:YES]];
+    }
+
+    return YES;
+}
+
+- (BOOL)affectsStyleableAtoms:(PXStyleableAtoms *)atoms
+{
+    if (_affectsAll)
+    {
+        return YES;
+    }
+
+    for (PXStyleableAtoms *target in targets_)
+    {
+        if (target.elementName != PXAtomNone && target.elementName != atoms.elementName)
+        {
+            continue;
+        }
+
+        if (target.styleId != PXAtomNone && target.styleId != atoms.styleId)
+        {
+            continue;
+        }
+
+        BOOL hasClasses = YES;
+
+        for (NSUInteger i = 0; i < target.styleClassCount; i++)
+        {
+            if (![atoms containsStyleClass:target.styleClasses[i]])
+            {
+                hasClasses = NO;
+                break;
+            }
+        }
+
+        if (hasClasses)
+        {
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+- (BOOL)affectsAnyStyleableAtoms:(NSArray *)atomsArray
+{
+    if (_affectsAll)
+    {
+        return YES;
+    }
+
+    for (PXStyleableAtoms *atoms in atomsArray)
+    {
+        if ([self affectsStyleableAtoms:atoms])
+        {
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+- (BOOL)affectsStyleable:(id<PXStyleable>)styleable
+{
+    return _affectsAll || (targets_.count > 0 && [self affectsStyleableAtoms:[PXStyleableAtoms atomsForStyleable:styleable]]);
+}
+
+@end
@@ -28,9 +28,11 @@
 #import "NSObject+PXSubclass.h"
 #import "PXLoggingUtils.h"
 #import "PXStyleUtils.h"
+#import "PXStyleScheduler.h"
 #import "PixateFreestyle-Private.h"
 #import "PixateFreestyle.h"
 #import "PXStylesheet-Private.h"
+#import "PXCompiledStylesheet.h"
 #import "NSDictionary+PXCSSEncoding.h"
 #import "PXRuntimeUtils.h"
 #import "PXUtils.h"
@@ -38,13 +40,18 @@
 #import "NSObject+PXClass.h"
 #import "NSObject+PXStyling.h"
 #import "PXStylingMacros.h"
+#import "PXStyleableAtoms.h"
+#import "PXSiblingIndex.h"
+#import "NSObject+PXSwizzle.h"
 
 static const char STYLE_ELEMENT_NAME_KEY;
 static const char STYLE_CLASS_KEY;
 static const char STYLE_CLASSES_KEY;
 static const char STYLE_ID_KEY;
+static const char STYLE_ATOMS_KEY;
 static const char STYLE_CHANGEABLE_KEY;
 static const char STYLE_CSS_KEY;
+static const char STYLE_INLINE_RULE_SETS_KEY;
 static const char STYLE_MODE_KEY;
 static const char KVC_DICTIONARY;
 static const char KVC_SET;
@@ -141,6 +148,10 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
     if([object respondsToSelector:@selector(pxClass)] == NO)
     {
         [superClass subclassInstance:object];
+
+        // the new class may have a different element name
+        objc_setAssociatedObject(object, &STYLE_ATOMS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+
         return YES;
     }
     
@@ -154,6 +165,10 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
     if (self != UIView.class)
         return;
     
+    // sibling indexes of the current style pass are dropped when a view's subviews change
+    [self swizzleMethod:@selector(didAddSubview:) withMethod:@selector(px_didAddSubview:)];
+    [self swizzleMethod:@selector(willRemoveSubview:) withMethod:@selector(px_willRemoveSubview:)];
+
     @autoreleasepool
     {
 #ifdef PX_LOGGING
@@ -163,11 +178,15 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
         // set logging level for all classes
         //[PXLoggingUtils setGlobalLoggingLevel:LOG_LEVEL_VERBOSE];
 #endif
-        // Load default stylesheets and send notification
-        NSString* defaultPath = [[NSBundle mainBundle] pathForResource:@"default" ofType:@"css"];
+        // Load default stylesheets and send notification. Compiled stylesheets are preferred since they do not need to
+        // be parsed. One that is out of date is replaced by the CSS next to it when it is loaded
+        NSBundle *bundle = [NSBundle mainBundle];
+        NSString* defaultPath = [bundle pathForResource:@"default" ofType:PXCompiledStylesheetPathExtension];
+        if (defaultPath == nil) defaultPath = [bundle pathForResource:@"default" ofType:@"css"];
         [PXStylesheet styleSheetFromFilePath:defaultPath withOrigin:PXStylesheetOriginApplication];
 
-        NSString* userPath = [[NSBundle mainBundle] pathForResource:@"user" ofType:@"css"];
+        NSString* userPath = [bundle pathForResource:@"user" ofType:PXCompiledStylesheetPathExtension];
+        if (userPath == nil) userPath = [bundle pathForResource:@"user" ofType:@"css"];
         [PXStylesheet styleSheetFromFilePath:userPath withOrigin:PXStylesheetOriginUser];
         
         // Set default styling mode of any UIView to 'normal' (i.e. stylable)
@@ -350,6 +369,25 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
     return id;
 }
 
+- (PXStyleableAtoms *)pxStyleAtoms
+{
+    PXStyleableAtoms *atoms = objc_getAssociatedObject(self, &STYLE_ATOMS_KEY);
+    NSString *elementName = self.pxStyleElementName;
+
+    // element names are shared per class, so a different instance means the class or its registration changed
+    if (atoms == nil || atoms.elementNameString != elementName)
+    {
+        atoms = [[PXStyleableAtoms alloc] initWithElementName:elementName
+                                                      styleId:self.styleId
+                                                 styleClasses:self.styleClasses
+                                                       intern:YES];
+
+        objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, atoms, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
+    return atoms;
+}
+
 - (BOOL)styleChangeable
 {
     return [objc_getAssociatedObject(self, &STYLE_CHANGEABLE_KEY) boolValue];
@@ -381,9 +419,25 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
     }
 }
 
+- (NSArray *)pxInlineRuleSets
+{
+    NSArray *ruleSets = objc_getAssociatedObject(self, &STYLE_INLINE_RULE_SETS_KEY);
+
+    // cleared when styleCSS or a KVC property changes, so KVC styles are not re-encoded on every restyle
+    if (ruleSets == nil)
+    {
+        ruleSets = [PXStyleUtils ruleSetsForInlineCSS:self.styleCSS];
+
+        objc_setAssociatedObject(self, &STYLE_INLINE_RULE_SETS_KEY, ruleSets, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
+    return ruleSets;
+}
+
 - (NSString *)styleKey
 {
-    return [PXStyleUtils selectorFromStyleable:self];
+    // cached with the atoms, which are replaced when the id, classes, or element name change
+    return self.pxStyleAtoms.styleKey;
 }
 
 - (void)setStyleClass:(NSString *)aClass
@@ -413,6 +467,7 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
 	objc_setAssociatedObject(self, &STYLE_CLASS_KEY, aClass, OBJC_ASSOCIATION_COPY_NONATOMIC);
 	
     objc_setAssociatedObject(self, &STYLE_CLASSES_KEY, classes, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
     
 	if ([aClass length])
     {
@@ -431,6 +486,7 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
     anId = [anId stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
 
     objc_setAssociatedObject(self, &STYLE_ID_KEY, anId, OBJC_ASSOCIATION_COPY_NONATOMIC);
+    objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
 
     if ([anId length])
     {
@@ -451,6 +507,7 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
     css = [css description];
 
     objc_setAssociatedObject(self, &STYLE_CSS_KEY, css, OBJC_ASSOCIATION_COPY_NONATOMIC);
+    objc_setAssociatedObject(self, &STYLE_INLINE_RULE_SETS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
 
     if ([css length])
     {
@@ -523,18 +580,28 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
     [UIView updateStyles:self recursively:NO];
 }
 
+- (void)px_didAddSubview:(UIView *)subview
+{
+    [self px_didAddSubview:subview];
+
+    [PXSiblingIndex invalidateIndexForParent:self];
+}
+
+- (void)px_willRemoveSubview:(UIView *)subview
+{
+    [self px_willRemoveSubview:subview];
+
+    [PXSiblingIndex invalidateIndexForParent:self];
+}
+
 - (void)updateStylesAsync
 {
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [self updateStyles];
-    });
+    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:self recursively:YES];
 }
 
 -(void)updateStylesNonRecursivelyAsync
 {
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [self updateStylesNonRecursively];
-    });
+    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:self recursively:NO];
 }
 
 - (void)setValue:(id)value forUndefinedKey:(NSString *)key
@@ -567,6 +634,8 @@ static NSMutableArray *DYNAMIC_SUBCLASSES;
         }
 
         [properties setValue:value forKey:key];
+
+        objc_setAssociatedObject(self, &STYLE_INLINE_RULE_SETS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
     }
 }
 
@@ -44,4 +44,13 @@
  */
 - (id)initWithLHS:(id<PXSelector>)lhs RHS:(id<PXSelector>)rhs;
 
+/**
+ *  Determine if the ancestor filter of the styleable being visited proves that this combinator cannot match the
+ *  specified element. This returns NO if the element is not being visited or if this combinator does not constrain
+ *  ancestors by element name, id, or class.
+ *
+ *  @param element The element being matched
+ */
+- (BOOL)ancestorFilterRejects:(id<PXStyleable>)element;
+
 @end
@@ -25,8 +25,12 @@
 #import "PXCombinatorBase.h"
 #import "PXSpecificity.h"
 #import "PXSourceWriter.h"
+#import "PXAncestorFilter.h"
 
 @implementation PXCombinatorBase
+{
+    NSData *ancestorKeys_;
+}
 
 @synthesize lhs = _lhs;
 @synthesize rhs = _rhs;
@@ -53,6 +57,8 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     {
         self->_lhs = lhs;
         self->_rhs = rhs;
+
+        ancestorKeys_ = [PXAncestorFilter ancestorKeysForSelector:self];
     }
 
     return self;
@@ -76,6 +82,20 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     return NO;
 }
 
+- (BOOL)ancestorFilterRejects:(id<PXStyleable>)element
+{
+    BOOL result = NO;
+
+    if (ancestorKeys_ != nil)
+    {
+        PXAncestorFilter *filter = [PXAncestorFilter activeFilterForStyleable:element];
+
+        result = (filter != nil && ![filter mightContainKeys:ancestorKeys_]);
+    }
+
+    return result;
+}
+
 - (void)incrementSpecificity:(PXSpecificity *)specificity
 {
     [self->_lhs incrementSpecificity:specificity];
@@ -55,7 +55,7 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 {
     BOOL result = NO;
 
-    if ([self.rhs matches:element])
+    if (![self ancestorFilterRejects:element] && [self.rhs matches:element])
     {
         id parent = element.pxStyleParent;
 
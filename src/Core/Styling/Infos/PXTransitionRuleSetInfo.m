@@ -43,7 +43,7 @@
                                                  byState:stateName];
 
         // merge rule sets for this state into a single rule set, taking specificity into account
-        _mergedRuleSet = [PXRuleSet ruleSetWithMergedRuleSets:_ruleSetsForState];
+        _mergedRuleSet = [PXStyleUtils mergedRuleSetForRuleSets:_ruleSetsForState];
 
         // extract any transition delcarations we might have
         PXTransitionStyler *styler = [[PXTransitionStyler alloc] init];
@@ -60,6 +60,20 @@
  */
 - (void)addRuleSet:(PXRuleSet *)ruleSet;
 
+/**
+ *  Add a new rule set to this stylesheet using the specified keys to partition it instead of reading them from the
+ *  rule set's target type selector. This allows rule sets whose selectors have not been created yet to be added
+ *
+ *  @param ruleSet The rule set to add. Nil values are ignored
+ *  @param elementName The element name of the target type selector, or nil if the type is universal
+ *  @param styleId The id of the target type selector. This may be nil
+ *  @param styleClasses The classes of the target type selector. This may be nil
+ */
+- (void)addRuleSet:(PXRuleSet *)ruleSet
+   withElementName:(NSString *)elementName
+           styleId:(NSString *)styleId
+      styleClasses:(NSArray *)styleClasses;
+
 /**
  *  Return a list of rule sets that could apply to the given styleable
  *
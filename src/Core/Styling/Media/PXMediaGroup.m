@@ -23,13 +23,33 @@
 //
 
 #import "PXMediaGroup.h"
+#import "PXStyleableAtoms.h"
+
+#pragma mark - Static Functions
+
+static CFMutableDictionaryRef PXMediaGroupCreatePartition(void)
+{
+    // atoms are used directly as keys, so only the values need memory management
+    return CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+}
+
+static NSMutableArray *PXMediaGroupPartitionRuleSets(CFDictionaryRef partition, PXAtom key)
+{
+    return (partition != NULL) ? (__bridge NSMutableArray *) CFDictionaryGetValue(partition, (const void *) (uintptr_t) key) : nil;
+}
+
+static void PXMediaGroupAddRuleSetToPartitionValue(const void *key, const void *value, void *context)
+{
+    [(__bridge NSMutableArray *) value addObject:(__bridge PXRuleSet *) context];
+}
 
 @implementation PXMediaGroup
 {
     NSMutableArray *ruleSets_;
-    NSMutableDictionary *ruleSetsByElementName_;
-    NSMutableDictionary *ruleSetsById_;
-    NSMutableDictionary *ruleSetsByClass_;
+    // partitions map atoms to mutable arrays of rule sets
+    CFMutableDictionaryRef ruleSetsByElementName_;
+    CFMutableDictionaryRef ruleSetsById_;
+    CFMutableDictionaryRef ruleSetsByClass_;
     NSMutableArray *uncategorizedRuleSets_;
 }
 
@@ -59,14 +79,12 @@
     NSMutableSet *items = [NSMutableSet set];
 
     // gather keys
-    NSString *elementName = styleable.pxStyleElementName;
-    NSString *styleId = styleable.styleId;
-    NSArray *styleClasses = styleable.styleClasses;
+    PXStyleableAtoms *atoms = [PXStyleableAtoms atomsForStyleable:styleable];
 
     // find relevant ruleSets by element name
-    if (elementName.length > 0)
+    if (atoms.elementName != PXAtomNone)
     {
-        for (PXRuleSet *ruleSet in [ruleSetsByElementName_ objectForKey:elementName])
+        for (PXRuleSet *ruleSet in PXMediaGroupPartitionRuleSets(ruleSetsByElementName_, atoms.elementName))
         {
             if ([items containsObject:ruleSet] == NO)
             {
@@ -77,9 +95,9 @@
     }
 
     // find relevant ruleSets by id
-    if (styleId.length > 0)
+    if (atoms.styleId != PXAtomNone)
     {
-        for (PXRuleSet *ruleSet in [ruleSetsById_ objectForKey:styleId])
+        for (PXRuleSet *ruleSet in PXMediaGroupPartitionRuleSets(ruleSetsById_, atoms.styleId))
         {
             if ([items containsObject:ruleSet] == NO)
             {
@@ -90,11 +108,11 @@
     }
 
     // find relevant ruleSets by class
-    if (styleClasses.count > 0)
+    if (atoms.styleClassCount > 0)
     {
-        for (NSString *aClass in styleClasses)
+        for (NSUInteger i = 0; i < atoms.styleClassCount; i++)
         {
-            for (PXRuleSet *ruleSet in [ruleSetsByClass_ objectForKey:aClass])
+            for (PXRuleSet *ruleSet in PXMediaGroupPartitionRuleSets(ruleSetsByClass_, atoms.styleClasses[i]))
             {
                 if ([items containsObject:ruleSet] == NO)
                 {
@@ -117,9 +135,10 @@
 
 #pragma mark - Methods
 
-- (void)addRuleSet:(PXRuleSet *)ruleSet toPartition:(NSMutableDictionary *)partition withKey:(NSString *)key
+- (void)addRuleSet:(PXRuleSet *)ruleSet toPartition:(CFMutableDictionaryRef)partition withKey:(NSString *)key
 {
-    NSMutableArray *ruleSets = [partition objectForKey:key];
+    PXAtom atom = [PXAtomTable atomForString:key];
+    NSMutableArray *ruleSets = PXMediaGroupPartitionRuleSets(partition, atom);
 
     // create ruleset array if we don't have one already
     if (ruleSets == nil)
@@ -130,7 +149,7 @@
         [ruleSets addObjectsFromArray:uncategorizedRuleSets_];
 
         // save the ruleSet array back to the partition dictionary
-        [partition setObject:ruleSets forKey:key];
+        CFDictionarySetValue(partition, (const void *) (uintptr_t) atom, (__bridge const void *) ruleSets);
     }
 
     // add this ruleSet to the ruleSet array associated with the given key
@@ -138,6 +157,25 @@
 }
 
 - (void)addRuleSet:(PXRuleSet *)ruleSet
+{
+    if (ruleSet)
+    {
+        // setup lookup by element type
+        PXTypeSelector *typeSelector = ruleSet.targetTypeSelector;
+        // NOTE: we have to check for nil since hasUniversalType returns false with a nil typeSelector, but we need
+        // the default to be true when typeSelector is nil
+        NSString *elementName = (typeSelector == nil || typeSelector.hasUniversalType) ? nil : typeSelector.typeName;
+        NSString *styleId = (typeSelector == nil) ? nil : typeSelector.styleId;
+        NSArray *styleClasses = (typeSelector == nil) ? nil : typeSelector.styleClasses;
+
+        [self addRuleSet:ruleSet withElementName:elementName styleId:styleId styleClasses:styleClasses];
+    }
+}
+
+- (void)addRuleSet:(PXRuleSet *)ruleSet
+   withElementName:(NSString *)elementName
+           styleId:(NSString *)styleId
+      styleClasses:(NSArray *)styleClasses
 {
     if (ruleSet)
     {
@@ -148,36 +186,29 @@
 
         [ruleSets_ addObject:ruleSet];
 
-        // set origin specificity
-        [ruleSet.specificity setSpecificity:kSpecificityTypeOrigin toValue:_origin];
+        // set origin specificity and source order
+        [ruleSet assignOrigin:_origin];
 
-        // setup lookup by element type
-        PXTypeSelector *typeSelector = ruleSet.targetTypeSelector;
-        // NOTE: we have to check for nil since hasUniversalType returns false with a nil typeSelector, but we need
-        // the default to be true when typeSelector is nil
-        NSString *elementName = (typeSelector == nil || typeSelector.hasUniversalType) ? nil : typeSelector.typeName;
-        NSString *styleId = (typeSelector == nil) ? nil : typeSelector.styleId;
-        NSArray *styleClasses = (typeSelector == nil) ? nil : typeSelector.styleClasses;
         BOOL added = NO;
 
         // NOTE: nesting if-statements to avoid walking type selector expressions for id and classes when not needed
         if (elementName != nil && [@"*" isEqualToString:elementName] == NO)
         {
-            if (ruleSetsByElementName_ == nil) ruleSetsByElementName_ = [NSMutableDictionary dictionary];
+            if (ruleSetsByElementName_ == NULL) ruleSetsByElementName_ = PXMediaGroupCreatePartition();
             [self addRuleSet:ruleSet toPartition:ruleSetsByElementName_ withKey:elementName];
             added = YES;
         }
 
         if (styleId.length > 0)
         {
-            if (ruleSetsById_ == nil) ruleSetsById_ = [NSMutableDictionary dictionary];
+            if (ruleSetsById_ == NULL) ruleSetsById_ = PXMediaGroupCreatePartition();
             [self addRuleSet:ruleSet toPartition:ruleSetsById_ withKey:styleId];
             added = YES;
         }
 
         if (styleClasses.count > 0)
         {
-            if (ruleSetsByClass_ == nil) ruleSetsByClass_ = [NSMutableDictionary dictionary];
+            if (ruleSetsByClass_ == NULL) ruleSetsByClass_ = PXMediaGroupCreatePartition();
 
             for (NSString *styleClass in styleClasses)
             {
@@ -195,26 +226,9 @@
             [uncategorizedRuleSets_ addObject:ruleSet];
 
             // add uncategorized ruleSets to all partitions
-            for (NSString *key in ruleSetsByElementName_.allKeys)
-            {
-                NSMutableArray *items = [ruleSetsByElementName_ objectForKey:key];
-
-                [items addObject:ruleSet];
-            }
-
-            for (NSString *key in ruleSetsById_.allKeys)
-            {
-                NSMutableArray *items = [ruleSetsById_ objectForKey:key];
-
-                [items addObject:ruleSet];
-            }
-
-            for (NSString *key in ruleSetsByClass_.allKeys)
-            {
-                NSMutableArray *items = [ruleSetsByClass_ objectForKey:key];
-
-                [items addObject:ruleSet];
-            }
+            if (ruleSetsByElementName_) CFDictionaryApplyFunction(ruleSetsByElementName_, PXMediaGroupAddRuleSetToPartitionValue, (__bridge void *) ruleSet);
+            if (ruleSetsById_) CFDictionaryApplyFunction(ruleSetsById_, PXMediaGroupAddRuleSetToPartitionValue, (__bridge void *) ruleSet);
+            if (ruleSetsByClass_) CFDictionaryApplyFunction(ruleSetsByClass_, PXMediaGroupAddRuleSetToPartitionValue, (__bridge void *) ruleSet);
         }
     }
 }
@@ -236,9 +250,11 @@
 - (void)dealloc
 {
     ruleSets_ = nil;
-    ruleSetsByElementName_ = nil;
-    ruleSetsById_ = nil;
-    ruleSetsByClass_ = nil;
+
+    if (ruleSetsByElementName_) CFRelease(ruleSetsByElementName_);
+    if (ruleSetsById_) CFRelease(ruleSetsById_);
+    if (ruleSetsByClass_) CFRelease(ruleSetsByClass_);
+
     uncategorizedRuleSets_ = nil;
     _query = nil;
 }
@@ -29,6 +29,7 @@
 #import "PXOffsets.h"
 #import "PixateFreestyleConfiguration.h"
 #import "PXBorderInfo.h"
+#import "PXAtomTable.h"
 
 /**
  *  PXDeclaration represents a single property/value pair in a CSS rule set. A declaration consists of a property name
@@ -39,9 +40,25 @@
 @interface PXDeclaration : NSObject
 
 @property (nonatomic, strong) NSString *name;
+
+/**
+ *  The interned property name. This is updated whenever the name is set
+ */
+@property (readonly, nonatomic) PXAtom nameAtom;
+
 @property (readonly, nonatomic, strong) NSArray *lexemes;
 @property (nonatomic) BOOL important;
 
+/**
+ *  The source of this declaration's value, as set by setSource:filename:lexemes:
+ */
+@property (readonly, nonatomic, strong) NSString *source;
+
+/**
+ *  The name of the file containing this declaration. This may be nil
+ */
+@property (readonly, nonatomic, strong) NSString *filename;
+
 /**
  *  Initializes a newly allocated PXDeclaration using the specified property name
  *
@@ -40,7 +40,7 @@
     NSString *filename_;
 }
 
-static PXValueParser *PARSER;
+static NSString *const PARSER_KEY = @"PXDeclaration.parser";
 static NSRegularExpression *ESCAPE_SEQUENCES;
 static NSDictionary *ESCAPE_SEQUENCE_MAP;
 
@@ -65,11 +65,6 @@ static NSDictionary *ESCAPE_SEQUENCE_MAP;
             @"\\f" : @"\f"
         };
     }
-
-    if (!PARSER)
-    {
-        PARSER = [[PXValueParser alloc] init];
-    }
 }
 
 #pragma mark - Initializers
@@ -89,6 +84,7 @@ static NSDictionary *ESCAPE_SEQUENCE_MAP;
     if (self = [super init])
     {
         _name = name;
+        _nameAtom = [PXAtomTable atomForString:name];
         cache_ = nil;
 
         [self setSource:value filename:nil lexemes:[PXValueParser lexemesForSource:value]];
@@ -97,8 +93,26 @@ static NSDictionary *ESCAPE_SEQUENCE_MAP;
     return self;
 }
 
+#pragma mark - Getters
+
+- (NSString *)source
+{
+    return source_;
+}
+
+- (NSString *)filename
+{
+    return filename_;
+}
+
 #pragma mark - Setters
 
+- (void)setName:(NSString *)name
+{
+    _name = name;
+    _nameAtom = [PXAtomTable atomForString:name];
+}
+
 - (void)setSource:(NSString *)source filename:(NSString *)filename lexemes:(NSArray *)lexemes
 {
     _lexemes = lexemes;
@@ -111,13 +125,32 @@ static NSDictionary *ESCAPE_SEQUENCE_MAP;
     {
         PXStylesheetLexeme *firstLexeme = [lexemes objectAtIndex:0];
         NSUInteger firstOffset = firstLexeme.range.location;
+        NSUInteger length = source.length;
+        unichar stackBuffer[256];
+        unichar *characters = (length <= 256) ? stackBuffer : malloc(length * sizeof(unichar));
 
-        [_lexemes enumerateObjectsUsingBlock:^(PXStylesheetLexeme *lexeme, NSUInteger idx, BOOL *stop) {
+        // hash the characters of each lexeme directly instead of creating a substring per lexeme
+        [source getCharacters:characters range:NSMakeRange(0, length)];
+
+        for (PXStylesheetLexeme *lexeme in lexemes)
+        {
             NSRange lexemeRange = lexeme.range;
-            NSRange normalizedRange = NSMakeRange(lexemeRange.location - firstOffset, lexemeRange.length);
+            NSUInteger start = lexemeRange.location - firstOffset;
+            NSUInteger end = MIN(start + lexemeRange.length, length);
+            NSUInteger lexemeHash = 0;
+
+            for (NSUInteger i = start; i < end; i++)
+            {
+                lexemeHash = lexemeHash * 31 + characters[i];
+            }
+
+            hash_ = hash_ * 31 + lexemeHash;
+        }
 
-            hash_ = hash_ * 31 + [source substringWithRange:normalizedRange].hash;
-        }];
+        if (characters != stackBuffer)
+        {
+            free(characters);
+        }
     }
 }
 
@@ -632,10 +665,19 @@ static NSDictionary *ESCAPE_SEQUENCE_MAP;
 
 - (PXValueParser *)parser
 {
-    // TODO: pull from parser pool?
-    PARSER.filename = filename_;
+    // value parsers are not thread safe, so each thread gets its own
+    NSMutableDictionary *threadDictionary = [NSThread currentThread].threadDictionary;
+    PXValueParser *parser = [threadDictionary objectForKey:PARSER_KEY];
+
+    if (!parser)
+    {
+        parser = [[PXValueParser alloc] init];
+        [threadDictionary setObject:parser forKey:PARSER_KEY];
+    }
+
+    parser.filename = filename_;
 
-    return PARSER;
+    return parser;
 }
 
 #pragma mark - Overrides
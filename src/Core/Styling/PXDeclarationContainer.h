@@ -36,6 +36,14 @@
  */
 - (void)addDeclaration:(PXDeclaration *)declaration;
 
+/**
+ *  Add declarations that are already known to have distinct names, both among themselves and from the declarations
+ *  already in this container. This skips the duplicate checks of addDeclaration:
+ *
+ *  @param declarations The declarations to add
+ */
+- (void)addDeclarationsWithDistinctNames:(NSArray *)declarations;
+
 /**
  *  Remove the specified declaration from this container
  */
@@ -59,6 +59,25 @@
     }
 }
 
+- (void)addDeclarationsWithDistinctNames:(NSArray *)declarations
+{
+    if (declarations.count > 0)
+    {
+        if (declarations_ == nil)
+        {
+            declarations_ = [NSMutableArray arrayWithCapacity:declarations.count];
+            names_ = [NSMutableSet setWithCapacity:declarations.count];
+        }
+
+        [declarations_ addObjectsFromArray:declarations];
+
+        for (PXDeclaration *declaration in declarations)
+        {
+            [names_ addObject:declaration.name];
+        }
+    }
+}
+
 - (void)removeDeclaration:(PXDeclaration *)declaration
 {
     if (declaration && declarations_)
@@ -72,9 +91,17 @@
 {
     PXDeclaration *result = nil;
 
+    // a name that was never interned cannot belong to any declaration
+    PXAtom atom = [PXAtomTable existingAtomForString:name];
+
+    if (atom == PXAtomNone)
+    {
+        return nil;
+    }
+
     for (PXDeclaration *declaration in declarations_)
     {
-        if ([declaration.name isEqualToString:name])
+        if (declaration.nameAtom == atom)
         {
             result = declaration;
             break;
@@ -28,6 +28,7 @@
 #import "PXDeclarationContainer.h"
 #import "PXDeclaration.h"
 #import "PXStyleable.h"
+#import "PXSelectorProgram.h"
 
 /**
  *  A PXRuleSet represents a single CSS rule set. A rule set consists of selectors and declarations. A specificity is
@@ -52,6 +53,19 @@
  */
 @property (readonly, nonatomic) PXTypeSelector *targetTypeSelector;
 
+/**
+ *  The compiled form of this rule set's selectors used by matches:. This is built on first use and rebuilt after
+ *  selectors are added
+ */
+@property (readonly, nonatomic) PXSelectorProgram *selectorProgram;
+
+/**
+ *  A single integer ordering this rule set in the cascade. From most to least significant it packs the rule set's
+ *  origin, its id, class, and element specificity counts, and the order in which it was added to a stylesheet, so a
+ *  larger key always wins. The key is updated as selectors are added and when the rule set is added to a stylesheet
+ */
+@property (readonly, nonatomic) uint64_t sortKey;
+
 /**
  *  A class method used to merge multiple rule sets into a single rule set, taking specificity of each rule set into
  *  account. The resulting rule set's selectors and specificity properties are undefined.
@@ -68,7 +82,26 @@
 - (void)addSelector:(id<PXSelector>)selector;
 
 /**
- *  Determine if a given element matches the selector associated with this rule set
+ *  Replace this rule set's selectors with the specified ones. The id, class, and element counts of specificity are
+ *  copied in and the sort key is updated once, so the specificity never passes through partial values, as it would
+ *  when adding one selector at a time
+ *
+ *  @param selectors The new selectors
+ *  @param specificity The specificity of the new selectors. Its origin is ignored
+ */
+- (void)setSelectors:(NSArray *)selectors withSpecificity:(PXSpecificity *)specificity;
+
+/**
+ *  Set the origin of this rule set and give it the next source order, so it sorts after every rule set that was
+ *  given one before it. This is called when the rule set is added to a stylesheet's media group
+ *
+ *  @param origin The origin of the stylesheet the rule set is added to
+ */
+- (void)assignOrigin:(int)origin;
+
+/**
+ *  Determine if a given element matches the selector associated with this rule set. Matching runs the compiled
+ *  selectorProgram rather than the selector objects
  *
  *  @param element The element to test
  */
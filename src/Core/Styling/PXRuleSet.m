@@ -28,9 +28,77 @@
 #import "PXFontRegistry.h"
 #import "PXCombinator.h"
 
+// the fields of a packed sort key, from most to least significant. The top bit is left clear, so the cascade can
+// place !important declarations above every rule set
+#define PX_SORT_KEY_IMPORTANT (1ULL << 63)
+#define PX_SORT_KEY_ORIGIN_SHIFT 60
+#define PX_SORT_KEY_ID_SHIFT 52
+#define PX_SORT_KEY_CLASS_SHIFT 44
+#define PX_SORT_KEY_ELEMENT_SHIFT 36
+#define PX_SORT_KEY_ORDER_MASK ((1ULL << PX_SORT_KEY_ELEMENT_SHIFT) - 1)
+
+// merges with at most this many declaration slots do not allocate their slot array
+#define PX_STACK_SLOT_COUNT 128
+
+// shared by all stylesheets, so rule sets added later always sort later within their origin
+static uint64_t SOURCE_ORDER = 0;
+
+typedef struct
+{
+    uint64_t key;
+    NSUInteger index;
+} PXRuleSetSortEntry;
+
+typedef struct
+{
+    PXAtom atom;
+    uint64_t weight;
+    BOOL emitted;
+    __unsafe_unretained PXDeclaration *declaration;     // owned by the merged rule sets
+} PXDeclarationSlot;
+
+static uint64_t PXRuleSetPackField(int value, int maximum, int shift)
+{
+    return (uint64_t) MIN(MAX(value, 0), maximum) << shift;
+}
+
+static int PXRuleSetCompareSortEntries(const void *a, const void *b)
+{
+    const PXRuleSetSortEntry *first = a;
+    const PXRuleSetSortEntry *second = b;
+
+    // equal keys keep their matched order, so the later rule set still wins
+    if (first->key != second->key)
+    {
+        return (first->key < second->key) ? -1 : 1;
+    }
+
+    return (first->index < second->index) ? -1 : (first->index > second->index) ? 1 : 0;
+}
+
+static PXDeclarationSlot *PXRuleSetSlotForAtom(PXDeclarationSlot *slots, NSUInteger mask, PXAtom atom)
+{
+    NSUInteger index = (atom * 2654435761u) & mask;
+
+    while (slots[index].declaration != nil && slots[index].atom != atom)
+    {
+        index = (index + 1) & mask;
+    }
+
+    return &slots[index];
+}
+
+@interface PXRuleSet ()
+
+// atomic, since rule sets are matched from background styling queues and the program is built lazily
+@property (atomic, strong) PXSelectorProgram *compiledProgram;
+
+@end
+
 @implementation PXRuleSet
 {
     NSMutableArray *selectors;
+    uint64_t sourceOrder_;
 }
 
 #pragma mark - Static initializers
@@ -38,47 +106,96 @@
 + (id)ruleSetWithMergedRuleSets:(NSArray *)ruleSets
 {
     PXRuleSet *result = [[PXRuleSet alloc] init];
+    NSUInteger count = ruleSets.count;
 
-    if (ruleSets.count > 0)
+    if (count > 0)
     {
-        // order rules by specificity
-        NSArray *sortedRuleSets =
-            [ruleSets sortedArrayUsingComparator:^NSComparisonResult(PXRuleSet *a, PXRuleSet *b)
-             {
-                 return [a.specificity compareSpecificity:b.specificity];
-             }];
-
-        for (PXRuleSet *ruleSet in [sortedRuleSets reverseObjectEnumerator])
+        PXRuleSetSortEntry *entries = malloc(count * sizeof(PXRuleSetSortEntry));
+        NSMutableArray *declarationLists = [NSMutableArray arrayWithCapacity:count];
+        NSUInteger declarationCount = 0;
+
+        for (NSUInteger i = 0; i < count; i++)
+        {
+            PXRuleSet *ruleSet = [ruleSets objectAtIndex:i];
+            NSArray *declarations = ruleSet.declarations;
+
+            entries[i].key = ruleSet.sortKey;
+            entries[i].index = i;
+
+            [declarationLists addObject:declarations];
+            declarationCount += declarations.count;
+        }
+
+        // order rules by their packed keys, which only takes integer compares
+        qsort(entries, count, sizeof(PXRuleSetSortEntry), PXRuleSetCompareSortEntries);
+
+        // cascade every property into its own slot, found by the property's name atom. An !important declaration
+        // beats any normal one, then the larger rule set key wins, then the later declaration
+        NSUInteger capacity = 16;
+
+        while (capacity < declarationCount * 2)
+        {
+            capacity <<= 1;
+        }
+
+        PXDeclarationSlot stackSlots[PX_STACK_SLOT_COUNT];
+        PXDeclarationSlot *slots = (capacity <= PX_STACK_SLOT_COUNT) ? stackSlots : malloc(capacity * sizeof(PXDeclarationSlot));
+        NSUInteger mask = capacity - 1;
+
+        memset(slots, 0, capacity * sizeof(PXDeclarationSlot));
+
+        for (NSUInteger i = 0; i < count; i++)
+        {
+            uint64_t key = entries[i].key;
+
+            for (PXDeclaration *declaration in [declarationLists objectAtIndex:entries[i].index])
+            {
+                PXAtom atom = declaration.nameAtom;
+                uint64_t weight = (declaration.important) ? (key | PX_SORT_KEY_IMPORTANT) : key;
+                PXDeclarationSlot *slot = PXRuleSetSlotForAtom(slots, mask, atom);
+
+                if (slot->declaration == nil || weight >= slot->weight)
+                {
+                    slot->atom = atom;
+                    slot->weight = weight;
+                    slot->declaration = declaration;
+                }
+            }
+        }
+
+        // emit the winners starting with the most specific rule set, which is the order stylers have always seen
+        NSMutableArray *winners = [NSMutableArray arrayWithCapacity:declarationCount];
+
+        for (NSUInteger i = count; i > 0; i--)
         {
-            // add selectors
+            NSUInteger index = entries[i - 1].index;
+            PXRuleSet *ruleSet = [ruleSets objectAtIndex:index];
+
             for (id<PXSelector> selector in ruleSet.selectors)
             {
                 [result addSelector:selector];
             }
 
-            // add declarations
-            for (PXDeclaration *declaration in ruleSet.declarations)
+            for (PXDeclaration *declaration in [declarationLists objectAtIndex:index])
             {
-                if ([result hasDeclarationForName:declaration.name])
-                {
-                    if (declaration.important)
-                    {
-                        PXDeclaration *addedDeclaration = [result declarationForName:declaration.name];
-
-                        if (addedDeclaration.important == NO)
-                        {
-                            // replace old with this !important one
-                            [result removeDeclaration:addedDeclaration];
-                            [result addDeclaration:declaration];
-                        }
-                    }
-                }
-                else
+                PXDeclarationSlot *slot = PXRuleSetSlotForAtom(slots, mask, declaration.nameAtom);
+
+                if (slot->declaration == declaration && !slot->emitted)
                 {
-                    [result addDeclaration:declaration];
+                    slot->emitted = YES;
+                    [winners addObject:declaration];
                 }
             }
         }
+
+        [result addDeclarationsWithDistinctNames:winners];
+
+        if (slots != stackSlots)
+        {
+            free(slots);
+        }
+
+        free(entries);
     }
 
     return result;
@@ -91,6 +208,7 @@
     if (self = [super init])
     {
         _specificity = [[PXSpecificity alloc] init];
+        [self updateSortKey];
     }
 
     return self;
@@ -138,6 +256,20 @@
     return result;
 }
 
+- (PXSelectorProgram *)selectorProgram
+{
+    PXSelectorProgram *result = self.compiledProgram;
+
+    if (result == nil)
+    {
+        // racing threads may each build a program, but they are equivalent
+        result = [[PXSelectorProgram alloc] initWithSelectors:selectors];
+        self.compiledProgram = result;
+    }
+
+    return result;
+}
+
 #pragma mark - Methods
 
 - (void)addSelector:(id<PXSelector>)selector
@@ -152,30 +284,56 @@
         [selectors addObject:selector];
 
         [selector incrementSpecificity:_specificity];
+        [self updateSortKey];
+
+        self.compiledProgram = nil;
     }
 }
 
+- (void)setSelectors:(NSArray *)newSelectors withSpecificity:(PXSpecificity *)specificity
+{
+    selectors = (newSelectors.count > 0) ? [NSMutableArray arrayWithArray:newSelectors] : nil;
+
+    [_specificity setSpecificity:kSpecificityTypeId toValue:[specificity valueForSpecificity:kSpecificityTypeId]];
+    [_specificity setSpecificity:kSpecificityTypeClassOrAttribute toValue:[specificity valueForSpecificity:kSpecificityTypeClassOrAttribute]];
+    [_specificity setSpecificity:kSpecificityTypeElement toValue:[specificity valueForSpecificity:kSpecificityTypeElement]];
+    [self updateSortKey];
+
+    self.compiledProgram = nil;
+}
+
+- (void)assignOrigin:(int)origin
+{
+    [_specificity setSpecificity:kSpecificityTypeOrigin toValue:origin];
+
+    sourceOrder_ = __atomic_add_fetch(&SOURCE_ORDER, 1, __ATOMIC_RELAXED);
+    [self updateSortKey];
+}
+
 - (BOOL)matches:(id<PXStyleable>)element
 {
     BOOL result = NO;
 
     if (element && selectors.count > 0)
     {
-        result = YES;
-
-        for (PXTypeSelector *selector in selectors)
-        {
-            if (![selector matches:element])
-            {
-                result = NO;
-                break;
-            }
-        }
+        result = [self.selectorProgram matches:element];
     }
 
     return result;
 }
 
+#pragma mark - Private Methods
+
+- (void)updateSortKey
+{
+    _sortKey =
+        PXRuleSetPackField([_specificity valueForSpecificity:kSpecificityTypeOrigin], 0x7, PX_SORT_KEY_ORIGIN_SHIFT)
+    |   PXRuleSetPackField([_specificity valueForSpecificity:kSpecificityTypeId], 0xFF, PX_SORT_KEY_ID_SHIFT)
+    |   PXRuleSetPackField([_specificity valueForSpecificity:kSpecificityTypeClassOrAttribute], 0xFF, PX_SORT_KEY_CLASS_SHIFT)
+    |   PXRuleSetPackField([_specificity valueForSpecificity:kSpecificityTypeElement], 0xFF, PX_SORT_KEY_ELEMENT_SHIFT)
+    |   (sourceOrder_ & PX_SORT_KEY_ORDER_MASK);
+}
+
 #pragma mark - Overrides
 
 - (void)dealloc
@@ -66,4 +66,11 @@ typedef enum
  */
 - (void)setSpecificity:(PXSpecificityType)specificity toValue:(int)value;
 
+/**
+ *  Return the specificity counter for a given specificity type
+ *
+ *  @param specificity The specificity type being retrieved
+ */
+- (int)valueForSpecificity:(PXSpecificityType)specificity;
+
 @end
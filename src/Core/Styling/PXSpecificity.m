@@ -92,6 +92,11 @@
     }
 }
 
+- (int)valueForSpecificity:(PXSpecificityType)specificity
+{
+    return (values && specificity < self->length) ? values[specificity] : 0;
+}
+
 #pragma mark - Overrides
 
 - (void)dealloc
@@ -36,6 +36,7 @@ typedef enum
 } PXStylingMode;
 
 @class PXRuleSet;
+@class PXStyleableAtoms;
 
 /**
  *  The PXStyleable protocol defines a set of properties and methods needed in order to style a given object.
@@ -133,6 +134,18 @@ typedef enum
  */
 @property (readonly, nonatomic, copy) NSString *pxStyleNamespace;
 
+/**
+ *  Return the interned element name, id, and classes of this object. Objects that implement this should cache the
+ *  returned value and replace it when their id, classes, or element name change
+ */
+@property (readonly, nonatomic, strong) PXStyleableAtoms *pxStyleAtoms;
+
+/**
+ *  Return the rule sets parsed from styleCSS. Objects that implement this should cache the returned value and clear it
+ *  whenever styleCSS changes
+ */
+@property (readonly, nonatomic, strong) NSArray *pxInlineRuleSets;
+
 /**
  *  Return a list of pseudo-classes that are recognized by this object
  */
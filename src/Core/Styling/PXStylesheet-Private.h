@@ -27,6 +27,7 @@
 #import "PXKeyframe.h"
 
 @class PXMediaGroup;
+@class PXStylesheetDiff;
 @protocol PXMediaExpression;
 
 /**
@@ -45,6 +46,34 @@
  */
 @property (readonly, nonatomic, strong) NSArray *mediaGroups;
 
+/**
+ *  A nonmutable dictionary of namespace URIs keyed by namespace prefix. The default namespace uses an empty prefix
+ */
+@property (readonly, nonatomic, strong) NSDictionary *namespacePrefixes;
+
+/**
+ *  A nonmutable array of the keyframes defined in this stylesheet
+ */
+@property (readonly, nonatomic, strong) NSArray *keyframes;
+
+/**
+ *  A nonmutable array of the src declarations of all @font-face rules in this stylesheet
+ */
+@property (readonly, nonatomic, strong) NSArray *fontFaceDeclarations;
+
+/**
+ *  The rule sets that changed between the previous current stylesheet of this origin and this one, recorded when this
+ *  stylesheet was loaded as the current stylesheet. This is nil for stylesheets that were never loaded that way
+ */
+@property (readonly, nonatomic, strong) PXStylesheetDiff *changesFromPreviousStylesheet;
+
+/**
+ *  A digest of the source or compiled file this stylesheet was loaded from, including the sources of any files it
+ *  imported, or nil if its rule sets were added or changed in code after loading. The digest is computed the first
+ *  time it is asked for
+ */
+@property (readonly, nonatomic, strong) NSString *contentHash;
+
 /**
  *  The current media query that applies to any rule sets added to this stylesheet
  */
@@ -66,6 +95,53 @@
  */
 + (id)styleSheetFromFilePath:(NSString *)filePath withOrigin:(PXStylesheetOrigin)origin;
 
+/**
+ *  Load the specified file into a new stylesheet without making it the current stylesheet for its origin. Files with
+ *  the PXCompiledStylesheetPathExtension are memory-mapped as compiled stylesheets, all others are parsed as CSS. A
+ *  compiled stylesheet that cannot be loaded, is older than the CSS file with the same name next to it, or was compiled
+ *  from different CSS is replaced by that CSS file. This may be called from any thread
+ *
+ *  @param filePath The string path to the stylesheet file
+ *  @param origin The specificity origin for this stylesheet
+ */
++ (id)loadedStyleSheetFromFilePath:(NSString *)filePath withOrigin:(PXStylesheetOrigin)origin;
+
+/**
+ *  Parse the specified source into a new stylesheet without making it the current stylesheet for its origin. Parsers
+ *  are drawn from a pool, so this may be called from any thread
+ *
+ *  @param source The CSS source for this stylesheet
+ *  @param origin The specificity origin for this stylesheet
+ *  @param name The name of the file containing the source. This may be nil
+ */
++ (id)parsedStyleSheetFromSource:(NSString *)source withOrigin:(PXStylesheetOrigin)origin filename:(NSString *)name;
+
+/**
+ *  Parse the specified source on a background queue. On the main queue, the result becomes the current stylesheet for
+ *  its origin and the completion block is called. If another load for the same origin was started after this one,
+ *  the result is passed to the completion block without becoming current.
+ *
+ *  @param source The CSS source for this stylesheet
+ *  @param origin The specificity origin for this stylesheet
+ *  @param name The name of the file containing the source. This may be nil
+ *  @param completion A block called on the main queue with the new stylesheet. This may be nil
+ */
++ (void)styleSheetFromSource:(NSString *)source
+                  withOrigin:(PXStylesheetOrigin)origin
+                    filename:(NSString *)name
+                  completion:(void (^)(PXStylesheet *stylesheet))completion;
+
+/**
+ *  Read and parse the specified file on a background queue. See styleSheetFromSource:withOrigin:filename:completion:
+ *
+ *  @param filePath The string path to the stylesheet file
+ *  @param origin The specificity origin for this stylesheet
+ *  @param completion A block called on the main queue with the new stylesheet. This may be nil
+ */
++ (void)styleSheetFromFilePath:(NSString *)filePath
+                    withOrigin:(PXStylesheetOrigin)origin
+                    completion:(void (^)(PXStylesheet *stylesheet))completion;
+
 /**
  *  A class-level getter returning the current application-level stylesheet. This value may be nil
  */
@@ -81,6 +157,14 @@
  */
 + (PXStylesheet *)currentViewStylesheet;
 
+/**
+ *  Restyle the views that the changes recorded in the specified stylesheet may affect. All views are restyled when the
+ *  stylesheet has no recorded changes or when its changes cannot be narrowed to specific views
+ *
+ *  @param stylesheet The stylesheet that was loaded
+ */
++ (void)updateStylesForChangesOfStylesheet:(PXStylesheet *)stylesheet;
+
 /**
  *  Initialize a new stylesheet instance and set its stylesheet origin
  *
@@ -88,6 +172,15 @@
  */
 - (id)initWithOrigin:(PXStylesheetOrigin)origin;
 
+/**
+ *  Initialize a new stylesheet instance and set its stylesheet origin, optionally making it the current stylesheet
+ *  for that origin
+ *
+ *  @param origin The specificity origin for this stylesheet
+ *  @param makeCurrent A flag indicating if this stylesheet should become the current stylesheet for its origin
+ */
+- (id)initWithOrigin:(PXStylesheetOrigin)origin makeCurrent:(BOOL)makeCurrent;
+
 /**
  *  Add a new rule set to this stylesheet
  *
@@ -95,6 +188,21 @@
  */
 - (void)addRuleSet:(PXRuleSet *)ruleSet;
 
+/**
+ *  Add a media group, along with its rule sets, to this stylesheet
+ *
+ *  @param mediaGroup The media group to add. Nil values are ignored
+ */
+- (void)addMediaGroup:(PXMediaGroup *)mediaGroup;
+
+/**
+ *  Record the src declaration of an @font-face rule so it can be registered again when this stylesheet is loaded
+ *  from its compiled form
+ *
+ *  @param declaration The src declaration
+ */
+- (void)addFontFaceDeclaration:(PXDeclaration *)declaration;
+
 /**
  *  Register a namespace URI for a given prefix. If the prefix is nil or an empty string, then this method sets the
  *  default namespace URI.
@@ -119,6 +227,17 @@
  */
 - (NSArray *)ruleSetsMatchingStyleable:(id<PXStyleable>)element;
 
+/**
+ *  Return a list of rule sets whose selectors match against a specified element, and indicate if the result may be
+ *  cached. The result is cacheable when the selector programs of all candidate rule sets are cacheable, in which case
+ *  any element with the same element name, id, classes, namespace, and class, and with equivalent ancestors, matches
+ *  the same rule sets
+ *
+ *  @param element The element to match against
+ *  @param cacheable Set to NO if the result may not be cached. This may be NULL
+ */
+- (NSArray *)ruleSetsMatchingStyleable:(id<PXStyleable>)element cacheable:(BOOL *)cacheable;
+
 /**
  *  Add a keyframe animation to this stylesheet
  *
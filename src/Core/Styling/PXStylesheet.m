@@ -26,15 +26,22 @@
 #import "PXStylesheet-Private.h"
 #import "PXSpecificity.h"
 #import "PXStylesheetParser.h"
+#import "PXCompiledStylesheet.h"
 #import "PXFileWatcher.h"
 #import "PXStyleUtils.h"
 #import "PXMediaExpression.h"
 #import "PXMediaGroup.h"
 #import "PixateFreestyle.h"
+#import "PXCacheManager.h"
+#import "PXStylesheetDiff.h"
+#import "PXStyleScheduler.h"
+#import "PXFileUtils.h"
 
 //NSString *const PXStylesheetDidChangeNotification = @"kPXStylesheetDidChangeNotification";
 
-static PXStylesheetParser *PARSER;
+static NSMutableArray *PARSER_POOL;
+static const NSUInteger PARSER_POOL_CAPACITY = 4;
+static NSUInteger REQUEST_GENERATIONS[4];
 
 static PXStylesheet *currentApplicationStylesheet = nil;
 static PXStylesheet *currentUserStylesheet = nil;
@@ -47,8 +54,17 @@ static PXStylesheet *currentViewStylesheet = nil;
     PXMediaGroup *activeMediaGroup_;
     NSMutableDictionary *namespacePrefixMap_;
     NSMutableDictionary *keyframesByName_;
+    NSMutableArray *fontFaceDeclarations_;
+
+    // the source text, or the path of the compiled file, that contentHash digests the first time it is asked for,
+    // followed by the sources the text @import'ed
+    NSString *contentSource_;
+    BOOL contentSourceIsFile_;
+    NSArray *contentImports_;
 }
 
+@synthesize contentHash = _contentHash;
+
 #ifdef PX_LOGGING
 static int ddLogLevel = LOG_LEVEL_WARN;
 
@@ -67,10 +83,38 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 
 + (void)initialize
 {
-    // TODO: Use a parser pool since the parser is not thread safe
-    if (PARSER == nil)
+    if (PARSER_POOL == nil)
+    {
+        PARSER_POOL = [[NSMutableArray alloc] initWithCapacity:PARSER_POOL_CAPACITY];
+    }
+}
+
++ (PXStylesheetParser *)dequeueParser
+{
+    PXStylesheetParser *result = nil;
+
+    @synchronized(PARSER_POOL)
     {
-        PARSER = [[PXStylesheetParser alloc] init];
+        result = [PARSER_POOL lastObject];
+
+        if (result)
+        {
+            [PARSER_POOL removeLastObject];
+        }
+    }
+
+    // parsers are not thread safe, so create a new one when all pooled parsers are in use
+    return (result) ? result : [[PXStylesheetParser alloc] init];
+}
+
++ (void)enqueueParser:(PXStylesheetParser *)parser
+{
+    @synchronized(PARSER_POOL)
+    {
+        if (PARSER_POOL.count < PARSER_POOL_CAPACITY)
+        {
+            [PARSER_POOL addObject:parser];
+        }
     }
 }
 
@@ -81,39 +125,160 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 
 + (id)styleSheetFromSource:(NSString *)source withOrigin:(PXStylesheetOrigin)origin filename:(NSString *)name
 {
-    PXStylesheet *result = nil;
+    return [self activateStyleSheet:[self parsedStyleSheetFromSource:source withOrigin:origin filename:name]
+                         withOrigin:origin];
+}
+
++ (id)activateStyleSheet:(PXStylesheet *)result withOrigin:(PXStylesheetOrigin)origin
+{
+    // remove cache entries the new stylesheet may style differently
+    [self invalidateCachesForStylesheet:result withOrigin:origin];
 
-    // TODO: maybe the following can be more intelligent and only remove cache entries that reference the stylesheet
-    // being replaced
+    // a synchronous load supersedes any asynchronous loads still in flight
+    @synchronized(PARSER_POOL)
+    {
+        REQUEST_GENERATIONS[origin]++;
+    }
+
+    [self assignCurrentStylesheet:result withOrigin:origin];
+
+    // update configuration - !!! This needs to be done some other way, just don't know how yet
+    [PXStyleUtils updateStyleForStyleable:PixateFreestyle.configuration];
 
-    // clear style cache
-    [PixateFreestyle clearStyleCache];
+    return result;
+}
+
++ (id)parsedStyleSheetFromSource:(NSString *)source withOrigin:(PXStylesheetOrigin)origin filename:(NSString *)name
+{
+    PXStylesheet *result = nil;
 
     if (source.length > 0)
     {
-        result = [PARSER parse:source withOrigin:origin filename:name];
-        result->_errors = PARSER.errors;
+        PXStylesheetParser *parser = [self dequeueParser];
+
+        result = [parser parse:source withOrigin:origin filename:name];
+        result->_errors = [NSArray arrayWithArray:parser.errors];
+        result->contentImports_ = parser.importedSources;
+
+        [self enqueueParser:parser];
     }
     else
     {
-        result = [[PXStylesheet alloc] initWithOrigin:origin];
+        result = [[PXStylesheet alloc] initWithOrigin:origin makeCurrent:NO];
     }
 
-    // update configuration - !!! This needs to be done some other way, just don't know how yet
-    [PXStyleUtils updateStyleForStyleable:PixateFreestyle.configuration];
+    // only the disk image cache needs the digest, so it is computed when first asked for
+    result->contentSource_ = (source) ? source : @"";
+    result->contentSourceIsFile_ = NO;
 
     return result;
 }
 
-+ (id)styleSheetFromFilePath:(NSString *)aFilePath withOrigin:(PXStylesheetOrigin)origin
++ (id)loadedStyleSheetFromFilePath:(NSString *)aFilePath withOrigin:(PXStylesheetOrigin)origin
+{
+    PXStylesheet *result = nil;
+
+    if ([aFilePath.pathExtension isEqualToString:PXCompiledStylesheetPathExtension])
+    {
+        // a compiled stylesheet that is missing, damaged, or out of date gives way to the CSS next to it
+        NSString *sourcePath = [[aFilePath stringByDeletingPathExtension] stringByAppendingPathExtension:@"css"];
+
+        result = [PXCompiledStylesheet styleSheetFromFilePath:aFilePath withOrigin:origin sourcePath:sourcePath];
+
+        if (result != nil)
+        {
+            // digesting the file would page in all of it, so wait until the disk image cache asks
+            result->contentSource_ = aFilePath;
+            result->contentSourceIsFile_ = YES;
+        }
+        else if ([[NSFileManager defaultManager] fileExistsAtPath:sourcePath])
+        {
+            aFilePath = sourcePath;
+        }
+        else
+        {
+            result = [[PXStylesheet alloc] initWithOrigin:origin makeCurrent:NO];
+            result->_errors = @[ [NSString stringWithFormat:@"Unable to load compiled stylesheet '%@'", aFilePath] ];
+        }
+    }
+
+    if (result == nil)
+    {
+        NSString *source = [NSString stringWithContentsOfFile:aFilePath encoding:NSUTF8StringEncoding error:NULL];
+
+        result = [self parsedStyleSheetFromSource:source withOrigin:origin filename:aFilePath];
+    }
+
+    return result;
+}
+
++ (void)styleSheetFromSource:(NSString *)source
+                  withOrigin:(PXStylesheetOrigin)origin
+                    filename:(NSString *)name
+                  completion:(void (^)(PXStylesheet *stylesheet))completion
+{
+    [self loadStyleSheetWithOrigin:origin loader:^PXStylesheet *{
+        return [self parsedStyleSheetFromSource:source withOrigin:origin filename:name];
+    } completion:completion];
+}
+
++ (void)styleSheetFromFilePath:(NSString *)aFilePath
+                    withOrigin:(PXStylesheetOrigin)origin
+                    completion:(void (^)(PXStylesheet *stylesheet))completion
 {
-    NSString* source = [NSString stringWithContentsOfFile:aFilePath encoding:NSUTF8StringEncoding error:NULL];
+    [self loadStyleSheetWithOrigin:origin loader:^PXStylesheet *{
+        return [self loadedStyleSheetFromFilePath:aFilePath withOrigin:origin];
+    } completion:completion];
+}
+
++ (void)loadStyleSheetWithOrigin:(PXStylesheetOrigin)origin
+                          loader:(PXStylesheet *(^)(void))loader
+                      completion:(void (^)(PXStylesheet *stylesheet))completion
+{
+    NSUInteger generation;
+
+    @synchronized(PARSER_POOL)
+    {
+        generation = ++REQUEST_GENERATIONS[origin];
+    }
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        PXStylesheet *result = loader();
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            BOOL isLatest;
+
+            @synchronized(PARSER_POOL)
+            {
+                isLatest = (generation == REQUEST_GENERATIONS[origin]);
+            }
 
-    return [self styleSheetFromSource:source withOrigin:origin filename:aFilePath];
+            // only swap in the result if no newer load for this origin has been requested since this one started
+            if (isLatest)
+            {
+                [self invalidateCachesForStylesheet:result withOrigin:origin];
+                [self assignCurrentStylesheet:result withOrigin:origin];
+                [PXStyleUtils updateStyleForStyleable:PixateFreestyle.configuration];
+            }
+
+            if (completion)
+            {
+                completion(result);
+            }
+        });
+    });
+}
+
++ (id)styleSheetFromFilePath:(NSString *)aFilePath withOrigin:(PXStylesheetOrigin)origin
+{
+    return [self activateStyleSheet:[self loadedStyleSheetFromFilePath:aFilePath withOrigin:origin] withOrigin:origin];
 }
 
 + (void)clearCache
 {
+    // media queries may evaluate differently now, so previous matches are no longer valid
+    [PXCacheManager clearRuleSetMatchCache];
+
     [[self currentApplicationStylesheet] clearCache];
     [[self currentUserStylesheet] clearCache];
     [[self currentViewStylesheet] clearCache];
@@ -127,12 +292,21 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 }
 
 - (id)initWithOrigin:(PXStylesheetOrigin)anOrigin
+{
+    return [self initWithOrigin:anOrigin makeCurrent:YES];
+}
+
+- (id)initWithOrigin:(PXStylesheetOrigin)anOrigin makeCurrent:(BOOL)makeCurrent
 {
     if (self = [super init])
     {
         self->_origin = anOrigin;
-        // Set this new stylesheet as one of the three current sheets (i.e. App, User, View)
-        [PXStylesheet assignCurrentStylesheet:self withOrigin:anOrigin];
+
+        if (makeCurrent)
+        {
+            // Set this new stylesheet as one of the three current sheets (i.e. App, User, View)
+            [PXStylesheet assignCurrentStylesheet:self withOrigin:anOrigin];
+        }
     }
 
     return self;
@@ -166,6 +340,11 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     return combined;
 }
 
+- (BOOL)isCurrent
+{
+    return (self == currentApplicationStylesheet || self == currentUserStylesheet || self == currentViewStylesheet);
+}
+
 - (NSArray *)ruleSetsForStyleable:(id<PXStyleable>)styleable
 {
     NSMutableArray *combined;
@@ -191,6 +370,21 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     return (mediaGroups_) ? [NSArray arrayWithArray:mediaGroups_] : nil;
 }
 
+- (NSDictionary *)namespacePrefixes
+{
+    return (namespacePrefixMap_) ? [NSDictionary dictionaryWithDictionary:namespacePrefixMap_] : nil;
+}
+
+- (NSArray *)keyframes
+{
+    return keyframesByName_.allValues;
+}
+
+- (NSArray *)fontFaceDeclarations
+{
+    return (fontFaceDeclarations_) ? [NSArray arrayWithArray:fontFaceDeclarations_] : nil;
+}
+
 + (PXStylesheet *)currentApplicationStylesheet
 {
 	return currentApplicationStylesheet;
@@ -206,6 +400,42 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 	return currentViewStylesheet;
 }
 
+- (NSString *)contentHash
+{
+    @synchronized(self)
+    {
+        if (_contentHash == nil && contentSource_)
+        {
+            NSData *data = nil;
+
+            if (contentSourceIsFile_)
+            {
+                data = [NSData dataWithContentsOfFile:contentSource_ options:NSDataReadingMappedIfSafe error:NULL];
+            }
+            else
+            {
+                NSMutableData *source = [[contentSource_ dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+
+                // an edit to an imported file changes the stylesheet as much as one to the importing file. Each
+                // source is terminated, so moving text between files changes the digest too
+                for (NSString *import in contentImports_)
+                {
+                    [source appendBytes:"\0" length:1];
+                    [source appendData:[import dataUsingEncoding:NSUTF8StringEncoding]];
+                }
+
+                data = source;
+            }
+
+            _contentHash = (data) ? [PXFileUtils digestOfData:data] : nil;
+            contentSource_ = nil;
+            contentImports_ = nil;
+        }
+
+        return _contentHash;
+    }
+}
+
 #pragma mark - Setters
 
 - (void)setActiveMediaQuery:(id<PXMediaExpression>)activeMediaQuery
@@ -222,12 +452,11 @@ static int ddLogLevel = LOG_LEVEL_WARN;
         if(state)
         {
             [[PXFileWatcher sharedInstance] watchFile:self.filePath handler:^{
-                // reload file
-                [PXStylesheet styleSheetFromFilePath:self.filePath withOrigin:self.origin];
-
-                // update all views
-                [PixateFreestyle updateStylesForAllViews];
-                
+                // reload file off of the main thread
+                [PXStylesheet styleSheetFromFilePath:self.filePath withOrigin:self.origin completion:^(PXStylesheet *stylesheet) {
+                    // update the views the edit may have changed
+                    [PXStylesheet updateStylesForChangesOfStylesheet:stylesheet];
+                }];
             }];
         }
         else
@@ -251,6 +480,14 @@ static int ddLogLevel = LOG_LEVEL_WARN;
         }
 
         [activeMediaGroup_ addRuleSet:ruleSet];
+
+        // the stylesheet no longer matches the content it was loaded from
+        [self clearContentHash];
+
+        if (self.isCurrent)
+        {
+            [PXCacheManager clearRuleSetMatchCache];
+        }
     }
 }
 
@@ -264,10 +501,34 @@ static int ddLogLevel = LOG_LEVEL_WARN;
         }
 
         [mediaGroups_ addObject:mediaGroup];
+        [self clearContentHash];
+
+        if (self.isCurrent)
+        {
+            [PXCacheManager clearRuleSetMatchCache];
+        }
+    }
+}
+
+- (void)addFontFaceDeclaration:(PXDeclaration *)declaration
+{
+    if (declaration)
+    {
+        if (!fontFaceDeclarations_)
+        {
+            fontFaceDeclarations_ = [NSMutableArray array];
+        }
+
+        [fontFaceDeclarations_ addObject:declaration];
     }
 }
 
 - (NSArray *)ruleSetsMatchingStyleable:(id<PXStyleable>)element
+{
+    return [self ruleSetsMatchingStyleable:element cacheable:NULL];
+}
+
+- (NSArray *)ruleSetsMatchingStyleable:(id<PXStyleable>)element cacheable:(BOOL *)cacheable
 {
     NSMutableArray *result = [NSMutableArray array];
 
@@ -279,6 +540,11 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 
         for (PXRuleSet *ruleSet in candidateRuleSets)
         {
+            if (cacheable && *cacheable && !ruleSet.selectorProgram.cacheable)
+            {
+                *cacheable = NO;
+            }
+
             if ([ruleSet matches:element])
             {
                 DDLogInfo(@"%@ matched\n%@", [PXStyleUtils descriptionForStyleable:element], ruleSet.description);
@@ -344,14 +610,95 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     return [keyframesByName_ objectForKey:name];
 }
 
+- (void)clearContentHash
+{
+    // rule sets are added while parsing, before there is anything to clear, so avoid the lock then
+    if (_contentHash || contentSource_)
+    {
+        @synchronized(self)
+        {
+            _contentHash = nil;
+            contentSource_ = nil;
+            contentImports_ = nil;
+        }
+    }
+}
+
 #pragma mark - Static public methods
 
 // none
 
 #pragma mark - Static private methods
 
++ (PXStylesheet *)currentStylesheetWithOrigin:(PXStylesheetOrigin)origin
+{
+    switch (origin)
+    {
+        case PXStylesheetOriginApplication:
+            return currentApplicationStylesheet;
+
+        case PXStylesheetOriginUser:
+            return currentUserStylesheet;
+
+        case PXStylesheetOriginView:
+            return currentViewStylesheet;
+
+        case PXStylesheetOriginInline:
+            return nil;
+    }
+
+    return nil;
+}
+
++ (void)invalidateCachesForStylesheet:(PXStylesheet *)stylesheet withOrigin:(PXStylesheetOrigin)origin
+{
+    PXStylesheetDiff *diff = [PXStylesheetDiff diffFromStylesheet:[self currentStylesheetWithOrigin:origin] toStylesheet:stylesheet];
+
+    if (diff.affectsAll)
+    {
+        [PixateFreestyle clearStyleCache];
+    }
+    else if (diff.hasChanges)
+    {
+        // cached cell styles that no changed rule set can reach are still valid. Background images are keyed by a
+        // hash of the declarations that produced them, so images of unchanged rules stay valid too
+        [PXCacheManager removeStyleTreeInfosPassingTest:^BOOL(PXStyleTreeInfo *styleTreeInfo) {
+            return [diff affectsAnyStyleableAtoms:styleTreeInfo.styleableAtoms];
+        }];
+    }
+
+    if (stylesheet)
+    {
+        stylesheet->_changesFromPreviousStylesheet = diff;
+    }
+}
+
++ (void)updateStylesForChangesOfStylesheet:(PXStylesheet *)stylesheet
+{
+    PXStylesheetDiff *diff = stylesheet.changesFromPreviousStylesheet;
+
+    if (diff == nil || diff.affectsAll)
+    {
+        [PixateFreestyle updateStylesForAllViews];
+    }
+    else if (diff.hasChanges)
+    {
+        for (UIWindow *window in [UIApplication sharedApplication].windows)
+        {
+            [PXStyleUtils enumerateStyleableAndDescendants:window usingBlock:^(id<PXStyleable> styleable, BOOL *stop, BOOL *stopDescending) {
+                if ([diff affectsStyleable:styleable])
+                {
+                    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:styleable recursively:NO];
+                }
+            }];
+        }
+    }
+}
+
 + (void)assignCurrentStylesheet:(PXStylesheet *)sheet withOrigin:(PXStylesheetOrigin)anOrigin
 {
+    [PXCacheManager clearRuleSetMatchCache];
+
     switch (anOrigin)
     {
         case PXStylesheetOriginApplication:
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXCompiledStylesheet.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStylesheet.h"
+
+/**
+ *  The file extension used for compiled stylesheets
+ */
+extern NSString *const PXCompiledStylesheetPathExtension;
+
+/**
+ *  Compiled stylesheets begin with this magic number followed by the format version. The version must be bumped
+ *  whenever the layout of any record changes.
+ */
+extern const uint32_t PXCompiledStylesheetMagic;
+extern const uint32_t PXCompiledStylesheetVersion;
+
+/**
+ *  String indexes and record offsets use this value to indicate nil
+ */
+extern const uint32_t PXCompiledNone;
+
+/**
+ *  The header at the start of a compiled stylesheet. Every offset is a byte offset from the start of the data, so the
+ *  data can be mapped anywhere in memory. All values are 32-bit little-endian words and every record is word aligned.
+ *
+ *  The string table is an array of (character offset, length) pairs indexing into a pool of UTF-16 characters. Each
+ *  of the namespace, media group, keyframe, font-face, and error sections is an array of words: string index pairs
+ *  for namespaces, string indexes for errors, and record offsets for everything else. The source digest is the string
+ *  index of the digest of the CSS file the stylesheet was compiled from, or PXCompiledNone.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t length;
+    uint32_t stringCount;
+    uint32_t stringsOffset;
+    uint32_t charactersOffset;
+    uint32_t namespaceCount;
+    uint32_t namespacesOffset;
+    uint32_t mediaGroupCount;
+    uint32_t mediaGroupsOffset;
+    uint32_t keyframeCount;
+    uint32_t keyframesOffset;
+    uint32_t fontFaceCount;
+    uint32_t fontFacesOffset;
+    uint32_t errorCount;
+    uint32_t errorsOffset;
+    uint32_t sourceDigest;
+} PXCompiledStylesheetHeader;
+
+/**
+ *  The first word of each selector record
+ */
+typedef enum
+{
+    PXCompiledSelectorType,
+    PXCompiledSelectorAttribute,
+    PXCompiledSelectorAttributeOperator,
+    PXCompiledSelectorClass,
+    PXCompiledSelectorId,
+    PXCompiledSelectorPseudoClass,
+    PXCompiledSelectorPseudoClassFunction,
+    PXCompiledSelectorPseudoClassPredicate,
+    PXCompiledSelectorNot,
+    PXCompiledSelectorDescendantCombinator,
+    PXCompiledSelectorChildCombinator,
+    PXCompiledSelectorAdjacentSiblingCombinator,
+    PXCompiledSelectorSiblingCombinator
+} PXCompiledSelectorKind;
+
+/**
+ *  The first word of each media query record
+ */
+typedef enum
+{
+    PXCompiledMediaQueryNamed,
+    PXCompiledMediaQueryGroup
+} PXCompiledMediaQueryKind;
+
+/**
+ *  Lexeme and media query values are stored as four words: a kind, a string index (the text of a string or the units
+ *  of a dimension), and a double split over two words
+ */
+typedef enum
+{
+    PXCompiledValueNone,
+    PXCompiledValueString,
+    PXCompiledValueNumber,
+    PXCompiledValueDimension
+} PXCompiledValueKind;
+
+/**
+ *  PXCompiledStylesheet wraps the data of a stylesheet produced by PXStylesheetCompiler. Files are memory-mapped, and
+ *  stylesheets built from this data only create the objects needed to find candidate rule sets. Selectors and
+ *  declarations of a rule set are decoded the first time they are needed.
+ */
+@interface PXCompiledStylesheet : NSObject
+
+/**
+ *  Determine if the specified data begins with a compiled stylesheet header of the current version
+ *
+ *  @param data The data to test
+ */
++ (BOOL)isCompiledStylesheetData:(NSData *)data;
+
+/**
+ *  Memory-map the specified file and return a stylesheet for its contents. The stylesheet does not become the current
+ *  stylesheet for its origin. This returns nil if the file could not be read or is not a valid compiled stylesheet.
+ *
+ *  @param path The path to the compiled stylesheet
+ *  @param origin The specificity origin for the stylesheet
+ */
++ (PXStylesheet *)styleSheetFromFilePath:(NSString *)path withOrigin:(PXStylesheetOrigin)origin;
+
+/**
+ *  Memory-map the specified file and return a stylesheet for its contents, as long as it is still current for the
+ *  specified CSS file. This returns nil if the compiled file could not be loaded, if it is older than the CSS file, or
+ *  if it was compiled from different CSS. The CSS file is only checked if it exists.
+ *
+ *  @param path The path to the compiled stylesheet
+ *  @param origin The specificity origin for the stylesheet
+ *  @param sourcePath The path to the CSS file the stylesheet was compiled from
+ */
++ (PXStylesheet *)styleSheetFromFilePath:(NSString *)path withOrigin:(PXStylesheetOrigin)origin sourcePath:(NSString *)sourcePath;
+
+/**
+ *  Initialize a new instance with the specified data. This returns nil if the data is not a valid compiled stylesheet.
+ *
+ *  @param data The compiled stylesheet data. Mapped data is retained, not copied
+ */
+- (id)initWithData:(NSData *)data;
+
+/**
+ *  The digest of the CSS file this stylesheet was compiled from, or nil if it was not compiled from a file
+ */
+@property (nonatomic, readonly) NSString *sourceDigest;
+
+/**
+ *  Create a new stylesheet from this instance's data
+ *
+ *  @param origin The specificity origin for the stylesheet
+ */
+- (PXStylesheet *)stylesheetWithOrigin:(PXStylesheetOrigin)origin;
+
+@end
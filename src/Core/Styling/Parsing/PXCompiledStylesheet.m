@@ -0,0 +1,886 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXCompiledStylesheet.m
+//  Pixate
+//
+
+#import "PXCompiledStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXStylesheetLexeme.h"
+#import "PXDeclaration.h"
+#import "PXMediaGroup.h"
+#import "PXNamedMediaExpression.h"
+#import "PXMediaExpressionGroup.h"
+#import "PXIdSelector.h"
+#import "PXClassSelector.h"
+#import "PXNotPseudoClass.h"
+#import "PXPseudoClassSelector.h"
+#import "PXPseudoClassPredicate.h"
+#import "PXPseudoClassFunction.h"
+#import "PXAttributeSelector.h"
+#import "PXAttributeSelectorOperator.h"
+#import "PXAdjacentSiblingCombinator.h"
+#import "PXChildCombinator.h"
+#import "PXDescendantCombinator.h"
+#import "PXSiblingCombinator.h"
+#import "PXKeyframeBlock.h"
+#import "PXFontRegistry.h"
+#import "PXFileUtils.h"
+
+NSString *const PXCompiledStylesheetPathExtension = @"pxssc";
+
+const uint32_t PXCompiledStylesheetMagic = 0x43535850; // "PXSC"
+const uint32_t PXCompiledStylesheetVersion = 2;
+const uint32_t PXCompiledNone = 0xFFFFFFFF;
+
+/**
+ *  A bounds-checked reader over the words of a record. Reads past the end of the data return PXCompiledNone and mark
+ *  the cursor as failed, so damaged data produces missing values instead of crashes.
+ */
+typedef struct
+{
+    const uint8_t *bytes;
+    uint32_t length;
+    uint32_t offset;
+    BOOL failed;
+} PXCompiledCursor;
+
+static inline uint32_t PXCompiledCursorReadWord(PXCompiledCursor *cursor)
+{
+    if (cursor->failed || cursor->offset > cursor->length - sizeof(uint32_t))
+    {
+        cursor->failed = YES;
+        return PXCompiledNone;
+    }
+
+    uint32_t result;
+
+    memcpy(&result, cursor->bytes + cursor->offset, sizeof(uint32_t));
+    cursor->offset += sizeof(uint32_t);
+
+    return CFSwapInt32LittleToHost(result);
+}
+
+static inline double PXCompiledCursorReadDouble(PXCompiledCursor *cursor)
+{
+    uint64_t low = PXCompiledCursorReadWord(cursor);
+    uint64_t high = PXCompiledCursorReadWord(cursor);
+    uint64_t bits = (high << 32) | low;
+    double result;
+
+    memcpy(&result, &bits, sizeof(double));
+
+    return result;
+}
+
+@interface PXCompiledStylesheet ()
+- (PXCompiledCursor)cursorAtOffset:(uint32_t)offset;
+- (NSString *)stringAtIndex:(uint32_t)index;
+- (id<PXSelector>)selectorAtOffset:(uint32_t)offset before:(uint32_t)limit;
+- (PXDeclaration *)declarationAtOffset:(uint32_t)offset;
+@end
+
+#pragma mark - PXCompiledRuleSet
+
+/**
+ *  A rule set backed by a record in a compiled stylesheet. Specificity is restored up front, but selectors and
+ *  declarations are only decoded the first time something asks for them.
+ */
+@interface PXCompiledRuleSet : PXRuleSet
+- (id)initWithImage:(PXCompiledStylesheet *)image selectorsOffset:(uint32_t)selectorsOffset;
+@end
+
+@implementation PXCompiledRuleSet
+{
+    PXCompiledStylesheet *image_;
+    uint32_t selectorsOffset_;
+    // set with release semantics once built, so readers that see them set also see what was built
+    volatile BOOL selectorsMaterialized_;
+    volatile BOOL declarationsMaterialized_;
+
+    // set while building, so the calls back into the materialize methods that building makes return early
+    BOOL materializingSelectors_;
+    BOOL materializingDeclarations_;
+}
+
+- (id)initWithImage:(PXCompiledStylesheet *)image selectorsOffset:(uint32_t)selectorsOffset
+{
+    if (self = [super init])
+    {
+        image_ = image;
+        selectorsOffset_ = selectorsOffset;
+    }
+
+    return self;
+}
+
+- (void)materializeSelectors
+{
+    // this is called on every match, so only the one-time build takes the lock
+    if (__atomic_load_n(&selectorsMaterialized_, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    @synchronized(self)
+    {
+        if (selectorsMaterialized_ == NO && materializingSelectors_ == NO)
+        {
+            PXCompiledCursor cursor = [image_ cursorAtOffset:selectorsOffset_];
+            uint32_t count = PXCompiledCursorReadWord(&cursor);
+            NSMutableArray *selectors = [NSMutableArray array];
+            PXSpecificity *specificity = [[PXSpecificity alloc] init];
+
+            materializingSelectors_ = YES;
+
+            // readers that skip the lock, like the specificity getter, must only ever see the restored values or
+            // the recomputed ones, so the recomputed ones are built aside and published in one call
+            for (uint32_t i = 0; i < count && !cursor.failed; i++)
+            {
+                id<PXSelector> selector = [image_ selectorAtOffset:PXCompiledCursorReadWord(&cursor) before:selectorsOffset_];
+
+                if (selector)
+                {
+                    [selectors addObject:selector];
+                    [selector incrementSpecificity:specificity];
+                }
+            }
+
+            [super setSelectors:selectors withSpecificity:specificity];
+
+            __atomic_store_n(&selectorsMaterialized_, YES, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+- (void)materializeDeclarations
+{
+    if (__atomic_load_n(&declarationsMaterialized_, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    @synchronized(self)
+    {
+        if (declarationsMaterialized_ == NO && materializingDeclarations_ == NO)
+        {
+            PXCompiledCursor cursor = [image_ cursorAtOffset:selectorsOffset_];
+            uint32_t selectorCount = PXCompiledCursorReadWord(&cursor);
+
+            materializingDeclarations_ = YES;
+
+            // skip over selectors
+            for (uint32_t i = 0; i < selectorCount && !cursor.failed; i++)
+            {
+                PXCompiledCursorReadWord(&cursor);
+            }
+
+            uint32_t count = PXCompiledCursorReadWord(&cursor);
+
+            for (uint32_t i = 0; i < count && !cursor.failed; i++)
+            {
+                [super addDeclaration:[image_ declarationAtOffset:PXCompiledCursorReadWord(&cursor)]];
+            }
+
+            __atomic_store_n(&declarationsMaterialized_, YES, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+#pragma mark - Overrides
+
+- (NSArray *)selectors
+{
+    [self materializeSelectors];
+
+    return [super selectors];
+}
+
+- (PXTypeSelector *)targetTypeSelector
+{
+    [self materializeSelectors];
+
+    return [super targetTypeSelector];
+}
+
+- (PXSelectorProgram *)selectorProgram
+{
+    [self materializeSelectors];
+
+    return [super selectorProgram];
+}
+
+- (uint64_t)sortKey
+{
+    // materializing recomputes the key one selector at a time, so it must not be read part way through
+    [self materializeSelectors];
+
+    return [super sortKey];
+}
+
+- (void)addSelector:(id<PXSelector>)selector
+{
+    [self materializeSelectors];
+    [super addSelector:selector];
+}
+
+- (void)setSelectors:(NSArray *)selectors withSpecificity:(PXSpecificity *)specificity
+{
+    [self materializeSelectors];
+    [super setSelectors:selectors withSpecificity:specificity];
+}
+
+- (BOOL)matches:(id<PXStyleable>)element
+{
+    [self materializeSelectors];
+
+    return [super matches:element];
+}
+
+- (NSArray *)declarations
+{
+    [self materializeDeclarations];
+
+    return [super declarations];
+}
+
+- (void)addDeclaration:(PXDeclaration *)declaration
+{
+    [self materializeDeclarations];
+    [super addDeclaration:declaration];
+}
+
+- (void)removeDeclaration:(PXDeclaration *)declaration
+{
+    [self materializeDeclarations];
+    [super removeDeclaration:declaration];
+}
+
+- (PXDeclaration *)declarationForName:(NSString *)name
+{
+    [self materializeDeclarations];
+
+    return [super declarationForName:name];
+}
+
+- (BOOL)hasDeclarationForName:(NSString *)name
+{
+    [self materializeDeclarations];
+
+    return [super hasDeclarationForName:name];
+}
+
+- (NSString *)description
+{
+    [self materializeSelectors];
+    [self materializeDeclarations];
+
+    return [super description];
+}
+
+@end
+
+#pragma mark - PXCompiledStylesheet
+
+@implementation PXCompiledStylesheet
+{
+    NSData *data_;
+    const uint8_t *bytes_;
+    PXCompiledStylesheetHeader header_;
+    // decoded strings, retained and published with a compare-and-swap, so lookups never take a lock
+    void **strings_;
+    NSMutableDictionary *declarations_;
+}
+
+#pragma mark - Static Methods
+
++ (BOOL)isCompiledStylesheetData:(NSData *)data
+{
+    if (data.length < sizeof(PXCompiledStylesheetHeader))
+    {
+        return NO;
+    }
+
+    uint32_t words[2];
+
+    [data getBytes:words length:sizeof(words)];
+
+    return CFSwapInt32LittleToHost(words[0]) == PXCompiledStylesheetMagic
+        && CFSwapInt32LittleToHost(words[1]) == PXCompiledStylesheetVersion;
+}
+
++ (PXStylesheet *)styleSheetFromFilePath:(NSString *)path withOrigin:(PXStylesheetOrigin)origin
+{
+    return [self styleSheetFromFilePath:path withOrigin:origin sourcePath:nil];
+}
+
++ (PXStylesheet *)styleSheetFromFilePath:(NSString *)path withOrigin:(PXStylesheetOrigin)origin sourcePath:(NSString *)sourcePath
+{
+    NSData *data = (path) ? [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:NULL] : nil;
+    PXCompiledStylesheet *image = (data) ? [[PXCompiledStylesheet alloc] initWithData:data] : nil;
+
+    if (image != nil && sourcePath != nil && [self image:image atPath:path isStaleForSourcePath:sourcePath])
+    {
+        image = nil;
+    }
+
+    PXStylesheet *result = [image stylesheetWithOrigin:origin];
+
+    result.filePath = path;
+
+    return result;
+}
+
++ (BOOL)image:(PXCompiledStylesheet *)image atPath:(NSString *)path isStaleForSourcePath:(NSString *)sourcePath
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSDate *sourceDate = [[fileManager attributesOfItemAtPath:sourcePath error:NULL] fileModificationDate];
+    NSDate *compiledDate = [[fileManager attributesOfItemAtPath:path error:NULL] fileModificationDate];
+    BOOL result = NO;
+
+    if (sourceDate != nil)
+    {
+        // the CSS was edited after it was compiled. Otherwise, a copy or checkout may have reset the dates, so the
+        // contents are compared as well
+        if (compiledDate == nil || [compiledDate compare:sourceDate] == NSOrderedAscending)
+        {
+            result = YES;
+        }
+        else
+        {
+            NSData *source = [NSData dataWithContentsOfFile:sourcePath options:NSDataReadingMappedIfSafe error:NULL];
+
+            result = (source == nil || ![[PXFileUtils digestOfData:source] isEqualToString:image.sourceDigest]);
+        }
+    }
+
+    return result;
+}
+
+#pragma mark - Initializers
+
+- (id)initWithData:(NSData *)data
+{
+    if ([PXCompiledStylesheet isCompiledStylesheetData:data] == NO)
+    {
+        return nil;
+    }
+
+    if (self = [super init])
+    {
+        data_ = data;
+        bytes_ = data.bytes;
+
+        PXCompiledCursor cursor = [self cursorAtOffset:0];
+        uint32_t *fields = (uint32_t *) &header_;
+
+        for (NSUInteger i = 0; i < sizeof(PXCompiledStylesheetHeader) / sizeof(uint32_t); i++)
+        {
+            fields[i] = PXCompiledCursorReadWord(&cursor);
+        }
+
+        // make sure the string table and its characters lie within the data before trusting any string index
+        uint64_t stringsEnd = (uint64_t) header_.stringsOffset + (uint64_t) header_.stringCount * 2 * sizeof(uint32_t);
+
+        if (header_.length != data.length || stringsEnd > data.length || header_.charactersOffset > data.length)
+        {
+            return nil;
+        }
+
+        strings_ = calloc(MAX(header_.stringCount, 1u), sizeof(void *));
+
+        declarations_ = [[NSMutableDictionary alloc] init];
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSString *)sourceDigest
+{
+    return [self stringAtIndex:header_.sourceDigest];
+}
+
+#pragma mark - Methods
+
+- (PXStylesheet *)stylesheetWithOrigin:(PXStylesheetOrigin)origin
+{
+    PXStylesheet *result = [[PXStylesheet alloc] initWithOrigin:origin makeCurrent:NO];
+    PXCompiledCursor cursor;
+
+    // namespaces
+    cursor = [self cursorAtOffset:header_.namespacesOffset];
+
+    for (uint32_t i = 0; i < header_.namespaceCount && !cursor.failed; i++)
+    {
+        NSString *prefix = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+        NSString *uri = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+
+        [result setURI:uri forNamespacePrefix:prefix];
+    }
+
+    // media groups and their rule sets. Only the partition keys are decoded here
+    cursor = [self cursorAtOffset:header_.mediaGroupsOffset];
+
+    for (uint32_t i = 0; i < header_.mediaGroupCount && !cursor.failed; i++)
+    {
+        [result addMediaGroup:[self mediaGroupAtOffset:PXCompiledCursorReadWord(&cursor) origin:origin]];
+    }
+
+    // keyframes
+    cursor = [self cursorAtOffset:header_.keyframesOffset];
+
+    for (uint32_t i = 0; i < header_.keyframeCount && !cursor.failed; i++)
+    {
+        [result addKeyframe:[self keyframeAtOffset:PXCompiledCursorReadWord(&cursor)]];
+    }
+
+    // fonts are registered at load time, just like PXStylesheetParser does when it encounters @font-face
+    cursor = [self cursorAtOffset:header_.fontFacesOffset];
+
+    for (uint32_t i = 0; i < header_.fontFaceCount && !cursor.failed; i++)
+    {
+        PXDeclaration *declaration = [self declarationAtOffset:PXCompiledCursorReadWord(&cursor)];
+
+        if (declaration)
+        {
+            [result addFontFaceDeclaration:declaration];
+            [PXFontRegistry loadFontFromURL:declaration.URLValue];
+        }
+    }
+
+    // errors captured when the stylesheet was compiled
+    if (header_.errorCount > 0)
+    {
+        NSMutableArray *errors = [NSMutableArray arrayWithCapacity:header_.errorCount];
+
+        cursor = [self cursorAtOffset:header_.errorsOffset];
+
+        for (uint32_t i = 0; i < header_.errorCount && !cursor.failed; i++)
+        {
+            NSString *error = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+
+            if (error)
+            {
+                [errors addObject:error];
+            }
+        }
+
+        result.errors = errors;
+    }
+
+    return result;
+}
+
+#pragma mark - Decoding
+
+- (PXCompiledCursor)cursorAtOffset:(uint32_t)offset
+{
+    PXCompiledCursor cursor = { bytes_, (uint32_t) data_.length, offset, (offset == PXCompiledNone) };
+
+    return cursor;
+}
+
+- (NSString *)stringAtIndex:(uint32_t)index
+{
+    if (index >= header_.stringCount)
+    {
+        return nil;
+    }
+
+    void *result = __atomic_load_n(&strings_[index], __ATOMIC_ACQUIRE);
+
+    if (result == NULL)
+    {
+        PXCompiledCursor cursor = [self cursorAtOffset:header_.stringsOffset + index * 2 * sizeof(uint32_t)];
+        uint64_t start = PXCompiledCursorReadWord(&cursor);
+        uint64_t length = PXCompiledCursorReadWord(&cursor);
+        uint64_t end = header_.charactersOffset + (start + length) * sizeof(unichar);
+
+        if (end > data_.length)
+        {
+            return nil;
+        }
+
+        const unichar *characters = (const unichar *) (bytes_ + header_.charactersOffset) + start;
+
+        // strings are copied out of the mapping, so they remain valid after this instance goes away
+        void *string = (void *) CFBridgingRetain([[NSString alloc] initWithCharacters:characters length:(NSUInteger) length]);
+
+        // racing threads may each decode the string, but only the first one is kept
+        if (__atomic_compare_exchange_n(&strings_[index], &result, string, NO, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            result = string;
+        }
+        else
+        {
+            CFRelease(string);
+        }
+    }
+
+    return (__bridge NSString *) result;
+}
+
+- (id)valueFromCursor:(PXCompiledCursor *)cursor
+{
+    uint32_t kind = PXCompiledCursorReadWord(cursor);
+    NSString *string = [self stringAtIndex:PXCompiledCursorReadWord(cursor)];
+    double number = PXCompiledCursorReadDouble(cursor);
+
+    switch (kind)
+    {
+        case PXCompiledValueString:
+            return string;
+
+        case PXCompiledValueNumber:
+            // lexemes hold floats. Only values that cannot be represented as a float were doubles to begin with
+            return ((double) (float) number == number) ? [NSNumber numberWithFloat:(float) number] : [NSNumber numberWithDouble:number];
+
+        case PXCompiledValueDimension:
+            return [PXDimension dimensionWithNumber:number withDimension:string];
+
+        default:
+            return nil;
+    }
+}
+
+- (id<PXMediaExpression>)mediaQueryAtOffset:(uint32_t)offset before:(uint32_t)limit
+{
+    if (offset >= limit)
+    {
+        return nil;
+    }
+
+    PXCompiledCursor cursor = [self cursorAtOffset:offset];
+    uint32_t kind = PXCompiledCursorReadWord(&cursor);
+
+    if (cursor.failed)
+    {
+        return nil;
+    }
+
+    if (kind == PXCompiledMediaQueryGroup)
+    {
+        PXMediaExpressionGroup *group = [[PXMediaExpressionGroup alloc] init];
+        uint32_t count = PXCompiledCursorReadWord(&cursor);
+
+        for (uint32_t i = 0; i < count && !cursor.failed; i++)
+        {
+            id<PXMediaExpression> expression = [self mediaQueryAtOffset:PXCompiledCursorReadWord(&cursor) before:offset];
+
+            if (expression)
+            {
+                [group addExpression:expression];
+            }
+        }
+
+        return group;
+    }
+    else
+    {
+        NSString *name = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+        id value = [self valueFromCursor:&cursor];
+
+        return [[PXNamedMediaExpression alloc] initWithName:name value:value];
+    }
+}
+
+- (PXMediaGroup *)mediaGroupAtOffset:(uint32_t)offset origin:(PXStylesheetOrigin)origin
+{
+    PXCompiledCursor cursor = [self cursorAtOffset:offset];
+    id<PXMediaExpression> query = [self mediaQueryAtOffset:PXCompiledCursorReadWord(&cursor) before:offset];
+    uint32_t count = PXCompiledCursorReadWord(&cursor);
+    PXMediaGroup *result = [[PXMediaGroup alloc] initWithQuery:query origin:origin];
+
+    for (uint32_t i = 0; i < count && !cursor.failed; i++)
+    {
+        PXCompiledCursor ruleSetCursor = [self cursorAtOffset:PXCompiledCursorReadWord(&cursor)];
+        uint32_t idCount = PXCompiledCursorReadWord(&ruleSetCursor);
+        uint32_t classCount = PXCompiledCursorReadWord(&ruleSetCursor);
+        uint32_t elementCount = PXCompiledCursorReadWord(&ruleSetCursor);
+        NSString *elementName = [self stringAtIndex:PXCompiledCursorReadWord(&ruleSetCursor)];
+        NSString *styleId = [self stringAtIndex:PXCompiledCursorReadWord(&ruleSetCursor)];
+        uint32_t styleClassCount = PXCompiledCursorReadWord(&ruleSetCursor);
+        NSMutableArray *styleClasses = nil;
+
+        for (uint32_t j = 0; j < styleClassCount && !ruleSetCursor.failed; j++)
+        {
+            NSString *styleClass = [self stringAtIndex:PXCompiledCursorReadWord(&ruleSetCursor)];
+
+            if (styleClass)
+            {
+                if (styleClasses == nil) styleClasses = [NSMutableArray arrayWithCapacity:styleClassCount];
+                [styleClasses addObject:styleClass];
+            }
+        }
+
+        if (ruleSetCursor.failed)
+        {
+            continue;
+        }
+
+        PXCompiledRuleSet *ruleSet = [[PXCompiledRuleSet alloc] initWithImage:self selectorsOffset:ruleSetCursor.offset];
+
+        [ruleSet.specificity setSpecificity:kSpecificityTypeId toValue:idCount];
+        [ruleSet.specificity setSpecificity:kSpecificityTypeClassOrAttribute toValue:classCount];
+        [ruleSet.specificity setSpecificity:kSpecificityTypeElement toValue:elementCount];
+
+        [result addRuleSet:ruleSet withElementName:elementName styleId:styleId styleClasses:styleClasses];
+    }
+
+    return result;
+}
+
+- (id<PXSelector>)selectorAtOffset:(uint32_t)offset before:(uint32_t)limit
+{
+    // records are written after the records they refer to. Enforcing that here keeps damaged data from causing cycles
+    if (offset >= limit)
+    {
+        return nil;
+    }
+
+    PXCompiledCursor cursor = [self cursorAtOffset:offset];
+    uint32_t kind = PXCompiledCursorReadWord(&cursor);
+    id<PXSelector> result = nil;
+
+    if (cursor.failed)
+    {
+        return nil;
+    }
+
+    switch (kind)
+    {
+        case PXCompiledSelectorType:
+        {
+            NSString *namespaceURI = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+            NSString *typeName = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+            NSString *pseudoElement = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+            uint32_t count = PXCompiledCursorReadWord(&cursor);
+            PXTypeSelector *typeSelector = [[PXTypeSelector alloc] initWithNamespaceURI:namespaceURI typeName:typeName];
+
+            typeSelector.pseudoElement = pseudoElement;
+
+            for (uint32_t i = 0; i < count && !cursor.failed; i++)
+            {
+                [typeSelector addAttributeExpression:[self selectorAtOffset:PXCompiledCursorReadWord(&cursor) before:offset]];
+            }
+
+            result = typeSelector;
+            break;
+        }
+
+        case PXCompiledSelectorAttribute:
+        {
+            NSString *namespaceURI = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+            NSString *name = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+
+            result = [[PXAttributeSelector alloc] initWithNamespaceURI:namespaceURI attributeName:name];
+            break;
+        }
+
+        case PXCompiledSelectorAttributeOperator:
+        {
+            PXAttributeSelectorOperatorType type = PXCompiledCursorReadWord(&cursor);
+            id attributeSelector = [self selectorAtOffset:PXCompiledCursorReadWord(&cursor) before:offset];
+            NSString *value = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+
+            if ([attributeSelector isKindOfClass:[PXAttributeSelector class]])
+            {
+                result = [[PXAttributeSelectorOperator alloc] initWithOperatorType:type
+                                                                 attributeSelector:attributeSelector
+                                                                       stringValue:value];
+            }
+            break;
+        }
+
+        case PXCompiledSelectorClass:
+            result = [[PXClassSelector alloc] initWithClassName:[self stringAtIndex:PXCompiledCursorReadWord(&cursor)]];
+            break;
+
+        case PXCompiledSelectorId:
+            result = [[PXIdSelector alloc] initWithIdValue:[self stringAtIndex:PXCompiledCursorReadWord(&cursor)]];
+            break;
+
+        case PXCompiledSelectorPseudoClass:
+            result = [[PXPseudoClassSelector alloc] initWithClassName:[self stringAtIndex:PXCompiledCursorReadWord(&cursor)]];
+            break;
+
+        case PXCompiledSelectorPseudoClassFunction:
+        {
+            PXPseudoClassFunctionType type = PXCompiledCursorReadWord(&cursor);
+            int32_t modulus = (int32_t) PXCompiledCursorReadWord(&cursor);
+            int32_t remainder = (int32_t) PXCompiledCursorReadWord(&cursor);
+
+            result = [[PXPseudoClassFunction alloc] initWithFunctionType:type modulus:modulus remainder:remainder];
+            break;
+        }
+
+        case PXCompiledSelectorPseudoClassPredicate:
+            result = [[PXPseudoClassPredicate alloc] initWithPredicateType:PXCompiledCursorReadWord(&cursor)];
+            break;
+
+        case PXCompiledSelectorNot:
+            result = [[PXNotPseudoClass alloc] initWithExpression:[self selectorAtOffset:PXCompiledCursorReadWord(&cursor) before:offset]];
+            break;
+
+        case PXCompiledSelectorDescendantCombinator:
+        case PXCompiledSelectorChildCombinator:
+        case PXCompiledSelectorAdjacentSiblingCombinator:
+        case PXCompiledSelectorSiblingCombinator:
+        {
+            id<PXSelector> lhs = [self selectorAtOffset:PXCompiledCursorReadWord(&cursor) before:offset];
+            id<PXSelector> rhs = [self selectorAtOffset:PXCompiledCursorReadWord(&cursor) before:offset];
+            Class combinatorClass;
+
+            switch (kind)
+            {
+                case PXCompiledSelectorDescendantCombinator: combinatorClass = [PXDescendantCombinator class]; break;
+                case PXCompiledSelectorChildCombinator: combinatorClass = [PXChildCombinator class]; break;
+                case PXCompiledSelectorAdjacentSiblingCombinator: combinatorClass = [PXAdjacentSiblingCombinator class]; break;
+                default: combinatorClass = [PXSiblingCombinator class]; break;
+            }
+
+            result = [[combinatorClass alloc] initWithLHS:lhs RHS:rhs];
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return (cursor.failed) ? nil : result;
+}
+
+- (PXDeclaration *)declarationAtOffset:(uint32_t)offset
+{
+    NSNumber *key = @(offset);
+    PXDeclaration *result;
+
+    // rule sets created from a selector group share their declarations, just as they do when parsed
+    @synchronized(declarations_)
+    {
+        result = [declarations_ objectForKey:key];
+    }
+
+    if (result)
+    {
+        return result;
+    }
+
+    PXCompiledCursor cursor = [self cursorAtOffset:offset];
+    NSString *name = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+    BOOL important = (PXCompiledCursorReadWord(&cursor) != 0);
+    NSString *source = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+    NSString *filename = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+    uint32_t count = PXCompiledCursorReadWord(&cursor);
+
+    if (cursor.failed || name == nil)
+    {
+        return nil;
+    }
+
+    NSMutableArray *lexemes = [NSMutableArray arrayWithCapacity:count];
+
+    for (uint32_t i = 0; i < count && !cursor.failed; i++)
+    {
+        int type = (int) PXCompiledCursorReadWord(&cursor);
+        uint32_t flags = PXCompiledCursorReadWord(&cursor);
+        uint32_t location = PXCompiledCursorReadWord(&cursor);
+        uint32_t length = PXCompiledCursorReadWord(&cursor);
+        id value = [self valueFromCursor:&cursor];
+        NSRange range = NSMakeRange((location == PXCompiledNone) ? NSNotFound : location, length);
+        PXStylesheetLexeme *lexeme = [PXStylesheetLexeme lexemeWithType:type withRange:range withValue:value];
+
+        if (flags != 0)
+        {
+            [lexeme setFlag:flags];
+        }
+
+        [lexemes addObject:lexeme];
+    }
+
+    result = [[PXDeclaration alloc] initWithName:name];
+    result.important = important;
+    [result setSource:source filename:filename lexemes:lexemes];
+
+    @synchronized(declarations_)
+    {
+        PXDeclaration *existing = [declarations_ objectForKey:key];
+
+        if (existing)
+        {
+            result = existing;
+        }
+        else
+        {
+            [declarations_ setObject:result forKey:key];
+        }
+    }
+
+    return result;
+}
+
+- (PXKeyframe *)keyframeAtOffset:(uint32_t)offset
+{
+    PXCompiledCursor cursor = [self cursorAtOffset:offset];
+    NSString *name = [self stringAtIndex:PXCompiledCursorReadWord(&cursor)];
+    uint32_t blockCount = PXCompiledCursorReadWord(&cursor);
+
+    if (cursor.failed || name == nil)
+    {
+        return nil;
+    }
+
+    PXKeyframe *result = [[PXKeyframe alloc] initWithName:name];
+
+    for (uint32_t i = 0; i < blockCount && !cursor.failed; i++)
+    {
+        PXKeyframeBlock *block = [[PXKeyframeBlock alloc] initWithOffset:PXCompiledCursorReadDouble(&cursor)];
+        uint32_t declarationCount = PXCompiledCursorReadWord(&cursor);
+
+        for (uint32_t j = 0; j < declarationCount && !cursor.failed; j++)
+        {
+            [block addDeclaration:[self declarationAtOffset:PXCompiledCursorReadWord(&cursor)]];
+        }
+
+        [result addKeyframeBlock:block];
+    }
+
+    return result;
+}
+
+#pragma mark - Overrides
+
+- (void)dealloc
+{
+    if (strings_ != NULL)
+    {
+        for (uint32_t i = 0; i < header_.stringCount; i++)
+        {
+            if (strings_[i] != NULL)
+            {
+                CFRelease(strings_[i]);
+            }
+        }
+
+        free(strings_);
+    }
+}
+
+@end
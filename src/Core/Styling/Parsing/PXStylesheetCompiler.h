@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXStylesheetCompiler.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStylesheet.h"
+
+/**
+ *  PXStylesheetCompiler serializes a parsed stylesheet into the format read by PXCompiledStylesheet. Everything
+ *  PXStylesheetParser produces is captured: media groups, rule sets with their selectors and specificity, declarations
+ *  with their lexemes, keyframes, namespaces, @font-face sources, and parse errors. @import statements have already
+ *  been inlined by the parser.
+ */
+@interface PXStylesheetCompiler : NSObject
+
+/**
+ *  Return the compiled form of the specified stylesheet. This returns nil if the stylesheet contains a selector type
+ *  the format does not know about.
+ *
+ *  @param stylesheet The stylesheet to compile
+ */
++ (NSData *)dataForStylesheet:(PXStylesheet *)stylesheet;
+
+/**
+ *  Return the compiled form of the specified stylesheet, recording the digest of the CSS it was parsed from. Loaders
+ *  compare it to the CSS file next to the compiled one to detect compiled stylesheets that are out of date.
+ *
+ *  @param stylesheet The stylesheet to compile
+ *  @param sourceDigest The digest of the CSS file, as returned by PXFileUtils, or nil
+ */
++ (NSData *)dataForStylesheet:(PXStylesheet *)stylesheet sourceDigest:(NSString *)sourceDigest;
+
+/**
+ *  Parse the specified CSS file and write its compiled form to the specified path. Parse errors are stored in the
+ *  compiled stylesheet, but do not cause this method to fail.
+ *
+ *  @param sourcePath The path to the CSS file
+ *  @param destinationPath The path of the compiled stylesheet to write
+ *  @param errors If not NULL, set to the parse errors for the CSS file
+ */
++ (BOOL)compileFileAtPath:(NSString *)sourcePath toPath:(NSString *)destinationPath errors:(NSArray **)errors;
+
+@end
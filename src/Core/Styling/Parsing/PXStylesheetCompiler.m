@@ -0,0 +1,624 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXStylesheetCompiler.m
+//  Pixate
+//
+
+#import "PXStylesheetCompiler.h"
+#import "PXCompiledStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXStylesheetLexeme.h"
+#import "PXDeclaration.h"
+#import "PXMediaGroup.h"
+#import "PXNamedMediaExpression.h"
+#import "PXMediaExpressionGroup.h"
+#import "PXIdSelector.h"
+#import "PXClassSelector.h"
+#import "PXNotPseudoClass.h"
+#import "PXPseudoClassSelector.h"
+#import "PXPseudoClassPredicate.h"
+#import "PXPseudoClassFunction.h"
+#import "PXAttributeSelector.h"
+#import "PXAttributeSelectorOperator.h"
+#import "PXAdjacentSiblingCombinator.h"
+#import "PXChildCombinator.h"
+#import "PXDescendantCombinator.h"
+#import "PXSiblingCombinator.h"
+#import "PXKeyframeBlock.h"
+#import "PXFileUtils.h"
+
+static inline void PXAppendWord(NSMutableData *data, uint32_t word)
+{
+    word = CFSwapInt32HostToLittle(word);
+    [data appendBytes:&word length:sizeof(uint32_t)];
+}
+
+static inline void PXAppendDouble(NSMutableData *data, double number)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &number, sizeof(double));
+
+    PXAppendWord(data, (uint32_t) (bits & 0xFFFFFFFF));
+    PXAppendWord(data, (uint32_t) (bits >> 32));
+}
+
+@implementation PXStylesheetCompiler
+{
+    NSMutableData *data_;
+    NSMutableArray *strings_;
+    NSMutableDictionary *stringIndexes_;
+    NSMapTable *declarationOffsets_;
+    BOOL failed_;
+}
+
+#pragma mark - Static Methods
+
++ (NSData *)dataForStylesheet:(PXStylesheet *)stylesheet
+{
+    return [self dataForStylesheet:stylesheet sourceDigest:nil];
+}
+
++ (NSData *)dataForStylesheet:(PXStylesheet *)stylesheet sourceDigest:(NSString *)sourceDigest
+{
+    return [[[PXStylesheetCompiler alloc] init] compileStylesheet:stylesheet sourceDigest:sourceDigest];
+}
+
++ (BOOL)compileFileAtPath:(NSString *)sourcePath toPath:(NSString *)destinationPath errors:(NSArray **)errors
+{
+    NSData *sourceData = [NSData dataWithContentsOfFile:sourcePath];
+    NSString *source = (sourceData) ? [[NSString alloc] initWithData:sourceData encoding:NSUTF8StringEncoding] : nil;
+
+    if (source == nil)
+    {
+        return NO;
+    }
+
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:source
+                                                             withOrigin:PXStylesheetOriginApplication
+                                                               filename:sourcePath];
+
+    if (errors)
+    {
+        *errors = stylesheet.errors;
+    }
+
+    NSData *data = [self dataForStylesheet:stylesheet sourceDigest:[PXFileUtils digestOfData:sourceData]];
+
+    return (data) ? [data writeToFile:destinationPath atomically:YES] : NO;
+}
+
+#pragma mark - Initializers
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        data_ = [[NSMutableData alloc] init];
+        strings_ = [[NSMutableArray alloc] init];
+        stringIndexes_ = [[NSMutableDictionary alloc] init];
+        declarationOffsets_ = [NSMapTable mapTableWithKeyOptions:NSMapTableObjectPointerPersonality
+                                                    valueOptions:NSMapTableStrongMemory];
+    }
+
+    return self;
+}
+
+#pragma mark - Methods
+
+- (NSData *)compileStylesheet:(PXStylesheet *)stylesheet sourceDigest:(NSString *)sourceDigest
+{
+    PXCompiledStylesheetHeader header;
+
+    memset(&header, 0, sizeof(header));
+
+    // reserve space for the header. It is written once all section offsets are known
+    [data_ setLength:sizeof(PXCompiledStylesheetHeader)];
+
+    // media groups, children first so parents can refer to their offsets
+    NSMutableData *mediaGroups = [NSMutableData data];
+
+    for (PXMediaGroup *mediaGroup in stylesheet.mediaGroups)
+    {
+        PXAppendWord(mediaGroups, [self writeMediaGroup:mediaGroup]);
+    }
+
+    header.mediaGroupCount = (uint32_t) stylesheet.mediaGroups.count;
+    header.mediaGroupsOffset = [self writeRecord:mediaGroups];
+
+    // keyframes
+    NSMutableData *keyframes = [NSMutableData data];
+    NSArray *keyframeList = stylesheet.keyframes;
+
+    for (PXKeyframe *keyframe in keyframeList)
+    {
+        PXAppendWord(keyframes, [self writeKeyframe:keyframe]);
+    }
+
+    header.keyframeCount = (uint32_t) keyframeList.count;
+    header.keyframesOffset = [self writeRecord:keyframes];
+
+    // font faces
+    NSMutableData *fontFaces = [NSMutableData data];
+    NSArray *fontFaceDeclarations = stylesheet.fontFaceDeclarations;
+
+    for (PXDeclaration *declaration in fontFaceDeclarations)
+    {
+        PXAppendWord(fontFaces, [self writeDeclaration:declaration]);
+    }
+
+    header.fontFaceCount = (uint32_t) fontFaceDeclarations.count;
+    header.fontFacesOffset = [self writeRecord:fontFaces];
+
+    // namespaces
+    NSMutableData *namespaces = [NSMutableData data];
+    NSDictionary *namespacePrefixes = stylesheet.namespacePrefixes;
+
+    [namespacePrefixes enumerateKeysAndObjectsUsingBlock:^(NSString *prefix, NSString *uri, BOOL *stop) {
+        PXAppendWord(namespaces, [self indexForString:prefix]);
+        PXAppendWord(namespaces, [self indexForString:uri]);
+    }];
+
+    header.namespaceCount = (uint32_t) namespacePrefixes.count;
+    header.namespacesOffset = [self writeRecord:namespaces];
+
+    // errors
+    NSMutableData *errors = [NSMutableData data];
+
+    for (NSString *error in stylesheet.errors)
+    {
+        PXAppendWord(errors, [self indexForString:error]);
+    }
+
+    header.errorCount = (uint32_t) stylesheet.errors.count;
+    header.errorsOffset = [self writeRecord:errors];
+
+    // source digest
+    header.sourceDigest = [self indexForString:sourceDigest];
+
+    // string table, followed by the characters of all strings
+    NSMutableData *stringTable = [NSMutableData data];
+    NSMutableData *characters = [NSMutableData data];
+
+    for (NSString *string in strings_)
+    {
+        NSUInteger length = string.length;
+
+        PXAppendWord(stringTable, (uint32_t) (characters.length / sizeof(unichar)));
+        PXAppendWord(stringTable, (uint32_t) length);
+
+        [characters increaseLengthBy:length * sizeof(unichar)];
+
+        unichar *buffer = (unichar *) ((uint8_t *) characters.mutableBytes + characters.length) - length;
+
+        [string getCharacters:buffer range:NSMakeRange(0, length)];
+
+        for (NSUInteger i = 0; i < length; i++)
+        {
+            buffer[i] = CFSwapInt16HostToLittle(buffer[i]);
+        }
+    }
+
+    header.stringCount = (uint32_t) strings_.count;
+    header.stringsOffset = [self writeRecord:stringTable];
+    header.charactersOffset = [self writeRecord:characters];
+
+    if (failed_ || data_.length > UINT32_MAX)
+    {
+        return nil;
+    }
+
+    header.magic = PXCompiledStylesheetMagic;
+    header.version = PXCompiledStylesheetVersion;
+    header.length = (uint32_t) data_.length;
+
+    NSMutableData *headerData = [NSMutableData dataWithCapacity:sizeof(header)];
+    uint32_t *fields = (uint32_t *) &header;
+
+    for (NSUInteger i = 0; i < sizeof(PXCompiledStylesheetHeader) / sizeof(uint32_t); i++)
+    {
+        PXAppendWord(headerData, fields[i]);
+    }
+
+    [data_ replaceBytesInRange:NSMakeRange(0, sizeof(header)) withBytes:headerData.bytes];
+
+    return [NSData dataWithData:data_];
+}
+
+#pragma mark - Helpers
+
+- (uint32_t)writeRecord:(NSData *)record
+{
+    uint32_t result = (uint32_t) data_.length;
+
+    [data_ appendData:record];
+
+    // keep every record word aligned
+    NSUInteger padding = (sizeof(uint32_t) - (data_.length % sizeof(uint32_t))) % sizeof(uint32_t);
+
+    [data_ increaseLengthBy:padding];
+
+    return result;
+}
+
+- (uint32_t)indexForString:(NSString *)string
+{
+    if (string == nil)
+    {
+        return PXCompiledNone;
+    }
+
+    NSNumber *index = [stringIndexes_ objectForKey:string];
+
+    if (index == nil)
+    {
+        index = @(strings_.count);
+
+        [strings_ addObject:string];
+        [stringIndexes_ setObject:index forKey:string];
+    }
+
+    return index.unsignedIntValue;
+}
+
+- (void)appendValue:(id)value toRecord:(NSMutableData *)record
+{
+    if ([value isKindOfClass:[NSString class]])
+    {
+        PXAppendWord(record, PXCompiledValueString);
+        PXAppendWord(record, [self indexForString:value]);
+        PXAppendDouble(record, 0.0);
+    }
+    else if ([value isKindOfClass:[NSNumber class]])
+    {
+        PXAppendWord(record, PXCompiledValueNumber);
+        PXAppendWord(record, PXCompiledNone);
+        PXAppendDouble(record, [value doubleValue]);
+    }
+    else if ([value isKindOfClass:[PXDimension class]])
+    {
+        PXDimension *dimension = value;
+
+        PXAppendWord(record, PXCompiledValueDimension);
+        PXAppendWord(record, [self indexForString:dimension.dimension]);
+        PXAppendDouble(record, dimension.number);
+    }
+    else if (value != nil)
+    {
+        // lexemes only carry strings, numbers, and dimensions. Fall back to text for anything else
+        PXAppendWord(record, PXCompiledValueString);
+        PXAppendWord(record, [self indexForString:[value description]]);
+        PXAppendDouble(record, 0.0);
+    }
+    else
+    {
+        PXAppendWord(record, PXCompiledValueNone);
+        PXAppendWord(record, PXCompiledNone);
+        PXAppendDouble(record, 0.0);
+    }
+}
+
+#pragma mark - Records
+
+- (uint32_t)writeMediaQuery:(id<PXMediaExpression>)query
+{
+    NSMutableData *record = [NSMutableData data];
+
+    if ([query isKindOfClass:[PXMediaExpressionGroup class]])
+    {
+        NSArray *expressions = ((PXMediaExpressionGroup *) query).expressions;
+        NSMutableArray *offsets = [NSMutableArray arrayWithCapacity:expressions.count];
+
+        for (id<PXMediaExpression> expression in expressions)
+        {
+            [offsets addObject:@([self writeMediaQuery:expression])];
+        }
+
+        PXAppendWord(record, PXCompiledMediaQueryGroup);
+        PXAppendWord(record, (uint32_t) offsets.count);
+
+        for (NSNumber *offset in offsets)
+        {
+            PXAppendWord(record, offset.unsignedIntValue);
+        }
+    }
+    else if ([query isKindOfClass:[PXNamedMediaExpression class]])
+    {
+        PXNamedMediaExpression *expression = (PXNamedMediaExpression *) query;
+
+        PXAppendWord(record, PXCompiledMediaQueryNamed);
+        PXAppendWord(record, [self indexForString:expression.name]);
+        [self appendValue:expression.value toRecord:record];
+    }
+    else
+    {
+        failed_ = YES;
+    }
+
+    return [self writeRecord:record];
+}
+
+- (uint32_t)writeMediaGroup:(PXMediaGroup *)mediaGroup
+{
+    uint32_t queryOffset = (mediaGroup.query) ? [self writeMediaQuery:mediaGroup.query] : PXCompiledNone;
+    NSArray *ruleSets = mediaGroup.ruleSets;
+    NSMutableData *record = [NSMutableData data];
+
+    PXAppendWord(record, queryOffset);
+    PXAppendWord(record, (uint32_t) ruleSets.count);
+
+    for (PXRuleSet *ruleSet in ruleSets)
+    {
+        PXAppendWord(record, [self writeRuleSet:ruleSet]);
+    }
+
+    return [self writeRecord:record];
+}
+
+- (uint32_t)writeRuleSet:(PXRuleSet *)ruleSet
+{
+    NSArray *selectors = ruleSet.selectors;
+    NSArray *declarations = ruleSet.declarations;
+    NSMutableArray *selectorOffsets = [NSMutableArray arrayWithCapacity:selectors.count];
+    NSMutableArray *declarationOffsets = [NSMutableArray arrayWithCapacity:declarations.count];
+
+    for (id<PXSelector> selector in selectors)
+    {
+        [selectorOffsets addObject:@([self writeSelector:selector])];
+    }
+
+    for (PXDeclaration *declaration in declarations)
+    {
+        [declarationOffsets addObject:@([self writeDeclaration:declaration])];
+    }
+
+    // the keys PXMediaGroup uses to partition rule sets, so loading does not need to decode any selectors
+    PXTypeSelector *typeSelector = ruleSet.targetTypeSelector;
+    NSString *elementName = (typeSelector == nil || typeSelector.hasUniversalType) ? nil : typeSelector.typeName;
+    NSString *styleId = typeSelector.styleId;
+    NSArray *styleClasses = typeSelector.styleClasses;
+    PXSpecificity *specificity = ruleSet.specificity;
+    NSMutableData *record = [NSMutableData data];
+
+    PXAppendWord(record, (uint32_t) [specificity valueForSpecificity:kSpecificityTypeId]);
+    PXAppendWord(record, (uint32_t) [specificity valueForSpecificity:kSpecificityTypeClassOrAttribute]);
+    PXAppendWord(record, (uint32_t) [specificity valueForSpecificity:kSpecificityTypeElement]);
+    PXAppendWord(record, [self indexForString:elementName]);
+    PXAppendWord(record, [self indexForString:(styleId.length > 0) ? styleId : nil]);
+    PXAppendWord(record, (uint32_t) styleClasses.count);
+
+    for (NSString *styleClass in styleClasses)
+    {
+        PXAppendWord(record, [self indexForString:styleClass]);
+    }
+
+    PXAppendWord(record, (uint32_t) selectorOffsets.count);
+
+    for (NSNumber *offset in selectorOffsets)
+    {
+        PXAppendWord(record, offset.unsignedIntValue);
+    }
+
+    PXAppendWord(record, (uint32_t) declarationOffsets.count);
+
+    for (NSNumber *offset in declarationOffsets)
+    {
+        PXAppendWord(record, offset.unsignedIntValue);
+    }
+
+    return [self writeRecord:record];
+}
+
+- (uint32_t)writeSelector:(id<PXSelector>)selector
+{
+    NSMutableData *record = [NSMutableData data];
+
+    if ([selector isKindOfClass:[PXTypeSelector class]])
+    {
+        PXTypeSelector *typeSelector = (PXTypeSelector *) selector;
+        NSArray *expressions = typeSelector.attributeExpressions;
+        NSMutableArray *offsets = [NSMutableArray arrayWithCapacity:expressions.count];
+
+        for (id<PXSelector> expression in expressions)
+        {
+            [offsets addObject:@([self writeSelector:expression])];
+        }
+
+        PXAppendWord(record, PXCompiledSelectorType);
+        PXAppendWord(record, [self indexForString:typeSelector.namespaceURI]);
+        PXAppendWord(record, [self indexForString:typeSelector.typeName]);
+        PXAppendWord(record, [self indexForString:typeSelector.pseudoElement]);
+        PXAppendWord(record, (uint32_t) offsets.count);
+
+        for (NSNumber *offset in offsets)
+        {
+            PXAppendWord(record, offset.unsignedIntValue);
+        }
+    }
+    else if ([selector isKindOfClass:[PXAttributeSelector class]])
+    {
+        PXAttributeSelector *attributeSelector = (PXAttributeSelector *) selector;
+
+        PXAppendWord(record, PXCompiledSelectorAttribute);
+        PXAppendWord(record, [self indexForString:attributeSelector.namespaceURI]);
+        PXAppendWord(record, [self indexForString:attributeSelector.attributeName]);
+    }
+    else if ([selector isKindOfClass:[PXAttributeSelectorOperator class]])
+    {
+        PXAttributeSelectorOperator *operatorSelector = (PXAttributeSelectorOperator *) selector;
+        uint32_t attributeOffset = [self writeSelector:operatorSelector.attributeSelector];
+
+        PXAppendWord(record, PXCompiledSelectorAttributeOperator);
+        PXAppendWord(record, operatorSelector.operatorType);
+        PXAppendWord(record, attributeOffset);
+        PXAppendWord(record, [self indexForString:operatorSelector.value]);
+    }
+    else if ([selector isKindOfClass:[PXClassSelector class]])
+    {
+        PXAppendWord(record, PXCompiledSelectorClass);
+        PXAppendWord(record, [self indexForString:((PXClassSelector *) selector).className]);
+    }
+    else if ([selector isKindOfClass:[PXIdSelector class]])
+    {
+        PXAppendWord(record, PXCompiledSelectorId);
+        PXAppendWord(record, [self indexForString:((PXIdSelector *) selector).idValue]);
+    }
+    else if ([selector isKindOfClass:[PXPseudoClassSelector class]])
+    {
+        PXAppendWord(record, PXCompiledSelectorPseudoClass);
+        PXAppendWord(record, [self indexForString:((PXPseudoClassSelector *) selector).className]);
+    }
+    else if ([selector isKindOfClass:[PXPseudoClassFunction class]])
+    {
+        PXPseudoClassFunction *function = (PXPseudoClassFunction *) selector;
+
+        PXAppendWord(record, PXCompiledSelectorPseudoClassFunction);
+        PXAppendWord(record, function.functionType);
+        PXAppendWord(record, (uint32_t) (int32_t) function.modulus);
+        PXAppendWord(record, (uint32_t) (int32_t) function.remainder);
+    }
+    else if ([selector isKindOfClass:[PXPseudoClassPredicate class]])
+    {
+        PXAppendWord(record, PXCompiledSelectorPseudoClassPredicate);
+        PXAppendWord(record, ((PXPseudoClassPredicate *) selector).predicateType);
+    }
+    else if ([selector isKindOfClass:[PXNotPseudoClass class]])
+    {
+        uint32_t expressionOffset = [self writeSelector:((PXNotPseudoClass *) selector).expression];
+
+        PXAppendWord(record, PXCompiledSelectorNot);
+        PXAppendWord(record, expressionOffset);
+    }
+    else if ([selector conformsToProtocol:@protocol(PXCombinator)])
+    {
+        id<PXCombinator> combinator = (id<PXCombinator>) selector;
+        PXCompiledSelectorKind kind;
+
+        if ([selector isKindOfClass:[PXDescendantCombinator class]])
+        {
+            kind = PXCompiledSelectorDescendantCombinator;
+        }
+        else if ([selector isKindOfClass:[PXChildCombinator class]])
+        {
+            kind = PXCompiledSelectorChildCombinator;
+        }
+        else if ([selector isKindOfClass:[PXAdjacentSiblingCombinator class]])
+        {
+            kind = PXCompiledSelectorAdjacentSiblingCombinator;
+        }
+        else if ([selector isKindOfClass:[PXSiblingCombinator class]])
+        {
+            kind = PXCompiledSelectorSiblingCombinator;
+        }
+        else
+        {
+            failed_ = YES;
+            return PXCompiledNone;
+        }
+
+        uint32_t lhsOffset = [self writeSelector:combinator.lhs];
+        uint32_t rhsOffset = [self writeSelector:combinator.rhs];
+
+        PXAppendWord(record, kind);
+        PXAppendWord(record, lhsOffset);
+        PXAppendWord(record, rhsOffset);
+    }
+    else
+    {
+        failed_ = YES;
+        return PXCompiledNone;
+    }
+
+    return [self writeRecord:record];
+}
+
+- (uint32_t)writeDeclaration:(PXDeclaration *)declaration
+{
+    // rule sets created from a selector group share declaration instances, so write each instance only once
+    NSNumber *existingOffset = [declarationOffsets_ objectForKey:declaration];
+
+    if (existingOffset)
+    {
+        return existingOffset.unsignedIntValue;
+    }
+
+    NSArray *lexemes = declaration.lexemes;
+    NSMutableData *record = [NSMutableData data];
+
+    PXAppendWord(record, [self indexForString:declaration.name]);
+    PXAppendWord(record, (declaration.important) ? 1 : 0);
+    PXAppendWord(record, [self indexForString:declaration.source]);
+    PXAppendWord(record, [self indexForString:declaration.filename]);
+    PXAppendWord(record, (uint32_t) lexemes.count);
+
+    for (PXStylesheetLexeme *lexeme in lexemes)
+    {
+        NSRange range = lexeme.range;
+
+        PXAppendWord(record, (uint32_t) lexeme.type);
+        PXAppendWord(record, ([lexeme flagIsSet:PXLexemeFlagFollowsWhitespace]) ? PXLexemeFlagFollowsWhitespace : 0);
+        PXAppendWord(record, (range.location == NSNotFound) ? PXCompiledNone : (uint32_t) range.location);
+        PXAppendWord(record, (uint32_t) range.length);
+        [self appendValue:lexeme.value toRecord:record];
+    }
+
+    uint32_t result = [self writeRecord:record];
+
+    [declarationOffsets_ setObject:@(result) forKey:declaration];
+
+    return result;
+}
+
+- (uint32_t)writeKeyframe:(PXKeyframe *)keyframe
+{
+    NSArray *blocks = keyframe.blocks;
+    NSMutableArray *blockOffsets = [NSMutableArray arrayWithCapacity:blocks.count];
+
+    for (PXKeyframeBlock *block in blocks)
+    {
+        NSMutableArray *offsets = [NSMutableArray array];
+
+        for (PXDeclaration *declaration in block.declarations)
+        {
+            [offsets addObject:@([self writeDeclaration:declaration])];
+        }
+
+        [blockOffsets addObject:offsets];
+    }
+
+    NSMutableData *record = [NSMutableData data];
+
+    PXAppendWord(record, [self indexForString:keyframe.name]);
+    PXAppendWord(record, (uint32_t) blocks.count);
+
+    [blocks enumerateObjectsUsingBlock:^(PXKeyframeBlock *block, NSUInteger index, BOOL *stop) {
+        NSArray *offsets = [blockOffsets objectAtIndex:index];
+
+        PXAppendDouble(record, block.offset);
+        PXAppendWord(record, (uint32_t) offsets.count);
+
+        for (NSNumber *offset in offsets)
+        {
+            PXAppendWord(record, offset.unsignedIntValue);
+        }
+    }];
+
+    return [self writeRecord:record];
+}
+
+@end
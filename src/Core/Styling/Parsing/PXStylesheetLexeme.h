@@ -36,6 +36,38 @@ typedef enum {
 + (id)lexemeWithType:(int)type withValue:(id)value;
 + (id)lexemeWithType:(int)type withRange:(NSRange)range withValue:(id)value;
 
+/**
+ *  Create a lexeme whose value is the text of the specified range in source. The value is not created until it is
+ *  first requested
+ */
++ (id)lexemeWithType:(int)type withRange:(NSRange)range withSource:(NSString *)source;
+
+/**
+ *  Create a lexeme whose value is the text of valueRange in source. The value is not created until it is first
+ *  requested
+ */
++ (id)lexemeWithType:(int)type withRange:(NSRange)range withSource:(NSString *)source withValueRange:(NSRange)valueRange;
+
+/**
+ *  Create a lexeme for a number or dimension. If unitRange is empty, the value will be an NSNumber. Otherwise, the
+ *  value will be a PXDimension using the text of unitRange in source as its units. The value is not created until it
+ *  is first requested
+ */
++ (id)lexemeWithType:(int)type withRange:(NSRange)range withSource:(NSString *)source withNumber:(float)number withUnitRange:(NSRange)unitRange;
+
 - (id)initWithType:(int)type withRange:(NSRange)range withValue:(id)value;
 
+/**
+ *  Indicates if this lexeme's value has not been created from its source yet. Values are created at most once, even
+ *  when first requested from several threads at the same time
+ */
+@property (nonatomic, readonly, getter=isValueDeferred) BOOL valueDeferred;
+
+/**
+ *  Return a new lexeme of the specified type that shares this lexeme's range, source, value, and flags
+ *
+ *  @param type The new lexeme type
+ */
+- (PXStylesheetLexeme *)lexemeWithType:(int)type;
+
 @end
@@ -24,10 +24,23 @@
 
 #import "PXStylesheetLexeme.h"
 #import "PXStylesheetTokenType.h"
+#import "PXDimension.h"
+
+typedef enum {
+    PXLexemeValueKindNone,
+    PXLexemeValueKindString,
+    PXLexemeValueKindNumber
+} PXLexemeValueKind;
 
 @implementation PXStylesheetLexeme
 {
     NSUInteger flags_;
+
+    // lazy value support
+    NSString *source_;
+    NSRange valueRange_;
+    float number_;
+    PXLexemeValueKind valueKind_;
 }
 
 @synthesize type = _type;
@@ -57,6 +70,34 @@
     return [[PXStylesheetLexeme alloc] initWithType:type withRange:range withValue:value];
 }
 
++ (id)lexemeWithType:(int)type withRange:(NSRange)range withSource:(NSString *)source
+{
+    return [self lexemeWithType:type withRange:range withSource:source withValueRange:range];
+}
+
++ (id)lexemeWithType:(int)type withRange:(NSRange)range withSource:(NSString *)source withValueRange:(NSRange)valueRange
+{
+    PXStylesheetLexeme *result = [[PXStylesheetLexeme alloc] initWithType:type withRange:range withValue:nil];
+
+    result->source_ = source;
+    result->valueRange_ = valueRange;
+    result->valueKind_ = PXLexemeValueKindString;
+
+    return result;
+}
+
++ (id)lexemeWithType:(int)type withRange:(NSRange)range withSource:(NSString *)source withNumber:(float)number withUnitRange:(NSRange)unitRange
+{
+    PXStylesheetLexeme *result = [[PXStylesheetLexeme alloc] initWithType:type withRange:range withValue:nil];
+
+    result->source_ = source;
+    result->valueRange_ = unitRange;
+    result->number_ = number;
+    result->valueKind_ = PXLexemeValueKindNumber;
+
+    return result;
+}
+
 #pragma mark - Initializers
 
 - (id)initWithType:(int)type text:(NSString *)text
@@ -79,6 +120,41 @@
 
 #pragma mark - Getters
 
+- (id)value
+{
+    // declarations keep their lexemes, so a value may be requested by several styling threads. Only the first
+    // request creates it; once the kind reads as none, the value is published and never changes
+    if (__atomic_load_n(&valueKind_, __ATOMIC_ACQUIRE) != PXLexemeValueKindNone)
+    {
+        @synchronized(self)
+        {
+            if (valueKind_ == PXLexemeValueKindString)
+            {
+                _value = [source_ substringWithRange:valueRange_];
+            }
+            else if (valueKind_ == PXLexemeValueKindNumber && valueRange_.length == 0)
+            {
+                _value = [NSNumber numberWithFloat:number_];
+            }
+            else if (valueKind_ == PXLexemeValueKindNumber)
+            {
+                _value = [PXDimension dimensionWithNumber:number_ withDimension:[source_ substringWithRange:valueRange_]];
+            }
+
+            // the value has been materialized, so we no longer need the source
+            source_ = nil;
+            __atomic_store_n(&valueKind_, PXLexemeValueKindNone, __ATOMIC_RELEASE);
+        }
+    }
+
+    return _value;
+}
+
+- (BOOL)isValueDeferred
+{
+    return __atomic_load_n(&valueKind_, __ATOMIC_ACQUIRE) != PXLexemeValueKindNone;
+}
+
 - (NSString *)name
 {
     //return [PXSSTokenType typeNameForInt:type];
@@ -87,9 +163,28 @@
 
 #pragma mark - Methods
 
+- (PXStylesheetLexeme *)lexemeWithType:(int)type
+{
+    PXStylesheetLexeme *result = [[PXStylesheetLexeme alloc] initWithType:type withRange:_range withValue:nil];
+
+    result->flags_ = flags_;
+
+    // the value and its source have to be read together
+    @synchronized(self)
+    {
+        result->_value = _value;
+        result->source_ = source_;
+        result->valueRange_ = valueRange_;
+        result->number_ = number_;
+        result->valueKind_ = valueKind_;
+    }
+
+    return result;
+}
+
 - (NSString *)description
 {
-    return [NSString stringWithFormat:@"%@@%lu-%lu:«%@»", self.name, (unsigned long) _range.location, (unsigned long) _range.location + _range.length, _value];
+    return [NSString stringWithFormat:@"%@@%lu-%lu:«%@»", self.name, (unsigned long) _range.location, (unsigned long) _range.location + _range.length, self.value];
 }
 
 #pragma mark - Flags
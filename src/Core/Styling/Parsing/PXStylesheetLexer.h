@@ -57,6 +57,24 @@
  */
 @property (nonatomic, weak) id<PXStylesheetLexerDelegate> delegate;
 
+/**
+ *  By default, lexemes are produced by a single-pass PXStylesheetScanner. Setting this to YES falls back to the
+ *  original chain of regular-expression based PXLexemeCreators. This is mainly useful for comparing the two
+ */
+@property (nonatomic) BOOL usesMatcherChain;
+
+/**
+ *  Determine the initial value of usesMatcherChain for all lexers created after this call
+ *
+ *  @param flag A boolean indicating if new lexers should use the matcher chain
+ */
++ (void)setUsesMatcherChainByDefault:(BOOL)flag;
+
+/**
+ *  Return the initial value of usesMatcherChain for newly created lexers
+ */
++ (BOOL)usesMatcherChainByDefault;
+
 /**
  *  Initializer a new instance with the specified source value
  *
@@ -30,20 +30,23 @@
 #import "PXWordMatcher.h"
 #import "NSMutableArray+StackAdditions.h"
 #import "PXURLMatcher.h"
+#import "PXStylesheetScanner.h"
 
 @interface LexerState : NSObject
 @property (nonatomic, strong, readonly) NSString *source;
 @property (nonatomic, readonly) NSUInteger offset;
 @property (nonatomic, readonly) NSUInteger blockDepth;
 @property (nonatomic, strong, readonly) NSMutableArray *lexemeStack;
+@property (nonatomic, strong, readonly) PXStylesheetScanner *scanner;
 @end
 
 @implementation LexerState
-- (id)initWithSource:(NSString *)source offset:(NSUInteger)offset blockDepth:(NSUInteger)blockDepth lexemeStack:(NSMutableArray *)lexemeStack
+- (id)initWithSource:(NSString *)source scanner:(PXStylesheetScanner *)scanner offset:(NSUInteger)offset blockDepth:(NSUInteger)blockDepth lexemeStack:(NSMutableArray *)lexemeStack
 {
     if (self = [super init])
     {
         _source = source;
+        _scanner = scanner;
         _offset = offset;
         _blockDepth = blockDepth;
         _lexemeStack = lexemeStack;
@@ -55,13 +58,14 @@
 -(void)dealloc
 {
     _source = nil;
+    _scanner = nil;
     _lexemeStack = nil;
 }
 @end
 
 @implementation PXStylesheetLexer
 {
-    NSArray *tokens_;
+    PXStylesheetScanner *scanner_;
     NSUInteger offset_;
     NSUInteger blockDepth_;
     NSMutableArray *lexemeStack_;
@@ -70,10 +74,24 @@
 
 #pragma mark - Initializers
 
-- (id)init
+static BOOL USES_MATCHER_CHAIN_BY_DEFAULT = NO;
+
++ (void)setUsesMatcherChainByDefault:(BOOL)flag
 {
-    if (self = [super init])
-    {
+    USES_MATCHER_CHAIN_BY_DEFAULT = flag;
+}
+
++ (BOOL)usesMatcherChainByDefault
+{
+    return USES_MATCHER_CHAIN_BY_DEFAULT;
+}
+
++ (NSArray *)matcherChain
+{
+    static NSArray *matcherChain;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
         // create tokens
         NSMutableArray *tokenList = [NSMutableArray array];
 
@@ -212,7 +230,17 @@
         ];
         [tokenList addObject:[[PXCharacterMatcher alloc] initWithCharactersInString:operators withTypes:operatorTypes]];
 
-        tokens_ = [NSArray arrayWithArray:tokenList];
+        matcherChain = [NSArray arrayWithArray:tokenList];
+    });
+
+    return matcherChain;
+}
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        _usesMatcherChain = USES_MATCHER_CHAIN_BY_DEFAULT;
     }
 
     return self;
@@ -233,11 +261,21 @@
 - (void)setSource:(NSString *)aSource
 {
     _source = aSource;
+    scanner_ = (_usesMatcherChain || aSource == nil) ? nil : [[PXStylesheetScanner alloc] initWithString:aSource];
     offset_ = 0;
     blockDepth_ = 0;
     lexemeStack_ = nil;
 }
 
+- (void)setUsesMatcherChain:(BOOL)usesMatcherChain
+{
+    if (_usesMatcherChain != usesMatcherChain)
+    {
+        _usesMatcherChain = usesMatcherChain;
+        scanner_ = (_usesMatcherChain || _source == nil) ? nil : [[PXStylesheetScanner alloc] initWithString:_source];
+    }
+}
+
 #pragma mark - Methods
 
 - (void)pushLexeme:(PXStylesheetLexeme *)lexeme
@@ -270,7 +308,7 @@
         stateStack_ = [[NSMutableArray alloc] init];
     }
 
-    LexerState *state = [[LexerState alloc] initWithSource:_source offset:offset_ blockDepth:blockDepth_ lexemeStack:lexemeStack_];
+    LexerState *state = [[LexerState alloc] initWithSource:_source scanner:scanner_ offset:offset_ blockDepth:blockDepth_ lexemeStack:lexemeStack_];
 
     [stateStack_ push:state];
 
@@ -284,6 +322,7 @@
         LexerState *state = [stateStack_ pop];
 
         _source = state.source;
+        scanner_ = state.scanner;
         offset_ = state.offset;
         blockDepth_ = state.blockDepth;
         lexemeStack_ = state.lexemeStack;
@@ -309,9 +348,56 @@
     blockDepth_--;
 }
 
+- (PXStylesheetLexeme *)nextMatcherChainLexemeFollowingWhitespace:(BOOL *)followsWhitespace
+{
+    NSArray *tokens = [PXStylesheetLexer matcherChain];
+    NSUInteger length = [_source length];
+    PXStylesheetLexeme *result = nil;
+
+    // loop until we find a valid lexeme or the end of the string
+    while (offset_ < length)
+    {
+        NSRange range = NSMakeRange(offset_, length - offset_);
+        PXStylesheetLexeme *candidate = nil;
+
+        for (id<PXLexemeCreator> creator in tokens)
+        {
+            PXStylesheetLexeme *lexeme = [creator createLexemeWithString:_source withRange:range];
+
+            if (lexeme)
+            {
+                NSRange lexemeRange = lexeme.range;
+
+                offset_ = lexemeRange.location + lexemeRange.length;
+                candidate = lexeme;
+
+                if (*followsWhitespace)
+                {
+                    [lexeme setFlag:PXLexemeFlagFollowsWhitespace];
+                }
+                break;
+            }
+        }
+
+        // skip whitespace
+        if (!candidate || candidate.type != PXSS_WHITESPACE)
+        {
+            result = candidate;
+            break;
+        }
+        else
+        {
+            *followsWhitespace = YES;
+        }
+    }
+
+    return result;
+}
+
 - (PXStylesheetLexeme *)nextLexeme
 {
     PXStylesheetLexeme *result = nil;
+    BOOL scanned = NO;
 
     if (lexemeStack_.count > 0)
     {
@@ -319,51 +405,25 @@
     }
     else if (_source)
     {
+        scanned = YES;
+
         NSUInteger length = [_source length];
         BOOL followsWhitespace = NO;
 
-        // loop until we find a valid lexeme or the end of the string
-        while (offset_ < length)
+        if (scanner_)
         {
-            NSRange range = NSMakeRange(offset_, length - offset_);
-            PXStylesheetLexeme *candidate = nil;
-
-            for (id<PXLexemeCreator> creator in tokens_)
-            {
-                PXStylesheetLexeme *lexeme = [creator createLexemeWithString:_source withRange:range];
-
-                if (lexeme)
-                {
-                    NSRange lexemeRange = lexeme.range;
-
-                    offset_ = lexemeRange.location + lexemeRange.length;
-                    candidate = lexeme;
-
-                    if (followsWhitespace)
-                    {
-                        [lexeme setFlag:PXLexemeFlagFollowsWhitespace];
-                    }
-                    break;
-                }
-            }
-
-            // skip whitespace
-            if (!candidate || candidate.type != PXSS_WHITESPACE)
-            {
-                result = candidate;
-                break;
-            }
-            else
-            {
-                followsWhitespace = YES;
-            }
+            result = [scanner_ nextLexemeFromOffset:&offset_ followsWhitespace:&followsWhitespace];
+        }
+        else
+        {
+            result = [self nextMatcherChainLexemeFollowingWhitespace:&followsWhitespace];
         }
 
         // possibly create an error token
         if (!result && offset_ < length)
         {
             NSRange range = NSMakeRange(offset_, 1);
-            result = [PXStylesheetLexeme lexemeWithType:PXSS_ERROR withRange:range withValue:[_source substringWithRange:range]];
+            result = [PXStylesheetLexeme lexemeWithType:PXSS_ERROR withRange:range withSource:_source];
 
             if (followsWhitespace)
             {
@@ -381,12 +441,7 @@
         if (blockDepth_ == 0 && result.type == PXSS_HEX_COLOR)
         {
             // fix-up colors to be ids outside of declaration blocks
-            result = [PXStylesheetLexeme lexemeWithType:PXSS_ID withRange:result.range withValue:result.value];
-
-            if (followsWhitespace)
-            {
-                [result setFlag:PXLexemeFlagFollowsWhitespace];
-            }
+            result = [result lexemeWithType:PXSS_ID];
         }
 
         switch (result.type)
@@ -403,12 +458,12 @@
             case PXSS_CLASS:
             case PXSS_IDENTIFIER:
             {
-                NSString *stringValue = result.value;
-
-                if ([stringValue rangeOfString:@"\\"].location != NSNotFound)
+                // pushed lexemes were fixed up when they were first scanned, so only check new ones. Searching the
+                // source range avoids creating the lexeme's value
+                if (scanned && [_source rangeOfString:@"\\" options:NSLiteralSearch range:result.range].location != NSNotFound)
                 {
                     // simply drop slash, for now
-                    stringValue = [stringValue stringByReplacingOccurrencesOfString:@"\\" withString:@""];
+                    NSString *stringValue = [result.value stringByReplacingOccurrencesOfString:@"\\" withString:@""];
 
                     result = [PXStylesheetLexeme lexemeWithType:result.type withRange:result.range withValue:stringValue];
 
@@ -436,7 +491,7 @@
 
 - (void)dealloc
 {
-    tokens_ = nil;
+    scanner_ = nil;
     lexemeStack_ = nil;
     stateStack_ = nil;
     _source = nil;
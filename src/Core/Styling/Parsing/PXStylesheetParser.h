@@ -38,6 +38,11 @@
  */
 @interface PXStylesheetParser : PXParserBase <PXStylesheetLexerDelegate>
 
+/**
+ *  The sources of the files inlined by @import statements during the last parse, in the order they were inlined
+ */
+@property (readonly, nonatomic) NSArray *importedSources;
+
 /**
  *  Make a first pass parse of the specified source and return the results in a new stylesheet instance.
  *
@@ -52,6 +52,7 @@
     PXStylesheet *currentStyleSheet_;
     PXTypeSelector *currentSelector_;
     NSMutableArray *activeImports_;
+    NSMutableArray *importedSources_;
 }
 
 #ifdef PX_LOGGING
@@ -239,6 +240,13 @@ static NSIndexSet *ARCHAIC_PSEUDO_ELEMENTS_SET;
     return self;
 }
 
+#pragma mark - Getters
+
+- (NSArray *)importedSources
+{
+    return (importedSources_) ? [NSArray arrayWithArray:importedSources_] : @[];
+}
+
 #pragma mark - Methods
 
 // level 0
@@ -262,8 +270,9 @@ static NSIndexSet *ARCHAIC_PSEUDO_ELEMENTS_SET;
     // clear errors
     [self clearErrors];
 
-    // create stylesheet
-    currentStyleSheet_ = [[PXStylesheet alloc] initWithOrigin:origin];
+    // create stylesheet. Callers decide when it becomes current, so parsing can happen off of the main thread
+    currentStyleSheet_ = [[PXStylesheet alloc] initWithOrigin:origin makeCurrent:NO];
+    importedSources_ = nil;
 
     // setup lexer and prime it
     lexer_.source = source;
@@ -319,7 +328,7 @@ static NSIndexSet *ARCHAIC_PSEUDO_ELEMENTS_SET;
     [self clearErrors];
 
     // create stylesheet
-    self->currentStyleSheet_ = [[PXStylesheet alloc] initWithOrigin:PXStylesheetOriginInline];
+    self->currentStyleSheet_ = [[PXStylesheet alloc] initWithOrigin:PXStylesheetOriginInline makeCurrent:NO];
 
     // setup lexer and prime it
     lexer_.source = css;
@@ -389,6 +398,7 @@ static NSIndexSet *ARCHAIC_PSEUDO_ELEMENTS_SET;
         {
             if ([@"src" isEqualToString:declaration.name])
             {
+                [currentStyleSheet_ addFontFaceDeclaration:declaration];
                 [PXFontRegistry loadFontFromURL:declaration.URLValue];
             }
         }
@@ -443,6 +453,13 @@ static NSIndexSet *ARCHAIC_PSEUDO_ELEMENTS_SET;
 
             if (source.length > 0)
             {
+                if (importedSources_ == nil)
+                {
+                    importedSources_ = [[NSMutableArray alloc] init];
+                }
+
+                [importedSources_ addObject:source];
+
                 [lexer_ pushLexeme:currentLexeme];
                 [lexer_ pushSource:source];
                 [self advance];
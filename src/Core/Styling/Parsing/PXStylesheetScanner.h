@@ -0,0 +1,55 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXStylesheetScanner.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStylesheetLexeme.h"
+
+/**
+ *  PXStylesheetScanner is a hand-written, single-pass scanner over the UTF-16 characters of a stylesheet. It produces
+ *  the same lexemes as the PXLexemeCreator chain used by PXStylesheetLexer, but it decides on a token by dispatching
+ *  on the current character instead of running a regular expression per token type.
+ */
+@interface PXStylesheetScanner : NSObject
+
+/**
+ *  The source string being scanned
+ */
+@property (nonatomic, strong, readonly) NSString *source;
+
+/**
+ *  Initialize a new instance with the specified source value. The characters of the source are copied into an
+ *  internal buffer once, up front.
+ *
+ *  @param source The source string to scan
+ */
+- (id)initWithString:(NSString *)source;
+
+/**
+ *  Skip whitespace and comments starting at the specified offset and return the next lexeme. The offset is advanced
+ *  past the returned lexeme. If no token can be matched at the resulting offset, nil is returned and the offset is
+ *  left pointing at the offending character so the caller can produce an error lexeme.
+ *
+ *  @param offset A pointer to the offset where scanning should begin
+ *  @param followsWhitespace Set to YES if whitespace or a comment was skipped before the returned lexeme
+ */
+- (PXStylesheetLexeme *)nextLexemeFromOffset:(NSUInteger *)offset followsWhitespace:(BOOL *)followsWhitespace;
+
+@end
@@ -0,0 +1,888 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXStylesheetScanner.m
+//  Pixate
+//
+
+#import "PXStylesheetScanner.h"
+#import "PXStylesheetTokenType.h"
+
+typedef struct
+{
+    const char *text;
+    PXStylesheetTokens type;
+} PXScannerWord;
+
+// NOTE: no word in a table is a prefix of another word in the same table, so the first match is the only match
+
+static const PXScannerWord PSEUDO_CLASSES[] = {
+    { ":not(", PXSS_NOT_PSEUDO_CLASS },
+    { ":link", PXSS_LINK_PSEUDO_CLASS },
+    { ":visited", PXSS_VISITED_PSEUDO_CLASS },
+    { ":hover", PXSS_HOVER_PSEUDO_CLASS },
+    { ":active", PXSS_ACTIVE_PSEUDO_CLASS },
+    { ":focus", PXSS_FOCUS_PSEUDO_CLASS },
+    { ":target", PXSS_TARGET_PSEUDO_CLASS },
+    { ":lang(", PXSS_LANG_PSEUDO_CLASS },
+    { ":enabled", PXSS_ENABLED_PSEUDO_CLASS },
+    { ":checked", PXSS_CHECKED_PSEUDO_CLASS },
+    { ":indeterminate", PXSS_INDETERMINATE_PSEUDO_CLASS },
+    { ":root", PXSS_ROOT_PSEUDO_CLASS },
+    { ":nth-child(", PXSS_NTH_CHILD_PSEUDO_CLASS },
+    { ":nth-last-child(", PXSS_NTH_LAST_CHILD_PSEUDO_CLASS },
+    { ":nth-of-type(", PXSS_NTH_OF_TYPE_PSEUDO_CLASS },
+    { ":nth-last-of-type(", PXSS_NTH_LAST_OF_TYPE_PSEUDO_CLASS },
+    { ":first-child", PXSS_FIRST_CHILD_PSEUDO_CLASS },
+    { ":last-child", PXSS_LAST_CHILD_PSEUDO_CLASS },
+    { ":first-of-type", PXSS_FIRST_OF_TYPE_PSEUDO_CLASS },
+    { ":last-of-type", PXSS_LAST_OF_TYPE_PSEUDO_CLASS },
+    { ":only-child", PXSS_ONLY_CHILD_PSEUDO_CLASS },
+    { ":only-of-type", PXSS_ONLY_OF_TYPE_PSEUDO_CLASS },
+    { ":empty", PXSS_EMPTY_PSEUDO_CLASS },
+    { ":first-line", PXSS_FIRST_LINE_PSEUDO_ELEMENT },
+    { ":first-letter", PXSS_FIRST_LETTER_PSEUDO_ELEMENT },
+    { ":before", PXSS_BEFORE_PSEUDO_ELEMENT },
+    { ":after", PXSS_AFTER_PSEUDO_ELEMENT },
+};
+
+static const PXScannerWord FUNCTIONS[] = {
+    { "linear-gradient(", PXSS_LINEAR_GRADIENT },
+    { "radial-gradient(", PXSS_RADIAL_GRADIENT },
+    { "hsb(", PXSS_HSB },
+    { "hsba(", PXSS_HSBA },
+    { "hsl(", PXSS_HSL },
+    { "hsla(", PXSS_HSLA },
+    { "rgb(", PXSS_RGB },
+    { "rgba(", PXSS_RGBA },
+};
+
+static const PXScannerWord KEYWORDS[] = {
+    { "@keyframes", PXSS_KEYFRAMES },
+    { "@namespace", PXSS_NAMESPACE },
+    { "@import", PXSS_IMPORT },
+    { "@media", PXSS_MEDIA },
+    { "@font-face", PXSS_FONT_FACE },
+    { "and", PXSS_AND },
+};
+
+static const PXScannerWord UNITS[] = {
+    { "em", PXSS_EMS },
+    { "ex", PXSS_EXS },
+    { "px", PXSS_LENGTH },
+    { "dpx", PXSS_LENGTH },
+    { "cm", PXSS_LENGTH },
+    { "mm", PXSS_LENGTH },
+    { "in", PXSS_LENGTH },
+    { "pt", PXSS_LENGTH },
+    { "pc", PXSS_LENGTH },
+    { "deg", PXSS_ANGLE },
+    { "rad", PXSS_ANGLE },
+    { "grad", PXSS_ANGLE },
+    { "ms", PXSS_TIME },
+    { "s", PXSS_TIME },
+    { "Hz", PXSS_FREQUENCY },
+    { "kHz", PXSS_FREQUENCY },
+};
+
+#define PX_WORD_COUNT(table) (sizeof(table) / sizeof(PXScannerWord))
+
+#pragma mark - Character Classes
+
+static NSCharacterSet *WORD_SET;
+static NSCharacterSet *SPACE_SET;
+
+static inline BOOL isWordChar(unichar c)
+{
+    if (c < 128)
+    {
+        return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_';
+    }
+
+    return [WORD_SET characterIsMember:c];
+}
+
+static inline BOOL isSpaceChar(unichar c)
+{
+    if (c < 128)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    return [SPACE_SET characterIsMember:c];
+}
+
+static inline BOOL isDigit(unichar c)
+{
+    return '0' <= c && c <= '9';
+}
+
+static inline BOOL isHexDigit(unichar c)
+{
+    return isDigit(c) || ('a' <= c && c <= 'f') || ('A' <= c && c <= 'F');
+}
+
+static inline BOOL isNameStart(unichar c)
+{
+    return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '-' || c == '_';
+}
+
+static inline BOOL isNameChar(unichar c)
+{
+    return isNameStart(c) || isDigit(c);
+}
+
+#pragma mark - Scanning Functions
+
+/*
+ *  Return the length of an escape sequence at the specified index, or zero if there is none
+ */
+static inline NSUInteger escapeLength(const unichar *chars, NSUInteger length, NSUInteger index)
+{
+    if (chars[index] == '\\' && index + 1 < length)
+    {
+        unichar c = chars[index + 1];
+
+        if (c != '\r' && c != '\n' && c != '\f' && !isDigit(c) && !('a' <= c && c <= 'f'))
+        {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ *  Return the end of a name (identifier, class, or id body) beginning at the specified index. If no name begins at
+ *  the index, the index itself is returned
+ */
+static NSUInteger scanName(const unichar *chars, NSUInteger length, NSUInteger index)
+{
+    BOOL first = YES;
+
+    while (index < length)
+    {
+        unichar c = chars[index];
+
+        if ((first) ? isNameStart(c) : isNameChar(c))
+        {
+            index++;
+        }
+        else
+        {
+            NSUInteger escape = escapeLength(chars, length, index);
+
+            if (escape == 0)
+            {
+                break;
+            }
+
+            index += escape;
+        }
+
+        first = NO;
+    }
+
+    return index;
+}
+
+/*
+ *  Return the length of the word in the table that appears at the specified index, or zero if none does. When
+ *  wholeWord is YES, the word must not be followed by a word character
+ */
+static NSUInteger matchWord(const unichar *chars, NSUInteger length, NSUInteger index, const PXScannerWord *words, NSUInteger count, BOOL wholeWord, PXStylesheetTokens *type)
+{
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        const char *text = words[i].text;
+        NSUInteger j = 0;
+
+        while (text[j] != '\0' && index + j < length && chars[index + j] == (unichar) text[j])
+        {
+            j++;
+        }
+
+        if (text[j] == '\0')
+        {
+            if (!wholeWord || index + j >= length || !isWordChar(chars[index + j]))
+            {
+                *type = words[i].type;
+
+                return j;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ *  Return the end of the number beginning at the specified index, or the index itself if there is none. This matches
+ *  [-+]?(?:[0-9]*\.[0-9]+|[0-9]+)
+ */
+static NSUInteger scanNumber(const unichar *chars, NSUInteger length, NSUInteger index)
+{
+    NSUInteger i = index;
+
+    if (i < length && (chars[i] == '-' || chars[i] == '+'))
+    {
+        i++;
+    }
+
+    NSUInteger digitsStart = i;
+
+    while (i < length && isDigit(chars[i]))
+    {
+        i++;
+    }
+
+    if (i + 1 < length && chars[i] == '.' && isDigit(chars[i + 1]))
+    {
+        i += 2;
+
+        while (i < length && isDigit(chars[i]))
+        {
+            i++;
+        }
+
+        return i;
+    }
+
+    return (i > digitsStart) ? i : index;
+}
+
+/*
+ *  Return the end of an nth expression beginning at the specified index, or the index itself if there is none. This
+ *  matches [-+]?\d*[nN]\b
+ */
+static NSUInteger scanNth(const unichar *chars, NSUInteger length, NSUInteger index)
+{
+    NSUInteger i = index;
+
+    if (i < length && (chars[i] == '-' || chars[i] == '+'))
+    {
+        i++;
+    }
+
+    while (i < length && isDigit(chars[i]))
+    {
+        i++;
+    }
+
+    if (i < length && (chars[i] == 'n' || chars[i] == 'N') && (i + 1 >= length || !isWordChar(chars[i + 1])))
+    {
+        return i + 1;
+    }
+
+    return index;
+}
+
+/*
+ *  Return the end of a quoted string beginning at the specified index, or the index itself if the string is not
+ *  terminated on the same line
+ */
+static NSUInteger scanString(const unichar *chars, NSUInteger length, NSUInteger index)
+{
+    unichar quote = chars[index];
+    NSUInteger i = index + 1;
+
+    while (i < length)
+    {
+        unichar c = chars[i];
+
+        if (c == quote)
+        {
+            return i + 1;
+        }
+        else if (c == '\r' || c == '\n' || c == '\f')
+        {
+            break;
+        }
+        else if (c == '\\')
+        {
+            if (i + 1 >= length || chars[i + 1] == '\r' || chars[i + 1] == '\n' || chars[i + 1] == '\f')
+            {
+                break;
+            }
+
+            i += 2;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return index;
+}
+
+/*
+ *  Return the end of a url(...) expression beginning at the specified index, or the index itself if there is none.
+ *  The range of the url's content is returned in valueRange
+ */
+static NSUInteger scanURL(const unichar *chars, NSUInteger length, NSUInteger index, NSRange *valueRange)
+{
+    NSUInteger i = index + 4;
+
+    if (i > length || chars[index] != 'u' || chars[index + 1] != 'r' || chars[index + 2] != 'l' || chars[index + 3] != '(')
+    {
+        return index;
+    }
+
+    while (i < length && isSpaceChar(chars[i]))
+    {
+        i++;
+    }
+
+    NSUInteger contentStart = i;
+
+    // "..."
+    if (i < length && chars[i] == '"')
+    {
+        NSUInteger j = i + 1;
+
+        while (j < length && chars[j] != '"' && chars[j] != '\r' && chars[j] != '\n')
+        {
+            j++;
+        }
+
+        if (j < length && chars[j] == '"')
+        {
+            NSUInteger k = j + 1;
+
+            while (k < length && isSpaceChar(chars[k]))
+            {
+                k++;
+            }
+
+            if (k < length && chars[k] == ')')
+            {
+                *valueRange = NSMakeRange(i + 1, j - i - 1);
+
+                return k + 1;
+            }
+        }
+    }
+
+    // data:<type>,<base64>
+    if (i + 5 <= length && chars[i] == 'd' && chars[i + 1] == 'a' && chars[i + 2] == 't' && chars[i + 3] == 'a' && chars[i + 4] == ':')
+    {
+        NSUInteger j = i + 5;
+
+        while (j < length && chars[j] != ',' && chars[j] != '\r' && chars[j] != '\n' && chars[j] != ')')
+        {
+            j++;
+        }
+
+        if (j > i + 5 && j < length && chars[j] == ',')
+        {
+            NSUInteger dataStart = ++j;
+
+            while (j < length)
+            {
+                unichar c = chars[j];
+
+                if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || isDigit(c) || c == '+' || c == '/' || c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                {
+                    j++;
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            if (j > dataStart)
+            {
+                for (NSUInteger padding = 0; padding < 2 && j < length && chars[j] == '='; padding++)
+                {
+                    j++;
+                }
+
+                NSUInteger k = j;
+
+                while (k < length && isSpaceChar(chars[k]))
+                {
+                    k++;
+                }
+
+                if (k < length && chars[k] == ')')
+                {
+                    *valueRange = NSMakeRange(contentStart, j - contentStart);
+
+                    return k + 1;
+                }
+            }
+        }
+    }
+
+    // unquoted
+    while (i < length)
+    {
+        unichar c = chars[i];
+
+        if (c == '!' || ('#' <= c && c <= '&') || ('*' <= c && c <= '~'))
+        {
+            i++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    NSUInteger contentEnd = i;
+
+    while (i < length && isSpaceChar(chars[i]))
+    {
+        i++;
+    }
+
+    if (i < length && chars[i] == ')')
+    {
+        *valueRange = NSMakeRange(contentStart, contentEnd - contentStart);
+
+        return i + 1;
+    }
+
+    return index;
+}
+
+@implementation PXStylesheetScanner
+{
+    unichar *characters_;
+    NSUInteger length_;
+}
+
++ (void)initialize
+{
+    if (self == [PXStylesheetScanner class])
+    {
+        WORD_SET = [NSCharacterSet alphanumericCharacterSet];
+        SPACE_SET = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+    }
+}
+
+#pragma mark - Initializers
+
+- (id)initWithString:(NSString *)source
+{
+    if (self = [super init])
+    {
+        _source = source;
+        length_ = source.length;
+
+        if (length_ > 0)
+        {
+            characters_ = malloc(length_ * sizeof(unichar));
+            [source getCharacters:characters_ range:NSMakeRange(0, length_)];
+        }
+    }
+
+    return self;
+}
+
+#pragma mark - Methods
+
+- (PXStylesheetLexeme *)nextLexemeFromOffset:(NSUInteger *)offset followsWhitespace:(BOOL *)followsWhitespace
+{
+    const unichar *chars = characters_;
+    NSUInteger length = length_;
+    NSUInteger start = *offset;
+
+    // skip whitespace and comments
+    while (start < length)
+    {
+        unichar c = chars[start];
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            start++;
+            *followsWhitespace = YES;
+        }
+        else if (c == '/' && start + 1 < length && chars[start + 1] == '*')
+        {
+            NSUInteger end = NSNotFound;
+
+            for (NSUInteger i = start + 2; i + 1 < length; i++)
+            {
+                if (chars[i] == '*' && chars[i + 1] == '/')
+                {
+                    end = i + 2;
+                    break;
+                }
+            }
+
+            if (end == NSNotFound)
+            {
+                // an unterminated comment is lexed as a slash
+                break;
+            }
+
+            start = end;
+            *followsWhitespace = YES;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    *offset = start;
+
+    if (start >= length)
+    {
+        return nil;
+    }
+
+    unichar c = chars[start];
+    PXStylesheetTokens type = PXSS_ERROR;
+    NSUInteger end = start;
+    NSRange valueRange = NSMakeRange(NSNotFound, 0);
+    NSUInteger numberEnd = NSNotFound;
+
+    switch (c)
+    {
+        case ':':
+            end = start + matchWord(chars, length, start, PSEUDO_CLASSES, PX_WORD_COUNT(PSEUDO_CLASSES), NO, &type);
+
+            if (end == start)
+            {
+                if (start + 1 < length && chars[start + 1] == ':')
+                {
+                    type = PXSS_DOUBLE_COLON;
+                    end = start + 2;
+                }
+                else
+                {
+                    type = PXSS_COLON;
+                    end = start + 1;
+                }
+            }
+            break;
+
+        case '#':
+        {
+            NSUInteger i = start + 1;
+
+            while (i < length && isHexDigit(chars[i]))
+            {
+                i++;
+            }
+
+            NSUInteger count = i - start - 1;
+
+            if ((count == 3 || count == 4 || count == 6 || count == 8) && (i >= length || !isWordChar(chars[i])))
+            {
+                type = PXSS_HEX_COLOR;
+                end = i;
+            }
+            else
+            {
+                end = scanName(chars, length, start + 1);
+
+                if (end > start + 1)
+                {
+                    type = PXSS_ID;
+                }
+                else
+                {
+                    end = start;
+                }
+            }
+            break;
+        }
+
+        case '@':
+            end = start + matchWord(chars, length, start, KEYWORDS, PX_WORD_COUNT(KEYWORDS), YES, &type);
+            break;
+
+        case '!':
+        {
+            static const char *important = "important";
+            NSUInteger i = start + 1;
+
+            while (i < length && isSpaceChar(chars[i]))
+            {
+                i++;
+            }
+
+            NSUInteger j = 0;
+
+            while (important[j] != '\0' && i + j < length && chars[i + j] == (unichar) important[j])
+            {
+                j++;
+            }
+
+            if (important[j] == '\0' && (i + j >= length || !isWordChar(chars[i + j])))
+            {
+                type = PXSS_IMPORTANT;
+                end = i + j;
+            }
+            break;
+        }
+
+        case '"':
+        case '\'':
+            end = scanString(chars, length, start);
+
+            if (end > start)
+            {
+                type = PXSS_STRING;
+            }
+            break;
+
+        case '^':
+        case '$':
+        case '*':
+        case '~':
+        case '|':
+            if (start + 1 < length && chars[start + 1] == '=')
+            {
+                switch (c)
+                {
+                    case '^': type = PXSS_STARTS_WITH; break;
+                    case '$': type = PXSS_ENDS_WITH; break;
+                    case '*': type = PXSS_CONTAINS; break;
+                    case '~': type = PXSS_LIST_CONTAINS; break;
+                    default: type = PXSS_EQUALS_WITH_HYPHEN; break;
+                }
+
+                end = start + 2;
+            }
+            else
+            {
+                switch (c)
+                {
+                    case '*': type = PXSS_STAR; end = start + 1; break;
+                    case '~': type = PXSS_TILDE; end = start + 1; break;
+                    case '|': type = PXSS_PIPE; end = start + 1; break;
+                }
+            }
+            break;
+
+        case '{': type = PXSS_LCURLY; end = start + 1; break;
+        case '}': type = PXSS_RCURLY; end = start + 1; break;
+        case '(': type = PXSS_LPAREN; end = start + 1; break;
+        case ')': type = PXSS_RPAREN; end = start + 1; break;
+        case '[': type = PXSS_LBRACKET; end = start + 1; break;
+        case ']': type = PXSS_RBRACKET; end = start + 1; break;
+        case ';': type = PXSS_SEMICOLON; end = start + 1; break;
+        case '>': type = PXSS_GREATER_THAN; end = start + 1; break;
+        case '=': type = PXSS_EQUAL; end = start + 1; break;
+        case ',': type = PXSS_COMMA; end = start + 1; break;
+        case '/': type = PXSS_SLASH; end = start + 1; break;
+
+        default:
+        {
+            // functions
+            if (c == 'l' || c == 'r' || c == 'h')
+            {
+                end = start + matchWord(chars, length, start, FUNCTIONS, PX_WORD_COUNT(FUNCTIONS), NO, &type);
+            }
+
+            // urls
+            if (end == start && c == 'u')
+            {
+                end = scanURL(chars, length, start, &valueRange);
+
+                if (end > start)
+                {
+                    type = PXSS_URL;
+                }
+            }
+
+            // nth
+            if (end == start && (c == '-' || c == '+' || c == 'n' || c == 'N' || isDigit(c)))
+            {
+                end = scanNth(chars, length, start);
+
+                if (end > start)
+                {
+                    type = PXSS_NTH;
+                }
+            }
+
+            // numbers and dimensions
+            if (end == start && (c == '-' || c == '+' || c == '.' || isDigit(c)))
+            {
+                numberEnd = scanNumber(chars, length, start);
+
+                if (numberEnd > start)
+                {
+                    end = numberEnd;
+                    type = PXSS_NUMBER;
+
+                    if (end < length && chars[end] == '%')
+                    {
+                        type = PXSS_PERCENTAGE;
+                        end++;
+                    }
+                    else if (end < length && isNameStart(chars[end]))
+                    {
+                        while (end < length && isNameChar(chars[end]))
+                        {
+                            end++;
+                        }
+
+                        type = PXSS_DIMENSION;
+
+                        for (NSUInteger i = 0; i < PX_WORD_COUNT(UNITS); i++)
+                        {
+                            const char *unit = UNITS[i].text;
+                            NSUInteger j = 0;
+
+                            while (numberEnd + j < end && unit[j] != '\0' && chars[numberEnd + j] == (unichar) unit[j])
+                            {
+                                j++;
+                            }
+
+                            if (unit[j] == '\0' && numberEnd + j == end)
+                            {
+                                type = UNITS[i].type;
+                                break;
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    numberEnd = NSNotFound;
+                }
+            }
+
+            // the "and" keyword
+            if (end == start && c == 'a')
+            {
+                end = start + matchWord(chars, length, start, KEYWORDS, PX_WORD_COUNT(KEYWORDS), YES, &type);
+            }
+
+            // classes
+            if (end == start && c == '.')
+            {
+                end = scanName(chars, length, start + 1);
+
+                if (end > start + 1)
+                {
+                    type = PXSS_CLASS;
+                }
+                else
+                {
+                    end = start;
+                }
+            }
+
+            // identifiers
+            if (end == start && c != '.')
+            {
+                end = scanName(chars, length, start);
+
+                if (end > start)
+                {
+                    type = PXSS_IDENTIFIER;
+                }
+            }
+
+            // single-character operator that may also start a number
+            if (end == start && c == '+')
+            {
+                type = PXSS_PLUS;
+                end = start + 1;
+            }
+            break;
+        }
+    }
+
+    if (end == start)
+    {
+        // no match
+        return nil;
+    }
+
+    *offset = end;
+
+    NSRange range = NSMakeRange(start, end - start);
+    PXStylesheetLexeme *result;
+
+    // values are created lazily by the lexeme, directly from the source
+    if (numberEnd != NSNotFound)
+    {
+        float floatValue = [self floatValueFromIndex:start toIndex:numberEnd];
+
+        if (type == PXSS_NUMBER)
+        {
+            range = NSMakeRange(start, numberEnd - start);
+        }
+
+        result = [PXStylesheetLexeme lexemeWithType:type
+                                          withRange:range
+                                         withSource:_source
+                                         withNumber:floatValue
+                                      withUnitRange:NSMakeRange(numberEnd, end - numberEnd)];
+    }
+    else if (valueRange.location != NSNotFound)
+    {
+        result = [PXStylesheetLexeme lexemeWithType:type withRange:range withSource:_source withValueRange:valueRange];
+    }
+    else
+    {
+        result = [PXStylesheetLexeme lexemeWithType:type withRange:range withSource:_source];
+    }
+
+    if (*followsWhitespace)
+    {
+        [result setFlag:PXLexemeFlagFollowsWhitespace];
+    }
+
+    return result;
+}
+
+- (float)floatValueFromIndex:(NSUInteger)start toIndex:(NSUInteger)end
+{
+    char buffer[64];
+    NSUInteger count = end - start;
+
+    if (count >= sizeof(buffer))
+    {
+        // unusually long numbers take the slow path
+        return [[_source substringWithRange:NSMakeRange(start, count)] floatValue];
+    }
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        buffer[i] = (char) characters_[start + i];
+    }
+
+    buffer[count] = '\0';
+
+    return (float) strtod(buffer, NULL);
+}
+
+#pragma mark - Overrides
+
+- (void)dealloc
+{
+    if (characters_)
+    {
+        free(characters_);
+        characters_ = NULL;
+    }
+
+    _source = nil;
+}
+
+@end
@@ -185,13 +185,9 @@ static NSString *ASSET_SCHEME = @"asset://";
 
     if (source.length > 0)
     {
-        static PXStylesheetLexer *lexer;
-        static dispatch_once_t onceToken;
-        dispatch_once(&onceToken, ^{
-            lexer = [[PXStylesheetLexer alloc] init];
-        });
+        // lexers are cheap to create and are not thread safe, so don't share one
+        PXStylesheetLexer *lexer = [[PXStylesheetLexer alloc] initWithString:source];
 
-        lexer.source = source;
         [lexer increaseNesting];
         PXStylesheetLexeme *lexeme = [lexer nextLexeme];
 
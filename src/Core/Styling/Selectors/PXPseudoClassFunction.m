@@ -60,7 +60,10 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 - (BOOL)matches:(id<PXStyleable>)element
 {
     BOOL result = NO;
-    PXStyleableChildrenInfo *info = [PXStyleUtils childrenInfoForStyleable:element];
+    PXStyleableChildrenInfo childrenInfo;
+    PXStyleableChildrenInfo *info = &childrenInfo;
+
+    [PXStyleUtils getChildrenInfo:info forStyleable:element];
 
     if (_modulus != 0 || _remainder != 0)
     {
@@ -114,8 +117,6 @@ static int ddLogLevel = LOG_LEVEL_WARN;
         }
     }
 
-    free(info);
-
     if (result)
     {
         DDLogVerbose(@"%@ matched %@", self.description, [PXStyleUtils descriptionForStyleable:element]);
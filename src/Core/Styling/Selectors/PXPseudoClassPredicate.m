@@ -58,7 +58,14 @@ static int ddLogLevel = LOG_LEVEL_WARN;
 - (BOOL)matches:(id<PXStyleable>)element
 {
     BOOL result = NO;
-    PXStyleableChildrenInfo *info = [PXStyleUtils childrenInfoForStyleable:element];
+    PXStyleableChildrenInfo childrenInfo;
+    PXStyleableChildrenInfo *info = &childrenInfo;
+
+    // :root and :empty do not depend on siblings
+    if (_predicateType != PXPseudoClassPredicateRoot && _predicateType != PXPseudoClassPredicateEmpty)
+    {
+        [PXStyleUtils getChildrenInfo:info forStyleable:element];
+    }
 
     switch (_predicateType)
     {
@@ -110,8 +117,6 @@ static int ddLogLevel = LOG_LEVEL_WARN;
         }
     }
 
-    free(info);
-
     if (result)
     {
         DDLogVerbose(@"%@ matched %@", self.description, [PXStyleUtils descriptionForStyleable:element]);
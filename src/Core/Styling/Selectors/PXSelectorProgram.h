@@ -0,0 +1,92 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXSelectorProgram.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStyleable.h"
+#import "PXSelector.h"
+
+/**
+ *  The PXSelectorOpcode enumeration defines the instructions of a compiled selector. Each instruction tests the current
+ *  element and fails the match, or moves to another element in the case of combinators.
+ */
+typedef enum
+{
+    PXSelectorOpcodeMatch,                      // the selector matched
+    PXSelectorOpcodeFail,                       // the selector can never match
+    PXSelectorOpcodeElementName,                // a: element name atom
+    PXSelectorOpcodeNamespace,                  // a: namespace URI, or none to require no namespace
+    PXSelectorOpcodeStyleId,                    // a: id atom
+    PXSelectorOpcodeStyleClass,                 // a: class name atom
+    PXSelectorOpcodeAttributeExists,            // a: attribute name, b: namespace URI
+    PXSelectorOpcodeAttributeStartsWith,        // a: attribute name, b: namespace URI, c: value
+    PXSelectorOpcodeAttributeEndsWith,
+    PXSelectorOpcodeAttributeContains,
+    PXSelectorOpcodeAttributeEqual,
+    PXSelectorOpcodeAttributeListContains,
+    PXSelectorOpcodeAttributeEqualWithHyphen,
+    PXSelectorOpcodePseudoElement,              // a: pseudo-element name
+    PXSelectorOpcodeSelector,                   // a: selector object to call matches: on
+    PXSelectorOpcodeChild,                      // continue with the parent
+    PXSelectorOpcodeDescendant,                 // continue with any ancestor
+    PXSelectorOpcodeAdjacentSibling,            // continue with the previous sibling
+    PXSelectorOpcodeSibling                     // continue with any previous sibling
+} PXSelectorOpcode;
+
+/**
+ *  A PXSelectorProgram is the compiled form of the selectors of a rule set. Each selector is lowered into a flat array
+ *  of instructions that test the rightmost compound selector first and then move leftward through combinators, so most
+ *  elements are rejected by the first instruction. Type, id, class, and attribute tests are evaluated directly, while
+ *  pseudo-classes and selector types the compiler does not know about are evaluated by calling the selector objects.
+ *
+ *  The selector objects remain the source of truth for introspection. Programs are immutable and may be shared across
+ *  threads.
+ */
+@interface PXSelectorProgram : NSObject
+
+/**
+ *  The number of instructions in this program
+ */
+@property (nonatomic, readonly) NSUInteger instructionCount;
+
+/**
+ *  A flag indicating if the result of this program depends only on the element names, ids, classes, and namespaces of
+ *  an element and its ancestors. Programs that test attributes, siblings, or structural pseudo-classes
+ *  like :first-child and :nth-child() are not cacheable
+ */
+@property (nonatomic, readonly) BOOL cacheable;
+
+/**
+ *  Initialize a new instance for the specified selectors. The program matches an element when all of the selectors
+ *  match it.
+ *
+ *  @param selectors An array of id<PXSelector> instances
+ */
+- (id)initWithSelectors:(NSArray *)selectors;
+
+/**
+ *  Determine if all selectors in this program match the specified element. This returns NO if the program has no
+ *  selectors.
+ *
+ *  @param element The element to test
+ */
+- (BOOL)matches:(id<PXStyleable>)element;
+
+@end
@@ -0,0 +1,648 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXSelectorProgram.m
+//  Pixate
+//
+
+#import "PXSelectorProgram.h"
+#import "PXTypeSelector.h"
+#import "PXIdSelector.h"
+#import "PXClassSelector.h"
+#import "PXAttributeSelector.h"
+#import "PXAttributeSelectorOperator.h"
+#import "PXDescendantCombinator.h"
+#import "PXChildCombinator.h"
+#import "PXAdjacentSiblingCombinator.h"
+#import "PXSiblingCombinator.h"
+#import "PXPseudoClassSelector.h"
+#import "PXAncestorFilter.h"
+#import "PXStyleUtils.h"
+#import "PXStyleableAtoms.h"
+
+#define PX_SELECTOR_PROGRAM_NONE UINT32_MAX
+#define PX_SELECTOR_CONSTANT(index) (((index) == PX_SELECTOR_PROGRAM_NONE) ? nil : constants[(index)])
+
+typedef struct
+{
+    PXSelectorOpcode opcode;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+} PXSelectorInstruction;
+
+static NSArray *OPCODE_NAMES;
+
+@implementation PXSelectorProgram
+{
+    PXSelectorInstruction *instructions_;
+    NSUInteger instructionCount_;
+    NSUInteger capacity_;
+
+    // the constants array owns the strings and selectors the instructions refer to by index. Element names, ids, and
+    // classes are interned and stored in the instructions as atoms instead
+    NSMutableArray *constants_;
+    __unsafe_unretained id *constantPointers_;
+
+    NSUInteger *entries_;
+    NSUInteger entryCount_;
+
+    NSData *ancestorKeys_;
+}
+
+#pragma mark - Static Initializers
+
++ (void)initialize
+{
+    if (self == [PXSelectorProgram class])
+    {
+        OPCODE_NAMES = @[
+            @"MATCH", @"FAIL", @"ELEMENT", @"NAMESPACE", @"ID", @"CLASS",
+            @"ATTR", @"ATTR^=", @"ATTR$=", @"ATTR*=", @"ATTR=", @"ATTR~=", @"ATTR|=",
+            @"PSEUDO_ELEMENT", @"SELECTOR",
+            @"CHILD", @"DESCENDANT", @"ADJACENT_SIBLING", @"SIBLING"
+        ];
+    }
+}
+
+#pragma mark - Initializers
+
+- (id)initWithSelectors:(NSArray *)selectors
+{
+    if (self = [super init])
+    {
+        NSMutableData *ancestorKeys = [NSMutableData data];
+
+        constants_ = [[NSMutableArray alloc] init];
+        _cacheable = YES;
+        entries_ = malloc(MAX(selectors.count, 1) * sizeof(NSUInteger));
+
+        for (id<PXSelector> selector in selectors)
+        {
+            NSUInteger entry = instructionCount_;
+
+            entries_[entryCount_++] = entry;
+
+            if (![self compileSelector:selector])
+            {
+                // evaluate the selector object as a whole
+                instructionCount_ = entry;
+                _cacheable = NO;
+                [self emit:PXSelectorOpcodeSelector a:[self constantForObject:selector] b:PX_SELECTOR_PROGRAM_NONE c:PX_SELECTOR_PROGRAM_NONE];
+            }
+
+            [self emit:PXSelectorOpcodeMatch a:PX_SELECTOR_PROGRAM_NONE b:PX_SELECTOR_PROGRAM_NONE c:PX_SELECTOR_PROGRAM_NONE];
+
+            // every selector must match, so the ancestors must contain the keys of all of them
+            NSData *keys = [PXAncestorFilter ancestorKeysForSelector:selector];
+
+            if (keys)
+            {
+                [ancestorKeys appendData:keys];
+            }
+        }
+
+        ancestorKeys_ = (ancestorKeys.length > 0) ? [NSData dataWithData:ancestorKeys] : nil;
+
+        // flatten the constants so the interpreter can index them without messaging the array
+        constantPointers_ = (__unsafe_unretained id *) calloc(MAX(constants_.count, 1), sizeof(id));
+        [constants_ getObjects:constantPointers_ range:NSMakeRange(0, constants_.count)];
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSUInteger)instructionCount
+{
+    return instructionCount_;
+}
+
+#pragma mark - Compilation
+
+- (uint32_t)constantForObject:(id)object
+{
+    if (object == nil)
+    {
+        return PX_SELECTOR_PROGRAM_NONE;
+    }
+
+    NSUInteger index = [constants_ indexOfObject:object];
+
+    if (index == NSNotFound)
+    {
+        index = constants_.count;
+        [constants_ addObject:object];
+    }
+
+    return (uint32_t) index;
+}
+
+- (void)emit:(PXSelectorOpcode)opcode a:(uint32_t)a b:(uint32_t)b c:(uint32_t)c
+{
+    if (instructionCount_ == capacity_)
+    {
+        capacity_ = MAX(capacity_ * 2, 8);
+        instructions_ = realloc(instructions_, capacity_ * sizeof(PXSelectorInstruction));
+    }
+
+    instructions_[instructionCount_++] = (PXSelectorInstruction) { opcode, a, b, c };
+}
+
+- (BOOL)compileSelector:(id<PXSelector>)selector
+{
+    // PXStylesheetParser grows expressions down and to the left, so the right-hand side of every combinator is a type
+    // selector. Walking down the left-hand sides visits the compound selectors from right to left
+    id<PXSelector> current = selector;
+
+    while (current != nil)
+    {
+        Class currentClass = [current class];
+
+        if (currentClass == [PXTypeSelector class])
+        {
+            [self compileTypeSelector:(PXTypeSelector *) current];
+            current = nil;
+        }
+        else if (currentClass == [PXDescendantCombinator class] ||
+                 currentClass == [PXChildCombinator class] ||
+                 currentClass == [PXAdjacentSiblingCombinator class] ||
+                 currentClass == [PXSiblingCombinator class])
+        {
+            id<PXCombinator> combinator = (id<PXCombinator>) current;
+
+            if ([combinator.rhs class] != [PXTypeSelector class] || combinator.lhs == nil)
+            {
+                return NO;
+            }
+
+            [self compileTypeSelector:(PXTypeSelector *) combinator.rhs];
+
+            PXSelectorOpcode opcode;
+
+            if (currentClass == [PXDescendantCombinator class])
+            {
+                opcode = PXSelectorOpcodeDescendant;
+            }
+            else if (currentClass == [PXChildCombinator class])
+            {
+                opcode = PXSelectorOpcodeChild;
+            }
+            else if (currentClass == [PXAdjacentSiblingCombinator class])
+            {
+                opcode = PXSelectorOpcodeAdjacentSibling;
+            }
+            else
+            {
+                opcode = PXSelectorOpcodeSibling;
+            }
+
+            // the result depends on the position of the element among its siblings
+            if (opcode == PXSelectorOpcodeAdjacentSibling || opcode == PXSelectorOpcodeSibling)
+            {
+                _cacheable = NO;
+            }
+
+            [self emit:opcode a:PX_SELECTOR_PROGRAM_NONE b:PX_SELECTOR_PROGRAM_NONE c:PX_SELECTOR_PROGRAM_NONE];
+
+            current = combinator.lhs;
+        }
+        else
+        {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (void)compileTypeSelector:(PXTypeSelector *)selector
+{
+    uint32_t none = PX_SELECTOR_PROGRAM_NONE;
+    NSArray *expressions = selector.attributeExpressions;
+
+    // cheapest and most selective tests first. All tests are free of side effects, so their order does not matter
+    if (!selector.hasUniversalType)
+    {
+        [self emit:PXSelectorOpcodeElementName a:[PXAtomTable atomForString:selector.typeName] b:none c:none];
+    }
+
+    for (id<PXSelector> expression in expressions)
+    {
+        if ([expression class] == [PXIdSelector class])
+        {
+            [self emit:PXSelectorOpcodeStyleId a:[PXAtomTable atomForString:((PXIdSelector *) expression).idValue] b:none c:none];
+        }
+        else if ([expression class] == [PXClassSelector class])
+        {
+            NSString *className = ((PXClassSelector *) expression).className;
+
+            // names with whitespace can never match
+            if ([className rangeOfCharacterFromSet:[NSCharacterSet whitespaceCharacterSet]].location != NSNotFound)
+            {
+                [self emit:PXSelectorOpcodeFail a:none b:none c:none];
+            }
+            else
+            {
+                [self emit:PXSelectorOpcodeStyleClass a:[PXAtomTable atomForString:className] b:none c:none];
+            }
+        }
+    }
+
+    if (!selector.hasUniversalNamespace)
+    {
+        [self emit:PXSelectorOpcodeNamespace a:[self constantForObject:selector.namespaceURI] b:none c:none];
+    }
+
+    for (id<PXSelector> expression in expressions)
+    {
+        Class expressionClass = [expression class];
+
+        if (expressionClass == [PXIdSelector class] || expressionClass == [PXClassSelector class])
+        {
+            // already emitted
+        }
+        else if (expressionClass == [PXAttributeSelector class])
+        {
+            PXAttributeSelector *attribute = (PXAttributeSelector *) expression;
+
+            _cacheable = NO;
+
+            [self emit:PXSelectorOpcodeAttributeExists
+                     a:[self constantForObject:attribute.attributeName]
+                     b:[self constantForObject:attribute.namespaceURI]
+                     c:none];
+        }
+        else if (expressionClass == [PXAttributeSelectorOperator class])
+        {
+            PXAttributeSelectorOperator *operatorSelector = (PXAttributeSelectorOperator *) expression;
+            PXSelectorOpcode opcode;
+
+            _cacheable = NO;
+
+            switch (operatorSelector.operatorType)
+            {
+                case kAttributeSelectorOperatorStartsWith: opcode = PXSelectorOpcodeAttributeStartsWith; break;
+                case kAttributeSelectorOperatorEndsWith: opcode = PXSelectorOpcodeAttributeEndsWith; break;
+                case kAttributeSelectorOperatorContains: opcode = PXSelectorOpcodeAttributeContains; break;
+                case kAttributeSelectorOperatorEqual: opcode = PXSelectorOpcodeAttributeEqual; break;
+                case kAttributeSelectorOperatorListContains: opcode = PXSelectorOpcodeAttributeListContains; break;
+                case kAttributeSelectorOperatorEqualWithHyphen: opcode = PXSelectorOpcodeAttributeEqualWithHyphen; break;
+                default: opcode = PXSelectorOpcodeSelector; break;
+            }
+
+            if (opcode == PXSelectorOpcodeSelector)
+            {
+                [self emit:opcode a:[self constantForObject:expression] b:none c:none];
+            }
+            else
+            {
+                [self emit:opcode
+                         a:[self constantForObject:operatorSelector.attributeSelector.attributeName]
+                         b:[self constantForObject:operatorSelector.attributeSelector.namespaceURI]
+                         c:[self constantForObject:operatorSelector.value]];
+            }
+        }
+        else
+        {
+            // pseudo-classes and anything else are evaluated by the selector object. Plain pseudo-classes only depend on
+            // the element's class, but predicates, functions, and negations may look at anything
+            if (expressionClass != [PXPseudoClassSelector class])
+            {
+                _cacheable = NO;
+            }
+
+            [self emit:PXSelectorOpcodeSelector a:[self constantForObject:expression] b:none c:none];
+        }
+    }
+
+    if (selector.pseudoElement.length > 0)
+    {
+        [self emit:PXSelectorOpcodePseudoElement a:[self constantForObject:selector.pseudoElement] b:none c:none];
+    }
+}
+
+#pragma mark - Interpreter
+
+static BOOL PXSelectorAttributeMatches(PXSelectorOpcode opcode, NSString *value, NSString *operand)
+{
+    switch (opcode)
+    {
+        case PXSelectorOpcodeAttributeStartsWith:
+            return [value hasPrefix:operand];
+
+        case PXSelectorOpcodeAttributeEndsWith:
+            return [value hasSuffix:operand];
+
+        case PXSelectorOpcodeAttributeContains:
+            return (value && [value rangeOfString:operand].location != NSNotFound);
+
+        case PXSelectorOpcodeAttributeEqual:
+            return [operand isEqualToString:value];
+
+        case PXSelectorOpcodeAttributeListContains:
+            return [[value componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]] containsObject:operand];
+
+        case PXSelectorOpcodeAttributeEqualWithHyphen:
+            return [operand isEqualToString:value] || [value hasPrefix:[NSString stringWithFormat:@"%@-", operand]];
+
+        default:
+            return NO;
+    }
+}
+
+static BOOL PXSelectorProgramRun(const PXSelectorInstruction *instructions,
+                                 __unsafe_unretained id *constants,
+                                 NSUInteger pc,
+                                 id<PXStyleable> element)
+{
+    // the atoms of the current element, loaded by the first instruction that needs them
+    PXStyleableAtoms *atoms = nil;
+
+    while (YES)
+    {
+        const PXSelectorInstruction *instruction = &instructions[pc++];
+
+        switch (instruction->opcode)
+        {
+            case PXSelectorOpcodeMatch:
+                return YES;
+
+            case PXSelectorOpcodeFail:
+                return NO;
+
+            case PXSelectorOpcodeElementName:
+            {
+                if (atoms == nil) atoms = [PXStyleableAtoms atomsForStyleable:element];
+
+                if (instruction->a == PXAtomNone || instruction->a != atoms.elementName)
+                {
+                    return NO;
+                }
+                break;
+            }
+
+            case PXSelectorOpcodeNamespace:
+            {
+                if (![element respondsToSelector:@selector(pxStyleNamespace)])
+                {
+                    return NO;
+                }
+
+                NSString *elementNamespace = element.pxStyleNamespace;
+
+                if (instruction->a == PX_SELECTOR_PROGRAM_NONE)
+                {
+                    // there should be no namespace on the element
+                    if (elementNamespace.length > 0)
+                    {
+                        return NO;
+                    }
+                }
+                else if (![constants[instruction->a] isEqualToString:elementNamespace])
+                {
+                    return NO;
+                }
+                break;
+            }
+
+            case PXSelectorOpcodeStyleId:
+            {
+                if (atoms == nil) atoms = [PXStyleableAtoms atomsForStyleable:element];
+
+                if (instruction->a == PXAtomNone || instruction->a != atoms.styleId)
+                {
+                    return NO;
+                }
+                break;
+            }
+
+            case PXSelectorOpcodeStyleClass:
+            {
+                if (atoms == nil) atoms = [PXStyleableAtoms atomsForStyleable:element];
+
+                if (![atoms containsStyleClass:instruction->a])
+                {
+                    return NO;
+                }
+                break;
+            }
+
+            case PXSelectorOpcodeAttributeExists:
+            case PXSelectorOpcodeAttributeStartsWith:
+            case PXSelectorOpcodeAttributeEndsWith:
+            case PXSelectorOpcodeAttributeContains:
+            case PXSelectorOpcodeAttributeEqual:
+            case PXSelectorOpcodeAttributeListContains:
+            case PXSelectorOpcodeAttributeEqualWithHyphen:
+            {
+                if (![element respondsToSelector:@selector(attributeValueForName:withNamespace:)])
+                {
+                    return NO;
+                }
+
+                NSString *name = PX_SELECTOR_CONSTANT(instruction->a);
+                NSString *namespaceURI = PX_SELECTOR_CONSTANT(instruction->b);
+                NSString *value = [element attributeValueForName:name withNamespace:namespaceURI];
+
+                if (instruction->opcode == PXSelectorOpcodeAttributeExists)
+                {
+                    if (value.length == 0)
+                    {
+                        return NO;
+                    }
+                }
+                else if (!PXSelectorAttributeMatches(instruction->opcode, value, PX_SELECTOR_CONSTANT(instruction->c)))
+                {
+                    return NO;
+                }
+                break;
+            }
+
+            case PXSelectorOpcodePseudoElement:
+            {
+                if (![element respondsToSelector:@selector(supportedPseudoElements)] ||
+                    [[element supportedPseudoElements] indexOfObject:constants[instruction->a]] == NSNotFound)
+                {
+                    return NO;
+                }
+                break;
+            }
+
+            case PXSelectorOpcodeSelector:
+            {
+                if (![(id<PXSelector>) constants[instruction->a] matches:element])
+                {
+                    return NO;
+                }
+                break;
+            }
+
+            case PXSelectorOpcodeChild:
+            {
+                id parent = element.pxStyleParent;
+
+                if (![parent conformsToProtocol:@protocol(PXStyleable)])
+                {
+                    return NO;
+                }
+
+                element = parent;
+                atoms = nil;
+                break;
+            }
+
+            case PXSelectorOpcodeDescendant:
+            {
+                // try the rest of the program against each ancestor
+                for (id parent = element.pxStyleParent; parent != nil; parent = ((id<PXStyleable>) parent).pxStyleParent)
+                {
+                    if (PXSelectorProgramRun(instructions, constants, pc, parent))
+                    {
+                        return YES;
+                    }
+                }
+
+                return NO;
+            }
+
+            case PXSelectorOpcodeAdjacentSibling:
+            case PXSelectorOpcodeSibling:
+            {
+                id parent = element.pxStyleParent;
+
+                if (![parent conformsToProtocol:@protocol(PXStyleable)])
+                {
+                    return NO;
+                }
+
+                NSArray *children = [PXStyleUtils elementChildrenOfStyleable:parent];
+                NSUInteger elementIndex = [children indexOfObject:element];
+
+                if (elementIndex == NSNotFound || elementIndex == 0)
+                {
+                    return NO;
+                }
+
+                if (instruction->opcode == PXSelectorOpcodeAdjacentSibling)
+                {
+                    id previousSibling = [children objectAtIndex:elementIndex - 1];
+
+                    if (![previousSibling conformsToProtocol:@protocol(PXStyleable)])
+                    {
+                        return NO;
+                    }
+
+                    element = previousSibling;
+                    atoms = nil;
+                    break;
+                }
+
+                // try the rest of the program against each previous sibling, in document order
+                for (NSUInteger i = 0; i < elementIndex; i++)
+                {
+                    id previousSibling = [children objectAtIndex:i];
+
+                    if ([previousSibling conformsToProtocol:@protocol(PXStyleable)] &&
+                        PXSelectorProgramRun(instructions, constants, pc, previousSibling))
+                    {
+                        return YES;
+                    }
+                }
+
+                return NO;
+            }
+        }
+    }
+}
+
+#pragma mark - Methods
+
+- (BOOL)matches:(id<PXStyleable>)element
+{
+    if (element == nil || entryCount_ == 0)
+    {
+        return NO;
+    }
+
+    // reject without running the program when a required ancestor is definitely missing
+    if (ancestorKeys_ != nil)
+    {
+        PXAncestorFilter *filter = [PXAncestorFilter activeFilterForStyleable:element];
+
+        if (filter != nil && ![filter mightContainKeys:ancestorKeys_])
+        {
+            return NO;
+        }
+    }
+
+    for (NSUInteger i = 0; i < entryCount_; i++)
+    {
+        if (!PXSelectorProgramRun(instructions_, constantPointers_, entries_[i], element))
+        {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark - Overrides
+
+- (void)dealloc
+{
+    free(instructions_);
+    free(constantPointers_);
+    free(entries_);
+}
+
+- (NSString *)description
+{
+    NSMutableArray *lines = [NSMutableArray arrayWithCapacity:instructionCount_];
+
+    for (NSUInteger i = 0; i < instructionCount_; i++)
+    {
+        PXSelectorInstruction instruction = instructions_[i];
+        NSMutableArray *parts = [NSMutableArray arrayWithObject:[OPCODE_NAMES objectAtIndex:instruction.opcode]];
+
+        if (instruction.opcode == PXSelectorOpcodeElementName ||
+            instruction.opcode == PXSelectorOpcodeStyleId ||
+            instruction.opcode == PXSelectorOpcodeStyleClass)
+        {
+            [parts addObject:[NSString stringWithFormat:@"%@", [PXAtomTable stringForAtom:instruction.a]]];
+        }
+        else
+        {
+            for (NSNumber *operand in @[ @(instruction.a), @(instruction.b), @(instruction.c) ])
+            {
+                uint32_t index = operand.unsignedIntValue;
+
+                if (index != PX_SELECTOR_PROGRAM_NONE)
+                {
+                    [parts addObject:[NSString stringWithFormat:@"%@", [constants_ objectAtIndex:index]]];
+                }
+            }
+        }
+
+        [lines addObject:[NSString stringWithFormat:@"%3lu: %@", (unsigned long) i, [parts componentsJoinedByString:@" "]]];
+    }
+
+    return [lines componentsJoinedByString:@"\n"];
+}
+
+@end
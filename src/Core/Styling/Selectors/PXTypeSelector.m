@@ -27,10 +27,12 @@
 #import "PXStyleUtils.h"
 #import "PXIdSelector.h"
 #import "PXClassSelector.h"
+#import "PXStyleableAtoms.h"
 
 @implementation PXTypeSelector
 {
     NSMutableArray *attributeExpressions;
+    PXAtom typeNameAtom_;
 }
 
 #ifdef PX_LOGGING
@@ -65,6 +67,7 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     {
         _namespaceURI = uri;
         _typeName = type;
+        typeNameAtom_ = [PXAtomTable atomForString:type];
     }
 
     return self;
@@ -208,7 +211,7 @@ static int ddLogLevel = LOG_LEVEL_WARN;
     {
         if (self.hasUniversalType == NO)
         {
-            result = ([_typeName isEqualToString:element.pxStyleElementName]);
+            result = (typeNameAtom_ != PXAtomNone && typeNameAtom_ == [PXStyleableAtoms atomsForStyleable:element].elementName);
         }
     }
 
@@ -639,6 +639,12 @@
     return @[@(width), @(spacing)];
 }
 
+- (CGRect)localBoundingBox
+{
+    // borders and background images are rendered outside of our path, so leave boxes to the clip
+    return CGRectInfinite;
+}
+
 - (void)renderChildren:(CGContextRef)context
 {
     [borderPathTop_ render:context];
@@ -23,7 +23,7 @@
 //
 
 #import "PXBarShadowStyler.h"
-#import "PXShapeView.h"
+#import "PXSVGLoader.h"
 #import "PXRectangle.h"
 #import "PXStroke.h"
 #import "PXSolidPaint.h"
@@ -77,10 +77,9 @@
                 size = bounds.size;
             }
 
-            PXShapeView *shapeView = [[PXShapeView alloc] initWithFrame:bounds];
+            PXShapeDocument *document = [PXSVGLoader sharedDocumentForURL:context.shadowUrl];
 
-            [shapeView loadSceneFromURL:context.shadowUrl];
-            context.shadowImage = [shapeView renderToImage];
+            context.shadowImage = [document renderToImageWithSize:bounds.size withOpacity:NO];
         }
         else
         {
@@ -65,6 +65,7 @@
 @property (nonatomic) CGFloat opacity;
 
 @property (nonatomic, readonly, strong) UIImage *backgroundImage;
+@property (nonatomic, readonly, getter=isOpaque) BOOL opaque;
 @property (nonatomic) CGSize imageSize;
 @property (nonatomic) UIEdgeInsets insets;
 
@@ -37,14 +37,90 @@
 #import "PixateFreestyle.h"
 #import "PXCacheManager.h"
 #import "PXDeclaration.h"
+#import "PXImageRasterizer.h"
+#import "PXImageCacheKey.h"
+#import "PXDiskImageCache.h"
+#import "PXStyleScheduler.h"
+#import "PXStyleUtils.h"
 #import <CoreText/CoreText.h>
 
 static NSString *DEFAULT_FONT_NAME = @"DEFAULT";
 static NSString *DEFAULT_FONT = @"Helvetica";
 
+static BOOL PXPaintRendersOffMainThread(id<PXPaint> paint)
+{
+    // SVG image paints render through a PXShapeView, which is a UIView
+    if ([paint isKindOfClass:[PXImagePaint class]])
+    {
+        return ((PXImagePaint *) paint).hasSVGImageURL == NO;
+    }
+    else if ([paint isKindOfClass:[PXPaintGroup class]])
+    {
+        for (id<PXPaint> child in ((PXPaintGroup *) paint).paints)
+        {
+            if (!PXPaintRendersOffMainThread(child))
+            {
+                return NO;
+            }
+        }
+    }
+
+    return YES;
+}
+
+static UIImage *PXStylerContextRenderBackground(PXShape *shape, CGRect bounds, BOOL isOpaque, PXOffsets *padding, UIEdgeInsets insets)
+{
+    UIImage *result = nil;
+
+    if (padding == nil)
+    {
+        result = [shape renderToImageWithBounds:bounds withOpacity:isOpaque];
+    }
+    else if (bounds.size.width > 0 && bounds.size.height > 0)
+    {
+        CGFloat x = bounds.origin.x + padding.left;
+        CGFloat y = bounds.origin.y + padding.top;
+        CGFloat width = bounds.size.width - padding.left - padding.right;
+        CGFloat height = bounds.size.height - padding.top - padding.bottom;
+
+        // draw the shape straight into the padded rectangle, instead of rendering it and then redrawing that image
+        UIGraphicsBeginImageContextWithOptions(bounds.size, isOpaque, 0.0);
+        CGContextRef context = UIGraphicsGetCurrentContext();
+
+        CGContextTranslateCTM(context, x, y);
+        CGContextScaleCTM(context, width / bounds.size.width, height / bounds.size.height);
+        CGContextTranslateCTM(context, -bounds.origin.x, -bounds.origin.y);
+
+        [shape render:context];
+
+        result = UIGraphicsGetImageFromCurrentImageContext();
+        UIGraphicsEndImageContext();
+    }
+
+    // apply insets, if we have any
+    if (result != nil && !UIEdgeInsetsEqualToEdgeInsets(insets, UIEdgeInsetsZero))
+    {
+        result = [result resizableImageWithCapInsets:insets];
+    }
+
+    return result;
+}
+
+static UIImage *PXStylerContextStretchImage(UIImage *source, CGSize size, BOOL isOpaque, UIEdgeInsets insets)
+{
+    // blitting the 9-slice source is much cheaper than rendering the background at this size
+    UIGraphicsBeginImageContextWithOptions(size, isOpaque, 0.0);
+    [source drawInRect:CGRectMake(0.0f, 0.0f, size.width, size.height)];
+    UIImage *result = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+
+    return [result resizableImageWithCapInsets:insets];
+}
+
 @implementation PXStylerContext
 {
     NSMutableDictionary *properties_;
+    UIImage *placeholderImage_;
 }
 
 #pragma mark - Initializers
@@ -140,113 +216,216 @@ static NSString *DEFAULT_FONT = @"Helvetica";
 
 - (UIImage *)backgroundImage
 {
-    NSNumber *hashKey = [NSNumber numberWithUnsignedInteger:self.styleHash];
-    UIImage *result = [PXCacheManager imageForKey:hashKey];
+    [self prepareBackgroundBounds];
+
+    // identical backgrounds share one image, no matter which styleable or state asked for it
+    PXImageCacheKey *key = [[PXImageCacheKey alloc] initWithStylerContext:self];
+    UIImage *result = [PXCacheManager imageForKey:key];
 
     if (result == nil)
     {
-        // update bounds
-        if (CGSizeEqualToSize(_imageSize, CGSizeZero) == NO)
-        {
-            _bounds = CGRectMake(0.0f, 0.0f, _imageSize.width, _imageSize.height);
-        }
-        else if (CGRectEqualToRect(_bounds, CGRectZero))
-        {
-            _bounds = self.styleable.bounds;
+        // an asynchronous render for this key may have finished since the styleable was last styled
+        result = [[PXImageRasterizer sharedInstance] finishedImageForKey:key];
+    }
 
-            if (CGSizeEqualToSize(_bounds.size, CGSizeZero) == YES)
-            {
-                // Set default size to 32,32 if its zero
-                _bounds = CGRectMake(0.0f, 0.0f, 32.0f, 32.0f);
-            }
-        }
+    if (result == nil && placeholderImage_ != nil)
+    {
+        // the shape now belongs to the render already scheduled by this context, so it must not be prepared again
+        result = placeholderImage_;
+    }
+    else if (result == nil)
+    {
+        [self prepareBackgroundShapeWithBounds:key.renderBounds];
 
-        // apply bounds
-        // NOTE: this updates the bounds of the underlying geometry used to draw the background image. This does not resize
-        // the styleable.
-        if ([_shape conformsToProtocol:@protocol(PXBoundable)])
-        {
-            id<PXBoundable> boundable = (id<PXBoundable>)_shape;
+        // capture everything the render needs, so it does not depend on this context once scheduled
+        PXShape *shape = _shape;
+        CGRect bounds = key.renderBounds;
+        BOOL isOpaque = [self isOpaque];
+        PXOffsets *padding = (_padding.hasOffset) ? _padding : nil;
+        UIEdgeInsets insets = _insets;
+        BOOL cacheImages = PixateFreestyle.configuration.cacheImages;
 
-            boundable.bounds = _bounds;
-        }
+        // a bitmap persisted by an earlier launch is mapped instead of rendered. The name is nil when the disk tier
+        // is disabled or the background cannot be persisted
+        PXDiskImageCache *diskCache = [PXDiskImageCache sharedInstance];
+        NSString *fileName = [diskCache fileNameForKey:key];
 
-        // apply fill
-        _shape.fill = [self getCombinedPaints];
+        // 9-slice sources are tiny, so they are not worth a placeholder and a second styling pass
+        BOOL async = !key.stretchable && [self rendersBackgroundAsynchronously];
 
-        // apply stroke, and possible modify geometry bounds
-        if (_boxModel.hasBorder)
-        {
-            // NOTE: we're using top border since we set all borders the same right now
-            CGFloat strokeWidth = _boxModel.borderTopWidth;
-            id<PXPaint>strokeColor = _boxModel.borderTopPaint;
-            PXStroke *stroke = [[PXStroke alloc] initWithStrokeWidth:strokeWidth];
+        // an asynchronous render may land after its styleable is gone, so it is only kept until it is first used
+        PXCachePriority priority = (async) ? PXCachePrioritySpeculative : PXCachePriorityNormal;
 
-            if (strokeColor)
-            {
-                stroke.color = strokeColor;
-            }
+        UIImage *(^render)(void) = ^UIImage *{
+            UIImage *image = [diskCache imageWithFileName:fileName];
 
-            self.shape.stroke = stroke;
+            if (image == nil)
+            {
+                image = PXStylerContextRenderBackground(shape, bounds, isOpaque, padding, insets);
 
-            // shrink bounds by half of the stroke width
-            if ([_shape conformsToProtocol:@protocol(PXBoundable)])
+                [diskCache setImage:image withFileName:fileName];
+            }
+            else if (!UIEdgeInsetsEqualToEdgeInsets(insets, UIEdgeInsetsZero))
             {
-                id<PXBoundable> boundable = (id<PXBoundable>)_shape;
+                image = [image resizableImageWithCapInsets:insets];
+            }
 
-                boundable.bounds = CGRectInset(boundable.bounds, 0.5f * strokeWidth, 0.5f * strokeWidth);
+            if (image != nil && cacheImages)
+            {
+                [PXCacheManager setImage:image forKey:key cost:[PXCacheManager costForImage:image] priority:priority];
             }
-        }
 
-        // set corner radius
-        if ([self.shape isKindOfClass:[PXRectangle class]])
+            return image;
+        };
+
+        if (async)
         {
-            PXRectangle *rect = (PXRectangle *)self.shape;
+            __weak id<PXStyleable> styleable = self.styleable;
+
+            [[PXImageRasterizer sharedInstance] rasterizeImageForKey:key usingBlock:render completion:^(UIImage *image) {
+                id<PXStyleable> strongStyleable = styleable;
+
+                // restyle so the styler picks up the finished image. The style hash is unchanged, so the redundant
+                // styling check has to be cleared first
+                if (image != nil && strongStyleable != nil)
+                {
+                    [PXStyleUtils invalidateStyleable:strongStyleable];
+                    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:strongStyleable recursively:NO];
+                }
+            }];
 
-            rect.radiusTopLeft = _boxModel.radiusTopLeft;
-            rect.radiusTopRight = _boxModel.radiusTopRight;
-            rect.radiusBottomRight = _boxModel.radiusBottomRight;
-            rect.radiusBottomLeft = _boxModel.radiusBottomLeft;
+            result = placeholderImage_ = [self placeholderImage];
+        }
+        else
+        {
+            result = render();
         }
+    }
 
-        // apply inner shadows
-        if (_innerShadow.shadows.count > 0)
+    if (result != nil && result != placeholderImage_ && key.stretchable)
+    {
+        // pattern colors and layer contents ignore cap insets, so styleables need the stretched bitmap. It is cached
+        // per size, so the source is only redrawn once for each
+        PXImageCacheKey *stretchedKey = [key keyForStretchedSize:_bounds.size];
+        UIImage *stretched = [PXCacheManager imageForKey:stretchedKey];
+
+        if (stretched == nil)
         {
-            _shape.shadow = _innerShadow;
+            stretched = PXStylerContextStretchImage(result, _bounds.size, [self isOpaque], _insets);
+
+            if (stretched != nil && PixateFreestyle.configuration.cacheImages)
+            {
+                [PXCacheManager setImage:stretched
+                                  forKey:stretchedKey
+                                    cost:[PXCacheManager costForImage:stretched]
+                                priority:PXCachePriorityNormal];
+            }
         }
 
-        // generate image
-        BOOL isOpaque = [self isOpaque];
-        result = [_shape renderToImageWithBounds:_bounds withOpacity:isOpaque];
+        result = stretched;
+    }
+
+    return result;
+}
 
-        if (_padding.hasOffset)
+- (void)prepareBackgroundBounds
+{
+    if (CGSizeEqualToSize(_imageSize, CGSizeZero) == NO)
+    {
+        _bounds = CGRectMake(0.0f, 0.0f, _imageSize.width, _imageSize.height);
+    }
+    else if (CGRectEqualToRect(_bounds, CGRectZero))
+    {
+        _bounds = self.styleable.bounds;
+
+        if (CGSizeEqualToSize(_bounds.size, CGSizeZero) == YES)
         {
-            CGFloat x = _bounds.origin.x + _padding.left;
-            CGFloat y = _bounds.origin.y + _padding.top;
-            CGFloat width = _bounds.size.width - _padding.left - _padding.right;
-            CGFloat height = _bounds.size.height - _padding.top - _padding.bottom;
-
-            UIGraphicsBeginImageContextWithOptions(_bounds.size, isOpaque, 0.0);
-            [result drawInRect:CGRectMake(x, y, width, height)];
-            result = UIGraphicsGetImageFromCurrentImageContext();
-            UIGraphicsEndImageContext();
+            // Set default size to 32,32 if its zero
+            _bounds = CGRectMake(0.0f, 0.0f, 32.0f, 32.0f);
         }
+    }
+}
+
+- (void)prepareBackgroundShapeWithBounds:(CGRect)bounds
+{
+    // apply bounds
+    // NOTE: this updates the bounds of the underlying geometry used to draw the background image. This does not resize
+    // the styleable.
+    if ([_shape conformsToProtocol:@protocol(PXBoundable)])
+    {
+        id<PXBoundable> boundable = (id<PXBoundable>)_shape;
+
+        boundable.bounds = bounds;
+    }
+
+    // apply fill
+    _shape.fill = [self getCombinedPaints];
 
-        // apply insets, if we have any
-        if (!UIEdgeInsetsEqualToEdgeInsets(_insets, UIEdgeInsetsZero))
+    // apply stroke, and possible modify geometry bounds
+    if (_boxModel.hasBorder)
+    {
+        // NOTE: we're using top border since we set all borders the same right now
+        CGFloat strokeWidth = _boxModel.borderTopWidth;
+        id<PXPaint>strokeColor = _boxModel.borderTopPaint;
+        PXStroke *stroke = [[PXStroke alloc] initWithStrokeWidth:strokeWidth];
+
+        if (strokeColor)
         {
-            result = [result resizableImageWithCapInsets:_insets];
+            stroke.color = strokeColor;
         }
 
-        if (PixateFreestyle.configuration.cacheImages)
+        self.shape.stroke = stroke;
+
+        // shrink bounds by half of the stroke width
+        if ([_shape conformsToProtocol:@protocol(PXBoundable)])
         {
-            // estimate cost as number of pixels times 4 bytes per pixel. This is probably lower than actual
-            NSUInteger cost = result.size.width * result.size.height * 4;
+            id<PXBoundable> boundable = (id<PXBoundable>)_shape;
 
-            [PXCacheManager setImage:result forKey:hashKey cost:cost];
+            boundable.bounds = CGRectInset(boundable.bounds, 0.5f * strokeWidth, 0.5f * strokeWidth);
         }
     }
 
+    // set corner radius
+    if ([self.shape isKindOfClass:[PXRectangle class]])
+    {
+        PXRectangle *rect = (PXRectangle *)self.shape;
+
+        rect.radiusTopLeft = _boxModel.radiusTopLeft;
+        rect.radiusTopRight = _boxModel.radiusTopRight;
+        rect.radiusBottomRight = _boxModel.radiusBottomRight;
+        rect.radiusBottomLeft = _boxModel.radiusBottomLeft;
+    }
+
+    // apply inner shadows
+    if (_innerShadow.shadows.count > 0)
+    {
+        _shape.shadow = _innerShadow;
+    }
+}
+
+- (BOOL)rendersBackgroundAsynchronously
+{
+    // contexts without a style hash are not created by a styling pass, so restyling would not pick up the finished image
+    return
+        PixateFreestyle.configuration.asyncImageRendering
+    &&  [NSThread isMainThread]
+    &&  self.styleHash != 0
+    &&  self.styleable != nil
+    &&  PXPaintRendersOffMainThread(_shape.fill)
+    &&  PXPaintRendersOffMainThread(_boxModel.borderTopPaint);
+}
+
+- (UIImage *)placeholderImage
+{
+    // a tile of the solid fill, if there is one, keeps the styleable's color while its image is being rendered
+    UIColor *color = ([_fill isKindOfClass:[PXSolidPaint class]]) ? ((PXSolidPaint *) _fill).color : [UIColor clearColor];
+
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(1.0f, 1.0f), NO, 1.0f);
+    [color setFill];
+    UIRectFill(CGRectMake(0.0f, 0.0f, 1.0f, 1.0f));
+    UIImage *result = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+
     return result;
 }
 
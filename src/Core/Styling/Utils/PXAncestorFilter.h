@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXAncestorFilter.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStyleable.h"
+#import "PXSelector.h"
+
+/**
+ *  A PXAncestorFilter is a Bloom filter of the element names, ids, and classes of all ancestors of a styleable. A Bloom
+ *  filter may report keys that were never added, but never misses a key that was, so a combinator whose left-hand side
+ *  requires a key the filter does not contain cannot match, and can be rejected without walking the styleable's
+ *  parents.
+ *
+ *  All children of a styleable share the same ancestors, so PXStyleUtils builds one filter per parent as it walks the
+ *  styleable tree and makes it active while each child is visited.
+ */
+@interface PXAncestorFilter : NSObject
+
+/**
+ *  The styleable whose children this filter describes. This value may be nil for styleables without a parent
+ */
+@property (nonatomic, readonly, strong) id parent;
+
+/**
+ *  Initialize a new instance by walking the ancestors of the specified styleable
+ *
+ *  @param styleable The styleable whose ancestors are to be added to the filter
+ */
+- (id)initWithAncestorsOfStyleable:(id<PXStyleable>)styleable;
+
+/**
+ *  Initialize a new instance for the children of the specified parent. The parent filter must be the filter for the
+ *  parent itself.
+ *
+ *  @param filter The filter for the parent styleable
+ *  @param parent The styleable whose children this filter describes
+ */
+- (id)initWithParentFilter:(PXAncestorFilter *)filter parent:(id<PXStyleable>)parent;
+
+/**
+ *  Determine if all of the specified keys may have been added to this filter. A result of NO means at least one key is
+ *  definitely absent.
+ *
+ *  @param keys Keys as returned by ancestorKeysForSelector:
+ */
+- (BOOL)mightContainKeys:(NSData *)keys;
+
+/**
+ *  Return the keys an element's ancestors must contain for the specified selector to match that element. This returns
+ *  nil when the selector does not constrain ancestors by element name, id, or class.
+ *
+ *  @param selector The selector to inspect
+ */
++ (NSData *)ancestorKeysForSelector:(id<PXSelector>)selector;
+
+/**
+ *  Return the filter for the ancestors of the specified styleable, if that styleable is the one currently being visited
+ *  on this thread. This returns nil otherwise.
+ *
+ *  @param styleable The styleable being matched
+ */
++ (PXAncestorFilter *)activeFilterForStyleable:(id<PXStyleable>)styleable;
+
+/**
+ *  Make the specified filter active for the styleable while the block runs on the current thread. Visits may be nested.
+ *
+ *  @param styleable The styleable being visited
+ *  @param filter The filter for the ancestors of the styleable
+ *  @param block The block to run
+ */
++ (void)visitStyleable:(id<PXStyleable>)styleable withFilter:(PXAncestorFilter *)filter usingBlock:(void (^)(void))block;
+
+@end
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+//  PXAncestorFilter.m
+//  Pixate
+//
+
+#import "PXAncestorFilter.h"
+#import "PXCombinator.h"
+#import "PXDescendantCombinator.h"
+#import "PXChildCombinator.h"
+#import "PXTypeSelector.h"
+
+// 512 bits is enough to keep false positives low for the depth of typical view hierarchies while keeping the per-parent
+// copy small
+#define PX_ANCESTOR_FILTER_WORDS 8
+#define PX_ANCESTOR_FILTER_MASK (PX_ANCESTOR_FILTER_WORDS * 64 - 1)
+
+// salts keep an element name, an id, and a class with the same spelling from sharing a key
+static const uint32_t ELEMENT_NAME_SALT = 0x9E3779B9;
+static const uint32_t STYLE_ID_SALT = 0x85EBCA6B;
+static const uint32_t STYLE_CLASS_SALT = 0xC2B2AE35;
+
+// the styleable being visited on this thread and the filter for its ancestors. These are only compared against and
+// never messaged, and visitStyleable:withFilter:usingBlock: keeps both alive while they are set
+static __thread __unsafe_unretained id ACTIVE_STYLEABLE;
+static __thread __unsafe_unretained PXAncestorFilter *ACTIVE_FILTER;
+
+static inline uint32_t PXAncestorFilterKey(NSString *string, uint32_t salt)
+{
+    // 64-bit finalizer from MurmurHash3, so similar strings spread across the filter
+    uint64_t h = (uint64_t) string.hash ^ salt;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return (uint32_t) h;
+}
+
+@implementation PXAncestorFilter
+{
+    uint64_t bits_[PX_ANCESTOR_FILTER_WORDS];
+}
+
+#pragma mark - Initializers
+
+- (id)initWithAncestorsOfStyleable:(id<PXStyleable>)styleable
+{
+    if (self = [super init])
+    {
+        _parent = styleable.pxStyleParent;
+
+        id ancestor = _parent;
+
+        while (ancestor != nil)
+        {
+            [self addStyleable:ancestor];
+
+            ancestor = ((id<PXStyleable>) ancestor).pxStyleParent;
+        }
+    }
+
+    return self;
+}
+
+- (id)initWithParentFilter:(PXAncestorFilter *)filter parent:(id<PXStyleable>)parent
+{
+    if (self = [super init])
+    {
+        _parent = parent;
+
+        if (filter != nil)
+        {
+            memcpy(bits_, filter->bits_, sizeof(bits_));
+        }
+
+        [self addStyleable:parent];
+    }
+
+    return self;
+}
+
+#pragma mark - Methods
+
+- (void)addKey:(uint32_t)key
+{
+    // each key sets two bits, taken from different halves of the key
+    uint32_t first = key & PX_ANCESTOR_FILTER_MASK;
+    uint32_t second = (key >> 16) & PX_ANCESTOR_FILTER_MASK;
+
+    bits_[first >> 6] |= (1ULL << (first & 63));
+    bits_[second >> 6] |= (1ULL << (second & 63));
+}
+
+- (void)addStyleable:(id)styleable
+{
+    // descendant and child combinators never match non-styleables, so there is nothing to add for them
+    if ([styleable conformsToProtocol:@protocol(PXStyleable)])
+    {
+        id<PXStyleable> element = styleable;
+        NSString *elementName = element.pxStyleElementName;
+        NSString *styleId = element.styleId;
+
+        if (elementName.length > 0)
+        {
+            [self addKey:PXAncestorFilterKey(elementName, ELEMENT_NAME_SALT)];
+        }
+
+        if (styleId.length > 0)
+        {
+            [self addKey:PXAncestorFilterKey(styleId, STYLE_ID_SALT)];
+        }
+
+        if ([element respondsToSelector:@selector(styleClasses)])
+        {
+            for (NSString *styleClass in element.styleClasses)
+            {
+                [self addKey:PXAncestorFilterKey(styleClass, STYLE_CLASS_SALT)];
+            }
+        }
+    }
+}
+
+- (BOOL)mightContainKeys:(NSData *)keys
+{
+    const uint32_t *values = keys.bytes;
+    NSUInteger count = keys.length / sizeof(uint32_t);
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        uint32_t first = values[i] & PX_ANCESTOR_FILTER_MASK;
+        uint32_t second = (values[i] >> 16) & PX_ANCESTOR_FILTER_MASK;
+
+        if ((bits_[first >> 6] & (1ULL << (first & 63))) == 0 || (bits_[second >> 6] & (1ULL << (second & 63))) == 0)
+        {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark - Selector Keys
+
++ (void)addSubjectKeysOfSelector:(id<PXSelector>)selector toKeys:(NSMutableData *)keys
+{
+    if ([selector conformsToProtocol:@protocol(PXCombinator)])
+    {
+        // a combinator matches the element its right-hand side matches
+        [self addSubjectKeysOfSelector:((id<PXCombinator>) selector).rhs toKeys:keys];
+    }
+    else if ([selector isKindOfClass:[PXTypeSelector class]])
+    {
+        PXTypeSelector *typeSelector = (PXTypeSelector *) selector;
+        uint32_t key;
+
+        if (!typeSelector.hasUniversalType && typeSelector.typeName.length > 0)
+        {
+            key = PXAncestorFilterKey(typeSelector.typeName, ELEMENT_NAME_SALT);
+            [keys appendBytes:&key length:sizeof(key)];
+        }
+
+        if (typeSelector.styleId.length > 0)
+        {
+            key = PXAncestorFilterKey(typeSelector.styleId, STYLE_ID_SALT);
+            [keys appendBytes:&key length:sizeof(key)];
+        }
+
+        for (NSString *styleClass in typeSelector.styleClasses)
+        {
+            key = PXAncestorFilterKey(styleClass, STYLE_CLASS_SALT);
+            [keys appendBytes:&key length:sizeof(key)];
+        }
+    }
+}
+
++ (void)addAncestorKeysOfSelector:(id<PXSelector>)selector toKeys:(NSMutableData *)keys
+{
+    if ([selector conformsToProtocol:@protocol(PXCombinator)])
+    {
+        id<PXCombinator> combinator = (id<PXCombinator>) selector;
+
+        // the left-hand side of a descendant or child combinator matches an ancestor
+        if ([combinator isKindOfClass:[PXDescendantCombinator class]] || [combinator isKindOfClass:[PXChildCombinator class]])
+        {
+            [self addSubjectKeysOfSelector:combinator.lhs toKeys:keys];
+        }
+
+        // the left-hand side of a sibling combinator matches an element with the same ancestors, so in either case the
+        // ancestors required by each side are ancestors of the element being matched
+        [self addAncestorKeysOfSelector:combinator.lhs toKeys:keys];
+        [self addAncestorKeysOfSelector:combinator.rhs toKeys:keys];
+    }
+}
+
++ (NSData *)ancestorKeysForSelector:(id<PXSelector>)selector
+{
+    NSMutableData *keys = [NSMutableData data];
+
+    [self addAncestorKeysOfSelector:selector toKeys:keys];
+
+    return (keys.length > 0) ? [NSData dataWithData:keys] : nil;
+}
+
+#pragma mark - Active Filter
+
++ (PXAncestorFilter *)activeFilterForStyleable:(id<PXStyleable>)styleable
+{
+    return (styleable != nil && styleable == ACTIVE_STYLEABLE) ? ACTIVE_FILTER : nil;
+}
+
++ (void)visitStyleable:(id<PXStyleable>)styleable withFilter:(PXAncestorFilter *)filter usingBlock:(void (^)(void))block
+{
+    __unsafe_unretained id previousStyleable = ACTIVE_STYLEABLE;
+    __unsafe_unretained PXAncestorFilter *previousFilter = ACTIVE_FILTER;
+
+    ACTIVE_STYLEABLE = styleable;
+    ACTIVE_FILTER = filter;
+
+    @try
+    {
+        block();
+    }
+    @finally
+    {
+        ACTIVE_STYLEABLE = previousStyleable;
+        ACTIVE_FILTER = previousFilter;
+    }
+}
+
+@end
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXAtomDictionary.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXAtomTable.h"
+
+/**
+ *  A PXAtomDictionary is an immutable, atom-indexed copy of a dictionary with string keys. Lookups by atom are a bounds
+ *  check and an array load, which makes this suitable for tables like the property name to styler maps that are
+ *  consulted for every declaration during styling.
+ */
+@interface PXAtomDictionary : NSObject
+
+/**
+ *  Return the atom dictionary for the specified dictionary, creating it on first use. The result is kept with the
+ *  dictionary, so this should only be used with dictionaries that are never mutated, such as per-class tables
+ *
+ *  @param dictionary A dictionary with string keys
+ */
++ (PXAtomDictionary *)atomDictionaryForDictionary:(NSDictionary *)dictionary;
+
+/**
+ *  Initialize a new instance with the contents of the specified dictionary. Keys that are not strings are ignored
+ *
+ *  @param dictionary A dictionary with string keys
+ */
+- (id)initWithDictionary:(NSDictionary *)dictionary;
+
+/**
+ *  Return the object for the specified atom, or nil if the atom is not a key of this dictionary
+ *
+ *  @param atom The atom of the key
+ */
+- (id)objectForAtom:(PXAtom)atom;
+
+@end
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXAtomDictionary.m
+//  Pixate
+//
+
+#import "PXAtomDictionary.h"
+#import <objc/runtime.h>
+
+static const char ATOM_DICTIONARY_KEY;
+
+@implementation PXAtomDictionary
+{
+    // the dictionary owns the values, so the atom-indexed array does not retain them
+    NSDictionary *dictionary_;
+    __unsafe_unretained id *objectsByAtom_;
+    PXAtom atomLimit_;
+}
+
+#pragma mark - Static Methods
+
++ (PXAtomDictionary *)atomDictionaryForDictionary:(NSDictionary *)dictionary
+{
+    if (dictionary == nil)
+    {
+        return nil;
+    }
+
+    PXAtomDictionary *result = objc_getAssociatedObject(dictionary, &ATOM_DICTIONARY_KEY);
+
+    if (result == nil)
+    {
+        // a race creates equivalent instances, so whichever is stored last is as good as any other
+        result = [[PXAtomDictionary alloc] initWithDictionary:dictionary];
+
+        objc_setAssociatedObject(dictionary, &ATOM_DICTIONARY_KEY, result, OBJC_ASSOCIATION_RETAIN);
+    }
+
+    return result;
+}
+
+#pragma mark - Initializers
+
+- (id)initWithDictionary:(NSDictionary *)dictionary
+{
+    if (self = [super init])
+    {
+        dictionary_ = [dictionary copy];
+
+        NSUInteger count = dictionary_.count;
+        PXAtom *atoms = malloc(MAX(count, 1) * sizeof(PXAtom));
+        NSUInteger index = 0;
+
+        for (id key in dictionary_)
+        {
+            atoms[index] = ([key isKindOfClass:[NSString class]]) ? [PXAtomTable atomForString:key] : PXAtomNone;
+            atomLimit_ = MAX(atomLimit_, atoms[index] + 1);
+            index++;
+        }
+
+        objectsByAtom_ = (__unsafe_unretained id *) calloc(atomLimit_, sizeof(id));
+        index = 0;
+
+        for (id key in dictionary_)
+        {
+            if (atoms[index] != PXAtomNone)
+            {
+                objectsByAtom_[atoms[index]] = [dictionary_ objectForKey:key];
+            }
+
+            index++;
+        }
+
+        free(atoms);
+    }
+
+    return self;
+}
+
+#pragma mark - Methods
+
+- (id)objectForAtom:(PXAtom)atom
+{
+    return (atom < atomLimit_) ? objectsByAtom_[atom] : nil;
+}
+
+#pragma mark - Overrides
+
+- (void)dealloc
+{
+    free(objectsByAtom_);
+}
+
+@end
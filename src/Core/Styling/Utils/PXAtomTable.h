@@ -0,0 +1,70 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXAtomTable.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  An atom is a small integer that stands for an interned string. Two atoms from the shared table are equal exactly
+ *  when the strings they were created from are equal, so element names, ids, classes, and property names can be
+ *  compared with an integer compare and used as array indexes.
+ */
+typedef uint32_t PXAtom;
+
+/**
+ *  The atom of nil and empty strings, and of strings that have not been interned. It never equals another atom
+ */
+#define PXAtomNone ((PXAtom) 0)
+
+/**
+ *  PXAtomTable is the process-wide table of interned strings. Atoms are never removed, so they are stable for the
+ *  lifetime of the process. All methods are thread-safe.
+ */
+@interface PXAtomTable : NSObject
+
+/**
+ *  Return the atom for the specified string, adding the string to the table if needed. Nil and empty strings return
+ *  PXAtomNone
+ *
+ *  @param string The string to intern
+ */
++ (PXAtom)atomForString:(NSString *)string;
+
+/**
+ *  Return the atom for the specified string without adding it to the table. PXAtomNone is returned for strings that
+ *  have not been interned. Since nothing can be compared against a string that was never interned, such strings can
+ *  never match, which makes this useful for lookups with strings that may be arbitrary.
+ *
+ *  @param string The string to look up
+ */
++ (PXAtom)existingAtomForString:(NSString *)string;
+
+/**
+ *  Return the string for the specified atom, or nil for PXAtomNone and unknown atoms
+ *
+ *  @param atom The atom to look up
+ */
++ (NSString *)stringForAtom:(PXAtom)atom;
+
+/**
+ *  Return the number of atoms in the table. All atoms are less than this value plus one
+ */
++ (NSUInteger)atomCount;
+
+@end
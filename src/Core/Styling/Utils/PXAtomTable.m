@@ -0,0 +1,113 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXAtomTable.m
+//  Pixate
+//
+
+#import "PXAtomTable.h"
+#import <pthread.h>
+
+static NSMutableDictionary *ATOMS_BY_STRING;
+static NSMutableArray *STRINGS_BY_ATOM;
+
+// atoms are looked up far more often than they are added, so lookups share the lock and only adding takes it alone
+static pthread_rwlock_t ATOM_TABLE_LOCK = PTHREAD_RWLOCK_INITIALIZER;
+
+@implementation PXAtomTable
+
+#pragma mark - Static Initializers
+
++ (void)initialize
+{
+    if (self == [PXAtomTable class])
+    {
+        ATOMS_BY_STRING = [[NSMutableDictionary alloc] init];
+
+        // atom zero is PXAtomNone
+        STRINGS_BY_ATOM = [[NSMutableArray alloc] initWithObjects:[NSNull null], nil];
+    }
+}
+
+#pragma mark - Static Methods
+
++ (PXAtom)atomForString:(NSString *)string
+{
+    PXAtom result = [self existingAtomForString:string];
+
+    if (result == PXAtomNone && string.length > 0)
+    {
+        pthread_rwlock_wrlock(&ATOM_TABLE_LOCK);
+
+        // another thread may have added the string since it was looked up
+        NSNumber *atom = [ATOMS_BY_STRING objectForKey:string];
+
+        if (atom == nil)
+        {
+            // copy so a mutable string cannot change underneath its atom
+            NSString *key = [string copy];
+
+            atom = @(STRINGS_BY_ATOM.count);
+
+            [ATOMS_BY_STRING setObject:atom forKey:key];
+            [STRINGS_BY_ATOM addObject:key];
+        }
+
+        result = atom.unsignedIntValue;
+
+        pthread_rwlock_unlock(&ATOM_TABLE_LOCK);
+    }
+
+    return result;
+}
+
++ (PXAtom)existingAtomForString:(NSString *)string
+{
+    PXAtom result = PXAtomNone;
+
+    if (string.length > 0)
+    {
+        pthread_rwlock_rdlock(&ATOM_TABLE_LOCK);
+        result = [[ATOMS_BY_STRING objectForKey:string] unsignedIntValue];
+        pthread_rwlock_unlock(&ATOM_TABLE_LOCK);
+    }
+
+    return result;
+}
+
++ (NSString *)stringForAtom:(PXAtom)atom
+{
+    NSString *result = nil;
+
+    pthread_rwlock_rdlock(&ATOM_TABLE_LOCK);
+    result = (atom != PXAtomNone && atom < STRINGS_BY_ATOM.count) ? [STRINGS_BY_ATOM objectAtIndex:atom] : nil;
+    pthread_rwlock_unlock(&ATOM_TABLE_LOCK);
+
+    return result;
+}
+
++ (NSUInteger)atomCount
+{
+    NSUInteger result;
+
+    pthread_rwlock_rdlock(&ATOM_TABLE_LOCK);
+    result = STRINGS_BY_ATOM.count - 1;
+    pthread_rwlock_unlock(&ATOM_TABLE_LOCK);
+
+    return result;
+}
+
+@end
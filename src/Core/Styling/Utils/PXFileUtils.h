@@ -44,4 +44,11 @@
  */
 + (NSString *)sourceFromPath:(NSString *)path;
 
+/**
+ *  Return the SHA-1 digest of the specified data as a lowercase hexadecimal string
+ *
+ *  @param data The data to digest
+ */
++ (NSString *)digestOfData:(NSData *)data;
+
 @end
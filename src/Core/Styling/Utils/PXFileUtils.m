@@ -23,6 +23,7 @@
 //
 
 #import "PXFileUtils.h"
+#import <CommonCrypto/CommonDigest.h>
 
 @implementation PXFileUtils
 
@@ -38,4 +39,19 @@
     return [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
 }
 
++ (NSString *)digestOfData:(NSData *)data
+{
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    NSMutableString *result = [NSMutableString stringWithCapacity:CC_SHA1_DIGEST_LENGTH * 2];
+
+    CC_SHA1(data.bytes, (CC_LONG) data.length, digest);
+
+    for (NSUInteger i = 0; i < CC_SHA1_DIGEST_LENGTH; i++)
+    {
+        [result appendFormat:@"%02x", digest[i]];
+    }
+
+    return result;
+}
+
 @end
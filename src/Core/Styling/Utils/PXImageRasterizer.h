@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//
+//  PXImageRasterizer.h
+//  Pixate
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ *  PXImageRasterizer runs image rendering blocks on a concurrent queue, never running more than
+ *  maximumConcurrentRenders at once. Requests are keyed, typically by a styler context's style hash, and a request
+ *  for a key that is already being rendered joins it instead of rendering again. Completion blocks run on the main
+ *  queue once the image is ready, and finished images are kept briefly so restyled styleables can pick them up.
+ */
+@interface PXImageRasterizer : NSObject
+
+/**
+ *  The singleton instance of PXImageRasterizer
+ */
++ (PXImageRasterizer *)sharedInstance;
+
+/**
+ *  The maximum number of renders run at once. The default is 2. Values less than 1 are treated as 1
+ */
+@property (atomic) NSUInteger maximumConcurrentRenders;
+
+/**
+ *  The number of keys requested but not yet rendered, including those being rendered
+ */
+@property (nonatomic, readonly) NSUInteger inFlightCount;
+
+/**
+ *  The number of render blocks that have been run since the counters were last reset
+ */
+@property (nonatomic, readonly) NSUInteger renderCount;
+
+/**
+ *  The number of requests that joined a render already in flight since the counters were last reset
+ */
+@property (nonatomic, readonly) NSUInteger joinedCount;
+
+/**
+ *  Render an image for the specified key off the main thread. Returns YES if a new render was scheduled, or NO if the
+ *  request joined a render already in flight for the same key
+ *
+ *  @param key The key identifying the image
+ *  @param block The block that renders the image. It must not use UIKit views
+ *  @param completion The block to call on the main queue with the rendered image, which may be nil
+ */
+- (BOOL)rasterizeImageForKey:(id<NSCopying>)key usingBlock:(UIImage *(^)(void))block completion:(void (^)(UIImage *image))completion;
+
+/**
+ *  Return a recently finished image for the specified key, or nil if there is none
+ *
+ *  @param key The key identifying the image
+ */
+- (UIImage *)finishedImageForKey:(id<NSCopying>)key;
+
+/**
+ *  Block the calling thread until every scheduled render block has returned. Completion blocks are dispatched to the
+ *  main queue and may not have run yet
+ */
+- (void)waitUntilIdle;
+
+/**
+ *  Remove all finished images
+ */
+- (void)clearFinishedImages;
+
+/**
+ *  Reset the render and joined counters
+ */
+- (void)resetCounters;
+
+@end
@@ -0,0 +1,222 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//
+//  PXImageRasterizer.m
+//  Pixate
+//
+
+#import "PXImageRasterizer.h"
+
+// finished images only need to survive until the restyle that picks them up
+static const NSUInteger FINISHED_IMAGE_COUNT = 32;
+
+@implementation PXImageRasterizer
+{
+    dispatch_queue_t queue_;
+    dispatch_group_t group_;
+    NSMutableDictionary *completionsByKey_;     // key -> NSMutableArray of completion blocks
+    NSMutableArray *pendingKeys_;               // keys waiting for a worker, in request order
+    NSMutableDictionary *blocksByKey_;          // key -> render block of a pending key
+    NSCache *finishedImages_;
+    NSUInteger runningCount_;
+}
+
+#pragma mark - Static Methods
+
++ (PXImageRasterizer *)sharedInstance
+{
+	static __strong PXImageRasterizer *sharedInstance = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		sharedInstance = [[PXImageRasterizer alloc] init];
+	});
+	return sharedInstance;
+}
+
+#pragma mark - Initializers
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        queue_ = dispatch_queue_create("com.pixate.freestyle.rasterizer", DISPATCH_QUEUE_CONCURRENT);
+        group_ = dispatch_group_create();
+        completionsByKey_ = [[NSMutableDictionary alloc] init];
+        pendingKeys_ = [[NSMutableArray alloc] init];
+        blocksByKey_ = [[NSMutableDictionary alloc] init];
+
+        finishedImages_ = [[NSCache alloc] init];
+        finishedImages_.name = @"Pixate Rasterized Image Cache";
+        finishedImages_.countLimit = FINISHED_IMAGE_COUNT;
+
+        _maximumConcurrentRenders = 2;
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSUInteger)maximumConcurrentRenders
+{
+    @synchronized(self)
+    {
+        return _maximumConcurrentRenders;
+    }
+}
+
+- (NSUInteger)inFlightCount
+{
+    @synchronized(self)
+    {
+        return completionsByKey_.count;
+    }
+}
+
+#pragma mark - Setters
+
+- (void)setMaximumConcurrentRenders:(NSUInteger)maximumConcurrentRenders
+{
+    @synchronized(self)
+    {
+        _maximumConcurrentRenders = maximumConcurrentRenders;
+
+        [self startPendingRenders];
+    }
+}
+
+#pragma mark - Methods
+
+- (BOOL)rasterizeImageForKey:(id<NSCopying>)key usingBlock:(UIImage *(^)(void))block completion:(void (^)(UIImage *image))completion
+{
+    if (key == nil || block == nil)
+    {
+        return NO;
+    }
+
+    @synchronized(self)
+    {
+        NSMutableArray *completions = [completionsByKey_ objectForKey:key];
+        BOOL scheduled = (completions == nil);
+
+        if (scheduled)
+        {
+            completions = [[NSMutableArray alloc] init];
+
+            [completionsByKey_ setObject:completions forKey:key];
+            [blocksByKey_ setObject:[block copy] forKey:key];
+            [pendingKeys_ addObject:key];
+
+            dispatch_group_enter(group_);
+        }
+        else
+        {
+            _joinedCount++;
+        }
+
+        if (completion != nil)
+        {
+            [completions addObject:[completion copy]];
+        }
+
+        [self startPendingRenders];
+
+        return scheduled;
+    }
+}
+
+- (UIImage *)finishedImageForKey:(id<NSCopying>)key
+{
+    return (key != nil) ? [finishedImages_ objectForKey:key] : nil;
+}
+
+- (void)waitUntilIdle
+{
+    dispatch_group_wait(group_, DISPATCH_TIME_FOREVER);
+}
+
+- (void)clearFinishedImages
+{
+    [finishedImages_ removeAllObjects];
+}
+
+- (void)resetCounters
+{
+    @synchronized(self)
+    {
+        _renderCount = 0;
+        _joinedCount = 0;
+    }
+}
+
+#pragma mark - Private Methods
+
+- (void)startPendingRenders
+{
+    // called while synchronized on self
+    while (pendingKeys_.count > 0 && runningCount_ < MAX(_maximumConcurrentRenders, (NSUInteger) 1))
+    {
+        id<NSCopying> key = [pendingKeys_ objectAtIndex:0];
+        UIImage *(^block)(void) = [blocksByKey_ objectForKey:key];
+
+        [pendingKeys_ removeObjectAtIndex:0];
+        [blocksByKey_ removeObjectForKey:key];
+        runningCount_++;
+
+        dispatch_async(queue_, ^{
+            UIImage *image = nil;
+
+            @autoreleasepool
+            {
+                image = block();
+            }
+
+            if (image != nil)
+            {
+                [finishedImages_ setObject:image forKey:key];
+            }
+
+            NSArray *completions = nil;
+
+            @synchronized(self)
+            {
+                completions = [completionsByKey_ objectForKey:key];
+
+                [completionsByKey_ removeObjectForKey:key];
+                runningCount_--;
+                _renderCount++;
+
+                [self startPendingRenders];
+            }
+
+            if (completions.count > 0)
+            {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    for (void (^completion)(UIImage *) in completions)
+                    {
+                        completion(image);
+                    }
+                });
+            }
+
+            dispatch_group_leave(group_);
+        });
+    }
+}
+
+@end
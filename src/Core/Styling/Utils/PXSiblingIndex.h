@@ -0,0 +1,93 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//
+//  PXSiblingIndex.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStyleable.h"
+#import "PXStyleUtils.h"
+
+/**
+ *  A PXSiblingIndex records the position and position-of-type of every element child of a parent, so structural
+ *  pseudo-classes (:first-child, :last-of-type, :only-child, :nth-*) can be answered without walking the siblings of
+ *  each element they are matched against.
+ *
+ *  Indexes are built on demand and shared only within a style pass. Starting a pass with performStylePassUsingBlock:
+ *  gives each parent at most one index for the duration of the block, and all indexes are dropped when the outermost
+ *  pass ends. Outside of a pass, lookups build a temporary index and nothing is retained.
+ */
+@interface PXSiblingIndex : NSObject
+
+/**
+ *  The number of element children of the indexed parent
+ */
+@property (nonatomic, readonly) NSInteger childrenCount;
+
+/**
+ *  Initialize a new instance for the specified children. Children with element names starting with '#' are skipped
+ *
+ *  @param children The style children of the parent
+ */
+- (id)initWithChildren:(NSArray *)children;
+
+/**
+ *  Fill in the position of the specified child. Returns NO, leaving info untouched, if the child was not indexed
+ *
+ *  @param info The info to fill in
+ *  @param child The child to look up
+ */
+- (BOOL)getChildrenInfo:(PXStyleableChildrenInfo *)info forChild:(id<PXStyleable>)child;
+
+/**
+ *  Fill in the position of the specified styleable among the children of its style parent, using the current pass's
+ *  index of that parent when there is one
+ *
+ *  @param info The info to fill in
+ *  @param styleable The styleable to look up
+ */
++ (void)getChildrenInfo:(PXStyleableChildrenInfo *)info forStyleable:(id<PXStyleable>)styleable;
+
+/**
+ *  Return the number of items in a section of a table or collection view, remembering the count for the rest of the
+ *  current pass
+ *
+ *  @param section The section index
+ *  @param parent The table view, collection view, or other object implementing numberOfRowsInSection: or
+ *  numberOfItemsInSection:
+ */
++ (NSInteger)itemCountForSection:(NSUInteger)section ofParent:(id)parent;
+
+/**
+ *  Drop the current pass's index for the specified parent. This should be called when the children of the parent
+ *  change
+ *
+ *  @param parent The parent whose children changed
+ */
++ (void)invalidateIndexForParent:(id)parent;
+
+/**
+ *  Run the block as a style pass on the current thread. Passes may be nested, in which case the outermost pass owns the
+ *  indexes
+ *
+ *  @param block The block to run
+ */
++ (void)performStylePassUsingBlock:(void (^)(void))block;
+
+@end
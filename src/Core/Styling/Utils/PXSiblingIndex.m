@@ -0,0 +1,252 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//
+//  PXSiblingIndex.m
+//  Pixate
+//
+
+#import "PXSiblingIndex.h"
+#import <UIKit/UIKit.h>
+
+typedef struct {
+    NSInteger childrenIndex;
+    NSInteger childrenOfTypeIndex;
+    NSUInteger typeSlot;
+} PXSiblingIndexEntry;
+
+// the indexes and section counts of the outermost pass on this thread. Both are owned by
+// performStylePassUsingBlock:, which keeps them alive while they are set
+static __thread __unsafe_unretained NSMapTable *ACTIVE_INDEXES;
+static __thread __unsafe_unretained NSMapTable *ACTIVE_SECTION_COUNTS;
+
+static NSInteger PXSiblingIndexCountFromSelector(id parent, SEL selector, NSInteger index)
+{
+    NSInvocation *inv = [NSInvocation invocationWithMethodSignature:[parent methodSignatureForSelector:selector]];
+    NSInteger result;
+
+    [inv setSelector:selector];
+    [inv setTarget:parent];
+    [inv setArgument:&index atIndex:2];
+    [inv invoke];
+    [inv getReturnValue:&result];
+
+    return result;
+}
+
+@implementation PXSiblingIndex
+{
+    NSArray *children_;
+    NSMapTable *slotsByChild_;
+    NSDictionary *typeSlots_;
+    PXSiblingIndexEntry *entries_;
+    NSInteger *typeCounts_;
+}
+
+#pragma mark - Initializers
+
+- (id)initWithChildren:(NSArray *)children
+{
+    if (self = [super init])
+    {
+        NSUInteger count = children.count;
+        NSMutableDictionary *typeSlots = [[NSMutableDictionary alloc] init];
+        NSUInteger slot = 0;
+
+        // children are retained so that their addresses cannot be reused while they are keys
+        children_ = children;
+        slotsByChild_ = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                                              valueOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsIntegerPersonality];
+        entries_ = malloc(MAX(count, 1) * sizeof(PXSiblingIndexEntry));
+        typeCounts_ = calloc(MAX(count, 1), sizeof(NSInteger));
+
+        for (id<PXStyleable> child in children)
+        {
+            NSString *elementName = child.pxStyleElementName;
+
+            if ([elementName hasPrefix:@"#"])
+            {
+                continue;
+            }
+
+            // element names are shared per class, so most lookups hit the same few strings
+            NSNumber *typeSlot = [typeSlots objectForKey:(elementName != nil) ? elementName : @""];
+
+            if (typeSlot == nil)
+            {
+                typeSlot = @(typeSlots.count);
+                [typeSlots setObject:typeSlot forKey:(elementName != nil) ? elementName : @""];
+            }
+
+            PXSiblingIndexEntry *entry = &entries_[slot];
+
+            entry->typeSlot = typeSlot.unsignedIntegerValue;
+            entry->childrenIndex = ++_childrenCount;
+            entry->childrenOfTypeIndex = ++typeCounts_[entry->typeSlot];
+
+            // slots are stored one-based so that a missing child reads as zero
+            NSMapInsert(slotsByChild_, (__bridge void *) child, (void *) (uintptr_t) (++slot));
+        }
+
+        typeSlots_ = typeSlots;
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    free(entries_);
+    free(typeCounts_);
+}
+
+#pragma mark - Methods
+
+- (BOOL)getChildrenInfo:(PXStyleableChildrenInfo *)info forChild:(id<PXStyleable>)child
+{
+    uintptr_t slot = (uintptr_t) NSMapGet(slotsByChild_, (__bridge void *) child);
+
+    if (slot == 0)
+    {
+        return NO;
+    }
+
+    PXSiblingIndexEntry *entry = &entries_[slot - 1];
+
+    info->childrenCount = _childrenCount;
+    info->childrenIndex = entry->childrenIndex;
+    info->childrenOfTypeCount = typeCounts_[entry->typeSlot];
+    info->childrenOfTypeIndex = entry->childrenOfTypeIndex;
+
+    return YES;
+}
+
+- (void)getCountsForElementName:(NSString *)elementName info:(PXStyleableChildrenInfo *)info
+{
+    NSNumber *typeSlot = [typeSlots_ objectForKey:(elementName != nil) ? elementName : @""];
+
+    info->childrenCount = _childrenCount;
+    info->childrenOfTypeCount = (typeSlot != nil) ? typeCounts_[typeSlot.unsignedIntegerValue] : 0;
+}
+
+#pragma mark - Static Methods
+
++ (void)getChildrenInfo:(PXStyleableChildrenInfo *)info forStyleable:(id<PXStyleable>)styleable
+{
+    id<PXStyleable> parent = styleable.pxStyleParent;
+    PXSiblingIndex *index = (parent != nil) ? [ACTIVE_INDEXES objectForKey:parent] : nil;
+
+    // a child missing from an index was added without the parent invalidating it, so rebuild once
+    if (index == nil || ![index getChildrenInfo:info forChild:styleable])
+    {
+        index = [[PXSiblingIndex alloc] initWithChildren:parent.pxStyleChildren];
+
+        if (parent != nil && ACTIVE_INDEXES != nil)
+        {
+            [ACTIVE_INDEXES setObject:index forKey:parent];
+        }
+
+        if (![index getChildrenInfo:info forChild:styleable])
+        {
+            // not a child of its own parent: report the sibling counts with no position
+            [index getCountsForElementName:styleable.pxStyleElementName info:info];
+        }
+    }
+}
+
++ (NSInteger)itemCountForSection:(NSUInteger)section ofParent:(id)parent
+{
+    NSMutableDictionary *counts = [ACTIVE_SECTION_COUNTS objectForKey:parent];
+    NSNumber *count = [counts objectForKey:@(section)];
+
+    if (count != nil)
+    {
+        return count.integerValue;
+    }
+
+    NSInteger result = 0;
+
+    // UIKit's own views are messaged directly instead of through an invocation
+    if ([parent isKindOfClass:[UITableView class]])
+    {
+        result = [(UITableView *) parent numberOfRowsInSection:section];
+    }
+    else if ([parent isKindOfClass:[UICollectionView class]])
+    {
+        result = [(UICollectionView *) parent numberOfItemsInSection:section];
+    }
+    else if ([parent respondsToSelector:@selector(numberOfItemsInSection:)])
+    {
+        result = PXSiblingIndexCountFromSelector(parent, @selector(numberOfItemsInSection:), section);
+    }
+    else if ([parent respondsToSelector:@selector(numberOfRowsInSection:)])
+    {
+        result = PXSiblingIndexCountFromSelector(parent, @selector(numberOfRowsInSection:), section);
+    }
+
+    if (parent != nil && ACTIVE_SECTION_COUNTS != nil)
+    {
+        if (counts == nil)
+        {
+            counts = [[NSMutableDictionary alloc] init];
+            [ACTIVE_SECTION_COUNTS setObject:counts forKey:parent];
+        }
+
+        [counts setObject:@(result) forKey:@(section)];
+    }
+
+    return result;
+}
+
++ (void)invalidateIndexForParent:(id)parent
+{
+    if (parent != nil)
+    {
+        [ACTIVE_INDEXES removeObjectForKey:parent];
+        [ACTIVE_SECTION_COUNTS removeObjectForKey:parent];
+    }
+}
+
++ (void)performStylePassUsingBlock:(void (^)(void))block
+{
+    if (ACTIVE_INDEXES != nil)
+    {
+        // nested passes share the outermost pass's indexes
+        block();
+        return;
+    }
+
+    NSMapTable *indexes = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                valueOptions:NSPointerFunctionsStrongMemory];
+    NSMapTable *sectionCounts = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                      valueOptions:NSPointerFunctionsStrongMemory];
+
+    ACTIVE_INDEXES = indexes;
+    ACTIVE_SECTION_COUNTS = sectionCounts;
+
+    @try
+    {
+        block();
+    }
+    @finally
+    {
+        ACTIVE_INDEXES = nil;
+        ACTIVE_SECTION_COUNTS = nil;
+    }
+}
+
+@end
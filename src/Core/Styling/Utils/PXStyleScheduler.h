@@ -0,0 +1,104 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//
+//  PXStyleScheduler.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXStyleable.h"
+
+/**
+ *  PXStyleScheduler collects requests to restyle styleables and performs them in a single top-down pass on the main
+ *  queue. Styleables marked more than once, and styleables whose ancestor is marked for a recursive update, are only
+ *  styled once. When a frame budget is set, work left over when the budget runs out is carried to the next pass.
+ */
+@interface PXStyleScheduler : NSObject
+
+/**
+ *  The singleton instance of PXStyleScheduler
+ */
++ (PXStyleScheduler *)sharedInstance;
+
+/**
+ *  The maximum time, in seconds, a pass may spend styling before deferring the remaining styleables to the next pass.
+ *  At least one styleable is styled per pass. Zero, the default, means there is no limit
+ */
+@property (atomic) NSTimeInterval frameBudget;
+
+/**
+ *  The number of styleables waiting to be styled
+ */
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/**
+ *  The number of passes performed since the counters were last reset
+ */
+@property (nonatomic, readonly) NSUInteger passCount;
+
+/**
+ *  The number of styleables styled by the last pass
+ */
+@property (nonatomic, readonly) NSUInteger lastPassStyledCount;
+
+/**
+ *  The number of requests the last pass did not need to perform, because the styleable was marked more than once, was
+ *  covered by an ancestor's recursive update, or was released before the pass
+ */
+@property (nonatomic, readonly) NSUInteger lastPassSkippedCount;
+
+/**
+ *  The time, in seconds, spent in the last pass
+ */
+@property (nonatomic, readonly) NSTimeInterval lastPassDuration;
+
+/**
+ *  The number of styleables styled since the counters were last reset
+ */
+@property (nonatomic, readonly) NSUInteger totalStyledCount;
+
+/**
+ *  The number of requests skipped since the counters were last reset
+ */
+@property (nonatomic, readonly) NSUInteger totalSkippedCount;
+
+/**
+ *  The time, in seconds, spent in passes since the counters were last reset
+ */
+@property (nonatomic, readonly) NSTimeInterval totalDuration;
+
+/**
+ *  Mark the specified styleable as needing styling and schedule a pass if one is not already scheduled. This may be
+ *  called from any thread
+ *
+ *  @param styleable The styleable to style
+ *  @param recursively Style the styleable's descendants as well when YES
+ */
+- (void)setStyleableNeedsStyle:(id<PXStyleable>)styleable recursively:(BOOL)recursively;
+
+/**
+ *  Perform a pass now, ignoring the frame budget. This must be called on the main queue
+ */
+- (void)flush;
+
+/**
+ *  Reset the pass and total counters to zero
+ */
+- (void)resetCounters;
+
+@end
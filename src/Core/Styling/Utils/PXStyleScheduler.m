@@ -0,0 +1,284 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//
+//  PXStyleScheduler.m
+//  Pixate
+//
+
+#import "PXStyleScheduler.h"
+#import "PXStyleUtils.h"
+#import "PXSiblingIndex.h"
+
+@implementation PXStyleScheduler
+{
+    // styleable -> NSNumber flag for recursive updates. Keys are weak so pending work does not keep styleables alive
+    NSMapTable *pending_;
+    NSUInteger pendingRequestCount_;
+    NSUInteger pendingSkippedCount_;
+    BOOL scheduled_;
+}
+
+#pragma mark - Static Methods
+
++ (PXStyleScheduler *)sharedInstance
+{
+	static __strong PXStyleScheduler *sharedInstance = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		sharedInstance = [[PXStyleScheduler alloc] init];
+	});
+	return sharedInstance;
+}
+
+#pragma mark - Initializers
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        pending_ = [NSMapTable weakToStrongObjectsMapTable];
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSUInteger)pendingCount
+{
+    @synchronized(self)
+    {
+        // the map's count may include entries whose styleable has been released
+        return pending_.keyEnumerator.allObjects.count;
+    }
+}
+
+#pragma mark - Methods
+
+- (void)setStyleableNeedsStyle:(id<PXStyleable>)styleable recursively:(BOOL)recursively
+{
+    if (styleable == nil)
+    {
+        return;
+    }
+
+    BOOL schedule = NO;
+
+    @synchronized(self)
+    {
+        [self addStyleable:styleable recursively:recursively];
+
+        if (!scheduled_)
+        {
+            scheduled_ = YES;
+            schedule = YES;
+        }
+    }
+
+    if (schedule)
+    {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self performPassWithBudget:self.frameBudget];
+        });
+    }
+}
+
+- (void)addStyleable:(id<PXStyleable>)styleable recursively:(BOOL)recursively
+{
+    NSNumber *existing = [pending_ objectForKey:styleable];
+
+    if (existing != nil)
+    {
+        pendingSkippedCount_++;
+
+        if (recursively && !existing.boolValue)
+        {
+            [pending_ setObject:@YES forKey:styleable];
+        }
+    }
+    else
+    {
+        pendingRequestCount_++;
+        [pending_ setObject:@(recursively) forKey:styleable];
+    }
+}
+
+- (void)flush
+{
+    [self performPassWithBudget:0];
+}
+
+- (void)resetCounters
+{
+    _passCount = 0;
+    _lastPassStyledCount = 0;
+    _lastPassSkippedCount = 0;
+    _lastPassDuration = 0;
+    _totalStyledCount = 0;
+    _totalSkippedCount = 0;
+    _totalDuration = 0;
+}
+
+- (void)performPassWithBudget:(NSTimeInterval)budget
+{
+    NSMapTable *pending;
+    NSUInteger requestCount;
+    NSUInteger skippedCount;
+
+    // take the pending work so styleables marked while styling are left for the next pass
+    @synchronized(self)
+    {
+        pending = pending_;
+        requestCount = pendingRequestCount_;
+        skippedCount = pendingSkippedCount_;
+
+        pending_ = [NSMapTable weakToStrongObjectsMapTable];
+        pendingRequestCount_ = 0;
+        pendingSkippedCount_ = 0;
+        scheduled_ = NO;
+    }
+
+    if (requestCount == 0)
+    {
+        return;
+    }
+
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    NSMutableArray *roots = [NSMutableArray arrayWithCapacity:requestCount];
+    NSUInteger liveCount = 0;
+
+    // drop styleables an ancestor's recursive update will reach, and order the rest so ancestors are styled first
+    for (id<PXStyleable> styleable in pending.keyEnumerator.allObjects)
+    {
+        BOOL covered = NO;
+        NSUInteger depth = 0;
+
+        liveCount++;
+
+        for (id parent = styleable.pxStyleParent; [parent conformsToProtocol:@protocol(PXStyleable)]; parent = ((id<PXStyleable>) parent).pxStyleParent)
+        {
+            depth++;
+
+            if (!covered && [[pending objectForKey:parent] boolValue])
+            {
+                covered = YES;
+            }
+        }
+
+        if (covered)
+        {
+            skippedCount++;
+        }
+        else
+        {
+            [roots addObject:@[ styleable, @(depth) ]];
+        }
+    }
+
+    // styleables released before the pass
+    skippedCount += requestCount - liveCount;
+
+    [roots sortUsingComparator:^NSComparisonResult(NSArray *a, NSArray *b) {
+        return [a[1] compare:b[1]];
+    }];
+
+    __block NSUInteger styledCount = 0;
+
+    // one pass for all roots, so siblings marked separately share their parent's sibling index
+    [PXSiblingIndex performStylePassUsingBlock:^{
+        for (NSArray *root in roots)
+        {
+            if (budget > 0 && styledCount > 0 && [NSDate timeIntervalSinceReferenceDate] - start >= budget)
+            {
+                break;
+            }
+
+            id<PXStyleable> styleable = root[0];
+
+            [self styleStyleable:styleable recursively:[[pending objectForKey:styleable] boolValue]];
+            styledCount++;
+        }
+    }];
+
+    if (styledCount < roots.count)
+    {
+        // spill the remaining work to the next pass
+        BOOL schedule = NO;
+
+        @synchronized(self)
+        {
+            for (NSUInteger i = styledCount; i < roots.count; i++)
+            {
+                id<PXStyleable> styleable = roots[i][0];
+
+                [self addStyleable:styleable recursively:[[pending objectForKey:styleable] boolValue]];
+            }
+
+            if (!scheduled_)
+            {
+                scheduled_ = YES;
+                schedule = YES;
+            }
+        }
+
+        if (schedule)
+        {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self performPassWithBudget:self.frameBudget];
+            });
+        }
+    }
+
+    NSTimeInterval duration = [NSDate timeIntervalSinceReferenceDate] - start;
+
+    _passCount++;
+    _lastPassStyledCount = styledCount;
+    _lastPassSkippedCount = skippedCount;
+    _lastPassDuration = duration;
+    _totalStyledCount += styledCount;
+    _totalSkippedCount += skippedCount;
+    _totalDuration += duration;
+}
+
+- (void)styleStyleable:(id<PXStyleable>)styleable recursively:(BOOL)recursively
+{
+    if (recursively)
+    {
+        if ([styleable respondsToSelector:@selector(updateStyles)])
+        {
+            [styleable updateStyles];
+        }
+        else
+        {
+            [PXStyleUtils updateStylesForStyleable:styleable andDescendants:YES];
+        }
+    }
+    else
+    {
+        if ([styleable respondsToSelector:@selector(updateStylesNonRecursively)])
+        {
+            [styleable updateStylesNonRecursively];
+        }
+        else
+        {
+            [PXStyleUtils updateStylesForStyleable:styleable andDescendants:NO];
+        }
+    }
+}
+
+@end
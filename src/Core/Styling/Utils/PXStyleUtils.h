@@ -24,6 +24,9 @@
 
 #import <Foundation/Foundation.h>
 #import "PXStyleable.h"
+#import "PXAtomTable.h"
+
+@class PXRuleSet;
 
 typedef struct {
     NSInteger childrenCount;
@@ -38,22 +41,31 @@ typedef struct {
 
 + (NSInteger)childCountForStyleable:(id<PXStyleable>)styleable;
 + (PXStyleableChildrenInfo *)childrenInfoForStyleable:(id<PXStyleable>)styleable;
++ (void)getChildrenInfo:(PXStyleableChildrenInfo *)info forStyleable:(id<PXStyleable>)styleable;
 
 + (NSString *)descriptionForStyleable:(id<PXStyleable>)styleable;
 + (NSString *)selectorFromStyleable:(id<PXStyleable>)styleable;
++ (NSString *)selectorFromElementName:(NSString *)elementName styleId:(NSString *)styleId styleClasses:(NSArray *)styleClasses;
 
 + (void)enumerateStyleableAndDescendants:(id<PXStyleable>)styleable usingBlock:(void (^)(id obj, BOOL *stop, BOOL *stopDescending))block;
 + (void)enumerateStyleableDescendants:(id<PXStyleable>)styleable usingBlock:(void (^)(id obj, BOOL *stop, BOOL *stopDescending))block;
 
 + (NSDictionary *)viewStylerPropertyMapForStyleable:(id<PXStyleable>)styleable;
 + (NSMutableArray *)matchingRuleSetsForStyleable:(id<PXStyleable>)styleable;
++ (NSArray *)stylesheetRuleSetsMatchingStyleable:(id<PXStyleable>)styleable;
++ (NSArray *)inlineRuleSetsForStyleable:(id<PXStyleable>)styleable;
++ (NSArray *)ruleSetsForInlineCSS:(NSString *)source;
 + (NSArray *)filterRuleSets:(NSArray *)ruleSets forStyleable:(id<PXStyleable>)styleable byState:(NSString *)stateName;
 + (NSArray *)filterRuleSets:(NSArray *)ruleSets byPseudoElement:(NSString *)pseudoElement;
++ (PXRuleSet *)mergedRuleSetForRuleSets:(NSArray *)ruleSets;
 
++ (NSUInteger)hashValueForDeclarations:(NSArray *)declarations;
 + (BOOL)stylesOfStyleable:(id<PXStyleable>)styleable matchDeclarations:(NSArray *)declarations state:(NSString *)state;
++ (BOOL)stylesOfStyleable:(id<PXStyleable>)styleable matchDeclarationsHash:(NSUInteger)declarationsHash stateAtom:(PXAtom)state;
 + (void)invalidateStyleable:(id<PXStyleable>)styleable;
 + (void)invalidateStyleableAndDescendants:(id<PXStyleable>)styleable;
 + (NSUInteger)hashValueForStyleable:(id<PXStyleable>)styleable state:(NSString *)state;
++ (NSUInteger)hashValueForStyleable:(id<PXStyleable>)styleable stateAtom:(PXAtom)state;
 
 + (void)setItemIndex:(NSIndexPath *)index forObject:(NSObject *)object;
 + (NSIndexPath *)itemIndexForObject:(NSObject *)object;
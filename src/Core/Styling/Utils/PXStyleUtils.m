@@ -36,6 +36,11 @@
 #import "NSObject+PXStyling.h"
 #import "PXStyler.h"
 #import "PXVirtualStyleableControl.h"
+#import "PXAncestorFilter.h"
+#import "PXRuleSetMatchKey.h"
+#import "PXMergedRuleSetKey.h"
+#import "PXRuleSet.h"
+#import "PXSiblingIndex.h"
 
 #import <QuartzCore/QuartzCore.h>
 
@@ -45,6 +50,114 @@ static const char hash;
 static const char itemIndex;
 static const char viewDelegate;
 
+// most styleables have a handful of states, so their hashes fit without a separate allocation
+#define STYLE_HASH_RECORD_CAPACITY 4
+
+typedef struct
+{
+    PXAtom state;
+    NSUInteger hash;
+} PXStyleHashEntry;
+
+static inline NSUInteger PXHashCGFloat(CGFloat value)
+{
+    double d = (value == 0.0) ? 0.0 : value;    // treat -0.0 as 0.0
+    uint64_t bits;
+
+    memcpy(&bits, &d, sizeof(bits));
+
+    return (NSUInteger) (bits ^ (bits >> 32));
+}
+
+/**
+ *  A PXStyleHashRecord holds the hash of the last styles applied to a styleable, per state, so redundant styling can
+ *  be detected without allocating
+ */
+@interface PXStyleHashRecord : NSObject
+- (BOOL)getHash:(NSUInteger *)hash forState:(PXAtom)state;
+- (void)setHash:(NSUInteger)hash forState:(PXAtom)state;
+- (void)removeAllHashes;
+@end
+
+@implementation PXStyleHashRecord
+{
+    PXStyleHashEntry inlineEntries_[STYLE_HASH_RECORD_CAPACITY];
+    PXStyleHashEntry *entries_;
+    NSUInteger count_;
+    NSUInteger capacity_;
+}
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        entries_ = inlineEntries_;
+        capacity_ = STYLE_HASH_RECORD_CAPACITY;
+    }
+
+    return self;
+}
+
+- (BOOL)getHash:(NSUInteger *)hash forState:(PXAtom)state
+{
+    for (NSUInteger i = 0; i < count_; i++)
+    {
+        if (entries_[i].state == state)
+        {
+            *hash = entries_[i].hash;
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+- (void)setHash:(NSUInteger)hash forState:(PXAtom)state
+{
+    for (NSUInteger i = 0; i < count_; i++)
+    {
+        if (entries_[i].state == state)
+        {
+            entries_[i].hash = hash;
+            return;
+        }
+    }
+
+    if (count_ == capacity_)
+    {
+        capacity_ *= 2;
+
+        if (entries_ == inlineEntries_)
+        {
+            entries_ = malloc(capacity_ * sizeof(PXStyleHashEntry));
+            memcpy(entries_, inlineEntries_, count_ * sizeof(PXStyleHashEntry));
+        }
+        else
+        {
+            entries_ = realloc(entries_, capacity_ * sizeof(PXStyleHashEntry));
+        }
+    }
+
+    entries_[count_].state = state;
+    entries_[count_].hash = hash;
+    count_++;
+}
+
+- (void)removeAllHashes
+{
+    count_ = 0;
+}
+
+- (void)dealloc
+{
+    if (entries_ != inlineEntries_)
+    {
+        free(entries_);
+    }
+}
+
+@end
+
 @implementation PXStyleUtils
 
 + (NSArray *)elementChildrenOfStyleable:(id<PXStyleable>)styleable
@@ -87,17 +200,11 @@ static const char viewDelegate;
         // TODO: This won't work, need a child as last parameter
         NSIndexPath *path = [styleable performSelector:@selector(indexPathForCell:) withObject:styleable];
 
-        if ([styleable respondsToSelector:@selector(numberOfItemsInSection:)])
-        {
-            NSUInteger sectionIndex = [path indexAtPosition:path.length - 2];
-
-            result = [self getCountFromSelector:@selector(numberOfItemsInSection:) withParent:styleable index:sectionIndex];
-        }
-        else if ([styleable respondsToSelector:@selector(numberOfRowsInSection:)])
+        if ([styleable respondsToSelector:@selector(numberOfItemsInSection:)] || [styleable respondsToSelector:@selector(numberOfRowsInSection:)])
         {
             NSUInteger sectionIndex = [path indexAtPosition:path.length - 2];
 
-            result = [self getCountFromSelector:@selector(numberOfRowsInSection:) withParent:styleable index:sectionIndex];
+            result = [PXSiblingIndex itemCountForSection:sectionIndex ofParent:styleable];
         }
     }
     else
@@ -112,6 +219,13 @@ static const char viewDelegate;
 {
     PXStyleableChildrenInfo *result = malloc(sizeof(PXStyleableChildrenInfo));
 
+    [self getChildrenInfo:result forStyleable:styleable];
+
+    return result;
+}
+
++ (void)getChildrenInfo:(PXStyleableChildrenInfo *)result forStyleable:(id<PXStyleable>)styleable
+{
     // init
     result->childrenCount = 0;
     result->childrenOfTypeCount = 0;
@@ -120,13 +234,8 @@ static const char viewDelegate;
 
     id<PXStyleable> parent = styleable.pxStyleParent;
 
-    NSIndexPath *path = nil;
-    
     // First check to see if we've set the index property
-    if(path == nil)
-    {
-        path = [PXStyleUtils itemIndexForObject:styleable];
-    }
+    NSIndexPath *path = [PXStyleUtils itemIndexForObject:styleable];
 
     if (path || ([parent respondsToSelector:@selector(indexPathForCell:)] &&
                  ([styleable isKindOfClass:[UITableViewCell class]] ||
@@ -143,68 +252,21 @@ static const char viewDelegate;
         {
             result->childrenIndex = result->childrenOfTypeIndex = [path indexAtPosition:path.length - 1] + 1;
 
-            if ([parent respondsToSelector:@selector(numberOfItemsInSection:)])
-            {
-                NSUInteger sectionIndex = [path indexAtPosition:path.length - 2];
-                NSInteger count = [self getCountFromSelector:@selector(numberOfItemsInSection:) withParent:parent index:sectionIndex];
-
-                result->childrenCount = result->childrenOfTypeCount = count;
-            }
-            else if ([parent respondsToSelector:@selector(numberOfRowsInSection:)])
+            if ([parent respondsToSelector:@selector(numberOfItemsInSection:)] || [parent respondsToSelector:@selector(numberOfRowsInSection:)])
             {
                 NSUInteger sectionIndex = [path indexAtPosition:path.length - 2];
-                NSInteger count = [self getCountFromSelector:@selector(numberOfRowsInSection:) withParent:parent index:sectionIndex];
 
-                result->childrenCount = result->childrenOfTypeCount = count;
+                // cells of the same section share one count per style pass
+                result->childrenCount = result->childrenOfTypeCount = [PXSiblingIndex itemCountForSection:sectionIndex ofParent:parent];
             }
         }
         // else what?
     }
     else
     {
-        [parent.pxStyleChildren enumerateObjectsUsingBlock:^(id<PXStyleable> obj, NSUInteger idx, BOOL *stop) {
-            if (![obj.pxStyleElementName hasPrefix:@"#"])
-            {
-                result->childrenCount++;
-
-                // test for element existance after adding to make index 1-based
-                if (obj == styleable)
-                {
-                    result->childrenIndex = result->childrenCount;
-                }
-
-                if ([obj.pxStyleElementName isEqualToString:styleable.pxStyleElementName])
-                {
-                    result->childrenOfTypeCount++;
-
-                    // test for element existance after adding to make index 1-based
-                    if (obj == styleable)
-                    {
-                        result->childrenOfTypeIndex = result->childrenOfTypeCount;
-                    }
-                }
-            }
-        }];
+        // siblings share one index per style pass instead of each walking the parent's children
+        [PXSiblingIndex getChildrenInfo:result forStyleable:styleable];
     }
-
-    return result;
-}
-
-+ (NSInteger)getCountFromSelector:(SEL)selector withParent:(NSObject *)parent index:(NSInteger)index
-{
-    //return [[parent performSelector:selector withObject:@(index)] intValue];
-    //id count = objc_msgSend(parent, selector, index);
-
-    NSInvocation *inv = [NSInvocation invocationWithMethodSignature:[(NSObject *)parent methodSignatureForSelector:selector]];
-    NSInteger result;
-
-    [inv setSelector:selector];
-    [inv setTarget:parent];
-    [inv setArgument:&index atIndex:2];
-    [inv invoke];
-    [inv getReturnValue:&result];
-
-    return result;
 }
 
 + (NSString *)descriptionForStyleable:(id<PXStyleable>)styleable
@@ -232,23 +294,30 @@ static const char viewDelegate;
 
 + (NSString *)selectorFromStyleable:(id<PXStyleable>)styleable
 {
-    NSMutableArray *parts = [[NSMutableArray alloc] init];
+    return [self selectorFromElementName:styleable.pxStyleElementName
+                                 styleId:styleable.styleId
+                            styleClasses:styleable.styleClasses];
+}
 
-    // add element name
-    [parts addObject:styleable.pxStyleElementName];
++ (NSString *)selectorFromElementName:(NSString *)elementName styleId:(NSString *)styleId styleClasses:(NSArray *)styleClasses
+{
+    NSMutableString *result = [NSMutableString stringWithString:(elementName) ? elementName : @""];
 
     // add id
-    if (styleable.styleId) [parts addObject:[NSString stringWithFormat:@"#%@", styleable.styleId]];
+    if (styleId)
+    {
+        [result appendString:@"#"];
+        [result appendString:styleId];
+    }
 
     // add classes
-    NSArray *classes = styleable.styleClasses;
-
-    for (NSString *className in classes)
+    for (NSString *className in styleClasses)
     {
-        [parts addObject:[NSString stringWithFormat:@".%@", className]];
+        [result appendString:@"."];
+        [result appendString:className];
     }
 
-    return [parts componentsJoinedByString:@""];
+    return result;
 }
 
 + (void)enumerateStyleableAndDescendants:(id<PXStyleable>)styleable usingBlock:(void (^)(id obj, BOOL *stop, BOOL *stopDescending))block
@@ -289,21 +358,55 @@ static const char viewDelegate;
     // initialize stop flag
     BOOL stop = NO;
     BOOL stopDescending = NO;
+    BOOL *stopRef = &stop;
+    BOOL *stopDescendingRef = &stopDescending;
+
+    // ancestor filters for the styleables in the queue, kept in step with the queue. Siblings share one filter
+    NSMutableArray *filters = [NSMutableArray arrayWithCapacity:queue.count];
+    PXAncestorFilter *filter = nil;
+
+    for (id<PXStyleable> styleable in queue)
+    {
+        if (filter == nil || filter.parent != styleable.pxStyleParent)
+        {
+            filter = [[PXAncestorFilter alloc] initWithAncestorsOfStyleable:styleable];
+        }
+
+        [filters enqueue:filter];
+    }
 
     // loop until the queue is empty or we're told to stop
     while (queue.count > 0 && !stop)
     {
         id<PXStyleable> current = [queue dequeue];
 
-        // process styleable
-        block(current, &stop, &stopDescending);
+        filter = [filters dequeue];
+
+        // a styleable listed as a child of something other than its style parent gets a filter of its own
+        if (filter.parent != current.pxStyleParent)
+        {
+            filter = [[PXAncestorFilter alloc] initWithAncestorsOfStyleable:current];
+        }
+
+        // process styleable, letting combinators reject against its ancestor filter
+        [PXAncestorFilter visitStyleable:current withFilter:filter usingBlock:^{
+            block(current, stopRef, stopDescendingRef);
+        }];
 
         // enqueue children, but only if we're going to continue
         if (stop == NO && stopDescending == NO)
         {
-            for (id child in [current pxStyleChildren])
+            NSArray *children = [current pxStyleChildren];
+
+            if (children.count > 0)
             {
-                [queue enqueue:child];
+                PXAncestorFilter *childFilter = [[PXAncestorFilter alloc] initWithParentFilter:filter parent:current];
+
+                for (id child in children)
+                {
+                    [queue enqueue:child];
+                    [filters enqueue:childFilter];
+                }
             }
         }
     }
@@ -332,26 +435,104 @@ static const char viewDelegate;
 + (NSMutableArray *)matchingRuleSetsForStyleable:(id<PXStyleable>)styleable
 {
     // find matching rule sets, regardless of any supported or specified pseudo-classes
-    NSMutableArray *ruleSets = [NSMutableArray arrayWithArray:[[PXStylesheet currentApplicationStylesheet] ruleSetsMatchingStyleable:styleable]];
-    [ruleSets addObjectsFromArray:[[PXStylesheet currentUserStylesheet] ruleSetsMatchingStyleable:styleable]];
-    [ruleSets addObjectsFromArray:[[PXStylesheet currentViewStylesheet] ruleSetsMatchingStyleable:styleable]];
+    NSMutableArray *ruleSets = [NSMutableArray arrayWithArray:[self stylesheetRuleSetsMatchingStyleable:styleable]];
 
     // include any inline styling
-    if ([styleable respondsToSelector:@selector(styleCSS)])
+    [ruleSets addObjectsFromArray:[self inlineRuleSetsForStyleable:styleable]];
+
+    return ruleSets;
+}
+
++ (NSArray *)inlineRuleSetsForStyleable:(id<PXStyleable>)styleable
+{
+    // styleables that memoize their parsed inline styles avoid rebuilding their styleCSS string
+    if ([styleable respondsToSelector:@selector(pxInlineRuleSets)])
+    {
+        return styleable.pxInlineRuleSets;
+    }
+    else if ([styleable respondsToSelector:@selector(styleCSS)])
+    {
+        return [self ruleSetsForInlineCSS:styleable.styleCSS];
+    }
+    else
+    {
+        return @[];
+    }
+}
+
++ (NSArray *)ruleSetsForInlineCSS:(NSString *)source
+{
+    if (source.length == 0)
+    {
+        return @[];
+    }
+
+    // parsed rule sets are never mutated while styling, so views with identical inline styles share them
+    NSArray *result = [PXCacheManager inlineRuleSetsForSource:source];
+
+    if (result == nil)
+    {
+        PXStylesheetParser *parser = [[PXStylesheetParser alloc] init];
+        PXStylesheet *inlineStylesheet = [parser parseInlineCSS:source];
+
+        result = [NSArray arrayWithArray:inlineStylesheet.ruleSets];
+
+        [PXCacheManager setInlineRuleSets:result forSource:[source copy]];
+    }
+
+    return result;
+}
+
++ (NSArray *)stylesheetRuleSetsMatchingStyleable:(id<PXStyleable>)styleable
+{
+    NSNull *none = [NSNull null];
+    PXStylesheet *application = [PXStylesheet currentApplicationStylesheet];
+    PXStylesheet *user = [PXStylesheet currentUserStylesheet];
+    PXStylesheet *view = [PXStylesheet currentViewStylesheet];
+    NSArray *stylesheets = @[ (application) ? application : none, (user) ? user : none, (view) ? view : none ];
+
+    // styleables with the same identity and ancestors share results, as long as every candidate rule set was cacheable
+    PXRuleSetMatchKey *key = [[PXRuleSetMatchKey alloc] initWithStyleable:styleable stylesheets:stylesheets];
+    NSArray *result = [PXCacheManager ruleSetMatchesForKey:key];
+
+    if (result == nil)
     {
-        // TODO: store and use cached values
-        NSString *source = styleable.styleCSS;
+        NSMutableArray *ruleSets = [NSMutableArray array];
+        BOOL cacheable = YES;
 
-        if (source.length > 0)
+        for (id stylesheet in stylesheets)
         {
-            PXStylesheetParser *parser = [[PXStylesheetParser alloc] init];
-            PXStylesheet *inlineStylesheet = [parser parseInlineCSS:source];
+            if (stylesheet != none)
+            {
+                [ruleSets addObjectsFromArray:[(PXStylesheet *) stylesheet ruleSetsMatchingStyleable:styleable cacheable:&cacheable]];
+            }
+        }
+
+        result = [NSArray arrayWithArray:ruleSets];
 
-            [ruleSets addObjectsFromArray:inlineStylesheet.ruleSets];
+        if (cacheable)
+        {
+            [PXCacheManager setRuleSetMatches:result forKey:key];
         }
     }
 
-    return ruleSets;
+    return result;
+}
+
++ (PXRuleSet *)mergedRuleSetForRuleSets:(NSArray *)ruleSets
+{
+    // styleables that share match results usually filter them into the same lists, so the sort and cascade are shared
+    PXMergedRuleSetKey *key = [[PXMergedRuleSetKey alloc] initWithRuleSets:ruleSets];
+    PXRuleSet *result = [PXCacheManager mergedRuleSetForKey:key];
+
+    if (result == nil)
+    {
+        result = [PXRuleSet ruleSetWithMergedRuleSets:ruleSets];
+
+        [PXCacheManager setMergedRuleSet:result forKey:key];
+    }
+
+    return result;
 }
 
 + (NSArray *)filterRuleSets:(NSArray *)ruleSets forStyleable:(id<PXStyleable>)styleable byState:(NSString *)stateName
@@ -426,42 +607,55 @@ static const char viewDelegate;
     return ruleSetsForPseudoElement;
 }
 
++ (NSUInteger)hashValueForDeclarations:(NSArray *)declarations
+{
+    NSUInteger result = 0;
+
+    for (PXDeclaration *declaration in declarations)
+    {
+        result = result * 31 + declaration.hash;
+    }
+
+    return result;
+}
+
 + (BOOL)stylesOfStyleable:(id<PXStyleable>)styleable matchDeclarations:(NSArray *)declarations state:(NSString *)state
+{
+    return [self stylesOfStyleable:styleable
+             matchDeclarationsHash:[self hashValueForDeclarations:declarations]
+                         stateAtom:[PXAtomTable atomForString:state]];
+}
+
++ (BOOL)stylesOfStyleable:(id<PXStyleable>)styleable matchDeclarationsHash:(NSUInteger)declarationsHash stateAtom:(PXAtom)state
 {
     BOOL result = NO;
 
     // grab hash for active state
     if (PixateFreestyle.configuration.preventRedundantStyling)
     {
-        // grab associated hash dictionary on styleable, or create one (and store) if it doesn't have one already
-        NSMutableDictionary *cachedHashValues = objc_getAssociatedObject(styleable, &hash);
+        // grab associated hash record on styleable, or create one (and store) if it doesn't have one already
+        PXStyleHashRecord *record = objc_getAssociatedObject(styleable, &hash);
 
-        if (!cachedHashValues)
+        if (!record)
         {
-            cachedHashValues = [[NSMutableDictionary alloc] init];
-            objc_setAssociatedObject(styleable, &hash, cachedHashValues, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+            record = [[PXStyleHashRecord alloc] init];
+            objc_setAssociatedObject(styleable, &hash, record, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
         }
 
-        // grab last saved hash, may be nil
-        NSString *stateNameKey = (state) ? state : @"";
-        NSValue *cachedHashValue = [cachedHashValues objectForKey:stateNameKey];
-
         // calculate active declarations hash
         CGRect bounds = styleable.bounds;
-        NSString *boundsString = [NSString stringWithFormat:@"%f,%f,%f,%f", bounds.origin.x, bounds.origin.y, bounds.size.width, bounds.size.height];
-        __block NSUInteger activeDeclarationsHash = boundsString.hash;
+        NSUInteger activeDeclarationsHash = PXHashCGFloat(bounds.origin.x);
 
-        [declarations enumerateObjectsUsingBlock:^(PXDeclaration *declaration, NSUInteger idx, BOOL *stop) {
-            activeDeclarationsHash = activeDeclarationsHash * 31 + declaration.hash;
-        }];
+        activeDeclarationsHash = activeDeclarationsHash * 31 + PXHashCGFloat(bounds.origin.y);
+        activeDeclarationsHash = activeDeclarationsHash * 31 + PXHashCGFloat(bounds.size.width);
+        activeDeclarationsHash = activeDeclarationsHash * 31 + PXHashCGFloat(bounds.size.height);
+        activeDeclarationsHash = activeDeclarationsHash * 31 + declarationsHash;
 
         // if we had a previous hash, then see if it matches our new hash
-        if (cachedHashValue)
-        {
-            NSUInteger cachedHash;
-
-            [cachedHashValue getValue:&cachedHash];
+        NSUInteger cachedHash;
 
+        if ([record getHash:&cachedHash forState:state])
+        {
             result = (activeDeclarationsHash == cachedHash);
         }
 
@@ -472,7 +666,7 @@ static const char viewDelegate;
         }
         else
         {
-            [cachedHashValues setObject:[[NSValue alloc] initWithBytes:&activeDeclarationsHash objCType:@encode(NSUInteger)] forKey:stateNameKey];
+            [record setHash:activeDeclarationsHash forState:state];
         }
     }
     
@@ -481,24 +675,28 @@ static const char viewDelegate;
 
 + (void)invalidateStyleable:(id<PXStyleable>)styleable
 {
-    objc_setAssociatedObject(styleable, &hash, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    // keep the record so the next check does not allocate a new one
+    [(PXStyleHashRecord *) objc_getAssociatedObject(styleable, &hash) removeAllHashes];
 }
 
 + (void)invalidateStyleableAndDescendants:(id<PXStyleable>)styleable
 {
     [PXStyleUtils enumerateStyleableAndDescendants:styleable usingBlock:^(id<PXStyleable> s, BOOL *stop, BOOL *stopDescending) {
-        objc_setAssociatedObject(s, &hash, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        [(PXStyleHashRecord *) objc_getAssociatedObject(s, &hash) removeAllHashes];
     }];
 }
 
 + (NSUInteger)hashValueForStyleable:(id<PXStyleable>)styleable state:(NSString *)state
 {
-    NSMutableDictionary *cachedHashValues = objc_getAssociatedObject(styleable, &hash);
-    NSString *stateNameKey = (state) ? state : @"";
-    NSValue *cachedHashValue = [cachedHashValues objectForKey:stateNameKey];
-    NSUInteger cachedHash;
+    return [self hashValueForStyleable:styleable stateAtom:[PXAtomTable atomForString:state]];
+}
 
-    [cachedHashValue getValue:&cachedHash];
++ (NSUInteger)hashValueForStyleable:(id<PXStyleable>)styleable stateAtom:(PXAtom)state
+{
+    PXStyleHashRecord *record = objc_getAssociatedObject(styleable, &hash);
+    NSUInteger cachedHash = 0;
+
+    [record getHash:&cachedHash forState:state];
 
     return cachedHash;
 }
@@ -571,13 +769,15 @@ static const char viewDelegate;
     {
         if (recurse)
         {
-            [PXStyleUtils enumerateStyleableAndDescendants:styleable usingBlock:^(id<PXStyleable> obj, BOOL *stop, BOOL *stopDescending) {
-                [PXStyleUtils updateStyleForStyleable:obj];
+            [PXSiblingIndex performStylePassUsingBlock:^{
+                [PXStyleUtils enumerateStyleableAndDescendants:styleable usingBlock:^(id<PXStyleable> obj, BOOL *stop, BOOL *stopDescending) {
+                    [PXStyleUtils updateStyleForStyleable:obj];
 
-                if (PixateFreestyle.configuration.cacheStyles)
-                {
-                    *stopDescending = [obj isKindOfClass:[UITableViewCell class]];
-                }
+                    if (PixateFreestyle.configuration.cacheStyles)
+                    {
+                        *stopDescending = [obj isKindOfClass:[UITableViewCell class]];
+                    }
+                }];
             }];
         }
         else
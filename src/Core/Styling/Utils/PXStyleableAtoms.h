@@ -0,0 +1,96 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXStyleableAtoms.h
+//  Pixate
+//
+
+#import <Foundation/Foundation.h>
+#import "PXAtomTable.h"
+#import "PXStyleable.h"
+
+/**
+ *  A PXStyleableAtoms holds the atoms of the element name, id, and classes of a styleable, which are the values used to
+ *  select rule sets and to match type, id, and class selectors. Instances are immutable, so styleables that cache one
+ *  replace it when their id or classes change.
+ */
+@interface PXStyleableAtoms : NSObject
+
+/**
+ *  The element name these atoms were created from. Styleables that cache atoms may compare this by identity with
+ *  their current element name to detect changes
+ */
+@property (nonatomic, readonly, strong) NSString *elementNameString;
+
+/**
+ *  The style key of the styleable, as returned by PXStyleUtils selectorFromStyleable:. This is created on first use
+ */
+@property (nonatomic, readonly, strong) NSString *styleKey;
+
+/**
+ *  The hash of styleKey. It is computed along with the style key, so repeated lookups do not rehash the string
+ */
+@property (nonatomic, readonly) NSUInteger styleKeyHash;
+
+/**
+ *  The atom of the styleable's element name
+ */
+@property (nonatomic, readonly) PXAtom elementName;
+
+/**
+ *  The atom of the styleable's id
+ */
+@property (nonatomic, readonly) PXAtom styleId;
+
+/**
+ *  The number of class atoms
+ */
+@property (nonatomic, readonly) NSUInteger styleClassCount;
+
+/**
+ *  The class atoms, in ascending order. Classes that were not interned are left out
+ */
+@property (nonatomic, readonly) const PXAtom *styleClasses;
+
+/**
+ *  Return the atoms for the specified styleable. The styleable's own atoms are used when it implements pxStyleAtoms.
+ *  Otherwise atoms are looked up without interning, so strings that no stylesheet mentions become PXAtomNone
+ *
+ *  @param styleable The styleable whose atoms to return
+ */
++ (PXStyleableAtoms *)atomsForStyleable:(id<PXStyleable>)styleable;
+
+/**
+ *  Initialize a new instance with the specified values
+ *
+ *  @param elementName The element name
+ *  @param styleId The id. This may be nil
+ *  @param styleClasses An array of class names. This may be nil
+ *  @param intern Add the strings to the atom table when YES. Use NO for values that may be arbitrary and are not cached
+ */
+- (id)initWithElementName:(NSString *)elementName
+                  styleId:(NSString *)styleId
+             styleClasses:(NSArray *)styleClasses
+                   intern:(BOOL)intern;
+
+/**
+ *  Determine if the specified class atom is one of the styleable's classes
+ *
+ *  @param styleClass The class atom to find
+ */
+- (BOOL)containsStyleClass:(PXAtom)styleClass;
+
+@end
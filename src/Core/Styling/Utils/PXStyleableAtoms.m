@@ -0,0 +1,163 @@
+/*
+ * Copyright 2012-present Pixate, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//
+//  PXStyleableAtoms.m
+//  Pixate
+//
+
+#import "PXStyleableAtoms.h"
+#import "PXStyleUtils.h"
+
+@implementation PXStyleableAtoms
+{
+    PXAtom *styleClasses_;
+    NSUInteger styleClassCount_;
+
+    // the strings the style key is built from
+    NSString *styleIdString_;
+    NSArray *styleClassStrings_;
+    NSString *styleKey_;
+    NSUInteger styleKeyHash_;
+}
+
+#pragma mark - Static Methods
+
++ (PXStyleableAtoms *)atomsForStyleable:(id<PXStyleable>)styleable
+{
+    if ([styleable respondsToSelector:@selector(pxStyleAtoms)])
+    {
+        return styleable.pxStyleAtoms;
+    }
+
+    return [[PXStyleableAtoms alloc] initWithElementName:styleable.pxStyleElementName
+                                                 styleId:styleable.styleId
+                                            styleClasses:styleable.styleClasses
+                                                  intern:NO];
+}
+
+#pragma mark - Initializers
+
+- (id)initWithElementName:(NSString *)elementName
+                  styleId:(NSString *)styleId
+             styleClasses:(NSArray *)styleClasses
+                   intern:(BOOL)intern
+{
+    if (self = [super init])
+    {
+        _elementNameString = elementName;
+        styleIdString_ = styleId;
+        styleClassStrings_ = styleClasses;
+        _elementName = (intern) ? [PXAtomTable atomForString:elementName] : [PXAtomTable existingAtomForString:elementName];
+        _styleId = (intern) ? [PXAtomTable atomForString:styleId] : [PXAtomTable existingAtomForString:styleId];
+
+        if (styleClasses.count > 0)
+        {
+            styleClasses_ = malloc(styleClasses.count * sizeof(PXAtom));
+
+            for (NSString *styleClass in styleClasses)
+            {
+                PXAtom atom = (intern) ? [PXAtomTable atomForString:styleClass] : [PXAtomTable existingAtomForString:styleClass];
+
+                if (atom != PXAtomNone)
+                {
+                    // insertion sort; styleables rarely have more than a few classes
+                    NSUInteger i = styleClassCount_++;
+
+                    while (i > 0 && styleClasses_[i - 1] > atom)
+                    {
+                        styleClasses_[i] = styleClasses_[i - 1];
+                        i--;
+                    }
+
+                    styleClasses_[i] = atom;
+                }
+            }
+        }
+    }
+
+    return self;
+}
+
+#pragma mark - Getters
+
+- (NSString *)styleKey
+{
+    @synchronized(self)
+    {
+        if (styleKey_ == nil)
+        {
+            // the selector is built in a mutable string, which must not be shared
+            styleKey_ = [[PXStyleUtils selectorFromElementName:_elementNameString
+                                                       styleId:styleIdString_
+                                                  styleClasses:styleClassStrings_] copy];
+            styleKeyHash_ = styleKey_.hash;
+        }
+
+        return styleKey_;
+    }
+}
+
+- (NSUInteger)styleKeyHash
+{
+    @synchronized(self)
+    {
+        if (styleKey_ == nil)
+        {
+            [self styleKey];
+        }
+
+        return styleKeyHash_;
+    }
+}
+
+- (NSUInteger)styleClassCount
+{
+    return styleClassCount_;
+}
+
+- (const PXAtom *)styleClasses
+{
+    return styleClasses_;
+}
+
+#pragma mark - Methods
+
+- (BOOL)containsStyleClass:(PXAtom)styleClass
+{
+    if (styleClass == PXAtomNone)
+    {
+        return NO;
+    }
+
+    for (NSUInteger i = 0; i < styleClassCount_ && styleClasses_[i] <= styleClass; i++)
+    {
+        if (styleClasses_[i] == styleClass)
+        {
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+#pragma mark - Overrides
+
+- (void)dealloc
+{
+    free(styleClasses_);
+}
+
+@end
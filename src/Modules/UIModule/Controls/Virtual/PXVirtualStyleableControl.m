@@ -24,12 +24,14 @@
 
 #import "PXVirtualStyleableControl.h"
 #import "PXStyleUtils.h"
+#import "PXStyleableAtoms.h"
 
 @implementation PXVirtualStyleableControl
 {
     PXViewStyleUpdaterBlock _block;
     NSString *_styleClass;
     NSArray *_styleClasses;
+    PXStyleableAtoms *_atoms;
 }
 
 // synthesize properties coming from PXStyleable protocol
@@ -101,9 +103,23 @@
     }
 }
 
+- (PXStyleableAtoms *)pxStyleAtoms
+{
+    // a different element name instance means the element name was changed
+    if (_atoms == nil || _atoms.elementNameString != _name)
+    {
+        _atoms = [[PXStyleableAtoms alloc] initWithElementName:_name
+                                                       styleId:self.styleId
+                                                  styleClasses:_styleClasses
+                                                        intern:YES];
+    }
+
+    return _atoms;
+}
+
 - (NSString *)styleKey
 {
-    return [PXStyleUtils selectorFromStyleable:self];
+    return self.pxStyleAtoms.styleKey;
 }
 
 - (NSDictionary *)viewStylersByProperty
@@ -124,6 +140,13 @@
         return [class1 compare:class2];
     }];
     _styleClasses = classes;
+    _atoms = nil;
+}
+
+- (void)setStyleId:(NSString *)anId
+{
+    styleId = [anId copy];
+    _atoms = nil;
 }
 
 - (NSString *)styleClass {
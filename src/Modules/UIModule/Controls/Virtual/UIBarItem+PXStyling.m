@@ -26,8 +26,10 @@
 #import <objc/runtime.h>
 #import "PXStylingMacros.h"
 #import "PXStyleUtils.h"
+#import "PXStyleScheduler.h"
 #import "PXUtils.h"
 #import "PXVirtualStyleableControl.h"
+#import "PXStyleableAtoms.h"
 
 static const char STYLE_CLASS_KEY;
 static const char STYLE_CLASSES_KEY;
@@ -39,6 +41,7 @@ static const char STYLE_BOUNDS_KEY;
 static const char STYLE_FRAME_KEY;
 static const char STYLE_MODE_KEY;
 static const char STYLE_ELEMENT_NAME;
+static const char STYLE_ATOMS_KEY;
 
 void PXForceLoadUIBarItemPXStyling() {}
 
@@ -104,6 +107,25 @@ void PXForceLoadUIBarItemPXStyling() {}
     return objc_getAssociatedObject(self, &STYLE_ELEMENT_NAME);
 }
 
+- (PXStyleableAtoms *)pxStyleAtoms
+{
+    PXStyleableAtoms *atoms = objc_getAssociatedObject(self, &STYLE_ATOMS_KEY);
+    NSString *elementName = self.pxStyleElementName;
+
+    // a different element name instance means the element name was changed
+    if (atoms == nil || atoms.elementNameString != elementName)
+    {
+        atoms = [[PXStyleableAtoms alloc] initWithElementName:elementName
+                                                      styleId:self.styleId
+                                                 styleClasses:self.styleClasses
+                                                       intern:YES];
+
+        objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, atoms, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
+    return atoms;
+}
+
 - (id)pxStyleParent
 {
     return objc_getAssociatedObject(self, &STYLE_PARENT_KEY);
@@ -150,6 +172,7 @@ void PXForceLoadUIBarItemPXStyling() {}
         return [class1 compare:class2];
     }];
     objc_setAssociatedObject(self, &STYLE_CLASSES_KEY, classes, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
 
     [self updateStylesNonRecursively];
 }
@@ -163,6 +186,7 @@ void PXForceLoadUIBarItemPXStyling() {}
     anId = [anId stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
     
     objc_setAssociatedObject(self, &STYLE_ID_KEY, anId, OBJC_ASSOCIATION_COPY_NONATOMIC);
+    objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
     
     [self updateStylesNonRecursively];
 }
@@ -221,16 +245,12 @@ void PXForceLoadUIBarItemPXStyling() {}
 
 - (void)updateStylesAsync
 {
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [self updateStyles];
-    });
+    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:self recursively:YES];
 }
 
 -(void)updateStylesNonRecursivelyAsync
 {
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [self updateStylesNonRecursively];
-    });
+    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:self recursively:NO];
 }
 
 - (NSDictionary *)viewStylersByProperty
@@ -26,8 +26,10 @@
 #import <objc/runtime.h>
 #import "PXStylingMacros.h"
 #import "PXStyleUtils.h"
+#import "PXStyleScheduler.h"
 #import "PXUtils.h"
 #import "PXVirtualStyleableControl.h"
+#import "PXStyleableAtoms.h"
 #import "PXGenericStyler.h"
 #import "PXTextContentStyler.h"
 #import "PXTransformStyler.h"
@@ -53,6 +55,7 @@ static const char STYLE_BOUNDS_KEY;
 static const char STYLE_FRAME_KEY;
 static const char STYLE_MODE_KEY;
 static const char STYLE_ELEMENT_NAME;
+static const char STYLE_ATOMS_KEY;
 static const char STYLE_CHILDREN;
 
 
@@ -107,6 +110,25 @@ void PXForceLoadUINavigationItemPXStyling() {}
     return objc_getAssociatedObject(self, &STYLE_ELEMENT_NAME);
 }
 
+- (PXStyleableAtoms *)pxStyleAtoms
+{
+    PXStyleableAtoms *atoms = objc_getAssociatedObject(self, &STYLE_ATOMS_KEY);
+    NSString *elementName = self.pxStyleElementName;
+
+    // a different element name instance means the element name was changed
+    if (atoms == nil || atoms.elementNameString != elementName)
+    {
+        atoms = [[PXStyleableAtoms alloc] initWithElementName:elementName
+                                                      styleId:self.styleId
+                                                 styleClasses:self.styleClasses
+                                                       intern:YES];
+
+        objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, atoms, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
+    return atoms;
+}
+
 - (id)pxStyleParent
 {
     return objc_getAssociatedObject(self, &STYLE_PARENT_KEY);
@@ -152,6 +174,7 @@ void PXForceLoadUINavigationItemPXStyling() {}
         return [class1 compare:class2];
     }];
     objc_setAssociatedObject(self, &STYLE_CLASSES_KEY, classes, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
     
     [self updateStylesNonRecursively];
 }
@@ -165,6 +188,7 @@ void PXForceLoadUINavigationItemPXStyling() {}
     anId = [anId stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
     
     objc_setAssociatedObject(self, &STYLE_ID_KEY, anId, OBJC_ASSOCIATION_COPY_NONATOMIC);
+    objc_setAssociatedObject(self, &STYLE_ATOMS_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
     
     [self updateStylesNonRecursively];
 }
@@ -223,16 +247,12 @@ void PXForceLoadUINavigationItemPXStyling() {}
 
 - (void)updateStylesAsync
 {
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [self updateStyles];
-    });
+    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:self recursively:YES];
 }
 
 -(void)updateStylesNonRecursivelyAsync
 {
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [self updateStylesNonRecursively];
-    });
+    [[PXStyleScheduler sharedInstance] setStyleableNeedsStyle:self recursively:NO];
 }
 
 - (NSDictionary *)viewStylersByProperty
@@ -109,13 +109,27 @@
 + (id)styleSheetFromSource:(NSString *)source withOrigin:(PXStylesheetOrigin)origin;
 
 /**
- *  Allocate and initialize a new styleheet for the specified path and stylesheet origin
+ *  Allocate and initialize a new styleheet for the specified path and stylesheet origin. Paths ending in .pxssc are
+ *  loaded as stylesheets compiled by scripts/compile_stylesheet.sh instead of being parsed.
  *
  *  @param filePath The string path to the stylesheet file
  *  @param origin The specificity origin for this stylesheet
  */
 + (id)styleSheetFromFilePath:(NSString *)filePath withOrigin:(PXStylesheetOrigin)origin;
 
+/**
+ *  Parse the stylesheet at the specified path on a background queue, then make it the current stylesheet for its
+ *  origin on the main queue. The completion block is called on the main queue once the stylesheet is in place. Call
+ *  updateStylesForAllViews from the completion block to restyle existing views.
+ *
+ *  @param filePath The string path to the stylesheet file
+ *  @param origin The specificity origin for this stylesheet
+ *  @param completion A block called with the new stylesheet. This may be nil
+ */
++ (void)styleSheetFromFilePath:(NSString *)filePath
+                    withOrigin:(PXStylesheetOrigin)origin
+                    completion:(void (^)(PXStylesheet *stylesheet))completion;
+
 /**
  *  A class-level getter returning the current application-level stylesheet. This value may be nil
  */
@@ -156,7 +170,9 @@
 + (void)updateStylesNonRecursively:(id<PXStyleable>)styleable;
 
 /**
- *  Update styles for this styleable and all of its descendant styleables asynchronously
+ *  Update styles for this styleable and all of its descendant styleables asynchronously. Asynchronous updates requested
+ *  before the next turn of the main run loop are combined, so a styleable is styled once even if it, or one of its
+ *  ancestors, was updated several times
  *
  *  @param styleable The styleable to update
  */
@@ -177,6 +177,13 @@
     return [PXStylesheet styleSheetFromFilePath:filePath withOrigin:origin];
 }
 
++ (void)styleSheetFromFilePath:(NSString *)filePath
+                    withOrigin:(PXStylesheetOrigin)origin
+                    completion:(void (^)(PXStylesheet *stylesheet))completion
+{
+    [PXStylesheet styleSheetFromFilePath:filePath withOrigin:origin completion:completion];
+}
+
 + (id)styleSheetFromSource:(NSString *)source withOrigin:(PXStylesheetOrigin)origin
 {
     return [PXStylesheet styleSheetFromSource:source withOrigin:origin];
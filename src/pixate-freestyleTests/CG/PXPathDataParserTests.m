@@ -0,0 +1,499 @@
+//
+//  PXPathDataParserTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXPathDataParser.h"
+#import "PXSVGTokenizer.h"
+#import "PXPath.h"
+#import "NSScanner+PXFloat.h"
+
+static void PXPathElementCollector(void *info, const CGPathElement *element)
+{
+    NSMutableArray *values = (__bridge NSMutableArray *) info;
+    int pointCount = 0;
+
+    switch (element->type)
+    {
+        case kCGPathElementMoveToPoint:
+        case kCGPathElementAddLineToPoint:
+            pointCount = 1;
+            break;
+
+        case kCGPathElementAddQuadCurveToPoint:
+            pointCount = 2;
+            break;
+
+        case kCGPathElementAddCurveToPoint:
+            pointCount = 3;
+            break;
+
+        case kCGPathElementCloseSubpath:
+            pointCount = 0;
+            break;
+    }
+
+    [values addObject:@(element->type)];
+
+    for (int i = 0; i < pointCount; i++)
+    {
+        [values addObject:@(element->points[i].x)];
+        [values addObject:@(element->points[i].y)];
+    }
+}
+
+@interface PXPathDataCollector : NSObject <PXSVGTokenizerDelegate>
+@property (nonatomic, strong) NSMutableArray *pathData;
+@end
+
+@implementation PXPathDataCollector
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        _pathData = [NSMutableArray array];
+    }
+
+    return self;
+}
+
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didStartElement:(PXSVGElementType)type name:(NSString *)name attributes:(PXSVGAttributes *)attributes
+{
+    NSString *d = [attributes stringForAttribute:PXSVGAttributeD];
+
+    if (type == PXSVGElementPath && d)
+    {
+        [_pathData addObject:d];
+    }
+}
+
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didEndElement:(PXSVGElementType)type name:(NSString *)name
+{
+}
+
+@end
+
+@interface PXPathDataParserTests : XCTestCase
+
+@end
+
+@implementation PXPathDataParserTests
+
+#pragma mark - Helpers
+
+- (NSArray *)pathDataInFiles:(NSArray *)paths
+{
+    PXPathDataCollector *collector = [[PXPathDataCollector alloc] init];
+
+    for (NSString *path in paths)
+    {
+        NSData *data = [NSData dataWithContentsOfFile:path];
+        PXSVGTokenizer *tokenizer = [[PXSVGTokenizer alloc] initWithDelegate:collector];
+
+        [tokenizer appendBytes:data.bytes length:data.length];
+        [tokenizer finish];
+    }
+
+    return collector.pathData;
+}
+
+- (NSArray *)commandFilePaths
+{
+    NSArray *paths = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathsForResourcesOfType:@"svg" inDirectory:nil];
+
+    return [paths filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"lastPathComponent ENDSWITH 'Command.svg' OR lastPathComponent ENDSWITH 'Command2.svg'"]];
+}
+
+- (NSArray *)elementsOfPath:(PXPath *)path
+{
+    NSMutableArray *values = [NSMutableArray array];
+
+    CGPathApply(path.path, (__bridge void *) values, PXPathElementCollector);
+
+    return values;
+}
+
+- (NSArray *)elementsOfPathData:(NSString *)data
+{
+    return [self elementsOfPath:[PXPath createPathFromPathData:data]];
+}
+
+- (void)assertElements:(NSArray *)actual equalElements:(NSArray *)expected forPathData:(NSString *)data
+{
+    XCTAssertEqual(expected.count, actual.count, @"Expected the same number of path values for '%@'", data);
+
+    for (NSUInteger i = 0; i < MIN(expected.count, actual.count); i++)
+    {
+        XCTAssertEqualWithAccuracy([expected[i] doubleValue], [actual[i] doubleValue], 1e-3, @"Expected value %lu to match for '%@'", (unsigned long) i, data);
+    }
+}
+
+/**
+ *  The NSScanner-based parser this one replaced, kept to validate and benchmark against
+ */
+- (PXPath *)referencePathFromPathData:(NSString *)data
+{
+    PXPath *path = [[PXPath alloc] init];
+
+    NSScanner *scanner = [NSScanner scannerWithString:data];
+    NSCharacterSet *skipSet = [NSCharacterSet characterSetWithCharactersInString:@" \r\n,"];
+    [scanner setCharactersToBeSkipped:skipSet];
+
+    NSCharacterSet *commandSet = [NSCharacterSet characterSetWithCharactersInString:@"MmLlCcHhVvQqAaSsTtZz"];
+    NSString *command;
+    unichar lastCommand = '\0';
+    CGFloat firstX = 0.0, firstY = 0.0;
+    CGFloat lastX = 0.0, lastY = 0.0;
+    CGFloat lastHandleX = 0.0, lastHandleY = 0.0;
+    CGFloat x1, y1, x2, y2, x3, y3;
+
+    while ([scanner isAtEnd] == NO)
+    {
+        unichar ch;
+
+        if ([scanner scanCharactersFromSet:commandSet intoString:&command] == YES)
+        {
+            ch = [command characterAtIndex:0];
+
+            if (command.length > 1)
+            {
+                scanner.scanLocation = scanner.scanLocation - (command.length - 1);
+            }
+        }
+        else
+        {
+            ch = lastCommand;
+        }
+
+        BOOL relative = (ch >= 'a' && ch <= 'z');
+        CGFloat offsetX = (relative) ? lastX : 0.0;
+        CGFloat offsetY = (relative) ? lastY : 0.0;
+
+        switch (ch)
+        {
+            case 'A':
+            case 'a':
+            {
+                CGFloat rx, ry, xAxisRotation, largeArcFlag, sweepFlag;
+
+                [scanner scanCGFloat:&rx];
+                [scanner scanCGFloat:&ry];
+                [scanner scanCGFloat:&xAxisRotation];
+                [scanner scanCGFloat:&largeArcFlag];
+                [scanner scanCGFloat:&sweepFlag];
+                [scanner scanCGFloat:&x1];
+                [scanner scanCGFloat:&y1];
+
+                x1 += offsetX;
+                y1 += offsetY;
+
+                [path ellipticalArcRadiusX:rx radiusY:ry xAxisRotation:xAxisRotation largeArcFlag:(largeArcFlag > 0.0) sweepFlag:(sweepFlag > 0.0) x:x1 y:y1];
+
+                lastCommand = ch;
+                lastX = x1;
+                lastY = y1;
+                break;
+            }
+
+            case 'C':
+            case 'c':
+                [scanner scanCGFloat:&x1];
+                [scanner scanCGFloat:&y1];
+                [scanner scanCGFloat:&x2];
+                [scanner scanCGFloat:&y2];
+                [scanner scanCGFloat:&x3];
+                [scanner scanCGFloat:&y3];
+
+                x1 += offsetX;
+                y1 += offsetY;
+                x2 += offsetX;
+                y2 += offsetY;
+                x3 += offsetX;
+                y3 += offsetY;
+
+                [path cubicBezierToX1:x1 y1:y1 x2:x2 y2:y2 x3:x3 y3:y3];
+
+                lastCommand = ch;
+                lastHandleX = x2;
+                lastHandleY = y2;
+                lastX = x3;
+                lastY = y3;
+                break;
+
+            case 'H':
+            case 'h':
+                [scanner scanCGFloat:&x1];
+
+                x1 += offsetX;
+
+                [path lineToX:x1 y:lastY];
+
+                lastCommand = ch;
+                lastX = x1;
+                break;
+
+            case 'L':
+            case 'l':
+                [scanner scanCGFloat:&x1];
+                [scanner scanCGFloat:&y1];
+
+                x1 += offsetX;
+                y1 += offsetY;
+
+                [path lineToX:x1 y:y1];
+
+                lastCommand = ch;
+                lastX = x1;
+                lastY = y1;
+                break;
+
+            case 'M':
+            case 'm':
+                [scanner scanCGFloat:&x1];
+                [scanner scanCGFloat:&y1];
+
+                x1 += offsetX;
+                y1 += offsetY;
+
+                [path moveToX:x1 y:y1];
+
+                lastCommand = (relative) ? 'l' : 'L';
+                lastX = x1;
+                lastY = y1;
+                firstX = x1;
+                firstY = y1;
+                break;
+
+            case 'Q':
+            case 'q':
+                [scanner scanCGFloat:&x1];
+                [scanner scanCGFloat:&y1];
+                [scanner scanCGFloat:&x2];
+                [scanner scanCGFloat:&y2];
+
+                x1 += offsetX;
+                y1 += offsetY;
+                x2 += offsetX;
+                y2 += offsetY;
+
+                [path quadraticBezierToX1:x1 y1:y1 x2:x2 y2:y2];
+
+                lastCommand = ch;
+                lastHandleX = x1;
+                lastHandleY = y1;
+                lastX = x2;
+                lastY = y2;
+                break;
+
+            case 'S':
+            case 's':
+                [scanner scanCGFloat:&x2];
+                [scanner scanCGFloat:&y2];
+                [scanner scanCGFloat:&x3];
+                [scanner scanCGFloat:&y3];
+
+                switch (lastCommand) {
+                    case 'S':
+                    case 's':
+                    case 'C':
+                    case 'c':
+                        x1 = 2.0 * lastX - lastHandleX;
+                        y1 = 2.0 * lastY - lastHandleY;
+                        break;
+
+                    default:
+                        x1 = lastX;
+                        y1 = lastY;
+                        break;
+                }
+                x2 += offsetX;
+                y2 += offsetY;
+                x3 += offsetX;
+                y3 += offsetY;
+
+                [path cubicBezierToX1:x1 y1:y1 x2:x2 y2:y2 x3:x3 y3:y3];
+
+                lastCommand = ch;
+                lastHandleX = x2;
+                lastHandleY = y2;
+                lastX = x3;
+                lastY = y3;
+                break;
+
+            case 'T':
+            case 't':
+                [scanner scanCGFloat:&x2];
+                [scanner scanCGFloat:&y2];
+
+                switch (lastCommand) {
+                    case 'Q':
+                    case 'q':
+                    case 'T':
+                    case 't':
+                        x1 = 2.0 * lastX - lastHandleX;
+                        y1 = 2.0 * lastY - lastHandleY;
+                        break;
+
+                    default:
+                        x1 = lastX;
+                        y1 = lastY;
+                        break;
+                }
+                x2 += offsetX;
+                y2 += offsetY;
+
+                [path quadraticBezierToX1:x1 y1:y1 x2:x2 y2:y2];
+
+                lastCommand = ch;
+                lastHandleX = x1;
+                lastHandleY = y1;
+                lastX = x2;
+                lastY = y2;
+                break;
+
+            case 'V':
+            case 'v':
+                [scanner scanCGFloat:&y1];
+
+                y1 += offsetY;
+
+                [path lineToX:lastX y:y1];
+
+                lastCommand = ch;
+                lastY = y1;
+                break;
+
+            case 'Z':
+            case 'z':
+                [path close];
+
+                lastCommand = '\0';
+                lastX = firstX;
+                lastY = firstY;
+                break;
+
+            default:
+                // stop scanning
+                scanner.scanLocation = data.length;
+                break;
+        }
+    }
+
+    return path;
+}
+
+#pragma mark - Tests
+
+- (void)testCommandFilesMatchReference
+{
+    NSArray *pathData = [self pathDataInFiles:[self commandFilePaths]];
+
+    XCTAssertTrue(pathData.count >= 21, @"Expected path data in each command file");
+
+    for (NSString *data in pathData)
+    {
+        NSArray *expected = [self elementsOfPath:[self referencePathFromPathData:data]];
+
+        XCTAssertTrue(expected.count > 0, @"Expected the reference parser to produce elements for '%@'", data);
+        [self assertElements:[self elementsOfPathData:data] equalElements:expected forPathData:data];
+    }
+}
+
+- (void)testBytesMatchString
+{
+    const char *bytes = "M10,20 l5-5 h10 v10 z";
+    PXPath *path = [PXPath createPathFromPathDataBytes:bytes length:strlen(bytes)];
+
+    [self assertElements:[self elementsOfPath:path] equalElements:[self elementsOfPathData:@(bytes)] forPathData:@(bytes)];
+}
+
+- (void)testNumbersWithoutSeparators
+{
+    NSArray *expected = @[ @(kCGPathElementMoveToPoint), @1.5, @0.5, @(kCGPathElementAddLineToPoint), @-2, @1e2 ];
+
+    [self assertElements:[self elementsOfPathData:@"M1.5.5L-2+1e2"] equalElements:expected forPathData:@"M1.5.5L-2+1e2"];
+}
+
+- (void)testPackedArcFlags
+{
+    NSString *packed = @"M0,0a5,5 0 1010,0";
+    NSString *separated = @"M0,0a5,5 0 1 0 10,0";
+
+    [self assertElements:[self elementsOfPathData:packed] equalElements:[self elementsOfPathData:separated] forPathData:packed];
+}
+
+- (void)testSegmentsBeforeErrorAreKept
+{
+    PXPathSegmentBuffer buffer;
+    const char *bytes = "M0 0 L10 10 Z 5 5";
+
+    PXPathSegmentBufferInit(&buffer, strlen(bytes));
+
+    XCTAssertEqual((NSUInteger) 14, PXPathSegmentBufferParse(&buffer, bytes, strlen(bytes)), @"Expected arguments after a close to fail");
+    XCTAssertEqual((NSUInteger) 3, buffer.count, @"Expected the segments before the error");
+    XCTAssertEqual((NSUInteger) 4, buffer.valueCount, @"Expected the values before the error");
+
+    PXPathSegmentBufferFree(&buffer);
+}
+
+- (void)testMissingArgumentFails
+{
+    PXPathSegmentBuffer buffer;
+    const char *bytes = "M0 0 L1";
+
+    PXPathSegmentBufferInit(&buffer, strlen(bytes));
+
+    XCTAssertEqual((NSUInteger) 7, PXPathSegmentBufferParse(&buffer, bytes, strlen(bytes)), @"Expected a missing coordinate to fail");
+    XCTAssertEqual((NSUInteger) 1, buffer.count, @"Expected only the move");
+
+    PXPathSegmentBufferFree(&buffer);
+}
+
+#pragma mark - Performance Tests
+
+- (void)testParsePerformance
+{
+    NSArray *paths = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathsForResourcesOfType:@"svg" inDirectory:nil];
+    NSArray *pathData = [self pathDataInFiles:paths];
+    NSUInteger iterations = 20;
+    NSUInteger totalLength = 0;
+
+    for (NSString *data in pathData)
+    {
+        totalLength += data.length;
+    }
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < iterations; i++)
+    {
+        for (NSString *data in pathData)
+        {
+            CGPathRef path = [[self referencePathFromPathData:data] newPath];
+
+            CGPathRelease(path);
+        }
+    }
+
+    double referenceTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < iterations; i++)
+    {
+        for (NSString *data in pathData)
+        {
+            CGPathRef path = [[PXPath createPathFromPathData:data] newPath];
+
+            CGPathRelease(path);
+        }
+    }
+
+    double time = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu paths, %lu characters: NSScanner %f ms, single pass %f ms (%.1fx)", (unsigned long) pathData.count, (unsigned long) totalLength, referenceTime * 1000 / iterations, time * 1000 / iterations, referenceTime / time);
+}
+
+@end
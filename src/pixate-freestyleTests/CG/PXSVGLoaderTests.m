@@ -0,0 +1,186 @@
+//
+//  PXSVGLoaderTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXSVGLoader.h"
+#import "PXSVGTokenizer.h"
+#import "PXShapeDocument.h"
+#import "PXShapeGroup.h"
+#import "PXRectangle.h"
+#import "PXStroke.h"
+
+@interface PXSVGEventRecorder : NSObject <PXSVGTokenizerDelegate>
+@property (nonatomic, strong) NSMutableArray *events;
+@end
+
+@implementation PXSVGEventRecorder
+
+- (id)init
+{
+    if (self = [super init])
+    {
+        _events = [NSMutableArray array];
+    }
+
+    return self;
+}
+
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didStartElement:(PXSVGElementType)type name:(NSString *)name attributes:(PXSVGAttributes *)attributes
+{
+    NSArray *keys = [attributes.allKeys sortedArrayUsingSelector:@selector(compare:)];
+    NSMutableString *event = [NSMutableString stringWithFormat:@"<%@:%d", name, type];
+
+    for (NSString *key in keys)
+    {
+        [event appendFormat:@" %@=%@", key, [attributes objectForKey:key]];
+    }
+
+    [_events addObject:event];
+}
+
+- (void)tokenizer:(PXSVGTokenizer *)tokenizer didEndElement:(PXSVGElementType)type name:(NSString *)name
+{
+    [_events addObject:[NSString stringWithFormat:@"</%@", name]];
+}
+
+@end
+
+@interface PXSVGLoaderTests : XCTestCase
+
+@end
+
+@implementation PXSVGLoaderTests
+
+#pragma mark - Helpers
+
+- (NSArray *)sampleFilePaths
+{
+    return [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathsForResourcesOfType:@"svg" inDirectory:nil];
+}
+
+- (NSArray *)eventsForData:(NSData *)data chunkSize:(NSUInteger)chunkSize
+{
+    PXSVGEventRecorder *recorder = [[PXSVGEventRecorder alloc] init];
+    PXSVGTokenizer *tokenizer = [[PXSVGTokenizer alloc] initWithDelegate:recorder];
+    const char *bytes = data.bytes;
+
+    for (NSUInteger offset = 0; offset < data.length; offset += chunkSize)
+    {
+        [tokenizer appendBytes:bytes + offset length:MIN(chunkSize, data.length - offset)];
+    }
+
+    XCTAssertTrue([tokenizer finish], @"Expected the document to be well-formed");
+
+    return recorder.events;
+}
+
+#pragma mark - Tests
+
+- (void)testAttributesAndStyleMerge
+{
+    NSString *source = @"<?xml version=\"1.0\"?>\n"
+                        "<!DOCTYPE svg [ <!ENTITY ns \"http://www.w3.org/2000/svg\"> ]>\n"
+                        "<svg xmlns=\"&ns;\" viewBox=\"0 0 100 50\">\n"
+                        "  <!-- a <rect> in a comment -->\n"
+                        "  <desc><![CDATA[ <rect/> ]]></desc>\n"
+                        "  <rect id=\"a&amp;b\" x=\"10px\" y='5' width=\"50%\" height=\"20\" fill=\"red\"\n"
+                        "        stroke-width=\"1\" style=\"stroke-width: 3 ; fill:#00ff00;\"/>\n"
+                        "</svg>";
+    PXShapeDocument *document = [PXSVGLoader loadFromData:[source dataUsingEncoding:NSUTF8StringEncoding]];
+    PXShapeGroup *root = (PXShapeGroup *) document.shape;
+    PXRectangle *rectangle = (PXRectangle *) [document shapeForName:@"a&b"];
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(0.0f, 0.0f, 100.0f, 50.0f), root.viewport), @"Expected the viewBox");
+    XCTAssertEqual((NSUInteger) 1, root.shapeCount, @"Expected markup in comments and CDATA to be skipped");
+    XCTAssertNotNil(rectangle, @"Expected the id to be decoded");
+    XCTAssertEqual(10.0f, (float) rectangle.x, @"Expected the px unit to be ignored");
+    XCTAssertEqual(5.0f, (float) rectangle.y, @"Expected single quotes to be accepted");
+    XCTAssertEqual(0.5f, (float) rectangle.width, @"Expected percentages to be fractions");
+    XCTAssertEqual(3.0f, (float) ((PXStroke *) rectangle.stroke).width, @"Expected the style declaration to override the attribute");
+}
+
+- (void)testDictionaryAccess
+{
+    PXSVGAttributes *attributes = [PXSVGAttributes attributesWithDictionary:@{ @"points" : @"1,2 3 4 5", @"xlink:href" : @"#a" }];
+
+    XCTAssertEqual((NSUInteger) 2, attributes.count, @"Expected known and unknown attributes");
+    XCTAssertEqualObjects(@"#a", [attributes objectForKey:@"xlink:href"], @"Expected unknown names to be kept");
+    XCTAssertEqualObjects((@[ @1, @2, @3, @4, @5 ]), [attributes numbersForAttribute:PXSVGAttributePoints], @"Expected a number list");
+    XCTAssertEqualObjects(@"1,2 3 4 5", [attributes objectForKey:@"points"], @"Expected known names to be found by key");
+    XCTAssertNil([attributes objectForKey:@"fill"], @"Expected missing attributes to be nil");
+}
+
+- (void)testMalformedMarkupFails
+{
+    PXSVGEventRecorder *recorder = [[PXSVGEventRecorder alloc] init];
+    PXSVGTokenizer *tokenizer = [[PXSVGTokenizer alloc] initWithDelegate:recorder];
+    const char *source = "<svg><rect x=10/></svg>";
+
+    [tokenizer appendBytes:source length:strlen(source)];
+
+    XCTAssertFalse([tokenizer finish], @"Expected unquoted attribute values to fail");
+    XCTAssertEqual((NSUInteger) 1, recorder.events.count, @"Expected no elements after the error");
+}
+
+- (void)testChunkedInputMatchesWholeInput
+{
+    for (NSString *path in [self sampleFilePaths])
+    {
+        NSData *data = [NSData dataWithContentsOfFile:path];
+        NSArray *whole = [self eventsForData:data chunkSize:data.length];
+
+        XCTAssertTrue(whole.count > 0, @"Expected elements in %@", path.lastPathComponent);
+        XCTAssertEqualObjects(whole, [self eventsForData:data chunkSize:1], @"Expected byte-at-a-time input to match in %@", path.lastPathComponent);
+        XCTAssertEqualObjects(whole, [self eventsForData:data chunkSize:7], @"Expected odd chunk sizes to match in %@", path.lastPathComponent);
+    }
+}
+
+- (void)testStreamMatchesData
+{
+    for (NSString *path in [self sampleFilePaths])
+    {
+        PXShapeDocument *fromData = [PXSVGLoader loadFromData:[NSData dataWithContentsOfFile:path]];
+        PXShapeDocument *fromStream = [PXSVGLoader loadFromURL:[NSURL fileURLWithPath:path]];
+        PXShapeGroup *dataRoot = (PXShapeGroup *) fromData.shape;
+        PXShapeGroup *streamRoot = (PXShapeGroup *) fromStream.shape;
+
+        XCTAssertEqual(dataRoot.shapeCount, streamRoot.shapeCount, @"Expected the same shapes in %@", path.lastPathComponent);
+        XCTAssertTrue(CGRectEqualToRect(dataRoot.viewport, streamRoot.viewport), @"Expected the same viewport in %@", path.lastPathComponent);
+    }
+}
+
+#pragma mark - Performance Tests
+
+- (void)testParseThroughput
+{
+    NSMutableArray *files = [NSMutableArray array];
+    NSUInteger totalBytes = 0;
+    NSUInteger iterations = 20;
+
+    for (NSString *path in [self sampleFilePaths])
+    {
+        NSData *data = [NSData dataWithContentsOfFile:path];
+
+        [files addObject:data];
+        totalBytes += data.length;
+    }
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < iterations; i++)
+    {
+        for (NSData *data in files)
+        {
+            [PXSVGLoader loadFromData:data];
+        }
+    }
+
+    double time = [[NSDate date] timeIntervalSinceNow] - start;
+    double megabytes = (double) (totalBytes * iterations) / (1024.0 * 1024.0);
+
+    NSLog(@"%lu loads of %lu files: %f ms, %f MB/s", (unsigned long) iterations, (unsigned long) files.count, time * 1000, megabytes / time);
+}
+
+@end
@@ -0,0 +1,225 @@
+//
+//  PXShapeCullingTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXRectangle.h"
+#import "PXShapeGroup.h"
+#import "PXShapeDocument.h"
+#import "PXSVGLoader.h"
+#import "PXSolidPaint.h"
+#import "PXStroke.h"
+
+@interface PXShapeCullingTests : XCTestCase
+
+@end
+
+@implementation PXShapeCullingTests
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    [PXShape resetRenderCounts];
+}
+
+#pragma mark - Helpers
+
+- (PXRectangle *)rectangleWithBounds:(CGRect)bounds
+{
+    PXRectangle *result = [[PXRectangle alloc] initWithRect:bounds];
+
+    result.fill = [[PXSolidPaint alloc] initWithColor:[UIColor redColor]];
+
+    return result;
+}
+
+- (PXStroke *)strokeWithWidth:(CGFloat)width
+{
+    PXStroke *result = [[PXStroke alloc] initWithStrokeWidth:width];
+
+    result.color = [[PXSolidPaint alloc] initWithColor:[UIColor blackColor]];
+    result.miterLimit = 1.0;
+
+    return result;
+}
+
+- (PXShapeDocument *)documentForName:(NSString *)name
+{
+    NSString *path = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathForResource:name ofType:@"svg"];
+
+    return [PXSVGLoader loadFromURL:[NSURL fileURLWithPath:path]];
+}
+
+- (void)renderDocument:(PXShapeDocument *)document withSize:(CGSize)size inRect:(CGRect)rect
+{
+    UIGraphicsBeginImageContextWithOptions(size, NO, 1.0);
+
+    CGContextRef context = UIGraphicsGetCurrentContext();
+
+    CGContextClipToRect(context, rect);
+    [document render:context withSize:size];
+
+    UIGraphicsEndImageContext();
+}
+
+#pragma mark - Tests
+
+- (void)testBoundingBoxIncludesTransform
+{
+    PXRectangle *rectangle = [self rectangleWithBounds:CGRectMake(10.0, 20.0, 30.0, 40.0)];
+
+    rectangle.transform = CGAffineTransformMakeTranslation(100.0, 200.0);
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(110.0, 220.0, 30.0, 40.0), rectangle.boundingBox), @"Expected the transform to be applied");
+}
+
+- (void)testBoundingBoxIncludesStroke
+{
+    PXRectangle *rectangle = [self rectangleWithBounds:CGRectMake(10.0, 20.0, 30.0, 40.0)];
+
+    rectangle.stroke = [self strokeWithWidth:4.0];
+
+    // half the width, times the square cap factor
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(7.0, 17.0, 36.0, 46.0), rectangle.boundingBox), @"Expected the stroke to be included");
+}
+
+- (void)testBoundingBoxClearedWhenPathChanges
+{
+    PXRectangle *rectangle = [self rectangleWithBounds:CGRectMake(0.0, 0.0, 10.0, 10.0)];
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(0.0, 0.0, 10.0, 10.0), rectangle.boundingBox), @"Expected the rectangle's box");
+
+    rectangle.width = 50.0;
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(0.0, 0.0, 50.0, 10.0), rectangle.boundingBox), @"Expected the new width");
+}
+
+- (void)testBoundingBoxClearedWhenStrokeWidthChangesInPlace
+{
+    PXRectangle *rectangle = [self rectangleWithBounds:CGRectMake(10.0, 10.0, 10.0, 10.0)];
+    PXShapeGroup *group = [[PXShapeGroup alloc] init];
+    PXStroke *stroke = [self strokeWithWidth:2.0];
+
+    rectangle.stroke = stroke;
+    [group addShape:rectangle];
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(8.5, 8.5, 13.0, 13.0), group.boundingBox), @"Expected the stroked box");
+
+    stroke.width = 4.0;
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(7.0, 7.0, 16.0, 16.0), rectangle.boundingBox), @"Expected the wider stroke");
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(7.0, 7.0, 16.0, 16.0), group.boundingBox), @"Expected the group to follow");
+}
+
+- (void)testGroupBoundingBoxFollowsChildren
+{
+    PXShapeGroup *group = [[PXShapeGroup alloc] init];
+    PXRectangle *first = [self rectangleWithBounds:CGRectMake(0.0, 0.0, 10.0, 10.0)];
+    PXRectangle *second = [self rectangleWithBounds:CGRectMake(90.0, 90.0, 10.0, 10.0)];
+
+    XCTAssertTrue(CGRectIsNull(group.boundingBox), @"Expected an empty group to draw nothing");
+
+    [group addShape:first];
+    [group addShape:second];
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(0.0, 0.0, 100.0, 100.0), group.boundingBox), @"Expected the union of the children");
+
+    second.transform = CGAffineTransformMakeTranslation(100.0, 0.0);
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(0.0, 0.0, 200.0, 100.0), group.boundingBox), @"Expected a child's transform to reach the group");
+
+    second.visible = NO;
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(0.0, 0.0, 10.0, 10.0), group.boundingBox), @"Expected hidden children to be left out");
+
+    [group removeShape:first];
+
+    XCTAssertTrue(CGRectIsNull(group.boundingBox), @"Expected nothing to be drawn");
+}
+
+- (void)testClippingPathLimitsBoundingBox
+{
+    PXRectangle *rectangle = [self rectangleWithBounds:CGRectMake(0.0, 0.0, 100.0, 100.0)];
+
+    rectangle.clippingPath = [self rectangleWithBounds:CGRectMake(25.0, 25.0, 10.0, 10.0)];
+
+    XCTAssertTrue(CGRectEqualToRect(CGRectMake(25.0, 25.0, 10.0, 10.0), rectangle.boundingBox), @"Expected the clip to be applied");
+}
+
+- (void)testShapesOutsideOfClipAreCulled
+{
+    PXShapeGroup *group = [[PXShapeGroup alloc] init];
+
+    [group addShape:[self rectangleWithBounds:CGRectMake(0.0, 0.0, 10.0, 10.0)]];
+    [group addShape:[self rectangleWithBounds:CGRectMake(80.0, 80.0, 10.0, 10.0)]];
+
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(100.0, 100.0), NO, 1.0);
+
+    CGContextRef context = UIGraphicsGetCurrentContext();
+
+    CGContextClipToRect(context, CGRectMake(0.0, 0.0, 20.0, 20.0));
+    [group render:context];
+
+    UIGraphicsEndImageContext();
+
+    XCTAssertEqual((NSUInteger) 2, [PXShape renderedShapeCount], @"Expected the group and the first rectangle to be rendered");
+    XCTAssertEqual((NSUInteger) 1, [PXShape culledShapeCount], @"Expected the second rectangle to be culled");
+}
+
+- (void)testDirtyRectCullsLion
+{
+    PXShapeDocument *document = [self documentForName:@"lion"];
+    CGSize size = CGSizeMake(242.0, 383.0);
+
+    [self renderDocument:document withSize:size inRect:CGRectMake(0.0, 0.0, size.width, size.height)];
+
+    NSUInteger fullCount = [PXShape renderedShapeCount];
+
+    [PXShape resetRenderCounts];
+    [self renderDocument:document withSize:size inRect:CGRectMake(0.0, 0.0, 40.0, 40.0)];
+
+    XCTAssertTrue([PXShape renderedShapeCount] < fullCount, @"Expected fewer shapes to be rendered in a corner");
+    XCTAssertTrue([PXShape culledShapeCount] > 0, @"Expected shapes outside of the corner to be culled");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testDirtyRectRendering
+{
+    NSArray *names = @[@"lion", @"toucan", @"people", @"logos", @"wood"];
+
+    for (NSString *name in names)
+    {
+        PXShapeDocument *document = [self documentForName:name];
+        CGRect viewport = ((PXShapeGroup *) document.shape).viewport;
+        CGSize size = (CGRectIsEmpty(viewport)) ? CGSizeMake(100.0, 100.0) : viewport.size;
+        CGRect quarter = CGRectMake(0.0, 0.0, size.width * 0.5, size.height * 0.5);
+
+        [document buildPaths];
+        [PXShape resetRenderCounts];
+
+        double start = [[NSDate date] timeIntervalSinceNow];
+        [self renderDocument:document withSize:size inRect:CGRectMake(0.0, 0.0, size.width, size.height)];
+        double fullTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+        NSUInteger fullRendered = [PXShape renderedShapeCount];
+        NSUInteger fullCulled = [PXShape culledShapeCount];
+
+        [PXShape resetRenderCounts];
+
+        start = [[NSDate date] timeIntervalSinceNow];
+        [self renderDocument:document withSize:size inRect:quarter];
+        double quarterTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+        NSLog(@"%@: full %f ms (%lu drawn, %lu culled), quarter %f ms (%lu drawn, %lu culled)",
+              name,
+              fullTime * 1000, (unsigned long) fullRendered, (unsigned long) fullCulled,
+              quarterTime * 1000, (unsigned long) [PXShape renderedShapeCount], (unsigned long) [PXShape culledShapeCount]);
+    }
+}
+
+@end
@@ -0,0 +1,162 @@
+//
+//  PXShapeDocumentCacheTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXSVGLoader.h"
+#import "PXShapeDocument.h"
+#import "PXImagePaint.h"
+#import "PXCacheManager.h"
+
+static NSString *SQUARE_SVG = @"<svg viewBox=\"0 0 10 10\"><rect x=\"0\" y=\"0\" width=\"10\" height=\"10\" fill=\"%@\"/></svg>";
+
+@interface PXImagePaint (PXShapeDocumentCacheTests)
+- (UIImage *)imageForBounds:(CGRect)bounds;
+@end
+
+@interface PXShapeDocumentCacheTests : XCTestCase
+
+@end
+
+@implementation PXShapeDocumentCacheTests
+{
+    NSUInteger shapeDocumentCacheSize_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    shapeDocumentCacheSize_ = [PXCacheManager shapeDocumentCacheSize];
+
+    [PXCacheManager clearShapeDocumentCache];
+    [PXCacheManager resetShapeDocumentCacheStatistics];
+}
+
+- (void)tearDown
+{
+    [PXCacheManager setShapeDocumentCacheSize:shapeDocumentCacheSize_];
+    [PXCacheManager clearShapeDocumentCache];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (NSURL *)sampleURL
+{
+    NSString *path = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathForResource:@"icon1" ofType:@"svg"];
+
+    return [NSURL fileURLWithPath:path];
+}
+
+- (NSURL *)temporaryFileWithFill:(NSString *)fill
+{
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"PXShapeDocumentCacheTests.svg"];
+    NSString *source = [NSString stringWithFormat:SQUARE_SVG, fill];
+
+    [source writeToFile:path atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+
+    return [NSURL fileURLWithPath:path];
+}
+
+#pragma mark - Tests
+
+- (void)testFiftySizesParseOnce
+{
+    PXImagePaint *paint = [[PXImagePaint alloc] initWithURL:[self sampleURL]];
+
+    for (NSUInteger i = 0; i < 50; i++)
+    {
+        CGRect bounds = CGRectMake(0.0f, 0.0f, 16.0f + i * 4, 16.0f + i * 3);
+        UIImage *image = [paint imageForBounds:bounds];
+
+        XCTAssertTrue(CGSizeEqualToSize(bounds.size, image.size), @"Expected an image of the requested size");
+    }
+
+    XCTAssertEqual((NSUInteger) 1, [PXCacheManager shapeDocumentCacheMissCount], @"Expected the file to be parsed once");
+    XCTAssertEqual((NSUInteger) 49, [PXCacheManager shapeDocumentCacheHitCount], @"Expected every other size to share it");
+    XCTAssertEqual((NSUInteger) 1, [PXCacheManager shapeDocumentCacheCount], @"Expected one cached document");
+    XCTAssertTrue([PXCacheManager shapeDocumentCacheUsage] > 0, @"Expected the document to have a cost");
+}
+
+- (void)testSharedRenderingMatchesDocumentBounds
+{
+    CGRect bounds = CGRectMake(0.0f, 0.0f, 64.0f, 40.0f);
+    PXShapeDocument *document = [PXSVGLoader loadFromURL:[self sampleURL]];
+    PXShapeDocument *shared = [PXSVGLoader sharedDocumentForURL:[self sampleURL]];
+
+    document.bounds = bounds;
+
+    NSData *expected = UIImagePNGRepresentation([document renderToImageWithBounds:bounds withOpacity:NO]);
+    NSData *actual = UIImagePNGRepresentation([shared renderToImageWithSize:bounds.size withOpacity:NO]);
+
+    XCTAssertEqualObjects(expected, actual, @"Expected fitting the viewport to a size to match setting the bounds");
+    XCTAssertTrue(CGRectEqualToRect(CGRectZero, shared.bounds), @"Expected the shared document to be left unchanged");
+}
+
+- (void)testModifiedFileIsParsedAgain
+{
+    NSURL *URL = [self temporaryFileWithFill:@"red"];
+    PXShapeDocument *first = [PXSVGLoader sharedDocumentForURL:URL];
+
+    XCTAssertEqual(first, [PXSVGLoader sharedDocumentForURL:URL], @"Expected an unchanged file to be shared");
+
+    [self temporaryFileWithFill:@"blue"];
+    [[NSFileManager defaultManager] setAttributes:@{ NSFileModificationDate : [NSDate dateWithTimeIntervalSinceNow:60.0] }
+                                     ofItemAtPath:URL.path
+                                            error:NULL];
+
+    XCTAssertNotEqual(first, [PXSVGLoader sharedDocumentForURL:URL], @"Expected a modified file to be parsed again");
+    XCTAssertEqual((NSUInteger) 2, [PXCacheManager shapeDocumentCacheMissCount], @"Expected two parses");
+
+    [[NSFileManager defaultManager] removeItemAtURL:URL error:NULL];
+}
+
+- (void)testSizeLimitEvicts
+{
+    [PXCacheManager setShapeDocumentCacheSize:1];
+
+    PXShapeDocument *document = [PXSVGLoader sharedDocumentForURL:[self sampleURL]];
+
+    XCTAssertNotNil(document, @"Expected documents over the limit to still be returned");
+    XCTAssertEqual((NSUInteger) 0, [PXCacheManager shapeDocumentCacheCount], @"Expected the document not to be kept");
+    XCTAssertTrue([PXCacheManager shapeDocumentCacheEvictionCount] > 0, @"Expected an eviction");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testRenderingManySizes
+{
+    NSURL *URL = [self sampleURL];
+    NSUInteger sizes = 50;
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < sizes; i++)
+    {
+        CGRect bounds = CGRectMake(0.0f, 0.0f, 16.0f + i, 16.0f + i);
+        PXShapeDocument *document = [PXSVGLoader loadFromURL:URL];
+
+        document.bounds = bounds;
+        [document renderToImageWithBounds:bounds withOpacity:NO];
+    }
+
+    double parseEachTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < sizes; i++)
+    {
+        [[PXSVGLoader sharedDocumentForURL:URL] renderToImageWithSize:CGSizeMake(16.0f + i, 16.0f + i) withOpacity:NO];
+    }
+
+    double sharedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu sizes: parse each %f ms, shared %f ms", (unsigned long) sizes, parseEachTime * 1000, sharedTime * 1000);
+}
+
+@end
@@ -0,0 +1,221 @@
+//
+//  PXTiledRasterizerTests.m
+//  Pixate
+//
+
+#import "ImageBasedTests.h"
+#import <XCTest/XCTest.h>
+#import "PXTiledRasterizer.h"
+#import "PXSVGLoader.h"
+#import "PXShapeDocument.h"
+#import "PXShapeGroup.h"
+
+@interface PXTiledRasterizerTests : ImageBasedTests
+
+@end
+
+@implementation PXTiledRasterizerTests
+{
+    BOOL enabled_;
+    NSUInteger tileSize_;
+    NSUInteger minimumPixelCount_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    enabled_ = rasterizer.enabled;
+    tileSize_ = rasterizer.tileSize;
+    minimumPixelCount_ = rasterizer.minimumPixelCount;
+
+    // use small tiles, so even the small samples are split and culled
+    rasterizer.tileSize = 64;
+    rasterizer.minimumPixelCount = 0;
+    [rasterizer resetCounters];
+    [PXShape resetRenderCounts];
+}
+
+- (void)tearDown
+{
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    rasterizer.enabled = enabled_;
+    rasterizer.tileSize = tileSize_;
+    rasterizer.minimumPixelCount = minimumPixelCount_;
+
+    [super tearDown];
+}
+
+- (NSString *)rasterImageDirectoryName
+{
+    return @"SVG-Rendering";
+}
+
+#pragma mark - Helpers
+
+- (PXShapeDocument *)documentForName:(NSString *)name
+{
+    NSString *path = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathForResource:name ofType:@"svg"];
+
+    return [PXSVGLoader loadFromURL:[NSURL fileURLWithPath:path]];
+}
+
+- (CGSize)sizeOfDocument:(PXShapeDocument *)document scale:(CGFloat)scale
+{
+    CGRect viewport = ((PXShapeGroup *) document.shape).viewport;
+
+    if (CGRectIsEmpty(viewport))
+    {
+        viewport = CGRectMake(0.0, 0.0, 100.0, 100.0);
+    }
+
+    return CGSizeMake(viewport.size.width * scale, viewport.size.height * scale);
+}
+
+- (void)assertTiledImageMatchesSerialImageForName:(NSString *)name scale:(CGFloat)scale
+{
+    PXShapeDocument *document = [self documentForName:name];
+    CGSize size = [self sizeOfDocument:document scale:scale];
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    rasterizer.enabled = NO;
+    UIImage *serial = [document renderToImageWithSize:size withOpacity:NO];
+
+    rasterizer.enabled = YES;
+    UIImage *tiled = [document renderToImageWithSize:size withOpacity:NO];
+
+    XCTAssertNotNil(serial, @"Expected a serial image of %@", name);
+    XCTAssertNotNil(tiled, @"Expected a tiled image of %@", name);
+
+    [self assertImage:tiled equalsImage:serial];
+}
+
+#pragma mark - Tests
+
+- (void)testLion
+{
+    [self assertTiledImageMatchesSerialImageForName:@"lion" scale:2.0];
+
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    XCTAssertEqual((NSUInteger) 1, rasterizer.imageCount, @"Expected the image to be tiled");
+    XCTAssertTrue(rasterizer.tileCount > 1, @"Expected several tiles");
+    XCTAssertTrue([PXShape culledShapeCount] > 0, @"Expected shapes outside of a tile to be culled");
+}
+
+- (void)testToucan
+{
+    [self assertTiledImageMatchesSerialImageForName:@"toucan" scale:2.0];
+}
+
+- (void)testPeople
+{
+    [self assertTiledImageMatchesSerialImageForName:@"people" scale:1.0];
+}
+
+- (void)testLogos
+{
+    [self assertTiledImageMatchesSerialImageForName:@"logos" scale:1.0];
+}
+
+- (void)testLinearGradient
+{
+    [self assertTiledImageMatchesSerialImageForName:@"linear-gradient" scale:3.0];
+}
+
+- (void)testRadialGradient
+{
+    [self assertTiledImageMatchesSerialImageForName:@"radial-gradient" scale:3.0];
+}
+
+- (void)testClippingPath
+{
+    [self assertTiledImageMatchesSerialImageForName:@"clipping-path" scale:3.0];
+}
+
+- (void)testLineJoins
+{
+    [self assertTiledImageMatchesSerialImageForName:@"line-join" scale:3.0];
+}
+
+- (void)testFractionalSize
+{
+    // tiles at the right and bottom edges are partial
+    PXShapeDocument *document = [self documentForName:@"lion"];
+    CGSize size = CGSizeMake(301.5, 217.25);
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    rasterizer.enabled = NO;
+    UIImage *serial = [document renderToImageWithSize:size withOpacity:YES];
+
+    rasterizer.enabled = YES;
+    UIImage *tiled = [document renderToImageWithSize:size withOpacity:YES];
+
+    [self assertImage:tiled equalsImage:serial];
+}
+
+- (void)testTextIsRenderedSerially
+{
+    PXShapeDocument *document = [self documentForName:@"text"];
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    rasterizer.enabled = YES;
+
+    UIImage *image = [rasterizer imageOfRenderable:document
+                                        withBounds:CGRectMake(0.0, 0.0, 200.0, 200.0)
+                                       withOpacity:NO
+                                        usingBlock:^(CGContextRef context) {
+                                            [document render:context];
+                                        }];
+
+    XCTAssertNil(image, @"Expected text to be left to serial rendering");
+    XCTAssertEqual((NSUInteger) 0, rasterizer.imageCount, @"Expected no tiled images");
+}
+
+- (void)testDisabled
+{
+    PXShapeDocument *document = [self documentForName:@"lion"];
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    rasterizer.enabled = NO;
+
+    XCTAssertNotNil([document renderToImageWithSize:CGSizeMake(242.0, 383.0) withOpacity:NO], @"Expected an image");
+    XCTAssertEqual((NSUInteger) 0, rasterizer.imageCount, @"Expected no tiled images");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testLargeImage
+{
+    PXShapeDocument *document = [self documentForName:@"lion"];
+    CGSize size = [self sizeOfDocument:document scale:8.0];
+    PXTiledRasterizer *rasterizer = [PXTiledRasterizer sharedInstance];
+
+    rasterizer.tileSize = 256;
+
+    // build the paths before timing either
+    [document renderToImageWithSize:CGSizeMake(1.0, 1.0) withOpacity:NO];
+
+    rasterizer.enabled = NO;
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+    [document renderToImageWithSize:size withOpacity:NO];
+    double serialTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    rasterizer.enabled = YES;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+    [document renderToImageWithSize:size withOpacity:NO];
+    double tiledTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%.0fx%.0f lion: serial %f ms, tiled %f ms (%lu tiles, %lu culled)",
+          size.width, size.height, serialTime * 1000, tiledTime * 1000,
+          (unsigned long) rasterizer.tileCount, (unsigned long) [PXShape culledShapeCount]);
+}
+
+@end
@@ -13,6 +13,7 @@
 #import "PXDeclaration.h"
 #import "PXStylerContext.h"
 #import "PXStyleUtils.h"
+#import "PXStyleableAtoms.h"
 
 @implementation PXDOMElement
 {
@@ -21,6 +22,7 @@
     NSMutableArray *attributeNames_;
     NSMutableDictionary *prefixes_;
     NSMutableArray *prefixNames_;
+    PXStyleableAtoms *atoms_;
 }
 
 @synthesize namespacePrefix = namespacePrefix_;
@@ -102,6 +104,9 @@
 {
     if (name && value)
     {
+        // the id or class may be changing
+        atoms_ = nil;
+
         PXDOMAttribute *attribute = [[PXDOMAttribute alloc] initWithName:name value:value];
 
         if ([attribute.namespacePrefix isEqualToString:@"xmlns"])
@@ -329,6 +334,28 @@
     [self setAttributeValue:styleClass forName:@"class"];
 }
 
+- (NSArray *)styleClasses
+{
+    NSMutableArray *classes = [[self.styleClass componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]] mutableCopy];
+
+    [classes removeObject:@""];
+
+    return classes;
+}
+
+- (PXStyleableAtoms *)pxStyleAtoms
+{
+    if (atoms_ == nil || atoms_.elementNameString != self.name)
+    {
+        atoms_ = [[PXStyleableAtoms alloc] initWithElementName:self.name
+                                                       styleId:self.styleId
+                                                  styleClasses:self.styleClasses
+                                                        intern:YES];
+    }
+
+    return atoms_;
+}
+
 - (NSArray *)pxStyleChildren
 {
     return self.children;
@@ -8,6 +8,7 @@
 
 #import "PXDOMText.h"
 #import "PXStyleUtils.h"
+#import "PXStyleableAtoms.h"
 
 @implementation PXDOMText
 {
@@ -88,6 +89,19 @@
     return @"#text";
 }
 
+- (PXStyleableAtoms *)pxStyleAtoms
+{
+    // every text node has the same element name, id, and classes
+    static PXStyleableAtoms *atoms = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        atoms = [[PXStyleableAtoms alloc] initWithElementName:@"#text" styleId:nil styleClasses:nil intern:YES];
+    });
+
+    return atoms;
+}
+
 - (id)pxStyleParent
 {
     return self.parent;
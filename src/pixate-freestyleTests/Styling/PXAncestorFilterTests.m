@@ -0,0 +1,218 @@
+//
+//  PXAncestorFilterTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXAncestorFilter.h"
+#import "PXStyleUtils.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+#import "PXDOMElement.h"
+
+@interface PXAncestorFilterTests : XCTestCase
+
+@end
+
+@implementation PXAncestorFilterTests
+
+#pragma mark - Helpers
+
+- (id<PXSelector>)selectorFromSource:(NSString *)source
+{
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:[NSString stringWithFormat:@"%@ {}", source]
+                                                             withOrigin:PXStylesheetOriginApplication
+                                                               filename:nil];
+    PXRuleSet *ruleSet = [stylesheet.ruleSets objectAtIndex:0];
+
+    return [ruleSet.selectors objectAtIndex:0];
+}
+
+- (PXDOMElement *)treeWithNodeCount:(NSUInteger)count
+{
+    NSArray *names = @[ @"view", @"button", @"label", @"table-view", @"cell" ];
+    PXDOMElement *root = [[PXDOMElement alloc] initWithName:@"window"];
+    NSMutableArray *parents = [NSMutableArray arrayWithObject:root];
+    NSUInteger created = 1;
+
+    // three children per node gives a tree about nine levels deep
+    while (created < count)
+    {
+        PXDOMElement *parent = [parents objectAtIndex:0];
+
+        [parents removeObjectAtIndex:0];
+
+        for (NSUInteger i = 0; i < 3 && created < count; i++, created++)
+        {
+            PXDOMElement *child = [[PXDOMElement alloc] initWithName:[names objectAtIndex:created % names.count]];
+
+            child.styleClass = [NSString stringWithFormat:@"row-%lu", (unsigned long) (created % 50)];
+
+            if (created % 97 == 0)
+            {
+                child.styleId = [NSString stringWithFormat:@"item-%lu", (unsigned long) created];
+            }
+
+            [parent addChild:child];
+            [parents addObject:child];
+        }
+    }
+
+    return root;
+}
+
+- (NSArray *)ruleSetsWithCount:(NSUInteger)count
+{
+    NSMutableString *source = [NSMutableString string];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        // panels never occur in the tree, so these can only be rejected by walking to the root
+        [source appendFormat:@".panel-%lu label { color: red; }\n", (unsigned long) i];
+        [source appendFormat:@"#item-%lu > button { color: red; }\n", (unsigned long) (i * 97)];
+        [source appendFormat:@"table-view .row-%lu button { color: red; }\n", (unsigned long) (i % 50)];
+    }
+
+    return [PXStylesheet parsedStyleSheetFromSource:source withOrigin:PXStylesheetOriginApplication filename:nil].ruleSets;
+}
+
+#pragma mark - Tests
+
+- (void)testAncestorKeys
+{
+    XCTAssertNil([PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:@"button"]], @"Expected no keys for a type selector");
+    XCTAssertNil([PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:@"* button"]], @"Expected no keys for a universal ancestor");
+    XCTAssertNil([PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:@"label + button"]], @"Expected no keys for a sibling");
+
+    XCTAssertEqual((NSUInteger) 4, [PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:@"view button"]].length, @"Expected one key");
+    XCTAssertEqual((NSUInteger) 12, [PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:@"view#a.b > button"]].length, @"Expected three keys");
+    XCTAssertEqual((NSUInteger) 4, [PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:@"window view + button"]].length, @"Expected only the ancestor of the sibling");
+}
+
+- (void)testFilterContainsAncestors
+{
+    PXDOMElement *root = [[PXDOMElement alloc] initWithName:@"window"];
+    PXDOMElement *view = [[PXDOMElement alloc] initWithName:@"view"];
+    PXDOMElement *button = [[PXDOMElement alloc] initWithName:@"button"];
+
+    view.styleId = @"main";
+    view.styleClass = @"panel  dark";
+    [root addChild:view];
+    [view addChild:button];
+
+    PXAncestorFilter *filter = [[PXAncestorFilter alloc] initWithAncestorsOfStyleable:button];
+
+    XCTAssertEqual(view, filter.parent, @"Expected the button's parent");
+
+    for (NSString *source in @[ @"window button", @"view > button", @"#main button", @".panel.dark button", @"window view#main.panel > button" ])
+    {
+        XCTAssertTrue([filter mightContainKeys:[PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:source]]], @"Expected '%@' to pass the filter", source);
+    }
+
+    for (NSString *source in @[ @"button button", @"#panel button", @".main button" ])
+    {
+        XCTAssertFalse([filter mightContainKeys:[PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:source]]], @"Expected '%@' to be rejected", source);
+    }
+
+    // a filter built from its parent's filter matches one built by walking ancestors
+    PXAncestorFilter *rootFilter = [[PXAncestorFilter alloc] initWithAncestorsOfStyleable:view];
+    PXAncestorFilter *childFilter = [[PXAncestorFilter alloc] initWithParentFilter:rootFilter parent:view];
+
+    XCTAssertTrue([childFilter mightContainKeys:[PXAncestorFilter ancestorKeysForSelector:[self selectorFromSource:@"window #main .dark button"]]], @"Expected all ancestors");
+}
+
+- (void)testCombinatorsOnlyUseFilterDuringTraversal
+{
+    PXDOMElement *root = [[PXDOMElement alloc] initWithName:@"window"];
+    PXDOMElement *button = [[PXDOMElement alloc] initWithName:@"button"];
+    id<PXSelector> selector = [self selectorFromSource:@"window button"];
+
+    [root addChild:button];
+
+    // an empty filter rejects everything, but only applies to the styleable being visited
+    PXAncestorFilter *emptyFilter = [[PXAncestorFilter alloc] initWithParentFilter:nil parent:nil];
+
+    [PXAncestorFilter visitStyleable:button withFilter:emptyFilter usingBlock:^{
+        XCTAssertFalse([selector matches:button], @"Expected the active filter to reject");
+        XCTAssertNil([PXAncestorFilter activeFilterForStyleable:root], @"Expected no filter for other styleables");
+    }];
+
+    XCTAssertTrue([selector matches:button], @"Expected a match outside of a visit");
+    XCTAssertNil([PXAncestorFilter activeFilterForStyleable:button], @"Expected the filter to be cleared");
+}
+
+- (void)testTraversalMatchesUnfilteredMatching
+{
+    PXDOMElement *root = [self treeWithNodeCount:500];
+    NSArray *ruleSets = [self ruleSetsWithCount:20];
+    NSMutableArray *nodes = [NSMutableArray array];
+    __block NSUInteger filteredCount = 0;
+    NSUInteger unfilteredCount = 0;
+
+    [PXStyleUtils enumerateStyleableAndDescendants:root usingBlock:^(id obj, BOOL *stop, BOOL *stopDescending) {
+        [nodes addObject:obj];
+
+        for (PXRuleSet *ruleSet in ruleSets)
+        {
+            if ([ruleSet matches:obj]) filteredCount++;
+        }
+    }];
+
+    for (id node in nodes)
+    {
+        for (PXRuleSet *ruleSet in ruleSets)
+        {
+            if ([ruleSet matches:node]) unfilteredCount++;
+        }
+    }
+
+    XCTAssertEqual((NSUInteger) 500, nodes.count, @"Expected every node to be visited");
+    XCTAssertTrue(unfilteredCount > 0, @"Expected some matches");
+    XCTAssertEqual(unfilteredCount, filteredCount, @"Expected filtered matching to agree with unfiltered matching");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testTenThousandNodeTree
+{
+    PXDOMElement *root = [self treeWithNodeCount:10000];
+    NSArray *ruleSets = [self ruleSetsWithCount:100];
+    NSMutableArray *nodes = [NSMutableArray array];
+
+    [PXStyleUtils enumerateStyleableAndDescendants:root usingBlock:^(id obj, BOOL *stop, BOOL *stopDescending) {
+        [nodes addObject:obj];
+    }];
+
+    // without a traversal no filter is active, so every combinator walks its parents
+    NSUInteger unfilteredCount = 0;
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (id node in nodes)
+    {
+        for (PXRuleSet *ruleSet in ruleSets)
+        {
+            if ([ruleSet matches:node]) unfilteredCount++;
+        }
+    }
+
+    double unfilteredTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    __block NSUInteger filteredCount = 0;
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    [PXStyleUtils enumerateStyleableAndDescendants:root usingBlock:^(id obj, BOOL *stop, BOOL *stopDescending) {
+        for (PXRuleSet *ruleSet in ruleSets)
+        {
+            if ([ruleSet matches:obj]) filteredCount++;
+        }
+    }];
+
+    double filteredTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertEqual(unfilteredCount, filteredCount, @"Expected filtered matching to agree with unfiltered matching");
+
+    NSLog(@"%lu nodes x %lu rule sets: parent walk = %f ms, ancestor filter = %f ms", (unsigned long) nodes.count, (unsigned long) ruleSets.count, unfilteredTime * 1000, filteredTime * 1000);
+}
+
+@end
@@ -0,0 +1,255 @@
+//
+//  PXAtomTableTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXAtomTable.h"
+#import "PXAtomDictionary.h"
+#import "PXStyleableAtoms.h"
+#import "PXVirtualStyleableControl.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+#import "PXDeclaration.h"
+#import "PXDOMElement.h"
+
+/**
+ *  A DOM element that does not cache its atoms, so every lookup converts its strings
+ */
+@interface PXUncachedAtomsDOMElement : PXDOMElement
+@end
+
+@implementation PXUncachedAtomsDOMElement
+
+- (BOOL)respondsToSelector:(SEL)aSelector
+{
+    return (aSelector == @selector(pxStyleAtoms)) ? NO : [super respondsToSelector:aSelector];
+}
+
+@end
+
+@interface PXAtomTableTests : XCTestCase
+
+@end
+
+@implementation PXAtomTableTests
+
+#pragma mark - Helpers
+
+- (NSArray *)elementsWithCount:(NSUInteger)count class:(Class)elementClass
+{
+    NSArray *names = @[ @"view", @"button", @"label", @"table-view", @"cell" ];
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity:count];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        PXDOMElement *element = [[elementClass alloc] initWithName:[names objectAtIndex:i % names.count]];
+
+        element.styleClass = [NSString stringWithFormat:@"row-%lu group-%lu", (unsigned long) (i % 50), (unsigned long) (i % 7)];
+
+        if (i % 13 == 0)
+        {
+            element.styleId = [NSString stringWithFormat:@"item-%lu", (unsigned long) i];
+        }
+
+        [result addObject:element];
+    }
+
+    return result;
+}
+
+- (PXStylesheet *)stylesheetWithCount:(NSUInteger)count
+{
+    NSMutableString *source = [NSMutableString string];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [source appendFormat:@"button.row-%lu { color: red; }\n", (unsigned long) (i % 50)];
+        [source appendFormat:@"#item-%lu { color: red; }\n", (unsigned long) (i * 13)];
+        [source appendFormat:@"label.group-%lu.row-%lu { color: red; }\n", (unsigned long) (i % 7), (unsigned long) (i % 50)];
+    }
+
+    return [PXStylesheet parsedStyleSheetFromSource:source withOrigin:PXStylesheetOriginApplication filename:nil];
+}
+
+#pragma mark - Tests
+
+- (void)testInterning
+{
+    PXAtom atom = [PXAtomTable atomForString:@"atom-table-test"];
+    NSString *copy = [NSMutableString stringWithString:@"atom-table-test"];
+
+    XCTAssertTrue(atom != PXAtomNone, @"Expected an atom");
+    XCTAssertEqual(atom, [PXAtomTable atomForString:copy], @"Expected equal strings to share an atom");
+    XCTAssertEqual(atom, [PXAtomTable existingAtomForString:copy], @"Expected to find the atom");
+    XCTAssertEqualObjects(@"atom-table-test", [PXAtomTable stringForAtom:atom], @"Expected the original string");
+    XCTAssertTrue(atom != [PXAtomTable atomForString:@"atom-table-test-2"], @"Expected different strings to have different atoms");
+
+    XCTAssertEqual(PXAtomNone, [PXAtomTable atomForString:nil], @"Expected no atom for nil");
+    XCTAssertEqual(PXAtomNone, [PXAtomTable atomForString:@""], @"Expected no atom for an empty string");
+    XCTAssertNil([PXAtomTable stringForAtom:PXAtomNone], @"Expected no string for PXAtomNone");
+}
+
+- (void)testExistingAtomDoesNotIntern
+{
+    NSUInteger count = [PXAtomTable atomCount];
+
+    XCTAssertEqual(PXAtomNone, [PXAtomTable existingAtomForString:@"atom-table-never-interned"], @"Expected no atom");
+    XCTAssertEqual(count, [PXAtomTable atomCount], @"Expected the table to be unchanged");
+}
+
+- (void)testConcurrentInterning
+{
+    NSUInteger count = 200;
+    PXAtom *atoms = calloc(count * 8, sizeof(PXAtom));
+
+    dispatch_apply(count * 8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        atoms[i] = [PXAtomTable atomForString:[NSString stringWithFormat:@"concurrent-%lu", (unsigned long) (i % count)]];
+    });
+
+    for (NSUInteger i = 0; i < count * 8; i++)
+    {
+        XCTAssertEqual(atoms[i % count], atoms[i], @"Expected every thread to get the same atom");
+        XCTAssertEqualObjects(([NSString stringWithFormat:@"concurrent-%lu", (unsigned long) (i % count)]), [PXAtomTable stringForAtom:atoms[i]], @"Expected the atom's string");
+    }
+
+    free(atoms);
+}
+
+- (void)testStyleableAtoms
+{
+    PXAtom a = [PXAtomTable atomForString:@"atoms-a"];
+    PXAtom b = [PXAtomTable atomForString:@"atoms-b"];
+    PXStyleableAtoms *atoms = [[PXStyleableAtoms alloc] initWithElementName:@"button"
+                                                                    styleId:@"atoms-id"
+                                                               styleClasses:@[ @"atoms-b", @"atoms-never-interned", @"atoms-a" ]
+                                                                     intern:NO];
+
+    XCTAssertEqual([PXAtomTable atomForString:@"button"], atoms.elementName, @"Expected the element name atom");
+    XCTAssertEqual(PXAtomNone, atoms.styleId, @"Expected no atom for an id that was not interned");
+    XCTAssertEqual((NSUInteger) 2, atoms.styleClassCount, @"Expected classes that were not interned to be left out");
+    XCTAssertEqual(MIN(a, b), atoms.styleClasses[0], @"Expected sorted classes");
+    XCTAssertTrue([atoms containsStyleClass:a], @"Expected class a");
+    XCTAssertTrue([atoms containsStyleClass:b], @"Expected class b");
+    XCTAssertFalse([atoms containsStyleClass:PXAtomNone], @"Expected PXAtomNone to never match");
+}
+
+- (void)testCachedAtomsFollowChanges
+{
+    PXDOMElement *element = [[PXDOMElement alloc] initWithName:@"button"];
+
+    element.styleClass = @"before";
+
+    PXStyleableAtoms *atoms = element.pxStyleAtoms;
+
+    XCTAssertTrue(atoms == element.pxStyleAtoms, @"Expected cached atoms");
+    XCTAssertTrue([atoms containsStyleClass:[PXAtomTable atomForString:@"before"]], @"Expected the class");
+
+    element.styleId = @"after";
+
+    XCTAssertTrue(atoms != element.pxStyleAtoms, @"Expected changes to replace the cached atoms");
+    XCTAssertEqual([PXAtomTable atomForString:@"after"], element.pxStyleAtoms.styleId, @"Expected the new id");
+}
+
+- (void)testVirtualControlCachesAtoms
+{
+    PXVirtualStyleableControl *control = [[PXVirtualStyleableControl alloc] initWithParent:nil elementName:@"icon"];
+
+    control.styleClass = @"before";
+
+    PXStyleableAtoms *atoms = control.pxStyleAtoms;
+
+    XCTAssertTrue(atoms == [PXStyleableAtoms atomsForStyleable:control], @"Expected cached atoms");
+    XCTAssertTrue([atoms containsStyleClass:[PXAtomTable atomForString:@"before"]], @"Expected the class");
+
+    control.styleId = @"after";
+
+    XCTAssertTrue(atoms != control.pxStyleAtoms, @"Expected changes to replace the cached atoms");
+    XCTAssertEqual([PXAtomTable atomForString:@"after"], control.pxStyleAtoms.styleId, @"Expected the new id");
+}
+
+- (void)testAtomDictionary
+{
+    NSDictionary *dictionary = @{ @"color" : @"ColorStyler", @"font-size" : @"FontStyler" };
+    PXAtomDictionary *atomDictionary = [PXAtomDictionary atomDictionaryForDictionary:dictionary];
+
+    XCTAssertTrue(atomDictionary == [PXAtomDictionary atomDictionaryForDictionary:dictionary], @"Expected the cached instance");
+    XCTAssertEqualObjects(@"ColorStyler", [atomDictionary objectForAtom:[PXAtomTable atomForString:@"color"]], @"Expected the color styler");
+    XCTAssertEqualObjects(@"FontStyler", [atomDictionary objectForAtom:[PXAtomTable atomForString:@"font-size"]], @"Expected the font styler");
+    XCTAssertNil([atomDictionary objectForAtom:[PXAtomTable atomForString:@"atom-dictionary-missing"]], @"Expected no styler");
+    XCTAssertNil([atomDictionary objectForAtom:PXAtomNone], @"Expected no styler for PXAtomNone");
+}
+
+- (void)testDeclarationLookup
+{
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:@"button { color: red; font-size: 12; }"
+                                                             withOrigin:PXStylesheetOriginApplication
+                                                               filename:nil];
+    PXRuleSet *ruleSet = [stylesheet.ruleSets objectAtIndex:0];
+    PXDeclaration *declaration = [ruleSet declarationForName:@"font-size"];
+
+    XCTAssertEqualObjects(@"font-size", declaration.name, @"Expected the font-size declaration");
+    XCTAssertEqual([PXAtomTable atomForString:@"font-size"], declaration.nameAtom, @"Expected the name atom");
+    XCTAssertNil([ruleSet declarationForName:@"declaration-lookup-missing"], @"Expected no declaration");
+
+    declaration.name = @"font-weight";
+
+    XCTAssertEqual(declaration, [ruleSet declarationForName:@"font-weight"], @"Expected renaming to update the atom");
+}
+
+- (void)testPartitionsMatchStrings
+{
+    PXStylesheet *stylesheet = [self stylesheetWithCount:20];
+    NSArray *cached = [self elementsWithCount:500 class:[PXDOMElement class]];
+    NSArray *uncached = [self elementsWithCount:500 class:[PXUncachedAtomsDOMElement class]];
+    NSUInteger matchCount = 0;
+
+    for (NSUInteger i = 0; i < cached.count; i++)
+    {
+        NSArray *expected = [stylesheet ruleSetsMatchingStyleable:[uncached objectAtIndex:i]];
+        NSArray *actual = [stylesheet ruleSetsMatchingStyleable:[cached objectAtIndex:i]];
+
+        XCTAssertEqualObjects(expected, actual, @"Expected cached and uncached atoms to select the same rule sets");
+
+        matchCount += actual.count;
+    }
+
+    XCTAssertTrue(matchCount > 0, @"Expected some matches");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testStyleResolutionTime
+{
+    PXStylesheet *stylesheet = [self stylesheetWithCount:100];
+    NSArray *cached = [self elementsWithCount:5000 class:[PXDOMElement class]];
+    NSArray *uncached = [self elementsWithCount:5000 class:[PXUncachedAtomsDOMElement class]];
+
+    // the uncached elements convert their strings on every lookup, like styleables did before atoms
+    NSUInteger uncachedCount = 0;
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (id element in uncached)
+    {
+        uncachedCount += [stylesheet ruleSetsMatchingStyleable:element].count;
+    }
+
+    double uncachedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSUInteger cachedCount = 0;
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (id element in cached)
+    {
+        cachedCount += [stylesheet ruleSetsMatchingStyleable:element].count;
+    }
+
+    double cachedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertEqual(uncachedCount, cachedCount, @"Expected the same matches");
+
+    NSLog(@"%lu elements x %lu rule sets: string lookups = %f ms, cached atoms = %f ms", (unsigned long) cached.count, (unsigned long) stylesheet.ruleSets.count, uncachedTime * 1000, cachedTime * 1000);
+}
+
+@end
@@ -0,0 +1,191 @@
+//
+//  PXCacheManagerTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXCacheManager.h"
+#import "PXLRUCache.h"
+#import "PXStyleTreeInfo.h"
+#import "PXDOMElement.h"
+
+@interface PXCacheManagerTests : XCTestCase
+
+@end
+
+@implementation PXCacheManagerTests
+{
+    NSUInteger memoryBudget_;
+    NSUInteger imageCacheCount_;
+    NSUInteger styleCacheCount_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    memoryBudget_ = [PXCacheManager memoryBudget];
+    imageCacheCount_ = [PXCacheManager imageCacheCount];
+    styleCacheCount_ = [PXCacheManager styleCacheCount];
+
+    [PXCacheManager clearImageCache];
+    [PXCacheManager clearStyleCache];
+    [PXCacheManager resetImageCacheStatistics];
+    [PXCacheManager resetStyleCacheStatistics];
+}
+
+- (void)tearDown
+{
+    [PXCacheManager setMemoryBudget:memoryBudget_];
+    [PXCacheManager setImageCacheCount:imageCacheCount_];
+    [PXCacheManager setStyleCacheCount:styleCacheCount_];
+    [PXCacheManager clearImageCache];
+    [PXCacheManager clearStyleCache];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (UIImage *)imageWithSize:(CGSize)size scale:(CGFloat)scale
+{
+    UIGraphicsBeginImageContextWithOptions(size, YES, scale);
+    [[UIColor redColor] setFill];
+    UIRectFill(CGRectMake(0.0f, 0.0f, size.width, size.height));
+    UIImage *result = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+
+    return result;
+}
+
+#pragma mark - Tests
+
+- (void)testEvictionFollowsPriority
+{
+    PXLRUCache *cache = [[PXLRUCache alloc] initWithCountLimit:0];
+
+    cache.totalCostLimit = 30;
+
+    [cache setObject:@"pinned" forKey:@"1" cost:10 priority:PXCachePriorityPinned];
+    [cache setObject:@"normal" forKey:@"2" cost:10 priority:PXCachePriorityNormal];
+    [cache setObject:@"speculative" forKey:@"3" cost:10 priority:PXCachePrioritySpeculative];
+    [cache setObject:@"new" forKey:@"4" cost:10 priority:PXCachePriorityNormal];
+
+    XCTAssertNil([cache objectForKey:@"3"], @"Expected the speculative object to be evicted first");
+    XCTAssertEqualObjects(@"normal", [cache objectForKey:@"2"], @"Expected the normal object to be kept");
+
+    [cache setObject:@"newer" forKey:@"5" cost:10 priority:PXCachePriorityNormal];
+
+    XCTAssertNil([cache objectForKey:@"4"], @"Expected the least recently used normal object to be evicted next");
+    XCTAssertEqualObjects(@"pinned", [cache objectForKey:@"1"], @"Expected the pinned object to be kept");
+    XCTAssertEqual((NSUInteger) 30, cache.totalCost, @"Expected the cost limit to be kept");
+    XCTAssertEqual((NSUInteger) 2, cache.evictionCount, @"Expected two evictions");
+
+    cache.totalCostLimit = 5;
+
+    XCTAssertEqualObjects(@"pinned", [cache objectForKey:@"1"], @"Expected pinned objects to survive any limit");
+    XCTAssertEqual((NSUInteger) 1, cache.count, @"Expected everything else to be evicted");
+}
+
+- (void)testSpeculativeObjectsArePromotedOnUse
+{
+    PXLRUCache *cache = [[PXLRUCache alloc] initWithCountLimit:0];
+
+    [cache setObject:@"a" forKey:@"1" cost:1 priority:PXCachePrioritySpeculative];
+    [cache setObject:@"b" forKey:@"2" cost:1 priority:PXCachePrioritySpeculative];
+    [cache objectForKey:@"1"];
+    [cache removeObjectsWithPriority:PXCachePrioritySpeculative];
+
+    XCTAssertEqualObjects(@"a", [cache objectForKey:@"1"], @"Expected the used object to have become normal");
+    XCTAssertNil([cache objectForKey:@"2"], @"Expected the unused object to be removed");
+    XCTAssertEqual((NSUInteger) 2, cache.hitCount, @"Expected two hits");
+    XCTAssertEqual((NSUInteger) 1, cache.missCount, @"Expected one miss");
+}
+
+- (void)testImageCostIncludesScale
+{
+    UIImage *image = [self imageWithSize:CGSizeMake(10.0f, 10.0f) scale:2.0f];
+
+    XCTAssertTrue([PXCacheManager costForImage:image] >= 20 * 20 * 4, @"Expected the cost of the decoded pixels");
+}
+
+- (void)testBudgetSpansImageAndStyleCaches
+{
+    UIImage *image = [self imageWithSize:CGSizeMake(16.0f, 16.0f) scale:1.0f];
+    NSUInteger imageCost = [PXCacheManager costForImage:image];
+    PXStyleTreeInfo *styleTreeInfo = [[PXStyleTreeInfo alloc] initWithStyleable:[[PXDOMElement alloc] initWithName:@"view"]];
+
+    [PXCacheManager setImageCacheCount:0];
+    [PXCacheManager setStyleCacheCount:0];
+    [PXCacheManager setMemoryBudget:0];
+
+    [PXCacheManager setStyleTreeInfo:styleTreeInfo forKey:@"view"];
+
+    for (NSUInteger i = 0; i < 4; i++)
+    {
+        [PXCacheManager setImage:image forKey:@(i) cost:imageCost];
+    }
+
+    XCTAssertEqual(imageCost * 4 + styleTreeInfo.cost, [PXCacheManager memoryUsage], @"Expected both caches to be counted");
+
+    // the style tree info is the least recently used entry of either cache
+    [PXCacheManager setMemoryBudget:imageCost * 4];
+
+    XCTAssertNil([PXCacheManager styleTreeInfoForKey:@"view"], @"Expected the oldest entry to be evicted from the style cache");
+    XCTAssertEqual((NSUInteger) 1, [PXCacheManager styleCacheEvictionCount], @"Expected a style eviction");
+    XCTAssertTrue([PXCacheManager memoryUsage] <= imageCost * 4, @"Expected the budget to be kept");
+
+    [PXCacheManager setImage:image forKey:@"speculative" cost:imageCost priority:PXCachePrioritySpeculative];
+
+    XCTAssertNil([PXCacheManager imageForKey:@"speculative"], @"Expected a speculative image to be evicted before normal ones");
+    XCTAssertNotNil([PXCacheManager imageForKey:@(0)], @"Expected normal images to be kept");
+}
+
+- (void)testMemoryPressureEvictsSpeculativeEntriesFirst
+{
+    UIImage *image = [self imageWithSize:CGSizeMake(16.0f, 16.0f) scale:1.0f];
+    NSUInteger imageCost = [PXCacheManager costForImage:image];
+
+    [PXCacheManager setImageCacheCount:0];
+    [PXCacheManager setMemoryBudget:0];
+
+    [PXCacheManager setImage:image forKey:@"pinned" cost:imageCost priority:PXCachePriorityPinned];
+    [PXCacheManager setImage:image forKey:@"normal" cost:imageCost priority:PXCachePriorityNormal];
+    [PXCacheManager setImage:image forKey:@"speculative" cost:imageCost priority:PXCachePrioritySpeculative];
+
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+
+    XCTAssertNil([PXCacheManager imageForKey:@"speculative"], @"Expected the speculative image to be evicted");
+    XCTAssertNotNil([PXCacheManager imageForKey:@"pinned"], @"Expected the pinned image to be kept");
+    XCTAssertEqual(imageCost, [PXCacheManager memoryUsage], @"Expected the rest to be trimmed to half");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testInsertionsUnderBudget
+{
+    UIImage *image = [self imageWithSize:CGSizeMake(32.0f, 32.0f) scale:1.0f];
+    NSUInteger imageCost = [PXCacheManager costForImage:image];
+    NSUInteger count = 10000;
+
+    [PXCacheManager setImageCacheCount:0];
+    [PXCacheManager setMemoryBudget:imageCost * 100];
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [PXCacheManager setImage:image forKey:@(i) cost:imageCost priority:(i % 3) ? PXCachePriorityNormal : PXCachePrioritySpeculative];
+        [PXCacheManager imageForKey:@(i / 2)];
+    }
+
+    double time = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertTrue([PXCacheManager memoryUsage] <= imageCost * 100, @"Expected the budget to be kept");
+
+    NSLog(@"%lu insertions: %f ms, %lu evictions, hit ratio = %f", (unsigned long) count, time * 1000, (unsigned long) [PXCacheManager imageCacheEvictionCount], [PXCacheManager imageCacheHitRatio]);
+}
+
+@end
@@ -0,0 +1,288 @@
+//
+//  PXDiskImageCacheTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXDiskImageCache.h"
+#import "PXImageCacheKey.h"
+#import "PXStylerContext.h"
+#import "PXCacheManager.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+#import "PXLinearGradient.h"
+#import "PXSolidPaint.h"
+#import "PXImagePaint.h"
+#import "PXShadow.h"
+#import "PXBorderInfo.h"
+#import "PXDOMElement.h"
+#import "PixateFreestyle.h"
+
+@interface PXDiskImageCacheTests : XCTestCase
+
+@end
+
+@implementation PXDiskImageCacheTests
+{
+    PXDiskImageCache *cache_;
+    BOOL asyncImageRendering_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+
+    cache_ = [[PXDiskImageCache alloc] initWithDirectory:directory];
+    cache_.enabled = YES;
+
+    asyncImageRendering_ = PixateFreestyle.configuration.asyncImageRendering;
+    PixateFreestyle.configuration.asyncImageRendering = NO;
+
+    [PXStylesheet styleSheetFromSource:@"button { color: red; }" withOrigin:PXStylesheetOriginApplication];
+}
+
+- (void)tearDown
+{
+    [cache_ removeAllImages];
+
+    PixateFreestyle.configuration.asyncImageRendering = asyncImageRendering_;
+    [PXStylesheet styleSheetFromSource:@"" withOrigin:PXStylesheetOriginApplication];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (PXStylerContext *)contextWithSize:(CGSize)size
+{
+    PXStylerContext *context = [[PXStylerContext alloc] init];
+    PXShadow *shadow = [[PXShadow alloc] init];
+
+    shadow.inset = YES;
+    shadow.blurDistance = 2.0f;
+    shadow.color = [UIColor blackColor];
+
+    context.styleable = [[PXDOMElement alloc] initWithName:@"button"];
+    context.bounds = CGRectMake(0.0f, 0.0f, size.width, size.height);
+    context.fill = [PXLinearGradient gradientFromStartColor:[UIColor redColor] endColor:[UIColor blueColor]];
+    context.shadow = shadow;
+    [context.boxModel setCornerRadius:6.0f];
+    [context.boxModel setBorderPaint:[PXSolidPaint paintWithColor:[UIColor greenColor]] width:2.0f style:PXBorderStyleSolid];
+
+    return context;
+}
+
+- (NSString *)fileNameWithSize:(CGSize)size
+{
+    return [cache_ fileNameForKey:[[PXImageCacheKey alloc] initWithStylerContext:[self contextWithSize:size]]];
+}
+
+- (UIImage *)imageWithSize:(CGSize)size
+{
+    UIGraphicsBeginImageContextWithOptions(size, NO, 2.0f);
+    [[UIColor redColor] setFill];
+    UIRectFill(CGRectMake(0.0f, 0.0f, size.width * 0.5f, size.height));
+    UIImage *result = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+
+    return result;
+}
+
+- (NSData *)pixelsOfImage:(UIImage *)image
+{
+    return (__bridge_transfer NSData *) CGDataProviderCopyData(CGImageGetDataProvider(image.CGImage));
+}
+
+- (void)drawImage:(UIImage *)image
+{
+    // drawing pages in a mapped bitmap, which a first screen would do too
+    UIGraphicsBeginImageContextWithOptions(image.size, NO, image.scale);
+    [image drawAtPoint:CGPointZero];
+    UIGraphicsEndImageContext();
+}
+
+#pragma mark - Tests
+
+- (void)testPersistentIdentifiersAreStable
+{
+    PXImageCacheKey *first = [[PXImageCacheKey alloc] initWithStylerContext:[self contextWithSize:CGSizeMake(100.0f, 40.0f)]];
+    PXImageCacheKey *second = [[PXImageCacheKey alloc] initWithStylerContext:[self contextWithSize:CGSizeMake(100.0f, 40.0f)]];
+    PXStylerContext *context;
+
+    XCTAssertEqualObjects(first.persistentIdentifier, second.persistentIdentifier, @"Expected equal keys to share an identifier");
+    XCTAssertEqual((NSUInteger) 40, first.persistentIdentifier.length, @"Expected a SHA-1 digest");
+
+    context = [self contextWithSize:CGSizeMake(100.0f, 40.0f)];
+    context.fill = [PXLinearGradient gradientFromStartColor:[UIColor redColor] endColor:[UIColor greenColor]];
+    XCTAssertFalse([first.persistentIdentifier isEqualToString:[[PXImageCacheKey alloc] initWithStylerContext:context].persistentIdentifier], @"Expected the fill to change the identifier");
+
+    context = [self contextWithSize:CGSizeMake(100.0f, 40.0f)];
+    context.imageFill = [[PXImagePaint alloc] initWithURL:[NSURL URLWithString:@"bundle://image.png"]];
+    XCTAssertNil([[PXImageCacheKey alloc] initWithStylerContext:context].persistentIdentifier, @"Expected image paints to not be persisted");
+}
+
+- (void)testImagesRoundTrip
+{
+    UIImage *image = [self imageWithSize:CGSizeMake(30.0f, 20.0f)];
+    NSString *fileName = [self fileNameWithSize:CGSizeMake(30.0f, 20.0f)];
+
+    XCTAssertNil([cache_ imageWithFileName:fileName], @"Expected an empty cache");
+
+    [cache_ setImage:image withFileName:fileName];
+    [cache_ waitUntilIdle];
+
+    UIImage *loaded = [cache_ imageWithFileName:fileName];
+
+    XCTAssertNotNil(loaded, @"Expected the image to be read back");
+    XCTAssertTrue(CGSizeEqualToSize(image.size, loaded.size), @"Expected the size to be kept");
+    XCTAssertEqual(image.scale, loaded.scale, @"Expected the scale to be kept");
+    XCTAssertEqualObjects([self pixelsOfImage:image], [self pixelsOfImage:loaded], @"Expected the pixels to be kept");
+    XCTAssertEqual((NSUInteger) 1, cache_.writeCount, @"Expected one write");
+    XCTAssertEqual((NSUInteger) 1, cache_.hitCount, @"Expected one hit");
+    XCTAssertEqual((NSUInteger) 1, cache_.missCount, @"Expected one miss");
+}
+
+- (void)testChangedStylesheetsChangeTheNamespace
+{
+    NSString *fileName = [self fileNameWithSize:CGSizeMake(30.0f, 20.0f)];
+
+    [cache_ setImage:[self imageWithSize:CGSizeMake(30.0f, 20.0f)] withFileName:fileName];
+    [cache_ waitUntilIdle];
+
+    [PXStylesheet styleSheetFromSource:@"button { color: blue; }" withOrigin:PXStylesheetOriginApplication];
+
+    NSString *changedFileName = [self fileNameWithSize:CGSizeMake(30.0f, 20.0f)];
+
+    XCTAssertFalse([fileName isEqualToString:changedFileName], @"Expected a new namespace");
+    XCTAssertNil([cache_ imageWithFileName:changedFileName], @"Expected the old bitmap to not be found");
+
+    [PXStylesheet styleSheetFromSource:@"button { color: red; }" withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertEqualObjects(fileName, [self fileNameWithSize:CGSizeMake(30.0f, 20.0f)], @"Expected the same content to map to the same namespace");
+}
+
+- (void)testStylesheetsChangedInCodeAreNotPersisted
+{
+    [[PXStylesheet currentApplicationStylesheet] addRuleSet:[[PXRuleSet alloc] init]];
+
+    XCTAssertNil([PXStylesheet currentApplicationStylesheet].contentHash, @"Expected no content hash");
+    XCTAssertNil([self fileNameWithSize:CGSizeMake(30.0f, 20.0f)], @"Expected no file name");
+
+    cache_.enabled = NO;
+    [PXStylesheet styleSheetFromSource:@"button { color: red; }" withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertNil([self fileNameWithSize:CGSizeMake(30.0f, 20.0f)], @"Expected no file name while disabled");
+}
+
+- (void)testEvictsLeastRecentlyUsedImages
+{
+    UIImage *image = [self imageWithSize:CGSizeMake(30.0f, 20.0f)];
+    NSString *a = [self fileNameWithSize:CGSizeMake(30.0f, 20.0f)];
+    NSString *b = [self fileNameWithSize:CGSizeMake(31.0f, 20.0f)];
+    NSString *c = [self fileNameWithSize:CGSizeMake(32.0f, 20.0f)];
+
+    [cache_ setImage:image withFileName:a];
+    [cache_ setImage:image withFileName:b];
+
+    NSUInteger fileSize = cache_.totalSize / 2;
+
+    [cache_ imageWithFileName:a];
+    cache_.sizeLimit = fileSize * 2 + fileSize / 2;
+    [cache_ setImage:image withFileName:c];
+    [cache_ waitUntilIdle];
+
+    XCTAssertNil([cache_ imageWithFileName:b], @"Expected the least recently used image to be evicted");
+    XCTAssertNotNil([cache_ imageWithFileName:a], @"Expected the used image to be kept");
+    XCTAssertNotNil([cache_ imageWithFileName:c], @"Expected the new image to be kept");
+    XCTAssertEqual((NSUInteger) 1, cache_.evictionCount, @"Expected one eviction");
+}
+
+- (void)testStaleNamespacesAreEvictedFirst
+{
+    UIImage *image = [self imageWithSize:CGSizeMake(30.0f, 20.0f)];
+    NSString *stale = [self fileNameWithSize:CGSizeMake(30.0f, 20.0f)];
+
+    [cache_ setImage:image withFileName:stale];
+    [PXStylesheet styleSheetFromSource:@"button { color: blue; }" withOrigin:PXStylesheetOriginApplication];
+
+    NSString *b = [self fileNameWithSize:CGSizeMake(30.0f, 20.0f)];
+    NSString *c = [self fileNameWithSize:CGSizeMake(31.0f, 20.0f)];
+
+    [cache_ setImage:image withFileName:b];
+
+    NSUInteger fileSize = cache_.totalSize / 2;
+
+    // the stale image is now the most recently used one
+    [cache_ imageWithFileName:stale];
+    cache_.sizeLimit = fileSize * 2 + fileSize / 2;
+    [cache_ setImage:image withFileName:c];
+    [cache_ waitUntilIdle];
+
+    XCTAssertNil([cache_ imageWithFileName:stale], @"Expected the stale image to be evicted");
+    XCTAssertNotNil([cache_ imageWithFileName:b], @"Expected the current image to be kept");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testFirstScreenStyleTime
+{
+    PXDiskImageCache *sharedCache = [PXDiskImageCache sharedInstance];
+    NSUInteger count = 40;
+    NSMutableArray *sizes = [NSMutableArray arrayWithCapacity:count];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [sizes addObject:[NSValue valueWithCGSize:CGSizeMake(280.0f + i, 44.0f)]];
+    }
+
+    // every launch starts with empty memory caches, so each screen is styled from scratch
+    sharedCache.enabled = NO;
+    [PXCacheManager clearImageCache];
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSValue *size in sizes)
+    {
+        [self drawImage:[[self contextWithSize:size.CGSizeValue] backgroundImage]];
+    }
+
+    double renderTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    // an earlier launch with the disk tier leaves its bitmaps behind
+    sharedCache.enabled = YES;
+    [sharedCache removeAllImages];
+    [PXCacheManager clearImageCache];
+
+    for (NSValue *size in sizes)
+    {
+        [[self contextWithSize:size.CGSizeValue] backgroundImage];
+    }
+
+    [sharedCache waitUntilIdle];
+    [sharedCache resetCounters];
+    [PXCacheManager clearImageCache];
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSValue *size in sizes)
+    {
+        [self drawImage:[[self contextWithSize:size.CGSizeValue] backgroundImage]];
+    }
+
+    double diskTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertEqual(count, sharedCache.hitCount, @"Expected every background to be read from disk");
+
+    NSLog(@"%lu backgrounds: rendered = %f ms, disk tier = %f ms, %lu bytes on disk", (unsigned long) count, renderTime * 1000, diskTime * 1000, (unsigned long) sharedCache.totalSize);
+
+    sharedCache.enabled = NO;
+    [sharedCache removeAllImages];
+    [PXCacheManager clearImageCache];
+}
+
+@end
@@ -0,0 +1,224 @@
+//
+//  PXImageCacheKeyTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXImageCacheKey.h"
+#import "PXStylerContext.h"
+#import "PXCacheManager.h"
+#import "PXLinearGradient.h"
+#import "PXSolidPaint.h"
+#import "PXShadow.h"
+#import "PXEllipse.h"
+#import "PXBorderInfo.h"
+#import "PXDOMElement.h"
+#import "PixateFreestyle.h"
+
+@interface PXImageCacheKeyTests : XCTestCase
+
+@end
+
+@implementation PXImageCacheKeyTests
+{
+    BOOL asyncImageRendering_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    asyncImageRendering_ = PixateFreestyle.configuration.asyncImageRendering;
+    PixateFreestyle.configuration.asyncImageRendering = NO;
+
+    [PXCacheManager clearImageCache];
+    [PXCacheManager resetImageCacheStatistics];
+}
+
+- (void)tearDown
+{
+    PixateFreestyle.configuration.asyncImageRendering = asyncImageRendering_;
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (PXStylerContext *)contextWithElementName:(NSString *)name size:(CGSize)size
+{
+    PXStylerContext *context = [[PXStylerContext alloc] init];
+    PXShadow *shadow = [[PXShadow alloc] init];
+
+    shadow.inset = YES;
+    shadow.blurDistance = 2.0f;
+    shadow.color = [UIColor blackColor];
+
+    context.styleable = [[PXDOMElement alloc] initWithName:name];
+    context.styleHash = name.hash;
+    context.bounds = CGRectMake(0.0f, 0.0f, size.width, size.height);
+    context.fill = [PXLinearGradient gradientFromStartColor:[UIColor redColor] endColor:[UIColor blueColor]];
+    context.shadow = shadow;
+    [context.boxModel setCornerRadius:6.0f];
+    [context.boxModel setBorderPaint:[PXSolidPaint paintWithColor:[UIColor greenColor]] width:2.0f style:PXBorderStyleSolid];
+
+    return context;
+}
+
+- (PXStylerContext *)stretchableContextWithSize:(CGSize)size
+{
+    PXStylerContext *context = [[PXStylerContext alloc] init];
+
+    context.styleable = [[PXDOMElement alloc] initWithName:@"button"];
+    context.bounds = CGRectMake(0.0f, 0.0f, size.width, size.height);
+    context.fill = [PXSolidPaint paintWithColor:[UIColor redColor]];
+    context.insets = UIEdgeInsetsMake(8.0f, 8.0f, 8.0f, 8.0f);
+    [context.boxModel setCornerRadius:6.0f];
+    [context.boxModel setBorderPaint:[PXSolidPaint paintWithColor:[UIColor greenColor]] width:2.0f style:PXBorderStyleSolid];
+
+    return context;
+}
+
+- (PXImageCacheKey *)keyForContext:(PXStylerContext *)context
+{
+    return [[PXImageCacheKey alloc] initWithStylerContext:context];
+}
+
+#pragma mark - Tests
+
+- (void)testIdenticalBackgroundsShareAKey
+{
+    PXImageCacheKey *button = [self keyForContext:[self contextWithElementName:@"button" size:CGSizeMake(100.0f, 40.0f)]];
+    PXImageCacheKey *label = [self keyForContext:[self contextWithElementName:@"label" size:CGSizeMake(100.0f, 40.0f)]];
+
+    XCTAssertEqualObjects(button, label, @"Expected identical backgrounds on different elements to share a key");
+    XCTAssertEqual(button.hash, label.hash, @"Expected equal hashes");
+}
+
+- (void)testRenderInputsChangeTheKey
+{
+    PXImageCacheKey *original = [self keyForContext:[self contextWithElementName:@"button" size:CGSizeMake(100.0f, 40.0f)]];
+    PXStylerContext *context;
+
+    context = [self contextWithElementName:@"button" size:CGSizeMake(101.0f, 40.0f)];
+    XCTAssertFalse([original isEqual:[self keyForContext:context]], @"Expected the size to change the key");
+
+    context = [self contextWithElementName:@"button" size:CGSizeMake(100.0f, 40.0f)];
+    context.fill = [PXLinearGradient gradientFromStartColor:[UIColor redColor] endColor:[UIColor greenColor]];
+    XCTAssertFalse([original isEqual:[self keyForContext:context]], @"Expected the fill to change the key");
+
+    context = [self contextWithElementName:@"button" size:CGSizeMake(100.0f, 40.0f)];
+    [context.boxModel setCornerRadius:4.0f];
+    XCTAssertFalse([original isEqual:[self keyForContext:context]], @"Expected the radii to change the key");
+
+    context = [self contextWithElementName:@"button" size:CGSizeMake(100.0f, 40.0f)];
+    context.shadow = nil;
+    XCTAssertFalse([original isEqual:[self keyForContext:context]], @"Expected the shadow to change the key");
+
+    context = [self contextWithElementName:@"button" size:CGSizeMake(100.0f, 40.0f)];
+    context.shape = [[PXEllipse alloc] init];
+    XCTAssertFalse([original isEqual:[self keyForContext:context]], @"Expected the shape to change the key");
+}
+
+- (void)testIdenticalBackgroundsShareAnImage
+{
+    UIImage *button = [self contextWithElementName:@"button" size:CGSizeMake(100.0f, 40.0f)].backgroundImage;
+    UIImage *label = [self contextWithElementName:@"label" size:CGSizeMake(100.0f, 40.0f)].backgroundImage;
+
+    XCTAssertTrue(button == label, @"Expected one cached image");
+    XCTAssertEqual((NSUInteger) 1, [PXCacheManager imageCacheHitCount], @"Expected one hit");
+    XCTAssertEqual((NSUInteger) 1, [PXCacheManager imageCacheMissCount], @"Expected one miss");
+    XCTAssertEqualWithAccuracy(0.5, [PXCacheManager imageCacheHitRatio], 0.001, @"Expected half the lookups to hit");
+    XCTAssertTrue([PXCacheManager imageCacheBytesSaved] >= 100 * 40 * 4, @"Expected the hit to save at least one bitmap");
+
+    [PXCacheManager resetImageCacheStatistics];
+
+    XCTAssertEqual((NSUInteger) 0, [PXCacheManager imageCacheHitCount], @"Expected the statistics to be reset");
+    XCTAssertEqualWithAccuracy(0.0, [PXCacheManager imageCacheHitRatio], 0.001, @"Expected no ratio without lookups");
+}
+
+- (void)testStretchableBackgroundsShareASource
+{
+    PXImageCacheKey *small = [self keyForContext:[self stretchableContextWithSize:CGSizeMake(60.0f, 30.0f)]];
+    PXImageCacheKey *large = [self keyForContext:[self stretchableContextWithSize:CGSizeMake(300.0f, 44.0f)]];
+
+    XCTAssertTrue(small.stretchable, @"Expected a stretchable key");
+    XCTAssertEqualObjects(small, large, @"Expected every size to share the 9-slice source");
+    XCTAssertTrue(CGSizeEqualToSize(CGSizeMake(17.0f, 17.0f), small.renderBounds.size), @"Expected a minimal source");
+
+    UIImage *image = [self stretchableContextWithSize:CGSizeMake(300.0f, 44.0f)].backgroundImage;
+
+    XCTAssertTrue(CGSizeEqualToSize(CGSizeMake(300.0f, 44.0f), image.size), @"Expected the source to be stretched to the bounds");
+    XCTAssertTrue(UIEdgeInsetsEqualToEdgeInsets(UIEdgeInsetsMake(8.0f, 8.0f, 8.0f, 8.0f), image.capInsets), @"Expected the cap insets");
+
+    [[self stretchableContextWithSize:CGSizeMake(60.0f, 30.0f)] backgroundImage];
+
+    XCTAssertEqual((NSUInteger) 1, [PXCacheManager imageCacheHitCount], @"Expected the second size to reuse the source");
+}
+
+- (void)testStretchedBackgroundsAreCachedBySize
+{
+    PXImageCacheKey *source = [self keyForContext:[self stretchableContextWithSize:CGSizeMake(300.0f, 44.0f)]];
+    PXImageCacheKey *stretched = [source keyForStretchedSize:CGSizeMake(300.0f, 44.0f)];
+
+    XCTAssertFalse(stretched.stretchable, @"Expected a stretched key to not be stretchable");
+    XCTAssertFalse([stretched isEqual:source], @"Expected the stretched key to differ from the source");
+    XCTAssertEqualObjects(stretched, [source keyForStretchedSize:CGSizeMake(300.0f, 44.0f)], @"Expected equal sizes to share a key");
+    XCTAssertFalse([stretched isEqual:[source keyForStretchedSize:CGSizeMake(60.0f, 30.0f)]], @"Expected the size to change the key");
+
+    UIImage *first = [self stretchableContextWithSize:CGSizeMake(300.0f, 44.0f)].backgroundImage;
+    UIImage *second = [self stretchableContextWithSize:CGSizeMake(300.0f, 44.0f)].backgroundImage;
+
+    XCTAssertTrue(first == second, @"Expected the stretched bitmap to be reused, instead of redrawn");
+}
+
+- (void)testNonUniformBackgroundsAreNotStretchable
+{
+    PXStylerContext *context;
+
+    context = [self stretchableContextWithSize:CGSizeMake(100.0f, 40.0f)];
+    context.fill = [PXLinearGradient gradientFromStartColor:[UIColor redColor] endColor:[UIColor blueColor]];
+    XCTAssertFalse([self keyForContext:context].stretchable, @"Expected a gradient to not be stretchable");
+
+    context = [self stretchableContextWithSize:CGSizeMake(100.0f, 40.0f)];
+    [context.boxModel setCornerRadius:12.0f];
+    XCTAssertFalse([self keyForContext:context].stretchable, @"Expected corners outside of the caps to not be stretchable");
+
+    context = [self stretchableContextWithSize:CGSizeMake(100.0f, 40.0f)];
+    context.insets = UIEdgeInsetsZero;
+    XCTAssertFalse([self keyForContext:context].stretchable, @"Expected no insets to not be stretchable");
+
+    context = [self stretchableContextWithSize:CGSizeMake(12.0f, 12.0f)];
+    XCTAssertFalse([self keyForContext:context].stretchable, @"Expected backgrounds smaller than the source to not be stretchable");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testCellBackgrounds
+{
+    NSArray *names = @[ @"button", @"label", @"view", @"cell" ];
+    NSUInteger count = 200;
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [[self contextWithElementName:[names objectAtIndex:i % names.count] size:CGSizeMake(320.0f, 44.0f)] backgroundImage];
+    }
+
+    double sharedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [[self stretchableContextWithSize:CGSizeMake(200.0f + i, 44.0f)] backgroundImage];
+    }
+
+    double stretchedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu backgrounds: shared = %f ms, stretched sizes = %f ms, hit ratio = %f, bytes saved = %llu", (unsigned long) count, sharedTime * 1000, stretchedTime * 1000, [PXCacheManager imageCacheHitRatio], [PXCacheManager imageCacheBytesSaved]);
+}
+
+@end
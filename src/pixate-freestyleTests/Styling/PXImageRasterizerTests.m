@@ -0,0 +1,265 @@
+//
+//  PXImageRasterizerTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import <libkern/OSAtomic.h>
+#import "PXImageRasterizer.h"
+#import "PXStylerContext.h"
+#import "PXCacheManager.h"
+#import "PXLinearGradient.h"
+#import "PXSolidPaint.h"
+#import "PXOffsets.h"
+#import "PXShadow.h"
+#import "PXBorderInfo.h"
+#import "PXDOMElement.h"
+#import "PixateFreestyle.h"
+
+@interface PXImageRasterizerTests : XCTestCase
+
+@end
+
+@implementation PXImageRasterizerTests
+{
+    PXImageRasterizer *rasterizer_;
+    BOOL asyncImageRendering_;
+    NSUInteger maximumConcurrentRenders_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    rasterizer_ = [PXImageRasterizer sharedInstance];
+    asyncImageRendering_ = PixateFreestyle.configuration.asyncImageRendering;
+    maximumConcurrentRenders_ = rasterizer_.maximumConcurrentRenders;
+
+    [rasterizer_ waitUntilIdle];
+    [rasterizer_ clearFinishedImages];
+    [rasterizer_ resetCounters];
+    [PXCacheManager clearImageCache];
+}
+
+- (void)tearDown
+{
+    [rasterizer_ waitUntilIdle];
+
+    PixateFreestyle.configuration.asyncImageRendering = asyncImageRendering_;
+    rasterizer_.maximumConcurrentRenders = maximumConcurrentRenders_;
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (UIImage *)solidImageWithColor:(UIColor *)color
+{
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(4.0f, 4.0f), YES, 1.0f);
+    [color setFill];
+    UIRectFill(CGRectMake(0.0f, 0.0f, 4.0f, 4.0f));
+    UIImage *result = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+
+    return result;
+}
+
+- (NSData *)pixelsOfImage:(UIImage *)image
+{
+    // draw into a bitmap of a fixed format, so images can be compared byte for byte without a screen
+    CGImageRef cgImage = image.CGImage;
+    size_t width = CGImageGetWidth(cgImage);
+    size_t height = CGImageGetHeight(cgImage);
+    NSMutableData *pixels = [NSMutableData dataWithLength:width * height * 4];
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(pixels.mutableBytes, width, height, 8, width * 4, colorSpace, (CGBitmapInfo) kCGImageAlphaPremultipliedLast);
+
+    CGContextDrawImage(context, CGRectMake(0.0f, 0.0f, width, height), cgImage);
+
+    CGContextRelease(context);
+    CGColorSpaceRelease(colorSpace);
+
+    return pixels;
+}
+
+- (PXStylerContext *)contextWithStyleHash:(NSUInteger)styleHash
+{
+    PXStylerContext *context = [[PXStylerContext alloc] init];
+    PXShadow *shadow = [[PXShadow alloc] init];
+
+    shadow.inset = YES;
+    shadow.blurDistance = 4.0f;
+    shadow.color = [UIColor blackColor];
+
+    context.styleable = [[PXDOMElement alloc] initWithName:@"view"];
+    context.styleHash = styleHash;
+    context.bounds = CGRectMake(0.0f, 0.0f, 120.0f, 60.0f);
+    context.fill = [PXLinearGradient gradientFromStartColor:[UIColor redColor] endColor:[UIColor blueColor]];
+    context.shadow = shadow;
+    context.padding = [[PXOffsets alloc] initWithTop:2.0f right:4.0f bottom:6.0f left:8.0f];
+    [context.boxModel setCornerRadius:10.0f];
+    [context.boxModel setBorderPaint:[PXSolidPaint paintWithColor:[UIColor greenColor]] width:3.0f style:PXBorderStyleSolid];
+
+    return context;
+}
+
+- (void)runMainQueueUntil:(BOOL (^)(void))condition
+{
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:5.0];
+
+    while (!condition() && [timeout timeIntervalSinceNow] > 0)
+    {
+        [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+}
+
+#pragma mark - Tests
+
+- (void)testRequestsForTheSameKeyAreJoined
+{
+    dispatch_semaphore_t gate = dispatch_semaphore_create(0);
+    UIImage *image = [self solidImageWithColor:[UIColor redColor]];
+    __block NSUInteger completionCount = 0;
+
+    BOOL first = [rasterizer_ rasterizeImageForKey:@1 usingBlock:^UIImage *{
+        dispatch_semaphore_wait(gate, DISPATCH_TIME_FOREVER);
+        return image;
+    } completion:^(UIImage *result) {
+        XCTAssertTrue(result == image, @"Expected the rendered image");
+        completionCount++;
+    }];
+
+    BOOL second = [rasterizer_ rasterizeImageForKey:@1 usingBlock:^UIImage *{
+        XCTFail(@"Expected the in-flight render to be joined");
+        return nil;
+    } completion:^(UIImage *result) {
+        XCTAssertTrue(result == image, @"Expected the joined request to get the same image");
+        completionCount++;
+    }];
+
+    XCTAssertTrue(first, @"Expected a new render");
+    XCTAssertFalse(second, @"Expected the request to be joined");
+    XCTAssertEqual((NSUInteger) 1, rasterizer_.inFlightCount, @"Expected one key in flight");
+
+    dispatch_semaphore_signal(gate);
+    [rasterizer_ waitUntilIdle];
+    [self runMainQueueUntil:^BOOL{ return completionCount == 2; }];
+
+    XCTAssertEqual((NSUInteger) 2, completionCount, @"Expected both completions on the main queue");
+    XCTAssertEqual((NSUInteger) 1, rasterizer_.renderCount, @"Expected a single render");
+    XCTAssertEqual((NSUInteger) 1, rasterizer_.joinedCount, @"Expected one joined request");
+    XCTAssertTrue([rasterizer_ finishedImageForKey:@1] == image, @"Expected the finished image to be kept");
+}
+
+- (void)testConcurrencyIsBounded
+{
+    __block int32_t running = 0;
+    __block int32_t maximum = 0;
+
+    rasterizer_.maximumConcurrentRenders = 2;
+
+    for (NSUInteger i = 0; i < 8; i++)
+    {
+        [rasterizer_ rasterizeImageForKey:@(i) usingBlock:^UIImage *{
+            int32_t current = OSAtomicIncrement32(&running);
+            int32_t observed;
+
+            while ((observed = maximum) < current && !OSAtomicCompareAndSwap32(observed, current, &maximum));
+
+            [NSThread sleepForTimeInterval:0.01];
+            OSAtomicDecrement32(&running);
+
+            return nil;
+        } completion:nil];
+    }
+
+    [rasterizer_ waitUntilIdle];
+
+    XCTAssertEqual((NSUInteger) 8, rasterizer_.renderCount, @"Expected every key to be rendered");
+    XCTAssertTrue(maximum <= 2, @"Expected at most two renders at once, saw %d", maximum);
+    XCTAssertEqual((NSUInteger) 0, rasterizer_.inFlightCount, @"Expected nothing in flight");
+}
+
+- (void)testAsynchronousBackgroundMatchesSynchronousRendering
+{
+    PixateFreestyle.configuration.asyncImageRendering = NO;
+    UIImage *expected = [self contextWithStyleHash:42].backgroundImage;
+
+    XCTAssertEqual((NSUInteger) 0, rasterizer_.renderCount, @"Expected the synchronous path to render in place");
+
+    [PXCacheManager clearImageCache];
+    PixateFreestyle.configuration.asyncImageRendering = YES;
+
+    PXStylerContext *context = [self contextWithStyleHash:42];
+    UIImage *placeholder = context.backgroundImage;
+
+    XCTAssertTrue(CGSizeEqualToSize(CGSizeMake(1.0f, 1.0f), placeholder.size), @"Expected a placeholder");
+    XCTAssertTrue(placeholder == context.backgroundImage, @"Expected the context to not schedule a second render");
+
+    [rasterizer_ waitUntilIdle];
+
+    UIImage *actual = [self contextWithStyleHash:42].backgroundImage;
+
+    XCTAssertEqual((NSUInteger) 1, rasterizer_.renderCount, @"Expected one asynchronous render");
+    XCTAssertTrue(CGSizeEqualToSize(expected.size, actual.size), @"Expected the same size");
+    XCTAssertEqual(expected.scale, actual.scale, @"Expected the same scale");
+    XCTAssertEqualObjects([self pixelsOfImage:expected], [self pixelsOfImage:actual], @"Expected identical pixels");
+}
+
+- (void)testStylersWithoutStyleHashRenderSynchronously
+{
+    PixateFreestyle.configuration.asyncImageRendering = YES;
+
+    UIImage *image = [self contextWithStyleHash:0].backgroundImage;
+
+    XCTAssertTrue(CGSizeEqualToSize(CGSizeMake(120.0f, 60.0f), image.size), @"Expected the full image");
+    XCTAssertEqual((NSUInteger) 0, rasterizer_.renderCount, @"Expected no asynchronous render");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testMainThreadTimeForLargeBackgrounds
+{
+    NSUInteger count = 50;
+
+    PixateFreestyle.configuration.asyncImageRendering = NO;
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        PXStylerContext *context = [self contextWithStyleHash:1000 + i];
+
+        // distinct sizes, so identical backgrounds are not shared through the image cache
+        context.bounds = CGRectMake(0.0f, 0.0f, 640.0f + i, 480.0f);
+        [context backgroundImage];
+    }
+
+    double syncTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    [PXCacheManager clearImageCache];
+    PixateFreestyle.configuration.asyncImageRendering = YES;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        PXStylerContext *context = [self contextWithStyleHash:1000 + i];
+
+        // distinct sizes, so identical backgrounds are not shared through the image cache
+        context.bounds = CGRectMake(0.0f, 0.0f, 640.0f + i, 480.0f);
+        [context backgroundImage];
+    }
+
+    double asyncTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    [rasterizer_ waitUntilIdle];
+
+    double totalTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu backgrounds: synchronous = %f ms, main thread with async = %f ms, async until idle = %f ms", (unsigned long) count, syncTime * 1000, asyncTime * 1000, totalTime * 1000);
+}
+
+@end
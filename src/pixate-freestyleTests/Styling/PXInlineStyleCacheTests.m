@@ -0,0 +1,176 @@
+//
+//  PXInlineStyleCacheTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXLRUCache.h"
+#import "PXCacheManager.h"
+#import "PXStyleUtils.h"
+#import "PXStylesheetParser.h"
+#import "PXStylesheet.h"
+#import "PXRuleSet.h"
+#import "PXDeclaration.h"
+#import "StyleableView.h"
+#import "UIView+PXStyling.h"
+
+@interface PXInlineStyleCacheTests : XCTestCase
+
+@end
+
+@implementation PXInlineStyleCacheTests
+
+#pragma mark - Setup
+
+- (void)tearDown
+{
+    [PXCacheManager clearInlineStyleCache];
+
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void)testLeastRecentlyUsedIsEvicted
+{
+    PXLRUCache *cache = [[PXLRUCache alloc] initWithCountLimit:2];
+
+    [cache setObject:@"a" forKey:@"1"];
+    [cache setObject:@"b" forKey:@"2"];
+
+    XCTAssertEqualObjects(@"a", [cache objectForKey:@"1"], @"Expected the first object");
+
+    [cache setObject:@"c" forKey:@"3"];
+
+    XCTAssertEqual((NSUInteger) 2, cache.count, @"Expected the limit to be kept");
+    XCTAssertEqualObjects(@"a", [cache objectForKey:@"1"], @"Expected the recently used object to be kept");
+    XCTAssertNil([cache objectForKey:@"2"], @"Expected the least recently used object to be evicted");
+    XCTAssertEqualObjects(@"c", [cache objectForKey:@"3"], @"Expected the new object");
+}
+
+- (void)testReplacingAndLoweringLimit
+{
+    PXLRUCache *cache = [[PXLRUCache alloc] initWithCountLimit:3];
+
+    [cache setObject:@"a" forKey:@"1"];
+    [cache setObject:@"b" forKey:@"2"];
+    [cache setObject:@"c" forKey:@"3"];
+    [cache setObject:@"A" forKey:@"1"];
+
+    XCTAssertEqual((NSUInteger) 3, cache.count, @"Expected replacing to not add an entry");
+
+    cache.countLimit = 1;
+
+    XCTAssertEqual((NSUInteger) 1, cache.count, @"Expected lowering the limit to evict");
+    XCTAssertEqualObjects(@"A", [cache objectForKey:@"1"], @"Expected the most recently used object to be kept");
+
+    [cache removeObjectForKey:@"1"];
+    XCTAssertEqual((NSUInteger) 0, cache.count, @"Expected the object to be removed");
+}
+
+- (void)testIdenticalSourcesShareRuleSets
+{
+    NSString *source = @"color: red; border-width: 1px;";
+    NSArray *first = [PXStyleUtils ruleSetsForInlineCSS:source];
+
+    XCTAssertEqual((NSUInteger) 1, first.count, @"Expected one rule set");
+    XCTAssertNotNil([[first objectAtIndex:0] declarationForName:@"border-width"], @"Expected the parsed declarations");
+    XCTAssertTrue(first == [PXStyleUtils ruleSetsForInlineCSS:[NSMutableString stringWithString:source]], @"Expected equal sources to share rule sets");
+    XCTAssertEqual((NSUInteger) 0, [PXStyleUtils ruleSetsForInlineCSS:nil].count, @"Expected no rule sets without a source");
+}
+
+- (void)testViewMemoizationFollowsStyleCSS
+{
+    StyleableView *view = [[StyleableView alloc] initWithElementName:@"view"];
+
+    view.styleCSS = @"color: red;";
+
+    NSArray *ruleSets = [PXStyleUtils inlineRuleSetsForStyleable:view];
+
+    XCTAssertTrue(ruleSets == [PXStyleUtils inlineRuleSetsForStyleable:view], @"Expected memoized rule sets");
+    XCTAssertNotNil([[ruleSets objectAtIndex:0] declarationForName:@"color"], @"Expected the color declaration");
+
+    view.styleCSS = @"opacity: 0.5;";
+    ruleSets = [PXStyleUtils inlineRuleSetsForStyleable:view];
+
+    XCTAssertNil([[ruleSets objectAtIndex:0] declarationForName:@"color"], @"Expected setStyleCSS: to invalidate");
+    XCTAssertNotNil([[ruleSets objectAtIndex:0] declarationForName:@"opacity"], @"Expected the new declaration");
+}
+
+- (void)testViewMemoizationFollowsKVC
+{
+    StyleableView *view = [[StyleableView alloc] initWithElementName:@"view"];
+
+    [view setValue:@"red" forKey:@"color"];
+
+    NSArray *ruleSets = [PXStyleUtils inlineRuleSetsForStyleable:view];
+
+    XCTAssertNotNil([[ruleSets objectAtIndex:0] declarationForName:@"color"], @"Expected the KVC property");
+    XCTAssertTrue(ruleSets == [PXStyleUtils inlineRuleSetsForStyleable:view], @"Expected memoized rule sets");
+
+    [view setValue:@"0.5" forKey:@"opacity"];
+    ruleSets = [PXStyleUtils inlineRuleSetsForStyleable:view];
+
+    XCTAssertNotNil([[ruleSets objectAtIndex:0] declarationForName:@"opacity"], @"Expected the KVC setter to invalidate");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testRestylingViewsWithIdenticalInlineStyles
+{
+    NSString *source = @"background-color: red; border-radius: 5px; border-width: 1px; border-color: blue; opacity: 0.75;";
+    NSUInteger count = 1000;
+    NSMutableArray *views = [NSMutableArray arrayWithCapacity:count];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        StyleableView *view = [[StyleableView alloc] initWithElementName:@"view"];
+
+        view.styleCSS = source;
+        [views addObject:view];
+    }
+
+    // what every restyle did before: parse each view's source with a new parser
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (StyleableView *view in views)
+    {
+        PXStylesheetParser *parser = [[PXStylesheetParser alloc] init];
+
+        [[parser parseInlineCSS:view.styleCSS] ruleSets];
+    }
+
+    double parseTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    [PXCacheManager clearInlineStyleCache];
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (StyleableView *view in views)
+    {
+        [PXStyleUtils inlineRuleSetsForStyleable:view];
+    }
+
+    double firstTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (StyleableView *view in views)
+    {
+        [PXStyleUtils inlineRuleSetsForStyleable:view];
+    }
+
+    double memoizedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (StyleableView *view in views)
+    {
+        [view updateStyles];
+    }
+
+    double updateTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu views: parse each = %f ms, shared LRU = %f ms, memoized = %f ms, updateStyles = %f ms", (unsigned long) count, parseTime * 1000, firstTime * 1000, memoizedTime * 1000, updateTime * 1000);
+}
+
+@end
@@ -0,0 +1,116 @@
+//
+//  PXRuleSetCascadeTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXStylesheetParser.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+
+@interface PXRuleSetCascadeTests : XCTestCase
+
+@end
+
+@implementation PXRuleSetCascadeTests
+
+#pragma mark - Helpers
+
+- (NSArray *)ruleSetsFromSource:(NSString *)source origin:(PXStylesheetOrigin)origin
+{
+    PXStylesheetParser *parser = [[PXStylesheetParser alloc] init];
+    PXStylesheet *stylesheet = [parser parse:source withOrigin:origin];
+
+    XCTAssertTrue(parser.errors.count == 0, @"Unexpected parse error");
+
+    return stylesheet.ruleSets;
+}
+
+- (NSString *)valueOfProperty:(NSString *)name inRuleSets:(NSArray *)ruleSets
+{
+    return [[PXRuleSet ruleSetWithMergedRuleSets:ruleSets] declarationForName:name].stringValue;
+}
+
+#pragma mark - Tests
+
+- (void)testSortKeysFollowSpecificity
+{
+    NSArray *ruleSets = [self ruleSetsFromSource:@"button {} .a.b {} #c {} button.a {}" origin:PXStylesheetOriginApplication];
+    PXRuleSet *element = [ruleSets objectAtIndex:0];
+    PXRuleSet *classes = [ruleSets objectAtIndex:1];
+    PXRuleSet *identifier = [ruleSets objectAtIndex:2];
+    PXRuleSet *mixed = [ruleSets objectAtIndex:3];
+
+    XCTAssertTrue(element.sortKey < mixed.sortKey, @"Expected a class to outweigh an element");
+    XCTAssertTrue(mixed.sortKey < classes.sortKey, @"Expected two classes to outweigh a class and an element");
+    XCTAssertTrue(classes.sortKey < identifier.sortKey, @"Expected an id to outweigh classes");
+}
+
+- (void)testSortKeysFollowOriginThenSourceOrder
+{
+    NSArray *application = [self ruleSetsFromSource:@"#a {} button {} button {}" origin:PXStylesheetOriginApplication];
+    NSArray *user = [self ruleSetsFromSource:@"button {}" origin:PXStylesheetOriginUser];
+    PXRuleSet *first = [application objectAtIndex:1];
+    PXRuleSet *second = [application objectAtIndex:2];
+
+    XCTAssertTrue(first.sortKey < second.sortKey, @"Expected the later rule set to sort later");
+    XCTAssertTrue([[application objectAtIndex:0] sortKey] < [[user objectAtIndex:0] sortKey], @"Expected the user origin to outweigh any application specificity");
+}
+
+- (void)testCascade
+{
+    NSArray *ruleSets = [self ruleSetsFromSource:@"button { color: red; width: 1; } "
+                                                  "#b { color: green; } "
+                                                  "button { color: blue; width: 2; height: 3 !important; } "
+                                                  ".c { height: 4; }"
+                                          origin:PXStylesheetOriginApplication];
+
+    // matched lists are not in source order, which must not change the result
+    NSArray *shuffled = @[ ruleSets[3], ruleSets[2], ruleSets[1], ruleSets[0] ];
+    PXRuleSet *merged = [PXRuleSet ruleSetWithMergedRuleSets:shuffled];
+
+    XCTAssertEqualObjects(@"green", [merged declarationForName:@"color"].stringValue, @"Expected the id to win");
+    XCTAssertEqualObjects(@"2", [merged declarationForName:@"width"].stringValue, @"Expected the later rule set to win");
+    XCTAssertEqualObjects(@"3", [merged declarationForName:@"height"].stringValue, @"Expected !important to win");
+    XCTAssertEqual((NSUInteger) 3, merged.declarations.count, @"Expected one declaration per property");
+    XCTAssertEqualObjects(@"2", [self valueOfProperty:@"width" inRuleSets:ruleSets], @"Expected the matched order to not matter");
+}
+
+- (void)testImportantDeclarationsCascadeBySpecificity
+{
+    NSArray *ruleSets = [self ruleSetsFromSource:@"#a { color: red !important; } button { color: blue !important; } .b { color: green; }"
+                                          origin:PXStylesheetOriginApplication];
+
+    XCTAssertEqualObjects(@"red", [self valueOfProperty:@"color" inRuleSets:ruleSets], @"Expected the more specific !important declaration to win");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testMergeManyRuleSets
+{
+    NSMutableString *source = [NSMutableString string];
+
+    for (NSUInteger i = 0; i < 20; i++)
+    {
+        [source appendFormat:@"button.c%lu { color: red; width: %lu; height: 2; border-width: 1; opacity: 0.5; "
+                              "background-color: blue; font-size: 12; padding: 2; margin: 1; left: %lu; }\n",
+                             (unsigned long) i, (unsigned long) i, (unsigned long) i];
+    }
+
+    NSArray *ruleSets = [self ruleSetsFromSource:source origin:PXStylesheetOriginApplication];
+    NSUInteger iterations = 2000;
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < iterations; i++)
+    {
+        [PXRuleSet ruleSetWithMergedRuleSets:ruleSets];
+    }
+
+    double time = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu merges of %lu rule sets: %f ms", (unsigned long) iterations, (unsigned long) ruleSets.count, time * 1000);
+}
+
+@end
@@ -0,0 +1,213 @@
+//
+//  PXRuleSetMatchCacheTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXStyleUtils.h"
+#import "PXCacheManager.h"
+#import "PXRuleSetMatchKey.h"
+#import "PXSelectorProgram.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+#import "PXDOMElement.h"
+
+@interface PXRuleSetMatchCacheTests : XCTestCase
+
+@end
+
+@implementation PXRuleSetMatchCacheTests
+
+#pragma mark - Setup
+
+- (void)tearDown
+{
+    [PXStylesheet styleSheetFromSource:@"" withOrigin:PXStylesheetOriginApplication];
+    [PXCacheManager clearRuleSetMatchCache];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (BOOL)isCacheable:(NSString *)source
+{
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:[NSString stringWithFormat:@"%@ {}", source]
+                                                             withOrigin:PXStylesheetOriginApplication
+                                                               filename:nil];
+
+    return ((PXRuleSet *) [stylesheet.ruleSets objectAtIndex:0]).selectorProgram.cacheable;
+}
+
+- (PXDOMElement *)list
+{
+    PXDOMElement *root = [[PXDOMElement alloc] initWithName:@"table-view"];
+
+    for (NSUInteger i = 0; i < 20; i++)
+    {
+        PXDOMElement *cell = [[PXDOMElement alloc] initWithName:@"cell"];
+        PXDOMElement *label = [[PXDOMElement alloc] initWithName:@"label"];
+
+        cell.styleClass = (i % 2) ? @"odd" : @"even";
+        label.styleClass = @"title";
+
+        [cell addChild:label];
+        [root addChild:cell];
+    }
+
+    return root;
+}
+
+- (NSArray *)nodesOfTree:(PXDOMElement *)root
+{
+    NSMutableArray *nodes = [NSMutableArray array];
+
+    [PXStyleUtils enumerateStyleableAndDescendants:root usingBlock:^(id obj, BOOL *stop, BOOL *stopDescending) {
+        [nodes addObject:obj];
+    }];
+
+    return nodes;
+}
+
+#pragma mark - Tests
+
+- (void)testCacheableSelectors
+{
+    for (NSString *source in @[ @"button", @"view button", @".a > #b", @"button:highlighted" ])
+    {
+        XCTAssertTrue([self isCacheable:source], @"Expected '%@' to be cacheable", source);
+    }
+
+    for (NSString *source in @[ @"button[title]", @"button[title=\"a\"]", @"label + button", @"label ~ button", @"button:first-child", @"button:nth-child(2)", @"button:not(.a)" ])
+    {
+        XCTAssertFalse([self isCacheable:source], @"Expected '%@' to not be cacheable", source);
+    }
+}
+
+- (void)testKeysCompareAncestors
+{
+    PXDOMElement *root = [self list];
+    PXDOMElement *even = [root.children objectAtIndex:0];
+    PXDOMElement *odd = [root.children objectAtIndex:1];
+    PXDOMElement *otherEven = [root.children objectAtIndex:2];
+    NSArray *stylesheets = @[ [NSNull null] ];
+
+    PXRuleSetMatchKey *evenKey = [[PXRuleSetMatchKey alloc] initWithStyleable:[even.children objectAtIndex:0] stylesheets:stylesheets];
+    PXRuleSetMatchKey *oddKey = [[PXRuleSetMatchKey alloc] initWithStyleable:[odd.children objectAtIndex:0] stylesheets:stylesheets];
+    PXRuleSetMatchKey *otherEvenKey = [[PXRuleSetMatchKey alloc] initWithStyleable:[otherEven.children objectAtIndex:0] stylesheets:stylesheets];
+
+    XCTAssertEqualObjects(evenKey, otherEvenKey, @"Expected labels in equivalent cells to share a key");
+    XCTAssertEqual(evenKey.hash, otherEvenKey.hash, @"Expected equal hashes");
+    XCTAssertFalse([evenKey isEqual:oddKey], @"Expected labels in different cells to have different keys");
+}
+
+- (void)testCachedMatchesAgreeWithMatching
+{
+    [PXStylesheet styleSheetFromSource:@"cell.odd label { color: red; } table-view .title { color: blue; } label { color: green; }"
+                            withOrigin:PXStylesheetOriginApplication];
+
+    for (id node in [self nodesOfTree:[self list]])
+    {
+        NSArray *expected = [[PXStylesheet currentApplicationStylesheet] ruleSetsMatchingStyleable:node];
+
+        XCTAssertEqualObjects(expected, [PXStyleUtils stylesheetRuleSetsMatchingStyleable:node], @"Expected the first lookup to match");
+        XCTAssertEqualObjects(expected, [PXStyleUtils stylesheetRuleSetsMatchingStyleable:node], @"Expected the cached lookup to match");
+    }
+
+    PXDOMElement *root = [self list];
+    PXDOMElement *first = [[root.children objectAtIndex:1] children][0];
+    PXDOMElement *second = [[root.children objectAtIndex:3] children][0];
+
+    XCTAssertTrue([PXStyleUtils stylesheetRuleSetsMatchingStyleable:first] == [PXStyleUtils stylesheetRuleSetsMatchingStyleable:second], @"Expected equivalent labels to share a cached result");
+}
+
+- (void)testNonCacheableCandidatesAreNotCached
+{
+    [PXStylesheet styleSheetFromSource:@"label:first-child { color: red; }" withOrigin:PXStylesheetOriginApplication];
+
+    PXDOMElement *root = [self list];
+    PXDOMElement *label = [[root.children objectAtIndex:0] children][0];
+    NSArray *first = [PXStyleUtils stylesheetRuleSetsMatchingStyleable:label];
+
+    XCTAssertEqual((NSUInteger) 1, first.count, @"Expected a match");
+    XCTAssertTrue(first != [PXStyleUtils stylesheetRuleSetsMatchingStyleable:label], @"Expected the result to be recomputed");
+}
+
+- (void)testReplacingStylesheetInvalidates
+{
+    PXDOMElement *label = [[PXDOMElement alloc] initWithName:@"label"];
+
+    [PXStylesheet styleSheetFromSource:@"label { color: red; }" withOrigin:PXStylesheetOriginApplication];
+    XCTAssertEqual((NSUInteger) 1, [PXStyleUtils stylesheetRuleSetsMatchingStyleable:label].count, @"Expected a match");
+
+    [PXStylesheet styleSheetFromSource:@"button { color: red; }" withOrigin:PXStylesheetOriginApplication];
+    XCTAssertEqual((NSUInteger) 0, [PXStyleUtils stylesheetRuleSetsMatchingStyleable:label].count, @"Expected the new stylesheet to be used");
+}
+
+- (void)testMergedRuleSetsAreShared
+{
+    [PXStylesheet styleSheetFromSource:@"label { color: red; } .title { opacity: 0.5; }" withOrigin:PXStylesheetOriginApplication];
+
+    PXDOMElement *root = [self list];
+    PXDOMElement *first = [[root.children objectAtIndex:1] children][0];
+    PXDOMElement *second = [[root.children objectAtIndex:3] children][0];
+    NSArray *ruleSets = [PXStyleUtils stylesheetRuleSetsMatchingStyleable:first];
+    PXRuleSet *merged = [PXStyleUtils mergedRuleSetForRuleSets:ruleSets];
+
+    XCTAssertEqual((NSUInteger) 2, merged.declarations.count, @"Expected both declarations");
+    XCTAssertTrue(merged == [PXStyleUtils mergedRuleSetForRuleSets:[PXStyleUtils stylesheetRuleSetsMatchingStyleable:second]], @"Expected equivalent labels to share a merged rule set");
+    XCTAssertTrue(merged == [PXStyleUtils mergedRuleSetForRuleSets:[ruleSets copy]], @"Expected an equal list of rule sets to share a merged rule set");
+
+    [PXCacheManager clearRuleSetMatchCache];
+
+    XCTAssertTrue(merged != [PXStyleUtils mergedRuleSetForRuleSets:ruleSets], @"Expected clearing the match cache to drop merged rule sets");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testRepeatedCells
+{
+    NSMutableString *source = [NSMutableString string];
+
+    for (NSUInteger i = 0; i < 100; i++)
+    {
+        [source appendFormat:@"table-view cell.odd label.title-%lu { color: red; }\n", (unsigned long) i];
+        [source appendFormat:@"cell label.title { color: red; }\n"];
+        [source appendFormat:@".panel-%lu label { color: red; }\n", (unsigned long) i];
+    }
+
+    [PXStylesheet styleSheetFromSource:source withOrigin:PXStylesheetOriginApplication];
+
+    NSArray *nodes = [self nodesOfTree:[self list]];
+    NSUInteger iterations = 200;
+    PXStylesheet *stylesheet = [PXStylesheet currentApplicationStylesheet];
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < iterations; i++)
+    {
+        for (id node in nodes)
+        {
+            [stylesheet ruleSetsMatchingStyleable:node];
+        }
+    }
+
+    double uncachedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < iterations; i++)
+    {
+        for (id node in nodes)
+        {
+            [PXStyleUtils stylesheetRuleSetsMatchingStyleable:node];
+        }
+    }
+
+    double cachedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu x %lu nodes: matching = %f ms, match cache = %f ms", (unsigned long) iterations, (unsigned long) nodes.count, uncachedTime * 1000, cachedTime * 1000);
+}
+
+@end
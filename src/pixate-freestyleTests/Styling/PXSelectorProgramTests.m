@@ -0,0 +1,137 @@
+//
+//  PXSelectorProgramTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXSelectorProgram.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+#import "PXDOMParser.h"
+#import "PXDOMElement.h"
+#import "PXXPath.h"
+
+@interface PXSelectorProgramTests : XCTestCase
+
+@end
+
+@implementation PXSelectorProgramTests
+
+#pragma mark - Helpers
+
+- (PXRuleSet *)ruleSetFromSource:(NSString *)source
+{
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:[NSString stringWithFormat:@"%@ {}", source]
+                                                             withOrigin:PXStylesheetOriginApplication
+                                                               filename:nil];
+
+    return [stylesheet.ruleSets objectAtIndex:0];
+}
+
+- (BOOL)selectorsOfRuleSet:(PXRuleSet *)ruleSet matchElement:(id<PXStyleable>)element
+{
+    for (id<PXSelector> selector in ruleSet.selectors)
+    {
+        if (![selector matches:element])
+        {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark - Tests
+
+- (void)testRightToLeftInstructions
+{
+    PXSelectorProgram *program = [self ruleSetFromSource:@"view.a > button#b.c"].selectorProgram;
+    NSArray *expected = @[
+        @"  0: ELEMENT button",
+        @"  1: ID b",
+        @"  2: CLASS c",
+        @"  3: CHILD",
+        @"  4: ELEMENT view",
+        @"  5: CLASS a",
+        @"  6: MATCH"
+    ];
+
+    XCTAssertEqualObjects([expected componentsJoinedByString:@"\n"], program.description, @"Unexpected program");
+}
+
+- (void)testPseudoClassesUseSelectorObjects
+{
+    PXSelectorProgram *program = [self ruleSetFromSource:@"button:first-child[title^=\"a\"]"].selectorProgram;
+
+    XCTAssertEqual((NSUInteger) 4, program.instructionCount, @"Expected element, attribute, pseudo-class, and match instructions");
+    XCTAssertTrue([program.description rangeOfString:@"ATTR^= title"].location != NSNotFound, @"Expected an inlined attribute operator");
+    XCTAssertTrue([program.description rangeOfString:@"SELECTOR"].location != NSNotFound, @"Expected the pseudo-class to be called");
+}
+
+- (void)testClassMatching
+{
+    PXDOMElement *element = [[PXDOMElement alloc] initWithName:@"button"];
+
+    element.styleClass = @"a";
+
+    XCTAssertTrue([[self ruleSetFromSource:@"button.a"] matches:element], @"Expected a match");
+    XCTAssertFalse([[self ruleSetFromSource:@"button.b"] matches:element], @"Expected no match");
+}
+
+- (void)testAgreesWithSelectorObjectsOnW3CSuite
+{
+    NSBundle *bundle = [NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"];
+    PXXPath *xpath = [[PXXPath alloc] init];
+    NSUInteger documentCount = 0;
+    NSUInteger matchCount = 0;
+
+    for (NSString *path in [bundle pathsForResourcesOfType:@"xml" inDirectory:nil])
+    {
+        NSString *name = path.lastPathComponent.stringByDeletingPathExtension;
+
+        if (![name hasPrefix:@"css3-modsel-"] || [name hasSuffix:@"-result"])
+        {
+            continue;
+        }
+
+        PXDOMElement *document = [PXDOMParser loadFromURL:[NSURL fileURLWithPath:path]];
+        NSArray *styles = [xpath findNodesFromNode:document withPath:@"//style"];
+
+        if (styles.count == 0)
+        {
+            continue;
+        }
+
+        PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:((PXDOMElement *) [styles objectAtIndex:0]).innerXML
+                                                                 withOrigin:PXStylesheetOriginUser
+                                                                   filename:name];
+        NSArray *nodes = [xpath findNodesFromNode:document withPath:@"//*"];
+
+        documentCount++;
+
+        for (PXRuleSet *ruleSet in stylesheet.ruleSets)
+        {
+            for (id node in nodes)
+            {
+                if ([node isKindOfClass:[PXDOMElement class]])
+                {
+                    BOOL expected = [self selectorsOfRuleSet:ruleSet matchElement:node];
+                    BOOL actual = [ruleSet.selectorProgram matches:node];
+
+                    XCTAssertEqual(expected, actual, @"%@: '%@' disagrees on %@\n%@", name, [ruleSet.selectors componentsJoinedByString:@", "], node, ruleSet.selectorProgram);
+
+                    if (actual)
+                    {
+                        matchCount++;
+                    }
+                }
+            }
+        }
+    }
+
+    XCTAssertTrue(documentCount > 0, @"Expected W3C documents");
+    XCTAssertTrue(matchCount > 0, @"Expected some matches");
+}
+
+@end
@@ -0,0 +1,206 @@
+//
+//  PXSiblingIndexTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXSiblingIndex.h"
+#import "PXStyleUtils.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+#import "PXDOMElement.h"
+#import "StyleableView.h"
+#import "UIView+PXStyling.h"
+
+@interface PXSiblingIndexTests : XCTestCase
+
+@end
+
+@implementation PXSiblingIndexTests
+
+#pragma mark - Helpers
+
+- (PXDOMElement *)parentWithCount:(NSUInteger)count
+{
+    PXDOMElement *parent = [[PXDOMElement alloc] initWithName:@"list"];
+    NSArray *names = @[ @"label", @"button", @"label", @"image" ];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [parent addChild:[[PXDOMElement alloc] initWithName:[names objectAtIndex:i % names.count]]];
+    }
+
+    return parent;
+}
+
+- (PXStyleableChildrenInfo)walkedInfoForStyleable:(id<PXStyleable>)styleable
+{
+    // what childrenInfoForStyleable: computed before sibling indexes
+    PXStyleableChildrenInfo result = { 0, NSNotFound, 0, NSNotFound };
+
+    for (id<PXStyleable> obj in styleable.pxStyleParent.pxStyleChildren)
+    {
+        if (![obj.pxStyleElementName hasPrefix:@"#"])
+        {
+            result.childrenCount++;
+
+            if (obj == styleable)
+            {
+                result.childrenIndex = result.childrenCount;
+            }
+
+            if ([obj.pxStyleElementName isEqualToString:styleable.pxStyleElementName])
+            {
+                result.childrenOfTypeCount++;
+
+                if (obj == styleable)
+                {
+                    result.childrenOfTypeIndex = result.childrenOfTypeCount;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+- (void)assertInfoOfStyleable:(id<PXStyleable>)styleable
+{
+    PXStyleableChildrenInfo expected = [self walkedInfoForStyleable:styleable];
+    PXStyleableChildrenInfo actual;
+
+    [PXStyleUtils getChildrenInfo:&actual forStyleable:styleable];
+
+    XCTAssertEqual(expected.childrenCount, actual.childrenCount, @"Unexpected children count");
+    XCTAssertEqual(expected.childrenIndex, actual.childrenIndex, @"Unexpected index");
+    XCTAssertEqual(expected.childrenOfTypeCount, actual.childrenOfTypeCount, @"Unexpected children of type count");
+    XCTAssertEqual(expected.childrenOfTypeIndex, actual.childrenOfTypeIndex, @"Unexpected index of type");
+}
+
+- (PXRuleSet *)ruleSetFromSource:(NSString *)source
+{
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:[NSString stringWithFormat:@"%@ {}", source]
+                                                             withOrigin:PXStylesheetOriginApplication
+                                                               filename:nil];
+
+    return [stylesheet.ruleSets objectAtIndex:0];
+}
+
+#pragma mark - Tests
+
+- (void)testIndexAgreesWithWalkingSiblings
+{
+    PXDOMElement *parent = [self parentWithCount:10];
+    [parent addChild:[[PXDOMElement alloc] initWithName:@"#text"]];
+
+    for (id child in parent.children)
+    {
+        [self assertInfoOfStyleable:child];
+    }
+
+    [PXSiblingIndex performStylePassUsingBlock:^{
+        for (id child in parent.children)
+        {
+            [self assertInfoOfStyleable:child];
+        }
+    }];
+}
+
+- (void)testStructuralPseudoClasses
+{
+    PXDOMElement *parent = [self parentWithCount:5];
+    NSArray *children = parent.children;
+
+    [PXSiblingIndex performStylePassUsingBlock:^{
+        XCTAssertTrue([[self ruleSetFromSource:@"label:first-child"] matches:[children objectAtIndex:0]], @"Expected :first-child");
+        XCTAssertTrue([[self ruleSetFromSource:@"label:last-of-type"] matches:[children objectAtIndex:4]], @"Expected :last-of-type");
+        XCTAssertFalse([[self ruleSetFromSource:@"label:last-of-type"] matches:[children objectAtIndex:2]], @"Expected no :last-of-type");
+        XCTAssertTrue([[self ruleSetFromSource:@"button:only-of-type"] matches:[children objectAtIndex:1]], @"Expected :only-of-type");
+        XCTAssertFalse([[self ruleSetFromSource:@"button:only-child"] matches:[children objectAtIndex:1]], @"Expected no :only-child");
+        XCTAssertTrue([[self ruleSetFromSource:@"label:nth-of-type(2n+1)"] matches:[children objectAtIndex:4]], @"Expected :nth-of-type");
+        XCTAssertTrue([[self ruleSetFromSource:@"image:nth-last-child(2)"] matches:[children objectAtIndex:3]], @"Expected :nth-last-child");
+    }];
+}
+
+- (void)testAddedChildrenAreIndexed
+{
+    PXDOMElement *parent = [self parentWithCount:3];
+
+    [PXSiblingIndex performStylePassUsingBlock:^{
+        [self assertInfoOfStyleable:[parent.children objectAtIndex:0]];
+
+        // DOM elements do not invalidate, so the new child must be found by rebuilding
+        [parent addChild:[[PXDOMElement alloc] initWithName:@"label"]];
+
+        [self assertInfoOfStyleable:[parent.children lastObject]];
+        [self assertInfoOfStyleable:[parent.children objectAtIndex:0]];
+    }];
+}
+
+- (void)testRemovingSubviewsInvalidates
+{
+    StyleableView *parent = [[StyleableView alloc] initWithElementName:@"view"];
+    StyleableView *first = [[StyleableView alloc] initWithElementName:@"label"];
+    StyleableView *second = [[StyleableView alloc] initWithElementName:@"label"];
+
+    [parent addSubview:first];
+    [parent addSubview:second];
+
+    [PXSiblingIndex performStylePassUsingBlock:^{
+        [self assertInfoOfStyleable:second];
+
+        [first removeFromSuperview];
+
+        [self assertInfoOfStyleable:second];
+    }];
+}
+
+#pragma mark - Performance Tests
+
+- (void)testStructuralMatchingOverManyChildren
+{
+    PXDOMElement *parent = [self parentWithCount:2000];
+    NSArray *children = parent.children;
+    NSArray *ruleSets = @[
+        [self ruleSetFromSource:@"label:nth-child(2n+1)"],
+        [self ruleSetFromSource:@"label:last-of-type"],
+        [self ruleSetFromSource:@"button:first-child"],
+        [self ruleSetFromSource:@"image:only-of-type"]
+    ];
+
+    // outside of a pass every lookup walks the siblings, as every lookup did before
+    __block NSUInteger walkedCount = 0;
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (id child in children)
+    {
+        for (PXRuleSet *ruleSet in ruleSets)
+        {
+            walkedCount += [ruleSet matches:child] ? 1 : 0;
+        }
+    }
+
+    double walkedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    __block NSUInteger indexedCount = 0;
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    [PXSiblingIndex performStylePassUsingBlock:^{
+        for (id child in children)
+        {
+            for (PXRuleSet *ruleSet in ruleSets)
+            {
+                indexedCount += [ruleSet matches:child] ? 1 : 0;
+            }
+        }
+    }];
+
+    double indexedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertEqual(walkedCount, indexedCount, @"Expected the same matches");
+
+    NSLog(@"%lu children x %lu rule sets: walked = %f ms, indexed = %f ms", (unsigned long) children.count, (unsigned long) ruleSets.count, walkedTime * 1000, indexedTime * 1000);
+}
+
+@end
@@ -0,0 +1,219 @@
+//
+//  PXStyleHashTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import <objc/runtime.h>
+#import "PXStyleUtils.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXRuleSet.h"
+#import "PXDeclaration.h"
+#import "PXDOMElement.h"
+#import "PixateFreestyle.h"
+
+static const char LEGACY_HASH_KEY;
+
+@interface PXStyleHashTests : XCTestCase
+
+@end
+
+@implementation PXStyleHashTests
+{
+    PXCacheStylesType cacheStylesType_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    cacheStylesType_ = PixateFreestyle.configuration.cacheStylesType;
+    PixateFreestyle.configuration.cacheStylesType = cacheStylesType_ | PXCacheStylesTypeStyleOnce;
+}
+
+- (void)tearDown
+{
+    PixateFreestyle.configuration.cacheStylesType = cacheStylesType_;
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (NSArray *)declarationsFromSource:(NSString *)source
+{
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:source withOrigin:PXStylesheetOriginApplication filename:nil];
+
+    return ((PXRuleSet *) [stylesheet.ruleSets objectAtIndex:0]).declarations;
+}
+
+- (PXDOMElement *)cellWithBounds:(CGRect)bounds
+{
+    PXDOMElement *cell = [[PXDOMElement alloc] initWithName:@"cell"];
+
+    cell.bounds = bounds;
+
+    return cell;
+}
+
+/**
+ *  The check as it was done before hash records, for comparison
+ */
+- (BOOL)legacyStylesOfStyleable:(id<PXStyleable>)styleable matchDeclarations:(NSArray *)declarations state:(NSString *)state
+{
+    NSMutableDictionary *cachedHashValues = objc_getAssociatedObject(styleable, &LEGACY_HASH_KEY);
+
+    if (!cachedHashValues)
+    {
+        cachedHashValues = [[NSMutableDictionary alloc] init];
+        objc_setAssociatedObject(styleable, &LEGACY_HASH_KEY, cachedHashValues, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
+    NSString *stateNameKey = (state) ? state : @"";
+    NSValue *cachedHashValue = [cachedHashValues objectForKey:stateNameKey];
+    CGRect bounds = styleable.bounds;
+    NSString *boundsString = [NSString stringWithFormat:@"%f,%f,%f,%f", bounds.origin.x, bounds.origin.y, bounds.size.width, bounds.size.height];
+    NSUInteger activeDeclarationsHash = boundsString.hash;
+    BOOL result = NO;
+
+    for (PXDeclaration *declaration in declarations)
+    {
+        activeDeclarationsHash = activeDeclarationsHash * 31 + declaration.hash;
+    }
+
+    if (cachedHashValue)
+    {
+        NSUInteger cachedHash;
+
+        [cachedHashValue getValue:&cachedHash];
+        result = (activeDeclarationsHash == cachedHash);
+    }
+
+    if (!result)
+    {
+        [cachedHashValues setObject:[[NSValue alloc] initWithBytes:&activeDeclarationsHash objCType:@encode(NSUInteger)] forKey:stateNameKey];
+    }
+
+    return result;
+}
+
+#pragma mark - Tests
+
+- (void)testRepeatedStylesAreDetected
+{
+    NSArray *declarations = [self declarationsFromSource:@"cell { color: red; opacity: 0.5; }"];
+    PXDOMElement *cell = [self cellWithBounds:CGRectMake(0, 0, 320, 44)];
+
+    XCTAssertFalse([PXStyleUtils stylesOfStyleable:cell matchDeclarations:declarations state:@"normal"], @"Expected the first styling to be needed");
+    XCTAssertTrue([PXStyleUtils stylesOfStyleable:cell matchDeclarations:declarations state:@"normal"], @"Expected the second styling to be redundant");
+    XCTAssertTrue([PXStyleUtils hashValueForStyleable:cell state:@"normal"] != 0, @"Expected a stored hash");
+}
+
+- (void)testStatesAreIndependent
+{
+    NSArray *declarations = [self declarationsFromSource:@"cell { color: red; }"];
+    PXDOMElement *cell = [self cellWithBounds:CGRectMake(0, 0, 320, 44)];
+    NSArray *states = @[ @"", @"normal", @"highlighted", @"selected", @"disabled", @"focused" ];
+
+    for (NSString *state in states)
+    {
+        XCTAssertFalse([PXStyleUtils stylesOfStyleable:cell matchDeclarations:declarations state:state], @"Expected '%@' to need styling", state);
+    }
+
+    for (NSString *state in states)
+    {
+        XCTAssertTrue([PXStyleUtils stylesOfStyleable:cell matchDeclarations:declarations state:state], @"Expected '%@' to be redundant", state);
+    }
+
+    XCTAssertEqual([PXStyleUtils hashValueForStyleable:cell state:nil], [PXStyleUtils hashValueForStyleable:cell state:@""], @"Expected nil to be the default state");
+}
+
+- (void)testChangesAreDetected
+{
+    NSArray *red = [self declarationsFromSource:@"cell { color: red; }"];
+    NSArray *blue = [self declarationsFromSource:@"cell { color: blue; }"];
+    PXDOMElement *cell = [self cellWithBounds:CGRectMake(0, 0, 320, 44)];
+
+    [PXStyleUtils stylesOfStyleable:cell matchDeclarations:red state:@"normal"];
+    XCTAssertFalse([PXStyleUtils stylesOfStyleable:cell matchDeclarations:blue state:@"normal"], @"Expected new declarations to need styling");
+
+    cell.bounds = CGRectMake(0, 0, 320, 44.5);
+    XCTAssertFalse([PXStyleUtils stylesOfStyleable:cell matchDeclarations:blue state:@"normal"], @"Expected new bounds to need styling");
+
+    [PXStyleUtils invalidateStyleable:cell];
+    XCTAssertEqual((NSUInteger) 0, [PXStyleUtils hashValueForStyleable:cell state:@"normal"], @"Expected no stored hash");
+    XCTAssertFalse([PXStyleUtils stylesOfStyleable:cell matchDeclarations:blue state:@"normal"], @"Expected invalidated styleables to need styling");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testTableScrolling
+{
+    NSArray *declarations = [self declarationsFromSource:@"cell { color: red; opacity: 0.5; border-width: 1px; background-color: white; }"];
+    NSArray *states = @[ @"normal", @"highlighted", @"selected" ];
+    NSUInteger rowCount = 500;
+    NSUInteger visibleCount = 12;
+    NSUInteger scrollCount = 20;
+    NSMutableArray *cells = [NSMutableArray arrayWithCapacity:visibleCount];
+
+    for (NSUInteger i = 0; i < visibleCount; i++)
+    {
+        [cells addObject:[self cellWithBounds:CGRectMake(0, 0, 320, 44)]];
+    }
+
+    // each row scrolled into view restyles a recycled cell at a new position, once per state
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger pass = 0; pass < scrollCount; pass++)
+    {
+        for (NSUInteger row = 0; row < rowCount; row++)
+        {
+            PXDOMElement *cell = [cells objectAtIndex:row % visibleCount];
+
+            cell.bounds = CGRectMake(0, row * 44.0, 320, 44);
+            objc_setAssociatedObject(cell, &LEGACY_HASH_KEY, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+
+            for (NSString *state in states)
+            {
+                [self legacyStylesOfStyleable:cell matchDeclarations:declarations state:state];
+            }
+        }
+    }
+
+    double legacyTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSUInteger declarationsHash = [PXStyleUtils hashValueForDeclarations:declarations];
+    PXAtom stateAtoms[3];
+
+    for (NSUInteger i = 0; i < states.count; i++)
+    {
+        stateAtoms[i] = [PXAtomTable atomForString:[states objectAtIndex:i]];
+    }
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger pass = 0; pass < scrollCount; pass++)
+    {
+        for (NSUInteger row = 0; row < rowCount; row++)
+        {
+            PXDOMElement *cell = [cells objectAtIndex:row % visibleCount];
+
+            cell.bounds = CGRectMake(0, row * 44.0, 320, 44);
+            [PXStyleUtils invalidateStyleable:cell];
+
+            for (NSUInteger i = 0; i < states.count; i++)
+            {
+                [PXStyleUtils stylesOfStyleable:cell matchDeclarationsHash:declarationsHash stateAtom:stateAtoms[i]];
+            }
+        }
+    }
+
+    double recordTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu rows x %lu scrolls x %lu states: string hash = %f ms, hash record = %f ms", (unsigned long) rowCount, (unsigned long) scrollCount, (unsigned long) states.count, legacyTime * 1000, recordTime * 1000);
+}
+
+@end
@@ -0,0 +1,182 @@
+//
+//  PXStyleInfoTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXStyleInfo.h"
+#import "PXStyleTreeInfo.h"
+#import "PXGenericStyler.h"
+#import "PXRuleSet.h"
+#import "PXDeclaration.h"
+#import "PXStyleUtils.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXDOMElement.h"
+
+static NSMutableArray *STYLER_LOG;
+static NSUInteger RULE_SET_UPDATE_COUNT;
+
+/**
+ *  A DOM element with stylers that record the declarations they process
+ */
+@interface PXStyledDOMElement : PXDOMElement
+@end
+
+@implementation PXStyledDOMElement
+
+@synthesize styleChangeable;
+
+- (NSArray *)viewStylers
+{
+    static __strong NSArray *stylers = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        PXDeclarationHandlerBlock handler = ^(PXDeclaration *declaration, PXStylerContext *context) {
+            [STYLER_LOG addObject:declaration.name];
+        };
+        PXStylerCompletionBlock (^completion)(NSString *) = ^PXStylerCompletionBlock(NSString *name) {
+            return ^(id<PXStyleable> view, id<PXStyler> styler, PXStylerContext *context) {
+                [STYLER_LOG addObject:name];
+            };
+        };
+
+        stylers = @[
+            [[PXGenericStyler alloc] initWithHandlers:@{ @"color" : handler, @"font-size" : handler } completionBlock:completion(@"text")],
+            [[PXGenericStyler alloc] initWithHandlers:@{ @"border-width" : handler } completionBlock:completion(@"border")],
+            [[PXGenericStyler alloc] initWithHandlers:@{ @"opacity" : handler } completionBlock:completion(@"opacity")],
+        ];
+    });
+
+    return stylers;
+}
+
+- (NSDictionary *)viewStylersByProperty
+{
+    static NSDictionary *map = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        map = [PXStyleUtils viewStylerPropertyMapForStyleable:self];
+    });
+
+    return map;
+}
+
+- (void)updateStyleWithRuleSet:(PXRuleSet *)ruleSet context:(PXStylerContext *)context
+{
+    RULE_SET_UPDATE_COUNT++;
+}
+
+@end
+
+@interface PXStyleInfoTests : XCTestCase
+
+@end
+
+@implementation PXStyleInfoTests
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    STYLER_LOG = [NSMutableArray array];
+    RULE_SET_UPDATE_COUNT = 0;
+}
+
+- (void)tearDown
+{
+    [PXStylesheet styleSheetFromSource:@"" withOrigin:PXStylesheetOriginApplication];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (PXStyledDOMElement *)cell
+{
+    PXStyledDOMElement *cell = [[PXStyledDOMElement alloc] initWithName:@"cell"];
+
+    for (NSUInteger i = 0; i < 8; i++)
+    {
+        PXStyledDOMElement *label = [[PXStyledDOMElement alloc] initWithName:@"label"];
+
+        label.styleClass = (i % 2) ? @"odd" : @"even";
+        [cell addChild:label];
+    }
+
+    return cell;
+}
+
+#pragma mark - Tests
+
+- (void)testDeclarationsAreDispatchedInStylerOrder
+{
+    [PXStylesheet styleSheetFromSource:@"cell { opacity: 0.5; color: red; border-width: 1px; font-size: 12; }"
+                            withOrigin:PXStylesheetOriginApplication];
+
+    PXStyledDOMElement *cell = [[PXStyledDOMElement alloc] initWithName:@"cell"];
+    PXStyleInfo *styleInfo = [PXStyleInfo styleInfoForStyleable:cell];
+
+    [styleInfo applyToStyleable:cell];
+
+    NSArray *expected = @[ @"color", @"font-size", @"text", @"border-width", @"border", @"opacity", @"opacity" ];
+
+    XCTAssertEqualObjects(expected, STYLER_LOG, @"Expected declarations grouped by styler, in styler order");
+    XCTAssertEqual((NSUInteger) 1, RULE_SET_UPDATE_COUNT, @"Expected the catch-all to be called");
+}
+
+- (void)testPlansAreRebuiltWhenDeclarationsChange
+{
+    [PXStylesheet styleSheetFromSource:@"cell { color: red; }" withOrigin:PXStylesheetOriginApplication];
+
+    PXStyledDOMElement *cell = [[PXStyledDOMElement alloc] initWithName:@"cell"];
+    PXStyleInfo *styleInfo = [PXStyleInfo styleInfoForStyleable:cell];
+
+    styleInfo.forceInvalidation = YES;
+    [styleInfo applyToStyleable:cell];
+
+    PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:@"cell { opacity: 1; }" withOrigin:PXStylesheetOriginApplication filename:nil];
+    PXRuleSet *ruleSet = [stylesheet.ruleSets objectAtIndex:0];
+
+    [styleInfo addDeclarations:ruleSet.declarations forState:@""];
+    [styleInfo addStylers:[NSSet setWithObject:@"PXGenericStyler"] forState:@""];
+    [STYLER_LOG removeAllObjects];
+    [styleInfo applyToStyleable:cell];
+
+    NSArray *expected = @[ @"text", @"border", @"opacity", @"opacity" ];
+
+    XCTAssertEqualObjects(expected, STYLER_LOG, @"Expected the new declarations to be dispatched");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testCachedTreeApplyThroughput
+{
+    [PXStylesheet styleSheetFromSource:@"cell { opacity: 0.5; color: red; border-width: 1px; } label { color: blue; font-size: 12; } label.odd { opacity: 0.8; }"
+                            withOrigin:PXStylesheetOriginApplication];
+
+    PXStyleTreeInfo *treeInfo = [[PXStyleTreeInfo alloc] initWithStyleable:[self cell]];
+    PXStyledDOMElement *recycledCell = [self cell];
+    NSUInteger count = 2000;
+
+    STYLER_LOG = nil;
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [treeInfo applyStylesToStyleable:recycledCell];
+    }
+
+    double applyTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertEqual((NSUInteger) 9 * count, RULE_SET_UPDATE_COUNT, @"Expected every styleable to be styled on every apply");
+
+    NSLog(@"%lu applies of a 9 styleable tree = %f ms (%f applies/s)", (unsigned long) count, applyTime * 1000, count / applyTime);
+}
+
+@end
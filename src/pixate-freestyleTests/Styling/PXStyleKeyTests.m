@@ -0,0 +1,100 @@
+//
+//  PXStyleKeyTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "StyleableView.h"
+#import "UIView+PXStyling.h"
+#import "PXStyleUtils.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+
+@interface PXStyleKeyTests : XCTestCase
+
+@end
+
+@implementation PXStyleKeyTests
+
+#pragma mark - Tests
+
+- (void)testStyleKeyMatchesSelector
+{
+    StyleableView *view = [[StyleableView alloc] initWithElementName:@"button"];
+
+    view.styleId = @"ok";
+    view.styleClass = @"primary large";
+
+    XCTAssertEqualObjects(@"button#ok.large.primary", view.styleKey, @"Unexpected style key");
+    XCTAssertEqualObjects([PXStyleUtils selectorFromStyleable:view], view.styleKey, @"Expected the cached key to match the computed key");
+}
+
+- (void)testStyleKeyIsCached
+{
+    StyleableView *view = [[StyleableView alloc] initWithElementName:@"button"];
+
+    view.styleClass = @"primary";
+
+    XCTAssertTrue(view.styleKey == view.styleKey, @"Expected the same key instance");
+}
+
+- (void)testStyleKeyFollowsChanges
+{
+    StyleableView *view = [[StyleableView alloc] initWithElementName:@"button"];
+
+    view.styleClass = @"primary";
+    XCTAssertEqualObjects(@"button.primary", view.styleKey, @"Unexpected style key");
+
+    view.styleClass = @"secondary";
+    XCTAssertEqualObjects(@"button.secondary", view.styleKey, @"Expected a new class to change the key");
+
+    view.styleId = @"ok";
+    XCTAssertEqualObjects(@"button#ok.secondary", view.styleKey, @"Expected a new id to change the key");
+
+    [view removeStyleClass:@"secondary"];
+    XCTAssertEqualObjects(@"button#ok", view.styleKey, @"Expected removing a class to change the key");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testRepeatedUpdateStyles
+{
+    [PXStylesheet styleSheetFromSource:@"button.primary { color: red; } #ok { border-width: 1px; }" withOrigin:PXStylesheetOriginApplication];
+
+    StyleableView *view = [[StyleableView alloc] initWithElementName:@"button"];
+    NSUInteger count = 10000;
+
+    view.styleId = @"ok";
+    view.styleClass = @"primary large";
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [PXStyleUtils selectorFromStyleable:view];
+    }
+
+    double computedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [view styleKey];
+    }
+
+    double cachedTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [view updateStyles];
+    }
+
+    double updateTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    NSLog(@"%lu iterations: computed key = %f ms, cached key = %f ms, updateStyles = %f ms", (unsigned long) count, computedTime * 1000, cachedTime * 1000, updateTime * 1000);
+}
+
+@end
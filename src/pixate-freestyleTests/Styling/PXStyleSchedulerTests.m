@@ -0,0 +1,202 @@
+//
+//  PXStyleSchedulerTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXStyleScheduler.h"
+#import "PXDOMElement.h"
+
+/**
+ *  A DOM element that records the updates it receives
+ */
+@interface PXRecordingDOMElement : PXDOMElement
+@property (nonatomic) NSUInteger recursiveUpdateCount;
+@property (nonatomic) NSUInteger nonRecursiveUpdateCount;
+@property (nonatomic, strong) NSMutableArray *log;
+@property (nonatomic) NSTimeInterval updateDuration;
+@end
+
+@implementation PXRecordingDOMElement
+
+- (void)updateStyles
+{
+    self.recursiveUpdateCount++;
+    [self.log addObject:self.name];
+
+    if (self.updateDuration > 0)
+    {
+        [NSThread sleepForTimeInterval:self.updateDuration];
+    }
+}
+
+- (void)updateStylesNonRecursively
+{
+    self.nonRecursiveUpdateCount++;
+    [self.log addObject:self.name];
+}
+
+@end
+
+@interface PXStyleSchedulerTests : XCTestCase
+
+@end
+
+@implementation PXStyleSchedulerTests
+{
+    PXStyleScheduler *scheduler_;
+    NSMutableArray *log_;
+}
+
+#pragma mark - Setup
+
+- (void)setUp
+{
+    [super setUp];
+
+    scheduler_ = [PXStyleScheduler sharedInstance];
+    [scheduler_ flush];
+    [scheduler_ resetCounters];
+    scheduler_.frameBudget = 0;
+    log_ = [NSMutableArray array];
+}
+
+- (void)tearDown
+{
+    scheduler_.frameBudget = 0;
+    [scheduler_ flush];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (PXRecordingDOMElement *)elementWithName:(NSString *)name
+{
+    PXRecordingDOMElement *element = [[PXRecordingDOMElement alloc] initWithName:name];
+
+    element.log = log_;
+
+    return element;
+}
+
+#pragma mark - Tests
+
+- (void)testRepeatedRequestsAreCoalesced
+{
+    PXRecordingDOMElement *element = [self elementWithName:@"button"];
+
+    [scheduler_ setStyleableNeedsStyle:element recursively:YES];
+    [scheduler_ setStyleableNeedsStyle:element recursively:YES];
+    [scheduler_ setStyleableNeedsStyle:element recursively:YES];
+
+    XCTAssertEqual((NSUInteger) 1, scheduler_.pendingCount, @"Expected one pending styleable");
+    XCTAssertEqual((NSUInteger) 0, element.recursiveUpdateCount, @"Expected styling to be deferred");
+
+    [scheduler_ flush];
+
+    XCTAssertEqual((NSUInteger) 1, element.recursiveUpdateCount, @"Expected a single update");
+    XCTAssertEqual((NSUInteger) 1, scheduler_.lastPassStyledCount, @"Expected one styled styleable");
+    XCTAssertEqual((NSUInteger) 2, scheduler_.lastPassSkippedCount, @"Expected two skipped requests");
+    XCTAssertEqual((NSUInteger) 0, scheduler_.pendingCount, @"Expected no pending work");
+}
+
+- (void)testRecursiveRequestWins
+{
+    PXRecordingDOMElement *element = [self elementWithName:@"button"];
+
+    [scheduler_ setStyleableNeedsStyle:element recursively:NO];
+    [scheduler_ setStyleableNeedsStyle:element recursively:YES];
+    [scheduler_ flush];
+
+    XCTAssertEqual((NSUInteger) 1, element.recursiveUpdateCount, @"Expected a recursive update");
+    XCTAssertEqual((NSUInteger) 0, element.nonRecursiveUpdateCount, @"Expected no non-recursive update");
+}
+
+- (void)testDescendantsOfRecursiveUpdatesAreSkipped
+{
+    PXRecordingDOMElement *root = [self elementWithName:@"view"];
+    PXRecordingDOMElement *child = [self elementWithName:@"cell"];
+    PXRecordingDOMElement *grandchild = [self elementWithName:@"label"];
+
+    [root addChild:child];
+    [child addChild:grandchild];
+
+    [scheduler_ setStyleableNeedsStyle:grandchild recursively:NO];
+    [scheduler_ setStyleableNeedsStyle:child recursively:YES];
+    [scheduler_ setStyleableNeedsStyle:root recursively:YES];
+    [scheduler_ flush];
+
+    XCTAssertEqualObjects(@[ @"view" ], log_, @"Expected only the root to be styled");
+    XCTAssertEqual((NSUInteger) 2, scheduler_.lastPassSkippedCount, @"Expected the descendants to be skipped");
+}
+
+- (void)testAncestorsAreStyledFirst
+{
+    PXRecordingDOMElement *root = [self elementWithName:@"view"];
+    PXRecordingDOMElement *child = [self elementWithName:@"cell"];
+    PXRecordingDOMElement *grandchild = [self elementWithName:@"label"];
+
+    [root addChild:child];
+    [child addChild:grandchild];
+
+    // non-recursive updates do not cover descendants
+    [scheduler_ setStyleableNeedsStyle:grandchild recursively:YES];
+    [scheduler_ setStyleableNeedsStyle:root recursively:NO];
+    [scheduler_ setStyleableNeedsStyle:child recursively:NO];
+    [scheduler_ flush];
+
+    NSArray *expected = @[ @"view", @"cell", @"label" ];
+
+    XCTAssertEqualObjects(expected, log_, @"Expected top-down order");
+    XCTAssertEqual((NSUInteger) 3, scheduler_.lastPassStyledCount, @"Expected all three to be styled");
+}
+
+- (void)testReleasedStyleablesAreSkipped
+{
+    @autoreleasepool
+    {
+        PXRecordingDOMElement *element = [self elementWithName:@"button"];
+
+        [scheduler_ setStyleableNeedsStyle:element recursively:YES];
+    }
+
+    [scheduler_ flush];
+
+    XCTAssertEqual((NSUInteger) 0, scheduler_.lastPassStyledCount, @"Expected nothing to be styled");
+    XCTAssertEqual((NSUInteger) 1, scheduler_.lastPassSkippedCount, @"Expected the released styleable to be skipped");
+}
+
+- (void)testFrameBudgetSpillsWork
+{
+    NSMutableArray *elements = [NSMutableArray array];
+
+    for (NSUInteger i = 0; i < 3; i++)
+    {
+        PXRecordingDOMElement *element = [self elementWithName:@"button"];
+
+        element.updateDuration = 0.01;
+        [elements addObject:element];
+        [scheduler_ setStyleableNeedsStyle:element recursively:YES];
+    }
+
+    scheduler_.frameBudget = 0.001;
+
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2.0];
+
+    while (scheduler_.totalStyledCount < 3 && [timeout timeIntervalSinceNow] > 0)
+    {
+        [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+
+    XCTAssertEqual((NSUInteger) 3, scheduler_.totalStyledCount, @"Expected every styleable to be styled eventually");
+    XCTAssertEqual((NSUInteger) 3, scheduler_.passCount, @"Expected one styleable per pass");
+    XCTAssertTrue(scheduler_.totalDuration >= 0.03, @"Expected the pass time to be counted");
+
+    for (PXRecordingDOMElement *element in elements)
+    {
+        XCTAssertEqual((NSUInteger) 1, element.recursiveUpdateCount, @"Expected a single update");
+    }
+}
+
+@end
@@ -0,0 +1,309 @@
+//
+//  PXStylesheetCompilerTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXStylesheetCompiler.h"
+#import "PXCompiledStylesheet.h"
+#import "PXMediaGroup.h"
+#import "PXKeyframeBlock.h"
+
+@interface PXStylesheetCompilerTests : XCTestCase
+
+@end
+
+@implementation PXStylesheetCompilerTests
+
+#pragma mark - Helpers
+
+- (PXStylesheet *)parse:(NSString *)source
+{
+    return [PXStylesheet parsedStyleSheetFromSource:source withOrigin:PXStylesheetOriginApplication filename:nil];
+}
+
+- (PXStylesheet *)roundTrip:(PXStylesheet *)stylesheet
+{
+    NSData *data = [PXStylesheetCompiler dataForStylesheet:stylesheet];
+
+    XCTAssertNotNil(data, @"Expected compiled data");
+
+    return [[[PXCompiledStylesheet alloc] initWithData:data] stylesheetWithOrigin:stylesheet.origin];
+}
+
+- (void)assertRoundTripOfSource:(NSString *)source
+{
+    PXStylesheet *expected = [self parse:source];
+    PXStylesheet *actual = [self roundTrip:expected];
+
+    XCTAssertNotNil(actual, @"Expected a compiled stylesheet");
+    XCTAssertEqualObjects(expected.description, actual.description, @"Compiled stylesheet differs from parsed stylesheet");
+    XCTAssertEqual(expected.mediaGroups.count, actual.mediaGroups.count, @"Media group counts differ");
+    XCTAssertEqualObjects(expected.namespacePrefixes, actual.namespacePrefixes, @"Namespaces differ");
+    XCTAssertEqualObjects(expected.errors, actual.errors, @"Errors differ");
+}
+
+- (NSString *)themeSourceWithVariantCount:(NSUInteger)count
+{
+    // modeled after the structure of themes/pixate-blue/css/default.css, repeated with a unique suffix per variant
+    NSMutableString *result = [NSMutableString string];
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        unsigned int color = (unsigned int) ((i * 2654435761u) & 0xFFFFFF);
+
+        [result appendFormat:@".container-%lu { border: 1px solid #%06x; }\n", (unsigned long) i, color];
+        [result appendFormat:@"navigation-bar.theme-%lu { background-color: #%06x; opacity: 1; color: white; }\n", (unsigned long) i, color];
+        [result appendFormat:@"navigation-bar.theme-%lu title { color: white; font-family: \"Avenir\"; font-size: 17pt; font-weight: bold; }\n", (unsigned long) i];
+        [result appendFormat:@"tab-bar.theme-%lu tab-bar-item:selected { color: #%06x; }\n", (unsigned long) i, color];
+        [result appendFormat:@".h1-%lu, .h2-%lu, .h3-%lu { font-family: \"Avenir\"; font-weight: bold; }\n", (unsigned long) i, (unsigned long) i, (unsigned long) i];
+        [result appendFormat:@"button.button-%lu { background-color: linear-gradient(#%06x, #ffffff); border-radius: 4px; border: 1px solid #d8d9dc; padding: 6px 12px; }\n", (unsigned long) i, color];
+        [result appendFormat:@"button.button-%lu:highlighted { background-color: #%06x; box-shadow: inset 0 1px 3px rgba(0,0,0,0.25); }\n", (unsigned long) i, color];
+        [result appendFormat:@"button.button-%lu > label { color: white; text-shadow: 0 1px 0 #000000; }\n", (unsigned long) i];
+        [result appendFormat:@"table-view-cell.cell-%lu:nth-child(2n+1) { background-color: #f6f6f6; }\n", (unsigned long) i];
+        [result appendFormat:@"#text-field-%lu[placeholder] ~ label { font-size: 14pt !important; }\n", (unsigned long) i];
+        [result appendFormat:@"@media (orientation:landscape) and (max-device-width:1024px) { .form-%lu { width: 480px; } }\n", (unsigned long) i];
+        [result appendFormat:@"@keyframes pulse-%lu { from { opacity: 0; } 50%% { opacity: 1; } to { opacity: 0; } }\n", (unsigned long) i];
+    }
+
+    return result;
+}
+
+#pragma mark - Tests
+
+- (void)testSelectors
+{
+    [self assertRoundTripOfSource:
+        @"button {}\n"
+        @"#myId {}\n"
+        @".myClass.otherClass {}\n"
+        @"button:highlighted::icon {}\n"
+        @"a b > c + d ~ e {}\n"
+        @"*[title] {}\n"
+        @"[title^=\"abc\"], [title$='def'], [title*=ghi], [title=jkl], [title~=mno], [title|=pqr] {}\n"
+        @"view:nth-child(2n+1):nth-last-of-type(-n+3) {}\n"
+        @"view:first-child:last-of-type:only-child:empty:root {}\n"
+        @"button:not(.disabled) {}\n"];
+}
+
+- (void)testDeclarations
+{
+    [self assertRoundTripOfSource:
+        @"button {\n"
+        @"  background-color: linear-gradient(red, #0f0 50%, rgba(0, 0, 255, 0.5));\n"
+        @"  border: 1px solid #abcdef;\n"
+        @"  font-family: \"Helvetica Neue\";\n"
+        @"  transform: rotate(45deg) scale(1.5);\n"
+        @"  shape: ellipse;\n"
+        @"  color: blue !important;\n"
+        @"}"];
+}
+
+- (void)testMediaQueriesNamespacesAndKeyframes
+{
+    NSString *source =
+        @"@namespace svg \"http://www.w3.org/2000/svg\";\n"
+        @"@namespace \"http://www.pixate.com\";\n"
+        @"svg|rect { fill: red; }\n"
+        @"@media (orientation:landscape) { button { width: 10px; } }\n"
+        @"@media (orientation:portrait) and (min-device-width: 320px) and (device-aspect-ratio: 16/9) { button { width: 20px; } }\n"
+        @"@keyframes pulse { from { opacity: 0; } 50%, 75% { opacity: 0.5; } to { opacity: 1; } }\n";
+    PXStylesheet *expected = [self parse:source];
+    PXStylesheet *actual = [self roundTrip:expected];
+
+    [self assertRoundTripOfSource:source];
+
+    PXKeyframe *keyframe = [actual keyframeForName:@"pulse"];
+
+    XCTAssertNotNil(keyframe, @"Expected a 'pulse' keyframe");
+    XCTAssertEqual([expected keyframeForName:@"pulse"].blocks.count, keyframe.blocks.count, @"Block counts differ");
+
+    PXKeyframeBlock *block = [keyframe.blocks objectAtIndex:2];
+
+    XCTAssertEqualWithAccuracy(0.75f, block.offset, 0.0001f, @"Unexpected block offset");
+    XCTAssertEqualObjects(@"0.5", [block declarationForName:@"opacity"].stringValue, @"Unexpected block declaration");
+}
+
+- (void)testParseErrors
+{
+    [self assertRoundTripOfSource:@"button { abc: def; ghi jkl }\n{ color: red; }"];
+}
+
+- (void)testSharedDeclarations
+{
+    PXStylesheet *stylesheet = [self roundTrip:[self parse:@"a, b, c { color: red; }"]];
+    NSArray *ruleSets = stylesheet.ruleSets;
+
+    XCTAssertEqual((NSUInteger) 3, ruleSets.count, @"Expected a rule set per selector");
+
+    PXDeclaration *first = [((PXRuleSet *) [ruleSets objectAtIndex:0]).declarations objectAtIndex:0];
+    PXDeclaration *last = [((PXRuleSet *) [ruleSets objectAtIndex:2]).declarations objectAtIndex:0];
+
+    XCTAssertTrue(first == last, @"Expected rule sets from one selector group to share declarations");
+}
+
+- (void)testStylesheetResources
+{
+    NSBundle *bundle = [NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"];
+
+    for (NSString *name in @[ @"large", @"sampleSelectors", @"messageSheet" ])
+    {
+        NSString *path = [bundle pathForResource:name ofType:@"css"];
+        NSString *source = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+
+        [self assertRoundTripOfSource:source];
+    }
+}
+
+- (void)testInvalidData
+{
+    NSData *data = [PXStylesheetCompiler dataForStylesheet:[self parse:@"button { color: red; }"]];
+
+    XCTAssertNil([[PXCompiledStylesheet alloc] initWithData:[@"button { color: red; }" dataUsingEncoding:NSUTF8StringEncoding]], @"Expected CSS to be rejected");
+    XCTAssertNil([[PXCompiledStylesheet alloc] initWithData:[data subdataWithRange:NSMakeRange(0, data.length - 4)]], @"Expected truncated data to be rejected");
+
+    // damaged records must not crash
+    NSMutableData *damaged = [data mutableCopy];
+    uint8_t *bytes = damaged.mutableBytes;
+
+    for (NSUInteger i = sizeof(PXCompiledStylesheetHeader); i < damaged.length; i += 7)
+    {
+        bytes[i] ^= 0xFF;
+    }
+
+    PXStylesheet *stylesheet = [[[PXCompiledStylesheet alloc] initWithData:damaged] stylesheetWithOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertNotNil(stylesheet.description, @"Expected a description");
+}
+
+- (void)testCompileFile
+{
+    NSString *directory = NSTemporaryDirectory();
+    NSString *cssPath = [directory stringByAppendingPathComponent:@"compiler-test.css"];
+    NSString *compiledPath = [directory stringByAppendingPathComponent:@"compiler-test.pxssc"];
+    NSArray *errors = nil;
+
+    [@"button { color: red; }" writeToFile:cssPath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+
+    XCTAssertTrue([PXStylesheetCompiler compileFileAtPath:cssPath toPath:compiledPath errors:&errors], @"Expected file to compile");
+    XCTAssertEqual((NSUInteger) 0, errors.count, @"Expected no parse errors");
+
+    PXStylesheet *stylesheet = [PXStylesheet loadedStyleSheetFromFilePath:compiledPath withOrigin:PXStylesheetOriginUser];
+
+    XCTAssertEqual(PXStylesheetOriginUser, stylesheet.origin, @"Expected user origin");
+    XCTAssertEqualObjects(compiledPath, stylesheet.filePath, @"Expected compiled file path");
+    XCTAssertEqual((NSUInteger) 1, stylesheet.ruleSets.count, @"Expected one rule set");
+}
+
+- (void)testStaleCompiledFileFallsBackToSource
+{
+    NSString *directory = NSTemporaryDirectory();
+    NSString *cssPath = [directory stringByAppendingPathComponent:@"stale-test.css"];
+    NSString *compiledPath = [directory stringByAppendingPathComponent:@"stale-test.pxssc"];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+
+    [@"button { color: red; }" writeToFile:cssPath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+    XCTAssertTrue([PXStylesheetCompiler compileFileAtPath:cssPath toPath:compiledPath errors:NULL], @"Expected file to compile");
+
+    PXStylesheet *stylesheet = [PXStylesheet loadedStyleSheetFromFilePath:compiledPath withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertEqualObjects(compiledPath, stylesheet.filePath, @"Expected a current compiled file to be used");
+
+    // edited CSS with a date that does not give it away, as after a checkout
+    NSDictionary *compiledAttributes = [fileManager attributesOfItemAtPath:compiledPath error:NULL];
+
+    [@"button { color: red; } label { color: blue; }" writeToFile:cssPath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+    [fileManager setAttributes:@{ NSFileModificationDate : compiledAttributes.fileModificationDate } ofItemAtPath:cssPath error:NULL];
+
+    stylesheet = [PXStylesheet loadedStyleSheetFromFilePath:compiledPath withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertEqualObjects(cssPath, stylesheet.filePath, @"Expected CSS compiled from other contents to be used instead");
+    XCTAssertEqual((NSUInteger) 2, stylesheet.ruleSets.count, @"Expected the edited rule sets");
+
+    // CSS edited after it was compiled
+    [PXStylesheetCompiler compileFileAtPath:cssPath toPath:compiledPath errors:NULL];
+    [fileManager setAttributes:@{ NSFileModificationDate : [NSDate dateWithTimeIntervalSinceNow:60.0] } ofItemAtPath:cssPath error:NULL];
+
+    stylesheet = [PXStylesheet loadedStyleSheetFromFilePath:compiledPath withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertEqualObjects(cssPath, stylesheet.filePath, @"Expected CSS newer than its compiled file to be used instead");
+
+    // damaged compiled file
+    [[@"not compiled" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:compiledPath atomically:YES];
+
+    stylesheet = [PXStylesheet loadedStyleSheetFromFilePath:compiledPath withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertEqualObjects(cssPath, stylesheet.filePath, @"Expected CSS to be used when the compiled file cannot be loaded");
+    XCTAssertEqual((NSUInteger) 0, stylesheet.errors.count, @"Expected no errors");
+
+    // no CSS to fall back to
+    [fileManager removeItemAtPath:cssPath error:NULL];
+
+    stylesheet = [PXStylesheet loadedStyleSheetFromFilePath:compiledPath withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertEqual((NSUInteger) 1, stylesheet.errors.count, @"Expected a load error");
+}
+
+- (void)testConcurrentMaterialization
+{
+    PXStylesheet *expected = [self parse:[self themeSourceWithVariantCount:50]];
+    PXStylesheet *actual = [self roundTrip:expected];
+    NSArray *expectedRuleSets = expected.ruleSets;
+    NSArray *actualRuleSets = actual.ruleSets;
+    NSUInteger count = actualRuleSets.count;
+    __block NSUInteger mismatches = 0;
+
+    XCTAssertEqual(expectedRuleSets.count, count, @"Expected the same number of rule sets");
+
+    // several threads read each rule set's specificity while others decode its selectors
+    dispatch_apply(count * 4, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        PXRuleSet *expectedRuleSet = [expectedRuleSets objectAtIndex:i % count];
+        PXRuleSet *actualRuleSet = [actualRuleSets objectAtIndex:i % count];
+        BOOL restored = [actualRuleSet.specificity compareSpecificity:expectedRuleSet.specificity] == NSOrderedSame;
+        BOOL decoded = actualRuleSet.selectors.count == expectedRuleSet.selectors.count
+                    && [actualRuleSet.specificity compareSpecificity:expectedRuleSet.specificity] == NSOrderedSame;
+
+        if (!restored || !decoded)
+        {
+            @synchronized(self)
+            {
+                mismatches++;
+            }
+        }
+    });
+
+    XCTAssertEqual((NSUInteger) 0, mismatches, @"Expected specificity to never be seen part way through decoding");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testGeneratedThemeStartupTime
+{
+    NSString *directory = NSTemporaryDirectory();
+    NSString *cssPath = [directory stringByAppendingPathComponent:@"generated-theme.css"];
+    NSString *compiledPath = [directory stringByAppendingPathComponent:@"generated-theme.pxssc"];
+
+    [[self themeSourceWithVariantCount:500] writeToFile:cssPath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+    XCTAssertTrue([PXStylesheetCompiler compileFileAtPath:cssPath toPath:compiledPath errors:NULL], @"Expected theme to compile");
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+    PXStylesheet *parsed = [PXStylesheet loadedStyleSheetFromFilePath:cssPath withOrigin:PXStylesheetOriginApplication];
+    double parseTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+    PXStylesheet *mapped = [PXStylesheet loadedStyleSheetFromFilePath:compiledPath withOrigin:PXStylesheetOriginApplication];
+    double loadTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    // forces every selector and declaration to be decoded
+    start = [[NSDate date] timeIntervalSinceNow];
+    NSString *mappedDescription = mapped.description;
+    double materializeTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertEqualObjects(parsed.description, mappedDescription, @"Compiled theme differs from parsed theme");
+
+    NSLog(@"Text parse = %f ms, mmap load = %f ms, full materialization = %f ms", parseTime * 1000, loadTime * 1000, materializeTime * 1000);
+}
+
+@end
@@ -0,0 +1,132 @@
+//
+//  PXStylesheetDiffTests.m
+//  Pixate
+//
+
+#import <XCTest/XCTest.h>
+#import "PXStylesheetDiff.h"
+#import "PXStylesheet.h"
+#import "PXStylesheet-Private.h"
+#import "PXStyleableAtoms.h"
+#import "PXDOMElement.h"
+
+@interface PXStylesheetDiffTests : XCTestCase
+
+@end
+
+@implementation PXStylesheetDiffTests
+
+#pragma mark - Setup
+
+- (void)tearDown
+{
+    [PXStylesheet styleSheetFromSource:@"" withOrigin:PXStylesheetOriginApplication];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (PXStylesheetDiff *)diffFromSource:(NSString *)oldSource toSource:(NSString *)newSource
+{
+    PXStylesheet *oldStylesheet = [PXStylesheet parsedStyleSheetFromSource:oldSource withOrigin:PXStylesheetOriginApplication filename:nil];
+    PXStylesheet *newStylesheet = [PXStylesheet parsedStyleSheetFromSource:newSource withOrigin:PXStylesheetOriginApplication filename:nil];
+
+    return [PXStylesheetDiff diffFromStylesheet:oldStylesheet toStylesheet:newStylesheet];
+}
+
+- (PXDOMElement *)elementWithName:(NSString *)name styleClass:(NSString *)styleClass
+{
+    PXDOMElement *element = [[PXDOMElement alloc] initWithName:name];
+
+    element.styleClass = styleClass;
+
+    return element;
+}
+
+#pragma mark - Tests
+
+- (void)testIdenticalStylesheets
+{
+    PXStylesheetDiff *diff = [self diffFromSource:@"button { color: red; } label { color: blue; }"
+                                         toSource:@"button { color: red; } label { color: blue; }"];
+
+    XCTAssertFalse(diff.hasChanges, @"Expected no changes");
+    XCTAssertFalse(diff.affectsAll, @"Expected no changes");
+    XCTAssertEqual((NSUInteger) 0, diff.changedRuleSets.count, @"Expected no changed rule sets");
+}
+
+- (void)testEditedRuleSet
+{
+    PXStylesheetDiff *diff = [self diffFromSource:@"button { color: red; } label.title { color: blue; } view { opacity: 1; }"
+                                         toSource:@"button { color: red; } label.title { color: green; } view { opacity: 1; }"];
+
+    XCTAssertTrue(diff.hasChanges, @"Expected changes");
+    XCTAssertFalse(diff.affectsAll, @"Expected the changes to be narrowed");
+    XCTAssertEqual((NSUInteger) 2, diff.changedRuleSets.count, @"Expected the old and new versions of the edited rule set");
+
+    XCTAssertTrue([diff affectsStyleable:[self elementWithName:@"label" styleClass:@"title subtitle"]], @"Expected titles to be affected");
+    XCTAssertFalse([diff affectsStyleable:[self elementWithName:@"label" styleClass:@"subtitle"]], @"Expected other labels to be unaffected");
+    XCTAssertFalse([diff affectsStyleable:[self elementWithName:@"button" styleClass:@"title"]], @"Expected buttons to be unaffected");
+}
+
+- (void)testAddedRuleSetUsesNewClass
+{
+    PXDOMElement *element = [self elementWithName:@"button" styleClass:@"diff-never-mentioned-before"];
+    PXStyleableAtoms *atoms = [[PXStyleableAtoms alloc] initWithElementName:@"button"
+                                                                    styleId:nil
+                                                               styleClasses:@[ @"diff-recorded-class" ]
+                                                                     intern:YES];
+    PXStylesheetDiff *diff = [self diffFromSource:@"label { color: red; }"
+                                         toSource:@"label { color: red; } .diff-never-mentioned-before, .diff-recorded-class { color: blue; }"];
+
+    XCTAssertTrue([diff affectsStyleable:element], @"Expected a class introduced by the new stylesheet to be found");
+    XCTAssertTrue([diff affectsAnyStyleableAtoms:@[ atoms ]], @"Expected recorded atoms to be found");
+}
+
+- (void)testCombinatorsUseTheirTarget
+{
+    PXStylesheetDiff *diff = [self diffFromSource:@"button { color: red; }"
+                                         toSource:@"button { color: red; } table-view cell > label { color: blue; }"];
+
+    XCTAssertTrue([diff affectsStyleable:[self elementWithName:@"label" styleClass:nil]], @"Expected labels to be affected");
+    XCTAssertFalse([diff affectsStyleable:[self elementWithName:@"cell" styleClass:nil]], @"Expected cells to be unaffected");
+}
+
+- (void)testMovedRuleSetsAreChanged
+{
+    PXStylesheetDiff *diff = [self diffFromSource:@"button { color: red; } label { color: blue; } view { opacity: 1; }"
+                                         toSource:@"label { color: blue; } button { color: red; } view { opacity: 1; }"];
+
+    XCTAssertTrue([diff affectsStyleable:[self elementWithName:@"button" styleClass:nil]], @"Expected buttons to be affected");
+    XCTAssertTrue([diff affectsStyleable:[self elementWithName:@"label" styleClass:nil]], @"Expected labels to be affected");
+    XCTAssertFalse([diff affectsStyleable:[self elementWithName:@"view" styleClass:nil]], @"Expected views to be unaffected");
+}
+
+- (void)testMediaQueriesArePartOfRuleSets
+{
+    PXStylesheetDiff *diff = [self diffFromSource:@"@media (orientation:portrait) { button { color: red; } }"
+                                         toSource:@"@media (orientation:landscape) { button { color: red; } }"];
+
+    XCTAssertTrue([diff affectsStyleable:[self elementWithName:@"button" styleClass:nil]], @"Expected buttons to be affected");
+}
+
+- (void)testUnnarrowableChanges
+{
+    XCTAssertTrue([self diffFromSource:@"button { color: red; }" toSource:@"button { color: red; } * { color: blue; }"].affectsAll, @"Expected universal selectors to affect all");
+    XCTAssertTrue([self diffFromSource:@"button { color: red; }" toSource:@"button { color: red; } :first-child { color: blue; }"].affectsAll, @"Expected pseudo-class only selectors to affect all");
+    XCTAssertTrue([self diffFromSource:@"button { color: red; }" toSource:@"@namespace svg url(http://www.w3.org/2000/svg); button { color: red; }"].affectsAll, @"Expected namespace changes to affect all");
+    XCTAssertTrue([PXStylesheetDiff diffFromStylesheet:nil toStylesheet:[[PXStylesheet alloc] initWithOrigin:PXStylesheetOriginApplication makeCurrent:NO]].affectsAll, @"Expected a first stylesheet to affect all");
+}
+
+- (void)testLoadingRecordsChanges
+{
+    [PXStylesheet styleSheetFromSource:@"button { color: red; }" withOrigin:PXStylesheetOriginApplication];
+
+    PXStylesheet *stylesheet = [PXStylesheet styleSheetFromSource:@"button { color: red; } label { color: blue; }" withOrigin:PXStylesheetOriginApplication];
+
+    XCTAssertNotNil(stylesheet.changesFromPreviousStylesheet, @"Expected the changes to be recorded");
+    XCTAssertEqual((NSUInteger) 1, stylesheet.changesFromPreviousStylesheet.changedRuleSets.count, @"Expected the added rule set");
+}
+
+@end
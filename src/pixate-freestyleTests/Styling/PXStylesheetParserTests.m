@@ -15,6 +15,11 @@
 #import "PXMediaExpressionGroup.h"
 #import "PXKeyframeBlock.h"
 #import "PXLinearGradient.h"
+#import "PXStylesheetLexer.h"
+#import "PXStylesheetLexeme.h"
+#import "PXDeclaration.h"
+#import "PXRuleSet.h"
+#import <malloc/malloc.h>
 
 @interface PXStylesheetParserTests : XCTestCase
 
@@ -822,6 +827,147 @@
     NSLog(@"Elapsed time = %f", diff * 1000);
 }
 
+- (size_t)liveAllocationsAfterParsingLargeCSS:(BOOL)usesMatcherChain stylesheet:(PXStylesheet **)stylesheet
+{
+    NSString *path = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathForResource:@"large" ofType:@"css"];
+    NSString *source = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+    PXStylesheet *result = nil;
+    malloc_statistics_t before, after;
+
+    [PXStylesheetLexer setUsesMatcherChainByDefault:usesMatcherChain];
+
+    @autoreleasepool
+    {
+        malloc_zone_statistics(NULL, &before);
+
+        PXStylesheetParser *parser = [[PXStylesheetParser alloc] init];
+        result = [parser parse:source withOrigin:PXStylesheetOriginApplication];
+    }
+
+    malloc_zone_statistics(NULL, &after);
+
+    [PXStylesheetLexer setUsesMatcherChainByDefault:NO];
+
+    *stylesheet = result;
+
+    // the allocator may free more than the parse allocated, such as pooled objects released by the autorelease pool
+    return (after.blocks_in_use > before.blocks_in_use) ? after.blocks_in_use - before.blocks_in_use : 0;
+}
+
+- (NSUInteger)deferredLexemeCountInStylesheet:(PXStylesheet *)stylesheet
+{
+    NSUInteger result = 0;
+
+    for (PXRuleSet *ruleSet in stylesheet.ruleSets)
+    {
+        for (PXDeclaration *declaration in ruleSet.declarations)
+        {
+            for (PXStylesheetLexeme *lexeme in declaration.lexemes)
+            {
+                if (lexeme.valueDeferred)
+                {
+                    result++;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+- (void)testLargeCSSAllocations
+{
+    PXStylesheet *eagerStylesheet = nil;
+    PXStylesheet *lazyStylesheet = nil;
+
+    // count the blocks kept alive by each stylesheet. Eager lexemes hold on to a string or number per token while
+    // source-backed lexemes only create values on demand
+    size_t eagerBlocks = [self liveAllocationsAfterParsingLargeCSS:YES stylesheet:&eagerStylesheet];
+    size_t lazyBlocks = [self liveAllocationsAfterParsingLargeCSS:NO stylesheet:&lazyStylesheet];
+
+    XCTAssertNotNil(eagerStylesheet, @"Expected a stylesheet");
+    XCTAssertNotNil(lazyStylesheet, @"Expected a stylesheet");
+    XCTAssertEqual(eagerStylesheet.ruleSets.count, lazyStylesheet.ruleSets.count, @"Expected the same number of rule sets");
+
+    // the allocator's block counts vary between runs, so only the values still waiting to be created are asserted
+    NSUInteger eagerDeferred = [self deferredLexemeCountInStylesheet:eagerStylesheet];
+    NSUInteger lazyDeferred = [self deferredLexemeCountInStylesheet:lazyStylesheet];
+
+    XCTAssertTrue(lazyDeferred > 0, @"Expected lazy lexemes to leave values to be created on demand");
+    XCTAssertLessThan(eagerDeferred, lazyDeferred, @"Expected eager lexemes to create their values while lexing");
+
+    NSLog(@"Live allocations: eager lexemes = %lu, lazy lexemes = %lu (%lu values deferred)", (unsigned long) eagerBlocks, (unsigned long) lazyBlocks, (unsigned long) lazyDeferred);
+}
+
+#pragma mark - Concurrency Tests
+
+- (void)testConcurrentParsing
+{
+    NSString *path = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathForResource:@"large" ofType:@"css"];
+    NSString *source = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+    PXStylesheet *expected = [PXStylesheet parsedStyleSheetFromSource:source withOrigin:PXStylesheetOriginApplication filename:nil];
+    NSUInteger expectedCount = expected.ruleSets.count;
+    NSUInteger expectedErrorCount = expected.errors.count;
+    const size_t iterations = 64;
+    __block NSUInteger mismatches = 0;
+
+    dispatch_apply(iterations, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index) {
+        PXStylesheet *stylesheet = [PXStylesheet parsedStyleSheetFromSource:source withOrigin:PXStylesheetOriginApplication filename:nil];
+        PXRuleSet *ruleSet = stylesheet.ruleSets.lastObject;
+
+        // force declaration values to be parsed on this thread as well
+        for (PXDeclaration *declaration in ruleSet.declarations)
+        {
+            (void) declaration.stringValue;
+        }
+
+        if (stylesheet.ruleSets.count != expectedCount || stylesheet.errors.count != expectedErrorCount)
+        {
+            @synchronized(self)
+            {
+                mismatches++;
+            }
+        }
+    });
+
+    XCTAssertEqual(mismatches, (NSUInteger) 0, @"Concurrent parses did not match the serial parse");
+}
+
+- (void)testAsyncStylesheetFromFilePath
+{
+    NSString *path = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathForResource:@"sampleSelectors" ofType:@"css"];
+    const NSUInteger requests = 16;
+    __block NSUInteger completed = 0;
+    __block PXStylesheet *latestStylesheet = nil;
+
+    for (NSUInteger i = 0; i < requests; i++)
+    {
+        [PXStylesheet styleSheetFromFilePath:path withOrigin:PXStylesheetOriginUser completion:^(PXStylesheet *stylesheet) {
+            XCTAssertTrue([NSThread isMainThread], @"Expected completion on the main thread");
+            XCTAssertNotNil(stylesheet, @"Expected a stylesheet");
+
+            completed++;
+
+            if (i == requests - 1)
+            {
+                latestStylesheet = stylesheet;
+            }
+        }];
+    }
+
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:30.0];
+
+    while (completed < requests && [timeout timeIntervalSinceNow] > 0)
+    {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+
+    XCTAssertEqual(completed, requests, @"Expected all loads to complete");
+
+    // loads may finish in any order, but only the last one requested is allowed to become current
+    XCTAssertTrue([PXStylesheet currentUserStylesheet] == latestStylesheet, @"Expected the latest load to be current");
+}
+
 #pragma mark - Bug Fixes
 
 - (void)testCrashWithHexPaint
@@ -0,0 +1,135 @@
+//
+//  PXStylesheetScannerTests.m
+//  Pixate
+//
+
+#import "PXStylesheetLexer.h"
+#import "PXStylesheetTokenType.h"
+#import <XCTest/XCTest.h>
+
+@interface PXStylesheetScannerTests : XCTestCase
+
+@end
+
+@implementation PXStylesheetScannerTests
+
+#pragma mark - Helpers
+
+- (NSArray *)lexemesForSource:(NSString *)source usingMatcherChain:(BOOL)usesMatcherChain
+{
+    PXStylesheetLexer *lexer = [[PXStylesheetLexer alloc] init];
+    NSMutableArray *result = [NSMutableArray array];
+
+    lexer.usesMatcherChain = usesMatcherChain;
+    lexer.source = source;
+
+    PXStylesheetLexeme *lexeme = [lexer nextLexeme];
+
+    while (lexeme)
+    {
+        [result addObject:lexeme];
+        lexeme = [lexer nextLexeme];
+    }
+
+    return result;
+}
+
+- (void)assertSameLexemesForSource:(NSString *)source
+{
+    NSArray *expected = [self lexemesForSource:source usingMatcherChain:YES];
+    NSArray *actual = [self lexemesForSource:source usingMatcherChain:NO];
+
+    XCTAssertEqual(expected.count, actual.count, @"Lexeme counts differ for '%@'", source);
+
+    NSUInteger count = MIN(expected.count, actual.count);
+
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        PXStylesheetLexeme *expectedLexeme = expected[i];
+        PXStylesheetLexeme *actualLexeme = actual[i];
+
+        XCTAssertEqual(expectedLexeme.type, actualLexeme.type, @"Types differ at lexeme %lu for '%@': %@ vs %@", (unsigned long) i, source, expectedLexeme, actualLexeme);
+        XCTAssertTrue(NSEqualRanges(expectedLexeme.range, actualLexeme.range), @"Ranges differ at lexeme %lu for '%@': %@ vs %@", (unsigned long) i, source, expectedLexeme, actualLexeme);
+        XCTAssertEqualObjects([expectedLexeme.value description], [actualLexeme.value description], @"Values differ at lexeme %lu for '%@'", (unsigned long) i, source);
+        XCTAssertEqual([expectedLexeme flagIsSet:PXLexemeFlagFollowsWhitespace], [actualLexeme flagIsSet:PXLexemeFlagFollowsWhitespace], @"Whitespace flags differ at lexeme %lu for '%@'", (unsigned long) i, source);
+    }
+}
+
+#pragma mark - Tests
+
+- (void)testLexerTestCorpus
+{
+    // the sources used by PXStylesheetLexerTests
+    NSArray *sources = @[
+        @"123", @"123.456", @".class", @".one\\ two", @"#id", @"#one\\ two", @"identifier0-with-dashes-and-numbers", @"one\\ two",
+        @"{", @"}", @"(", @")", @"[", @"]", @";", @">",
+        @"+", @"~", @"*", @"=", @":", @",", @"|", @"::",
+        @"^=", @"$=", @"*=", @"~=", @"|=", @"\"abc\"", @"\"This is a test with a tab \\t and a double-quote \\\"\"", @"'abc'",
+        @"'This is a test with a tab \\t and a single-quote \\''", @":not(", @"linear-gradient(", @"hsb(", @"hsba(", @"rgb(", @"rgba(", @"10em",
+        @"10ex", @"10px", @"10dpx", @"10cm", @"10mm", @"10in", @"10pt", @"10pc",
+        @"10deg", @"10rad", @"10grad", @"10ms", @"10s", @"10Hz", @"10kHz", @"10%",
+        @"10units", @"@keyframes", @"&", @"#abc", @"#back", @"#background", @"url(\"http://www.pixate.com\")", @"url(http://www.pixate.com)",
+        @"@namespace", @":link", @":visited", @":hover", @":active", @":focus", @":target", @":lang(",
+        @":enabled", @":checked", @":indeterminate", @":root", @":nth-child(", @":nth-last-child(", @":nth-of-type(", @":nth-last-of-type(",
+        @":first-child", @":last-child", @":first-of-type", @":last-of-type", @":only-child", @":only-of-type", @":empty", @"n",
+        @"-n", @"+n", @"2n", @"+2n", @"-2n", @"!important", @"! important", @"@import",
+        @"@media", @"and",
+    ];
+
+    for (NSString *source in sources)
+    {
+        [self assertSameLexemesForSource:source];
+    }
+}
+
+- (void)testEdgeCases
+{
+    NSArray *sources = @[
+        @"/* unterminated", @"/**/a", @"a/*x*/b", @"url( data:image/png;base64,iVBORw0KGgo= )", @"url(foo bar)", @"url(",
+        @"#abcd #abcde #abcdef12 #abcdef123 #123", @"1.5 .5 1. -.5em +3 - -- -x 10-5", @"2n+1 -n+3 nope N",
+        @"@media screen and (orientation:landscape) { a { b: c } }", @"@mediax @import'x'", @"!importantx ! /**/important",
+        @"\"unterminated\n'x'", @"\\1 \\g \\", @"a::before :hovered", @"$ ^ ~ ~= ^=", @"café é",
+    ];
+
+    for (NSString *source in sources)
+    {
+        [self assertSameLexemesForSource:source];
+    }
+}
+
+- (void)testStylesheetResources
+{
+    NSBundle *bundle = [NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"];
+
+    for (NSString *name in @[ @"large", @"sampleSelectors", @"messageSheet" ])
+    {
+        NSString *path = [bundle pathForResource:name ofType:@"css"];
+        NSString *source = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+
+        XCTAssertNotNil(source, @"Unable to load %@.css", name);
+
+        [self assertSameLexemesForSource:source];
+    }
+}
+
+#pragma mark - Performance Tests
+
+- (void)testLargeCSSScanTime
+{
+    NSString *path = [[NSBundle bundleWithIdentifier:@"com.pixate.pixate-freestyleTests"] pathForResource:@"large" ofType:@"css"];
+    NSString *source = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+
+    double start = [[NSDate date] timeIntervalSinceNow];
+    NSArray *matcherLexemes = [self lexemesForSource:source usingMatcherChain:YES];
+    double matcherTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    start = [[NSDate date] timeIntervalSinceNow];
+    NSArray *scannerLexemes = [self lexemesForSource:source usingMatcherChain:NO];
+    double scannerTime = [[NSDate date] timeIntervalSinceNow] - start;
+
+    XCTAssertEqual(matcherLexemes.count, scannerLexemes.count, @"Lexeme counts differ");
+
+    NSLog(@"Matcher chain = %f ms, scanner = %f ms", matcherTime * 1000, scannerTime * 1000);
+}
+
+@end